@@ -42,6 +42,10 @@ namespace embree
     return ptr;
   }
 
+  void* os_reserve(size_t bytes, int pageFlags) {
+    return os_reserve(bytes);
+  }
+
   void os_commit (void* ptr, size_t bytes) {
     VirtualAlloc(ptr,bytes,MEM_COMMIT,PAGE_READWRITE);
   }
@@ -65,6 +69,26 @@ namespace embree
     FATAL("not implemented");
   }
 
+  void* os_map_file(const char* fileName, size_t& bytes)
+  {
+    HANDLE file = CreateFile(fileName,GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,NULL);
+    if (file == INVALID_HANDLE_VALUE) return NULL;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file,&size) || size.QuadPart == 0) { CloseHandle(file); return NULL; }
+    HANDLE mapping = CreateFileMapping(file,NULL,PAGE_WRITECOPY,0,0,NULL);
+    CloseHandle(file);
+    if (mapping == NULL) return NULL;
+    void* ptr = MapViewOfFile(mapping,FILE_MAP_COPY,0,0,0);
+    CloseHandle(mapping);
+    if (ptr == NULL) return NULL;
+    bytes = (size_t) size.QuadPart;
+    return ptr;
+  }
+
+  void os_unmap_file(void* ptr, size_t bytes) {
+    if (ptr) UnmapViewOfFile(ptr);
+  }
+
   double getSeconds() {
     LARGE_INTEGER freq, val;
     QueryPerformanceFrequency(&freq);
@@ -82,6 +106,10 @@ namespace embree
 
 #include <sys/time.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <errno.h>
 #include <string.h>
 
@@ -119,6 +147,85 @@ namespace embree
     return ptr;
   }
 
+#if defined(__LINUX__) && !defined(__MIC__)
+
+  /*! NUMA nodes that are online, parsed from a list like "0-3,6" */
+  struct OnlineNumaNodes
+  {
+    OnlineNumaNodes () : maxnode(0), numNodes(0)
+    {
+      memset(mask,0,sizeof(mask));
+      FILE* file = fopen("/sys/devices/system/node/online","r");
+      if (file == NULL) return;
+      unsigned first = 0, last = 0;
+      while (fscanf(file,"%u",&first) == 1)
+      {
+        last = first;
+        int c = fgetc(file);
+        if (c == '-') {
+          if (fscanf(file,"%u",&last) != 1) break;
+          c = fgetc(file);
+        }
+        for (size_t i=first; i<=last && i<maxNodes; i++) {
+          mask[i/bitsPerWord] |= 1UL << (i%bitsPerWord);
+          maxnode = i+1; numNodes++;
+        }
+        if (c != ',') break;
+      }
+      fclose(file);
+    }
+
+    static const size_t maxNodes = 1024;
+    static const size_t bitsPerWord = 8*sizeof(unsigned long);
+    unsigned long mask[maxNodes/bitsPerWord];
+    size_t maxnode;    //!< highest online node plus one
+    size_t numNodes;   //!< number of online nodes
+  };
+
+#endif
+
+  void* os_reserve(size_t bytes, int pageFlags)
+  {
+#if defined(__LINUX__) && !defined(__MIC__)
+    char* ptr = NULL;
+    const bool huge = pageFlags & (OS_PAGES_HUGE | OS_PAGES_HUGE_EXPLICIT);
+
+    /* explicit huge pages get reserved at mmap time, thus we fall back if the pool is too small */
+    if (pageFlags & OS_PAGES_HUGE_EXPLICIT) {
+      ptr = (char*) mmap(0, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON | MAP_HUGETLB, -1, 0);
+      if (ptr == MAP_FAILED) ptr = NULL;
+    }
+
+    /* transparent huge pages require a huge page aligned region */
+    if (ptr == NULL && huge) 
+    {
+      char* base = (char*) os_reserve(bytes+OS_HUGE_PAGE_SIZE);
+      ptr = (char*) (((size_t)base+OS_HUGE_PAGE_SIZE-1) & ~(OS_HUGE_PAGE_SIZE-1));
+      if (ptr != base) munmap(base,ptr-base);
+      if (ptr+bytes != base+bytes+OS_HUGE_PAGE_SIZE) munmap(ptr+bytes,base+OS_HUGE_PAGE_SIZE-ptr);
+      madvise(ptr,bytes,MADV_HUGEPAGE);
+    }
+
+    if (ptr == NULL)
+      ptr = (char*) os_reserve(bytes);
+
+    /* pages are not touched yet, thus the policy applies to all of them */
+    if (pageFlags & OS_PAGES_INTERLEAVE) 
+    {
+      static const OnlineNumaNodes nodes;
+      const int MPOL_INTERLEAVE_ = 3;
+      /* the kernel ignores the last bit of the node mask, thus maxnode is one larger than the highest node */
+      if (nodes.numNodes > 1 && syscall(SYS_mbind,ptr,bytes,MPOL_INTERLEAVE_,nodes.mask,nodes.maxnode+1,0) != 0) {
+        if (pageFlags & OS_PAGES_VERBOSE) 
+          std::cout << "cannot interleave pages across NUMA nodes: " << strerror(errno) << std::endl;
+      }
+    }
+    return ptr;
+#else
+    return os_reserve(bytes);
+#endif
+  }
+
   void os_commit (void* ptr, size_t bytes) {
   }
 
@@ -178,6 +285,23 @@ namespace embree
 
   }
 
+  void* os_map_file(const char* fileName, size_t& bytes)
+  {
+    int fd = open(fileName,O_RDONLY);
+    if (fd == -1) return NULL;
+    struct stat st;
+    if (fstat(fd,&st) == -1 || st.st_size == 0) { close(fd); return NULL; }
+    void* ptr = mmap(0, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (ptr == NULL || ptr == MAP_FAILED) return NULL;
+    bytes = st.st_size;
+    return ptr;
+  }
+
+  void os_unmap_file(void* ptr, size_t bytes) {
+    if (ptr) munmap(ptr,bytes);
+  }
+
 
 #if defined(__MIC__)
 
@@ -336,6 +336,25 @@ namespace embree
   void  os_free   (void* ptr, size_t bytes);
   void* os_realloc(void* ptr, size_t bytesNew, size_t bytesOld);
 
+  /*! page placement hints for os_reserve */
+  enum {
+    OS_PAGES_HUGE          = 1, //!< use transparent huge pages
+    OS_PAGES_HUGE_EXPLICIT = 2, //!< use pages from the explicit huge page pool, falls back to transparent huge pages
+    OS_PAGES_INTERLEAVE    = 4, //!< interleave pages across all online NUMA nodes
+    OS_PAGES_VERBOSE       = 8  //!< report placement hints that cannot get fulfilled
+  };
+
+  /*! size of a huge page */
+  static const size_t OS_HUGE_PAGE_SIZE = 2*1024*1024;
+
+  /*! reserves pages with OS_PAGES placement hints, hints that cannot get fulfilled are ignored, 
+   *  for huge pages bytes has to be a multiple of OS_HUGE_PAGE_SIZE */
+  void* os_reserve(size_t bytes, int pageFlags);
+
+  /*! maps a file copy-on-write into memory, returns NULL if the file cannot be mapped */
+  void* os_map_file  (const char* fileName, size_t& bytes);
+  void  os_unmap_file(void* ptr, size_t bytes);
+
   /*! returns performance counter in seconds */
   double getSeconds();
 
@@ -120,6 +120,33 @@ typedef bool (*RTC_MEMORY_MONITOR_FUNCTION)(const ssize_t bytes, const bool post
  *  called before or after the library allocates or frees memory. */
 RTCORE_API void rtcSetMemoryMonitorFunction(RTC_MEMORY_MONITOR_FUNCTION func);
 
+/*! \brief Statistics of the tessellation cache used for subdivision surfaces. */
+struct RTCTessellationCacheStatistics
+{
+  size_t size;          //!< capacity of the cache in bytes
+  size_t bytesUsed;     //!< bytes of the cache that hold valid entries
+  size_t hits;          //!< number of patch lookups that found a cached entry
+  size_t misses;        //!< number of patches that got tessellated
+  size_t copies;        //!< number of cached entries that got copied to survive a flush
+  size_t flushes;       //!< number of cache regions that got flushed
+};
+
+/*! \brief Sets the size of the tessellation cache in bytes.
+
+  All cached entries get invalidated. The memory monitor callback is
+  invoked with the difference to the previous size. The size has to
+  be larger than 1 MB and smaller than 4 GB. Must not get called while
+  rays are traced. */
+RTCORE_API void rtcSetTessellationCacheSize(size_t bytes);
+
+/*! \brief Returns the statistics of the tessellation cache
+ *  accumulated since the last reset. */
+RTCORE_API void rtcGetTessellationCacheStatistics(RTCTessellationCacheStatistics* stats);
+
+/*! \brief Resets the statistics of the tessellation cache, e.g. at
+ *  the beginning of each frame. */
+RTCORE_API void rtcResetTessellationCacheStatistics();
+
 /*! \brief Implementation specific (do not call).
 
   This function is implementation specific and only for debugging
@@ -23,6 +23,17 @@
 /*! invalid geometry ID */
 #define RTC_INVALID_GEOMETRY_ID ((unsigned)-1)
 
+/*! maximal number of time steps of motion blurred triangle meshes */
+#define RTC_MAX_TIME_STEPS 16
+
+/*! Hits of instance arrays store an instance ID with the highest bit
+ *  set in the instID member of the ray. Each instance array of a scene
+ *  gets its own range of these IDs, thus the geometry ID of the array
+ *  is not limited. The instances of all arrays of a scene together can
+ *  use at most RTC_MAX_INSTANCE_ARRAY_SIZE IDs. */
+#define RTC_MAX_INSTANCE_ARRAY_SIZE 0x7FFFFFFFu
+#define RTC_IS_INSTANCE_ARRAY_INSTID(instID) ((instID) != -1 && ((unsigned)(instID) & 0x80000000u))
+
 /*! \brief Specifies the type of buffers when mapping buffers */
 enum RTCBufferType {
   RTC_INDEX_BUFFER         = 0x01000000,
@@ -40,6 +51,8 @@ enum RTCBufferType {
   RTC_VERTEX_CREASE_WEIGHT_BUFFER = 0x08000000,
 
   RTC_HOLE_BUFFER          = 0x09000001,
+
+  RTC_TRANSFORM_BUFFER     = 0x0A000000,
 };
 
 /*! \brief Supported types of matrix layout for functions involving matrices */
@@ -83,7 +96,10 @@ typedef void (*RTCFilterFunc16)(const void* valid, /*!< pointer to valid mask */
                                 void* ptr,         /*!< pointer to user data */
                                 RTCRay16& ray      /*!< intersection to filter */);
 
-/*! Displacement mapping function. */
+/*! Displacement mapping function. All arrays are 64 byte aligned and
+ *  padded to a multiple of 16 points by replicating the last point,
+ *  thus the function can process the points in SIMD blocks of 8 or 16
+ *  without handling a remainder. */
 typedef void (*RTCDisplacementFunc)(void* ptr,           /*!< pointer to user data of geometry */
                                     unsigned geomID,     /*!< ID of geometry to displace */
                                     unsigned primID,     /*!< ID of primitive of geometry to displace */
@@ -109,6 +125,37 @@ RTCORE_API unsigned rtcNewInstance (RTCScene target,                  //!< the s
                                     RTCScene source                   //!< the scene to instantiate
   );
 
+/*! \brief Creates a new array of scene instances.
+
+  An instance array instantiates the source scene numInstances times
+  using a single geometry. The transformation of each instance is
+  stored in the transform buffer (RTC_TRANSFORM_BUFFER) as 12 floats
+  in the RTC_MATRIX_COLUMN_MAJOR layout, the buffer can get mapped or
+  shared with an arbitrary stride using rtcSetBuffer. The hierarchy
+  over the instances is build directly over the transformed bounds of
+  the source scene. If any geometry is hit, the instID member of the
+  ray is set to the base ID of the array plus the index of the hit
+  instance, the base ID can get queried using
+  rtcGetInstanceArrayBaseID. The arrays of a scene get consecutive
+  and non-overlapping ID ranges in the order they are created, IDs of
+  deleted arrays are not reused. If the instances of all arrays of the
+  scene would exceed RTC_MAX_INSTANCE_ARRAY_SIZE IDs,
+  RTC_INVALID_ARGUMENT is raised and RTC_INVALID_GEOMETRY_ID
+  returned. */
+RTCORE_API unsigned rtcNewInstanceArray (RTCScene target,             //!< the scene the instance array belongs to
+                                         RTCScene source,             //!< the scene to instantiate
+                                         size_t numInstances          //!< number of instances
+  );
+
+/*! \brief Returns the instance ID reported for hits of the first
+  instance of an instance array. Hits of the i'th instance report this
+  ID plus i, RTC_IS_INSTANCE_ARRAY_INSTID distinguishes them from hits
+  of regular instances. Returns RTC_INVALID_GEOMETRY_ID if the
+  geometry is no instance array. */
+RTCORE_API unsigned rtcGetInstanceArrayBaseID (RTCScene scene,           //!< the scene the instance array belongs to
+                                               unsigned geomID           //!< ID of the instance array
+  );
+
 /*! \brief Sets transformation of the instance */
 RTCORE_API void rtcSetTransform (RTCScene scene,                          //!< scene handle
                                  unsigned geomID,                         //!< ID of geometry
@@ -118,13 +165,17 @@ RTCORE_API void rtcSetTransform (RTCScene scene,                          //!< s
 
 /*! \brief Creates a new triangle mesh. The number of triangles
   (numTriangles), number of vertices (numVertices), and number of time
-  steps (1 for normal meshes, and 2 for linear motion blur), have to
-  get specified. The triangle indices can be set be mapping and
-  writing to the index buffer (RTC_INDEX_BUFFER) and the triangle
-  vertices can be set by mapping and writing into the vertex buffer
-  (RTC_VERTEX_BUFFER). In case of linear motion blur, two vertex
-  buffers have to get filled (RTC_VERTEX_BUFFER0, RTC_VERTEX_BUFFER1),
-  one for each time step. The index buffer has the default layout of
+  steps (1 for normal meshes, and 2 up to RTC_MAX_TIME_STEPS for
+  motion blur), have to get specified. The triangle indices can be set
+  be mapping and writing to the index buffer (RTC_INDEX_BUFFER) and
+  the triangle vertices can be set by mapping and writing into the
+  vertex buffer (RTC_VERTEX_BUFFER). In case of motion blur, one vertex
+  buffer has to get filled for each time step (RTC_VERTEX_BUFFER0,
+  RTC_VERTEX_BUFFER1, ..., RTC_VERTEX_BUFFER0+numTimeSteps-1). The
+  time steps are distributed uniformly over the time range [0,1] and
+  the motion is linear between neighboring time steps. All motion
+  blurred triangle meshes of a scene have to use the same number of
+  time steps. The index buffer has the default layout of
   three 32 bit integer indices for each triangle. An index points to
   the ith vertex. The vertex buffer stores single precision x,y,z
   floating point coordinates aligned to 16 bytes. The value of the 4th
@@ -136,6 +187,26 @@ RTCORE_API unsigned rtcNewTriangleMesh (RTCScene scene,                    //!<
                                         size_t numTimeSteps = 1            //!< number of motion blur time steps
   );
 
+/*! \brief Creates a new quad mesh. The number of quads (numQuads),
+  number of vertices (numVertices), and number of time steps (has to
+  be 1) have to get specified. The quad indices can be set be mapping
+  and writing to the index buffer (RTC_INDEX_BUFFER) and the quad
+  vertices can be set by mapping and writing into the vertex buffer
+  (RTC_VERTEX_BUFFER). The index buffer has the default layout of four
+  32 bit integer indices for each quad. An index points to the ith
+  vertex. The vertex buffer stores single precision x,y,z floating
+  point coordinates aligned to 16 bytes. The value of the 4th float
+  used for alignment can be arbitrary. A quad v0,v1,v2,v3 is rendered
+  as the two triangles v0,v1,v3 and v2,v3,v1. The reported hit
+  coordinates u,v are the coordinates of the quad, with v0 at (0,0),
+  v1 at (1,0), v2 at (1,1), and v3 at (0,1). */
+RTCORE_API unsigned rtcNewQuadMesh (RTCScene scene,                    //!< the scene the mesh belongs to
+                                    RTCGeometryFlags flags,            //!< geometry flags
+                                    size_t numQuads,                   //!< number of quads
+                                    size_t numVertices,                //!< number of vertices
+                                    size_t numTimeSteps = 1            //!< number of motion blur time steps
+  );
+
 /*! \brief Creates a new subdivision mesh. The number of faces
  (numFaces), edges/indices (numEdges), vertices (numVertices), edge
  creases (numEdgeCreases), vertex creases (numVertexCreases), holes
@@ -283,6 +354,19 @@ RTCORE_API void rtcDisable (RTCScene scene, unsigned geomID);
 /*! \brief Sets the displacement function. */
 RTCORE_API void rtcSetDisplacementFunction (RTCScene scene, unsigned geomID, RTCDisplacementFunc func, RTCBounds* bounds);
 
+/*! \brief Enables view dependent tessellation levels for a subdivision mesh.
+
+  Instead of using the level buffer, the edge levels of the mesh get
+  calculated during rtcCommit, such that each tessellated edge
+  projects to about edgeLength pixels for a pinhole camera located at
+  pos (3 floats), with a vertical field of view of fovy degrees and a
+  vertical resolution of resolution pixels. The levels get rounded up
+  to integers, and only patches whose levels changed get updated when
+  only the camera moved. The levels are calculated from the first
+  time step. Calling this function again moves the camera, and an
+  edgeLength of zero disables view dependent levels again. */
+RTCORE_API void rtcSetViewDependentTessellation (RTCScene scene, unsigned geomID, const float* pos, float fovy, size_t resolution, float edgeLength);
+
 /*! \brief Sets the intersection filter function for single rays. */
 RTCORE_API void rtcSetIntersectionFilterFunction (RTCScene scene, unsigned geomID, RTCFilterFunc func);
 
@@ -318,6 +402,29 @@ RTCORE_API void* rtcGetUserData (RTCScene scene, unsigned geomID);
 /*! \brief Deletes the geometry. */
 RTCORE_API void rtcDeleteGeometry (RTCScene scene, unsigned geomID);
 
+/*! \brief Interpolates vertex attributes over the surface of a geometry.
+
+  Evaluates the user attributes stored in src at numUVs surface
+  locations of geometry geomID. The i'th location is given by the
+  primitive ID primIDs[i] and the hit coordinates u[i] and v[i], as
+  reported by rtcIntersect. The attribute buffer src stores numFloats
+  floats for each vertex of the geometry, with byteStride bytes
+  between vertices. It has to be padded such that 16 bytes can be
+  read at the end. The interpolated attributes and their derivatives
+  in u and v are stored component by component: component j of
+  location i is written to P[j*numUVs+i], dPdu[j*numUVs+i], and
+  dPdv[j*numUVs+i]. Each of the output arrays may be NULL. Triangle
+  and quad meshes get interpolated linearly. Subdivision meshes get
+  evaluated on their limit surface, ignoring displacements, locations
+  outside of a face get clamped to the face. The scene has to be
+  committed before calling this function. Static scenes release mapped index
+  buffers of triangle and quad meshes after the commit, thus these
+  have to be shared using rtcSetBuffer for interpolation. */
+RTCORE_API void rtcInterpolateN (RTCScene scene, unsigned geomID, 
+                                 const unsigned* primIDs, const float* u, const float* v, size_t numUVs, 
+                                 const float* src, size_t byteStride,
+                                 float* P, float* dPdu, float* dPdv, size_t numFloats);
+
 
 /*! @} */
 
@@ -71,6 +71,29 @@ typedef void (*RTCOccludedFunc16) (const void* valid, /*! pointer to valid mask
                                    RTCRay16& ray,     /*!< Ray packet to test occlusion. */
                                    size_t item        /*!< item to test for occlusion */);
 
+/*! Ray/item pair passed to the stream intersect and occluded functions. */
+struct RTCRayItem
+{
+  unsigned ray;                                       /*!< index of the ray in the passed ray array */
+  unsigned item;                                      /*!< item to intersect the ray with */
+};
+
+/*! Type of intersect function pointer for streams of ray/item
+ *  pairs. Each ray rays[items[i].ray] has to get intersected with the
+ *  item items[i].item, for all i<N. */
+typedef void (*RTCIntersectFuncN)(void* ptr,          /*!< pointer to user data */
+                                  RTCRay* rays,       /*!< rays to intersect */
+                                  const RTCRayItem* items, /*!< ray/item pairs to intersect */
+                                  size_t N            /*!< number of ray/item pairs */);
+
+/*! Type of occlusion function pointer for streams of ray/item
+ *  pairs. Has to set the geomID of rays[items[i].ray] to 0 if the ray
+ *  is occluded by the item items[i].item, for all i<N. */
+typedef void (*RTCOccludedFuncN)(void* ptr,           /*!< pointer to user data */
+                                 RTCRay* rays,        /*!< rays to test occlusion */
+                                 const RTCRayItem* items, /*!< ray/item pairs to test for occlusion */
+                                 size_t N             /*!< number of ray/item pairs */);
+
 /*! Creates a new user geometry object. This feature makes it possible
  *  to add arbitrary types of geometry to the scene by providing
  *  appropiate bounding, intersect and occluded functions. A user
@@ -133,6 +156,20 @@ RTCORE_API void rtcSetOccludedFunction8 (RTCScene scene, unsigned geomID, RTCOcc
  *  intersecting the user geometry. */
 RTCORE_API void rtcSetOccludedFunction16 (RTCScene scene, unsigned geomID, RTCOccludedFunc16 occluded16);
 
+/*! Set intersect function for streams of ray/item pairs. If set, the
+ *  rtcIntersect, rtcIntersect4, and rtcIntersect8 functions collect
+ *  the items of this user geometry that are hit by the traversal and
+ *  pass them in batches to the stream function, instead of invoking
+ *  the single ray or packet intersect function for each item. Items
+ *  are only collected in bounding box order, thus the stream function
+ *  may get invoked for items behind the closest hit. */
+RTCORE_API void rtcSetIntersectFunctionN (RTCScene scene, unsigned geomID, RTCIntersectFuncN intersectN);
+
+/*! Set occlusion function for streams of ray/item pairs. If set, the
+ *  rtcOccluded, rtcOccluded4, and rtcOccluded8 functions pass the
+ *  items of this user geometry in batches to the stream function. */
+RTCORE_API void rtcSetOccludedFunctionN (RTCScene scene, unsigned geomID, RTCOccludedFuncN occludedN);
+
 /*! @} */
 
 #endif
@@ -149,6 +149,41 @@ public:
   int   instID[16];  //!< instance ID
 };
 
+/*! \brief Ray structure for streams of rays in SoA layout. Each
+ *  member points to an array that holds the corresponding component
+ *  of all rays of the stream. */
+struct RTCRayNp
+{
+  /* ray data */
+public:
+  float* orgx;  //!< x coordinate of ray origin
+  float* orgy;  //!< y coordinate of ray origin
+  float* orgz;  //!< z coordinate of ray origin
+  
+  float* dirx;  //!< x coordinate of ray direction
+  float* diry;  //!< y coordinate of ray direction
+  float* dirz;  //!< z coordinate of ray direction
+  
+  float* tnear; //!< Start of ray segment 
+  float* tfar;  //!< End of ray segment (set to hit distance)
+
+  float* time;  //!< Time of this ray for motion blur
+  int*   mask;  //!< Used to mask out objects during traversal
+  
+  /* hit data */
+public:
+  float* Ngx;   //!< x coordinate of geometry normal
+  float* Ngy;   //!< y coordinate of geometry normal
+  float* Ngz;   //!< z coordinate of geometry normal
+  
+  float* u;     //!< Barycentric u coordinate of hit
+  float* v;     //!< Barycentric v coordinate of hit
+  
+  int*   geomID;  //!< geometry ID
+  int*   primID;  //!< primitive ID
+  int*   instID;  //!< instance ID
+};
+
 /*! @} */
 
 #endif
@@ -25,6 +25,7 @@ struct RTCRay;
 struct RTCRay4;
 struct RTCRay8;
 struct RTCRay16;
+struct RTCRayNp;
 
 /*! scene flags */
 enum RTCSceneFlags 
@@ -32,6 +33,7 @@ enum RTCSceneFlags
   /* dynamic type flags */
   RTC_SCENE_STATIC     = (0 << 0),    //!< specifies static scene
   RTC_SCENE_DYNAMIC    = (1 << 0),    //!< specifies dynamic scene
+  RTC_SCENE_ASYNC_COMMIT = (1 << 1),  //!< keeps tracing the previous build while rtcCommitAsync rebuilds the scene
 
   /* acceleration structure flags */
   RTC_SCENE_COMPACT    = (1 << 8),    //!< use memory conservative data structures
@@ -40,7 +42,8 @@ enum RTCSceneFlags
   RTC_SCENE_HIGH_QUALITY = (1 << 11),  //!< create higher quality data structures
 
   /* traversal algorithm flags */
-  RTC_SCENE_ROBUST     = (1 << 16)     //!< use more robust traversal algorithms
+  RTC_SCENE_ROBUST     = (1 << 16),    //!< use more robust traversal algorithms
+  RTC_SCENE_BACKFACE_CULLING = (1 << 17) //!< ignore hits with triangles that face away from the ray
 };
 
 /*! enabled algorithm flags */
@@ -64,6 +67,17 @@ typedef bool (*RTC_PROGRESS_MONITOR_FUNCTION)(void* ptr, const double n);
 /*! \brief Sets the progress callback function which is called during hierarchy build of this scene. */
 RTCORE_API void rtcSetProgressMonitorFunction(RTCScene scene, RTC_PROGRESS_MONITOR_FUNCTION func, void* ptr);
 
+/*! \brief Sets a file to cache the acceleration structures of a static scene.
+ *
+ *  When the scene gets committed and the file contains acceleration
+ *  structures for exactly the same geometry, the file is mapped into
+ *  memory instead of building the acceleration structures. Otherwise
+ *  the acceleration structures are build and written to the
+ *  file. Currently only BVH4 based triangle acceleration structures
+ *  get cached, all others are always build. The function has to get
+ *  called before the first commit of the scene. */
+RTCORE_API void rtcSetSceneCacheFile(RTCScene scene, const char* fileName);
+
 /*! Commits the geometry of the scene. After initializing or modifying
  *  geometries, commit has to get called before tracing
  *  rays. */
@@ -81,6 +95,23 @@ RTCORE_API void rtcCommit (RTCScene scene);
  *  coprocessor. */
 RTCORE_API void rtcCommitThread(RTCScene scene, unsigned int threadID, unsigned int numThreads);
 
+/*! Commits the geometry of a scene created with the
+ *  RTC_SCENE_ASYNC_COMMIT flag in a background thread and returns
+ *  immediately. Rays traced during the build still see the previously
+ *  committed state of the scene; once the new acceleration structures
+ *  are finished they atomically replace the old ones, which are freed
+ *  as soon as all traversals through them finished. The geometries of
+ *  the scene must not get modified until the commit finished, see
+ *  rtcWaitCommit. */
+RTCORE_API void rtcCommitAsync (RTCScene scene);
+
+/*! Waits until a commit started by rtcCommitAsync finished. Returns
+ *  immediately if no asynchronous commit is pending. Errors of the
+ *  asynchronous commit are reported to the thread that waits for it,
+ *  which is the caller of rtcWaitCommit, rtcCommit, rtcCommitAsync,
+ *  rtcCommitThread, or rtcDeleteScene. */
+RTCORE_API void rtcWaitCommit (RTCScene scene);
+
 /*! Intersects a single ray with the scene. The ray has to be aligned
  *  to 16 bytes. This function can only be called for scenes with the
  *  RTC_INTERSECT1 flag set. */
@@ -131,6 +162,33 @@ RTCORE_API void rtcOccluded8 (const void* valid, RTCScene scene, RTCRay8& ray);
  *  instructions. */
 RTCORE_API void rtcOccluded16 (const void* valid, RTCScene scene, RTCRay16& ray);
 
+/*! Intersects a stream of N rays in AoS layout with the scene. The
+ *  rays are stored 'stride' bytes apart, starting at 'rays'. The
+ *  stream is reordered internally into coherent packets which are
+ *  traced using the widest ray packet type enabled for the scene
+ *  through the RTC_INTERSECT4, RTC_INTERSECT8, and RTC_INTERSECT16
+ *  flags. If no packet type is enabled, the rays are traced as
+ *  single rays, which requires the RTC_INTERSECT1 flag. */
+RTCORE_API void rtcIntersectN (RTCScene scene, RTCRay* rays, size_t N, size_t stride);
+
+/*! Intersects a stream of N rays in SoA layout with the scene. Each
+ *  member of the RTCRayNp structure points to an array of N
+ *  elements. The same packet selection rules as for rtcIntersectN
+ *  apply. */
+RTCORE_API void rtcIntersectNp (RTCScene scene, const RTCRayNp& rays, size_t N);
+
+/*! Tests if the rays of a stream of N rays in AoS layout are
+ *  occluded by the scene. The rays are stored 'stride' bytes apart,
+ *  starting at 'rays'. The same packet selection rules as for
+ *  rtcIntersectN apply. */
+RTCORE_API void rtcOccludedN (RTCScene scene, RTCRay* rays, size_t N, size_t stride);
+
+/*! Tests if the rays of a stream of N rays in SoA layout are
+ *  occluded by the scene. Each member of the RTCRayNp structure
+ *  points to an array of N elements. The same packet selection rules
+ *  as for rtcIntersectN apply. */
+RTCORE_API void rtcOccludedNp (RTCScene scene, const RTCRayNp& rays, size_t N);
+
 /*! Deletes the scene. All contained geometry get also destroyed. */
 RTCORE_API void rtcDeleteScene (RTCScene scene);
 
@@ -696,4 +696,50 @@ LinearBarrierActive barrier; // FIXME: should be able to speficy number of threa
     void radix_sort_copy_u64(Ty* const src, Ty* const dst, const size_t N, const size_t blockSize = 4096) {
     radix_sort_copy<Ty,uint64>(src,dst,N,blockSize);
   } 
+
+  //////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////////////////////
+
+  /*! single threaded radix sort that does not spawn tasks, thus can
+   *  get used from inside of application threads, the sorted result
+   *  ends up in src */
+  template<typename Ty, typename Key>
+    void radix_sort_serial(Ty* const src, Ty* const tmp, const size_t N)
+  {
+    static const size_t BITS = 8;
+    static const size_t BUCKETS = (1 << BITS);
+    if (N == 0) return;
+
+    Ty* in = src;
+    Ty* out = tmp;
+    for (size_t shift=0; shift<8*sizeof(Key); shift+=BITS)
+    {
+      /* count how many items go into each bucket */
+      size_t count[BUCKETS];
+      for (size_t i=0; i<BUCKETS; i++) count[i] = 0;
+      for (size_t i=0; i<N; i++) count[(Key(in[i]) >> shift) & (BUCKETS-1)]++;
+
+      /* skip iteration if all items fall into the same bucket */
+      if (count[(Key(in[0]) >> shift) & (BUCKETS-1)] == N) continue;
+
+      /* calculate start offset of each bucket */
+      size_t offset[BUCKETS];
+      offset[0] = 0;
+      for (size_t i=1; i<BUCKETS; i++) offset[i] = offset[i-1]+count[i-1];
+
+      /* copy items into their buckets */
+      for (size_t i=0; i<N; i++) {
+        const size_t bucket = (Key(in[i]) >> shift) & (BUCKETS-1);
+        out[offset[bucket]++] = in[i];
+      }
+      std::swap(in,out);
+    }
+    if (in != src) 
+      for (size_t i=0; i<N; i++) src[i] = in[i];
+  }
+
+  template<typename Ty>
+    void radix_sort_serial_u32(Ty* const src, Ty* const tmp, const size_t N) {
+    radix_sort_serial<Ty,uint32>(src,tmp,N);
+  }
 }
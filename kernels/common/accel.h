@@ -25,6 +25,12 @@ namespace embree
   public:
     AccelData () : bounds(empty) {}
     virtual void clear() {} // FIXME: make pure virtual too see if implemented by all new builders
+
+    /*! writes the acceleration structure in relocatable form to a stream, returns false if not supported */
+    virtual bool store(std::ostream& stream) { return false; }
+
+    /*! initializes the acceleration structure from data written by store, the data is relocated in place and has to stay valid */
+    virtual bool load(char* ptr, size_t bytes) { return false; }
   public:
     BBox3fa bounds;
   };
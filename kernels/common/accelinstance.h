@@ -25,7 +25,7 @@ namespace embree
   {
   public:
     AccelInstance (AccelData* accel, Builder* builder, Intersectors& intersectors)
-      : accel(accel), builder(builder), Accel(intersectors) {}
+      : accel(accel), builder(builder), loaded(false), Accel(intersectors) {}
 
     void immutable () {
       delete builder; builder = NULL;
@@ -38,17 +38,28 @@ namespace embree
 
   public:
     void build (size_t threadIndex, size_t threadCount) {
-      if (builder) builder->build(threadIndex,threadCount);
+      if (builder && !loaded) builder->build(threadIndex,threadCount);
       bounds = accel->bounds;
     }
 
     void clear() {
       accel->clear();
       builder->clear();
+      loaded = false;
+    }
+
+    bool store(std::ostream& stream) {
+      return accel->store(stream);
+    }
+
+    bool load(char* ptr, size_t bytes) {
+      loaded = accel->load(ptr,bytes);
+      return loaded;
     }
 
   private:
     AccelData* accel;
     Builder* builder;
+    bool loaded;        //!< true if the acceleration structure got loaded instead of build
   };
 }
@@ -36,84 +36,147 @@ namespace embree
     if (N<16) accels[N++] = accel;
   }
   
-  void AccelN::intersect (void* ptr, RTCRay& ray) 
-  {
-    AccelN* This = (AccelN*)ptr;
-    for (size_t i=0; i<This->M; i++)
-      This->validAccels[i]->intersect(ray);
+  /*! reciprocal that avoids infinities for axis aligned directions */
+  __forceinline float rcp_dir(const float x) {
+    return 1.0f/(abs(x) < 1E-18f ? (x < 0.0f ? -1E-18f : 1E-18f) : x);
   }
 
-  void AccelN::intersect4 (const void* valid, void* ptr, RTCRay4& ray) 
+  /*! calculates the distance at which a ray enters the bounds, returns inf if the bounds are missed */
+  __forceinline float entryDistance(const BBox3fa& b, 
+                                    const float ox, const float oy, const float oz, 
+                                    const float dx, const float dy, const float dz, 
+                                    const float tnear, const float tfar)
   {
-    AccelN* This = (AccelN*)ptr;
-    for (size_t i=0; i<This->M; i++)
-      This->validAccels[i]->intersect4(valid,ray);
+    const float rx = rcp_dir(dx), ry = rcp_dir(dy), rz = rcp_dir(dz);
+    const float tx0 = (b.lower.x-ox)*rx, tx1 = (b.upper.x-ox)*rx;
+    const float ty0 = (b.lower.y-oy)*ry, ty1 = (b.upper.y-oy)*ry;
+    const float tz0 = (b.lower.z-oz)*rz, tz1 = (b.upper.z-oz)*rz;
+    const float tNear = max(tnear,min(tx0,tx1),min(ty0,ty1),min(tz0,tz1));
+    const float tFar  = min(tfar ,max(tx0,tx1),max(ty0,ty1),max(tz0,tz1));
+    return tNear <= tFar ? tNear : float(inf);
   }
 
-  void AccelN::intersect8 (const void* valid, void* ptr, RTCRay8& ray) 
+  /*! inserts accel i into the list of accels sorted by entry distance */
+  __forceinline void insertSorted(size_t* order, float* dist, size_t& n, const size_t i, const float d)
   {
-    AccelN* This = (AccelN*)ptr;
-    for (size_t i=0; i<This->M; i++)
-      This->validAccels[i]->intersect8(valid,ray);
+    size_t j = n++;
+    for (; j>0 && dist[j-1] > d; j--) {
+      order[j] = order[j-1]; dist[j] = dist[j-1];
+    }
+    order[j] = i; dist[j] = d;
   }
 
-  void AccelN::intersect16 (const void* valid, void* ptr, RTCRay16& ray) 
-  {
-    AccelN* This = (AccelN*)ptr;
-    for (size_t i=0; i<This->M; i++)
-      This->validAccels[i]->intersect16(valid,ray);
-  }
+  __forceinline void intersectAccel(Accel* accel, const void* valid, RTCRay4 & ray) { accel->intersect4 (valid,ray); }
+  __forceinline void intersectAccel(Accel* accel, const void* valid, RTCRay8 & ray) { accel->intersect8 (valid,ray); }
+  __forceinline void intersectAccel(Accel* accel, const void* valid, RTCRay16& ray) { accel->intersect16(valid,ray); }
 
-  void AccelN::occluded (void* ptr, RTCRay& ray) 
+  __forceinline void occludedAccel (Accel* accel, const void* valid, RTCRay4 & ray) { accel->occluded4 (valid,ray); }
+  __forceinline void occludedAccel (Accel* accel, const void* valid, RTCRay8 & ray) { accel->occluded8 (valid,ray); }
+  __forceinline void occludedAccel (Accel* accel, const void* valid, RTCRay16& ray) { accel->occluded16(valid,ray); }
+
+  /*! The bounds of all valid accels form a single top level node. A
+   *  packet enters an accel only with the rays that hit its bounds
+   *  closer than their current hit distance, and accels are
+   *  traversed front to back such that hits found in near accels cull
+   *  far ones. */
+  template<typename RTCRayK, size_t K>
+  __forceinline void intersectK (AccelN* This, const int* valid_i, RTCRayK& ray)
   {
-    AccelN* This = (AccelN*)ptr;
-    for (size_t i=0; i<This->M; i++) {
-      This->validAccels[i]->occluded(ray); 
-      if (ray.geomID == 0) break;
+    float dist[16][K];
+    size_t order[16]; float minDist[16]; size_t n = 0;
+    for (size_t i=0; i<This->M; i++) 
+    {
+      float d0 = inf;
+      for (size_t k=0; k<K; k++) {
+        dist[i][k] = valid_i[k] ? entryDistance(This->validBounds[i],ray.orgx[k],ray.orgy[k],ray.orgz[k],
+                                                ray.dirx[k],ray.diry[k],ray.dirz[k],ray.tnear[k],ray.tfar[k]) : float(inf);
+        d0 = min(d0,dist[i][k]);
+      }
+      if (d0 != float(inf)) insertSorted(order,minDist,n,i,d0);
+    }
+    
+    for (size_t j=0; j<n; j++)
+    {
+      const size_t i = order[j];
+      __aligned(64) int valid_o[K]; 
+      bool any = false;
+      for (size_t k=0; k<K; k++) {
+        valid_o[k] = dist[i][k] != float(inf) && dist[i][k] <= ray.tfar[k] ? -1 : 0;
+        any |= valid_o[k] != 0;
+      }
+      if (any) intersectAccel(This->validAccels[i],valid_o,ray);
     }
   }
 
-  void AccelN::occluded4 (const void* valid, void* ptr, RTCRay4& ray) 
+  template<typename RTCRayK, size_t K>
+  __forceinline void occludedK (AccelN* This, const int* valid_i, RTCRayK& ray)
   {
-    AccelN* This = (AccelN*)ptr;
-    for (size_t i=0; i<This->M; i++) {
-      This->validAccels[i]->occluded4(valid,ray);
-#if defined(__SSE2__)
-      sseb valid0 = ((sseb*)valid)[0];
-      sseb hit0   = ((ssei*)ray.geomID)[0] == ssei(0);
-      if (all(valid0,hit0)) break;
-#endif
+    for (size_t i=0; i<This->M; i++) 
+    {
+      __aligned(64) int valid_o[K]; 
+      bool any = false;
+      for (size_t k=0; k<K; k++) {
+        valid_o[k] = valid_i[k] && ray.geomID[k] != 0 && 
+          entryDistance(This->validBounds[i],ray.orgx[k],ray.orgy[k],ray.orgz[k],
+                        ray.dirx[k],ray.diry[k],ray.dirz[k],ray.tnear[k],ray.tfar[k]) != float(inf) ? -1 : 0;
+        any |= valid_o[k] != 0;
+      }
+      if (any) occludedAccel(This->validAccels[i],valid_o,ray);
     }
   }
-
-  void AccelN::occluded8 (const void* valid, void* ptr, RTCRay8& ray) 
+  
+  void AccelN::intersect (void* ptr, RTCRay& ray) 
   {
     AccelN* This = (AccelN*)ptr;
+    size_t order[16]; float dist[16]; size_t n = 0;
     for (size_t i=0; i<This->M; i++) {
-      This->validAccels[i]->occluded8(valid,ray);
-#if defined(__SSE2__)
-      sseb valid0 = ((sseb*)valid)[0];
-      sseb hit0   = ((ssei*)ray.geomID)[0] == ssei(0);
-      sseb valid1 = ((sseb*)valid)[1];
-      sseb hit1   = ((ssei*)ray.geomID)[1] == ssei(0);
-      if (all(valid0,hit0) && all(valid1,hit1)) break;
-#endif
+      const float d = entryDistance(This->validBounds[i],ray.org[0],ray.org[1],ray.org[2],
+                                    ray.dir[0],ray.dir[1],ray.dir[2],ray.tnear,ray.tfar);
+      if (d != float(inf)) insertSorted(order,dist,n,i,d);
     }
+    for (size_t j=0; j<n; j++) {
+      if (dist[j] > ray.tfar) break;
+      This->validAccels[order[j]]->intersect(ray);
+    }
+  }
+
+  void AccelN::intersect4 (const void* valid, void* ptr, RTCRay4& ray) {
+    intersectK<RTCRay4,4>((AccelN*)ptr,(const int*)valid,ray);
   }
 
-  void AccelN::occluded16 (const void* valid, void* ptr, RTCRay16& ray) 
+  void AccelN::intersect8 (const void* valid, void* ptr, RTCRay8& ray) {
+    intersectK<RTCRay8,8>((AccelN*)ptr,(const int*)valid,ray);
+  }
+
+  void AccelN::intersect16 (const void* valid, void* ptr, RTCRay16& ray) {
+    intersectK<RTCRay16,16>((AccelN*)ptr,(const int*)valid,ray);
+  }
+
+  void AccelN::occluded (void* ptr, RTCRay& ray) 
   {
     AccelN* This = (AccelN*)ptr;
-    for (size_t i=0; i<This->M; i++) {
-      This->validAccels[i]->occluded16(valid,ray);
-#if defined(__MIC__)
-      mic_m valid0 = ((mic_m*)valid)[0];
-      mic_m hit0   = ((mic_i*)ray.geomID)[0] == mic_i(0);
-      if (all(valid0,hit0)) break;
-#endif
+    for (size_t i=0; i<This->M; i++) 
+    {
+      const float d = entryDistance(This->validBounds[i],ray.org[0],ray.org[1],ray.org[2],
+                                    ray.dir[0],ray.dir[1],ray.dir[2],ray.tnear,ray.tfar);
+      if (d == float(inf)) continue;
+      This->validAccels[i]->occluded(ray); 
+      if (ray.geomID == 0) break;
     }
   }
 
+  void AccelN::occluded4 (const void* valid, void* ptr, RTCRay4& ray) {
+    occludedK<RTCRay4,4>((AccelN*)ptr,(const int*)valid,ray);
+  }
+
+  void AccelN::occluded8 (const void* valid, void* ptr, RTCRay8& ray) {
+    occludedK<RTCRay8,8>((AccelN*)ptr,(const int*)valid,ray);
+  }
+
+  void AccelN::occluded16 (const void* valid, void* ptr, RTCRay16& ray) {
+    occludedK<RTCRay16,16>((AccelN*)ptr,(const int*)valid,ray);
+  }
+
   void AccelN::print(size_t ident)
   {
     for (size_t i=0; i<M; i++)
@@ -140,6 +203,11 @@ namespace embree
       accels[i]->build(threadIndex,threadCount);
 
       if (accels[i]->bounds.empty()) continue;
+
+      /* enlarge bounds to be conservative against rounding in the culling test */
+      const BBox3fa b = accels[i]->bounds;
+      const Vec3fa eps = 1E-5f*(max(abs(b.lower),abs(b.upper))+Vec3fa(one));
+      validBounds[M] = BBox3fa(b.lower-eps,b.upper+eps);
       validAccels[M++] = accels[i];
     }
 
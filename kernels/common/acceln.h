@@ -53,6 +53,7 @@ namespace embree
     size_t N;
 
     Accel* validAccels[16];
+    BBox3fa validBounds[16];  //!< slightly enlarged bounds of valid accels used to order and cull traversal
     size_t M;
   };
 }
@@ -37,6 +37,9 @@ namespace embree
     typedef RTCOccludedFunc8 OccludedFunc8;
     typedef RTCOccludedFunc16 OccludedFunc16;
 
+    typedef RTCIntersectFuncN IntersectFuncN;
+    typedef RTCOccludedFuncN OccludedFuncN;
+
 #if defined(__SSE__)
     typedef void (*ISPCIntersectFunc4)(void* ptr, RTCRay4& ray, size_t item, __m128 valid);
     typedef void (*ISPCOccludedFunc4 )(void* ptr, RTCRay4& ray, size_t item, __m128 valid);
@@ -123,6 +126,16 @@ namespace embree
 	bool ispc;
       };
       
+      struct IntersectorN
+      {
+        IntersectorN () 
+        : intersect(NULL), occluded(NULL) {}
+
+      public:
+        IntersectFuncN intersect;
+        OccludedFuncN occluded;
+      };
+      
     public:
       
       /*! Construction */
@@ -190,12 +203,24 @@ namespace embree
 #endif
       }
       
+      /*! Intersects a stream of ray/item pairs with the scene. */
+      __forceinline void intersectN (RTCRay* rays, const RTCRayItem* items, size_t N) {
+        assert(intersectors.intersectorN.intersect);
+        intersectors.intersectorN.intersect(intersectors.ptr,rays,items,N);
+      }
+
       /*! Tests if single ray is occluded by the scene. */
       __forceinline void occluded (RTCRay& ray, size_t item) {
         assert(intersectors.intersector1.occluded);
         intersectors.intersector1.occluded(intersectors.ptr,ray,item);
       }
       
+      /*! Tests if a stream of ray/item pairs is occluded by the scene. */
+      __forceinline void occludedN (RTCRay* rays, const RTCRayItem* items, size_t N) {
+        assert(intersectors.intersectorN.occluded);
+        intersectors.intersectorN.occluded(intersectors.ptr,rays,items,N);
+      }
+      
       /*! Tests if a packet of 4 rays is occluded by the scene. */
 #if defined(__SSE__)
       __forceinline void occluded4 (const void* valid, RTCRay4& ray, size_t item) {
@@ -241,6 +266,7 @@ namespace embree
         Intersector4 intersector4;
         Intersector8 intersector8;
         Intersector16 intersector16;
+        IntersectorN intersectorN;      //!< optional stream callbacks of user geometries
       } intersectors;
   };
 
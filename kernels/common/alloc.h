@@ -340,19 +340,33 @@ namespace embree
 
     struct Block 
     {
+      /*! page placement for blocks of the specified size */
+      static int pageFlags(size_t bytesReserve)
+      {
+        int flags = 0;
+        if (g_numa_interleave) flags |= OS_PAGES_INTERLEAVE;
+        if (g_verbose >= 1) flags |= OS_PAGES_VERBOSE;
+        if (bytesReserve < OS_HUGE_PAGE_SIZE) return flags; // small blocks would waste most of a huge page
+        if (g_hugepages == 1) flags |= OS_PAGES_HUGE;
+        if (g_hugepages >= 2) flags |= OS_PAGES_HUGE_EXPLICIT;
+        return flags;
+      }
+
       static Block* create(size_t bytesAllocate, size_t bytesReserve, Block* next = NULL)
       {
         const size_t sizeof_Header = offsetof(Block,data[0]);
-        bytesAllocate = ((sizeof_Header+bytesAllocate+4095) & ~(4095)); // always consume full pages
-        bytesReserve  = ((sizeof_Header+bytesReserve +4095) & ~(4095)); // always consume full pages
+        const int flags = pageFlags(sizeof_Header+bytesReserve);
+        const size_t pageSize = (flags & (OS_PAGES_HUGE | OS_PAGES_HUGE_EXPLICIT)) ? OS_HUGE_PAGE_SIZE : 4096;
+        bytesAllocate = ((sizeof_Header+bytesAllocate+pageSize-1) & ~(pageSize-1)); // always consume full pages
+        bytesReserve  = ((sizeof_Header+bytesReserve +pageSize-1) & ~(pageSize-1)); // always consume full pages
         memoryMonitor(bytesAllocate,false);
-        void* ptr = os_reserve(bytesReserve);
+        void* ptr = os_reserve(bytesReserve,flags);
         os_commit(ptr,bytesAllocate);
-        return new (ptr) Block(bytesAllocate-sizeof_Header,bytesReserve-sizeof_Header,next);
+        return new (ptr) Block(bytesAllocate-sizeof_Header,bytesReserve-sizeof_Header,next,flags);
       }
 
-      Block (size_t bytesAllocate, size_t bytesReserve, Block* next) 
-      : cur(0), allocEnd(bytesAllocate), reserveEnd(bytesReserve), next(next) 
+      Block (size_t bytesAllocate, size_t bytesReserve, Block* next, int flags) 
+      : cur(0), allocEnd(bytesAllocate), reserveEnd(bytesReserve), next(next), flags(flags) 
       {
         //for (size_t i=0; i<allocEnd; i+=4096) data[i] = 0;
       }
@@ -406,8 +420,11 @@ namespace embree
 
       void shrink () 
       {
-        os_shrink(&data[0],cur,reserveEnd);
-        reserveEnd = allocEnd = cur;
+        /* huge page mappings can only get released as a whole */
+        if (!(flags & (OS_PAGES_HUGE | OS_PAGES_HUGE_EXPLICIT))) {
+          os_shrink(&data[0],cur,reserveEnd);
+          reserveEnd = allocEnd = cur;
+        }
         if (next) next->shrink();
       }
 
@@ -432,7 +449,8 @@ namespace embree
       size_t allocEnd;           //!< end of the allocated memory region
       size_t reserveEnd;         //!< end of the reserved memory region
       Block* next;               //!< pointer to next block in list
-      char align[maxAlignment-4*sizeof(size_t)]; //!< align data to maxAlignment
+      size_t flags;              //!< page placement of this block
+      char align[maxAlignment-5*sizeof(size_t)]; //!< align data to maxAlignment
       char data[1];              //!< here starts memory to use for allocations
     };
 
@@ -71,7 +71,18 @@ namespace embree
     return all(gt_mask(v.lower,Vec3fa_t(-VALID_FLOAT_RANGE)) & lt_mask(v.upper,Vec3fa_t(+VALID_FLOAT_RANGE)));
   };
 
+  /*! returns the time segment of 'numSegments' equal segments of [0,1]
+   *  the time falls into, and the time relative to that segment */
+  __forceinline size_t getTimeSegment(const float time, const float numSegments, float& ftime)
+  {
+    const float scaled = time*numSegments;
+    const float itime = clamp(floor(scaled),0.0f,numSegments-1.0f);
+    ftime = scaled-itime;
+    return size_t(itime);
+  }
+
 #define MODE_HIGH_QUALITY (1<<8)
+#define MODE_QUANTIZED (1<<9)
 #define LIST_MODE_BITS 0xFF
 
 #if 0
@@ -98,6 +109,8 @@ namespace embree
   extern std::string g_tri_builder;
   extern std::string g_tri_traverser;
   extern double g_tri_builder_replication_factor;
+  extern size_t g_build_chunk_size;
+  extern float g_tri_refit_restructure;
 
   extern std::string g_tri_accel_mb;
   extern std::string g_tri_builder_mb;
@@ -109,10 +122,17 @@ namespace embree
   extern double g_hair_builder_replication_factor;
 
   extern std::string g_subdiv_accel;
+  extern size_t g_subdiv_tight_bounds;
 
   extern int g_scene_flags;
   extern size_t g_benchmark;
   extern float g_memory_preallocation_factor;
+  extern size_t g_hugepages;
+  extern size_t g_numa_interleave;
+
+  extern ssize_t g_raystream_log_first_frame;
+  extern ssize_t g_raystream_log_frames;
+  extern bool g_raystream_log_compression;
 
   /*! processes an error */
   void process_error(RTCError error, const char* code);
@@ -120,12 +140,14 @@ namespace embree
   /*! decoding of geometry flags */
   __forceinline bool isStatic    (RTCSceneFlags flags) { return (flags & 1) == RTC_SCENE_STATIC; }
   __forceinline bool isDynamic   (RTCSceneFlags flags) { return (flags & 1) == RTC_SCENE_DYNAMIC; }
+  __forceinline bool isAsyncCommit(RTCSceneFlags flags) { return flags & RTC_SCENE_ASYNC_COMMIT; }
 
   __forceinline bool isCompact   (RTCSceneFlags flags) { return flags & RTC_SCENE_COMPACT; }
   __forceinline bool isRobust    (RTCSceneFlags flags) { return flags & RTC_SCENE_ROBUST; }
   __forceinline bool isCoherent  (RTCSceneFlags flags) { return flags & RTC_SCENE_COHERENT; }
   __forceinline bool isIncoherent(RTCSceneFlags flags) { return flags & RTC_SCENE_INCOHERENT; }
   __forceinline bool isHighQuality(RTCSceneFlags flags) { return flags & RTC_SCENE_HIGH_QUALITY; }
+  __forceinline bool isBackfaceCulling(RTCSceneFlags flags) { return flags & RTC_SCENE_BACKFACE_CULLING; }
 
   /*! CPU features */
   static const int SSE   = CPU_FEATURE_SSE; 
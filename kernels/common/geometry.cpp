@@ -25,7 +25,7 @@ namespace embree
       intersectionFilter4(NULL), occlusionFilter4(NULL), ispcIntersectionFilter4(NULL), ispcOcclusionFilter4(NULL), 
       intersectionFilter8(NULL), occlusionFilter8(NULL), ispcIntersectionFilter8(NULL), ispcOcclusionFilter8(NULL), 
       intersectionFilter16(NULL), occlusionFilter16(NULL), ispcIntersectionFilter16(NULL), ispcOcclusionFilter16(NULL), 
-      userPtr(NULL)
+      userPtr(NULL), mask(-1)
   {
     id = parent->add(this);
     parent->setModified();
@@ -42,6 +42,7 @@ namespace embree
       atomic_add(&parent->numIntersectionFilters4,(intersectionFilter4 != NULL) + (occlusionFilter4 != NULL));
       atomic_add(&parent->numIntersectionFilters8,(intersectionFilter8 != NULL) + (occlusionFilter8 != NULL));
       atomic_add(&parent->numIntersectionFilters16,(intersectionFilter16 != NULL) + (occlusionFilter16 != NULL));
+      atomic_add(&parent->numRayMasks,hasRayMask());
     }
 
     switch (state) {
@@ -102,6 +103,7 @@ namespace embree
       atomic_sub(&parent->numIntersectionFilters4,(intersectionFilter4 != NULL) + (occlusionFilter4 != NULL));
       atomic_sub(&parent->numIntersectionFilters8,(intersectionFilter8 != NULL) + (occlusionFilter8 != NULL));
       atomic_sub(&parent->numIntersectionFilters16,(intersectionFilter16 != NULL) + (occlusionFilter16 != NULL));
+      atomic_sub(&parent->numRayMasks,hasRayMask());
     }
 
     switch (state) {
@@ -179,10 +181,17 @@ namespace embree
     return userPtr;
   }
 
+  void Geometry::updateMask (unsigned mask)
+  {
+    atomic_sub(&parent->numRayMasks,hasRayMask());
+    this->mask = mask;
+    atomic_add(&parent->numRayMasks,hasRayMask());
+  }
+
   void Geometry::setIntersectionFilterFunction (RTCFilterFunc filter, bool ispc) 
   {
-    if (type != TRIANGLE_MESH && type != BEZIER_CURVES) {
-      process_error(RTC_INVALID_OPERATION,"filter functions only supported for triangle meshes and hair geometries"); 
+    if (type != TRIANGLE_MESH && type != QUAD_MESH && type != BEZIER_CURVES) {
+      process_error(RTC_INVALID_OPERATION,"filter functions only supported for triangle meshes, quad meshes and hair geometries"); 
       return;
     }
     intersectionFilter1 = filter;
@@ -190,8 +199,8 @@ namespace embree
     
   void Geometry::setIntersectionFilterFunction4 (RTCFilterFunc4 filter, bool ispc) 
   { 
-    if (type != TRIANGLE_MESH && type != BEZIER_CURVES) {
-      process_error(RTC_INVALID_OPERATION,"filter functions only supported for triangle meshes and hair geometries"); 
+    if (type != TRIANGLE_MESH && type != QUAD_MESH && type != BEZIER_CURVES) {
+      process_error(RTC_INVALID_OPERATION,"filter functions only supported for triangle meshes, quad meshes and hair geometries"); 
       return;
     }
     atomic_sub(&parent->numIntersectionFilters4,intersectionFilter4 != NULL);
@@ -203,8 +212,8 @@ namespace embree
     
   void Geometry::setIntersectionFilterFunction8 (RTCFilterFunc8 filter, bool ispc) 
   { 
-    if (type != TRIANGLE_MESH && type != BEZIER_CURVES) {
-      process_error(RTC_INVALID_OPERATION,"filter functions only supported for triangle meshes and hair geometries"); 
+    if (type != TRIANGLE_MESH && type != QUAD_MESH && type != BEZIER_CURVES) {
+      process_error(RTC_INVALID_OPERATION,"filter functions only supported for triangle meshes, quad meshes and hair geometries"); 
       return;
     }
     atomic_sub(&parent->numIntersectionFilters8,intersectionFilter8 != NULL);
@@ -216,8 +225,8 @@ namespace embree
   
   void Geometry::setIntersectionFilterFunction16 (RTCFilterFunc16 filter, bool ispc) 
   { 
-    if (type != TRIANGLE_MESH && type != BEZIER_CURVES) {
-      process_error(RTC_INVALID_OPERATION,"filter functions only supported for triangle meshes and hair geometries"); 
+    if (type != TRIANGLE_MESH && type != QUAD_MESH && type != BEZIER_CURVES) {
+      process_error(RTC_INVALID_OPERATION,"filter functions only supported for triangle meshes, quad meshes and hair geometries"); 
       return;
     }
     atomic_sub(&parent->numIntersectionFilters16,intersectionFilter16 != NULL);
@@ -229,8 +238,8 @@ namespace embree
 
   void Geometry::setOcclusionFilterFunction (RTCFilterFunc filter, bool ispc) 
   {
-    if (type != TRIANGLE_MESH && type != BEZIER_CURVES) {
-      process_error(RTC_INVALID_OPERATION,"filter functions only supported for triangle meshes and hair geometries"); 
+    if (type != TRIANGLE_MESH && type != QUAD_MESH && type != BEZIER_CURVES) {
+      process_error(RTC_INVALID_OPERATION,"filter functions only supported for triangle meshes, quad meshes and hair geometries"); 
       return;
     }
     occlusionFilter1 = filter;
@@ -238,8 +247,8 @@ namespace embree
     
   void Geometry::setOcclusionFilterFunction4 (RTCFilterFunc4 filter, bool ispc) 
   { 
-    if (type != TRIANGLE_MESH && type != BEZIER_CURVES) {
-      process_error(RTC_INVALID_OPERATION,"filter functions only supported for triangle meshes and hair geometries"); 
+    if (type != TRIANGLE_MESH && type != QUAD_MESH && type != BEZIER_CURVES) {
+      process_error(RTC_INVALID_OPERATION,"filter functions only supported for triangle meshes, quad meshes and hair geometries"); 
       return;
     }
     atomic_sub(&parent->numIntersectionFilters4,occlusionFilter4 != NULL);
@@ -251,8 +260,8 @@ namespace embree
     
   void Geometry::setOcclusionFilterFunction8 (RTCFilterFunc8 filter, bool ispc) 
   { 
-    if (type != TRIANGLE_MESH && type != BEZIER_CURVES) {
-      process_error(RTC_INVALID_OPERATION,"filter functions only supported for triangle meshes and hair geometries"); 
+    if (type != TRIANGLE_MESH && type != QUAD_MESH && type != BEZIER_CURVES) {
+      process_error(RTC_INVALID_OPERATION,"filter functions only supported for triangle meshes, quad meshes and hair geometries"); 
       return;
     }
     atomic_sub(&parent->numIntersectionFilters8,occlusionFilter8 != NULL);
@@ -264,8 +273,8 @@ namespace embree
   
   void Geometry::setOcclusionFilterFunction16 (RTCFilterFunc16 filter, bool ispc) 
   { 
-    if (type != TRIANGLE_MESH && type != BEZIER_CURVES) {
-      process_error(RTC_INVALID_OPERATION,"filter functions only supported for triangle meshes and hair geometries"); 
+    if (type != TRIANGLE_MESH && type != QUAD_MESH && type != BEZIER_CURVES) {
+      process_error(RTC_INVALID_OPERATION,"filter functions only supported for triangle meshes, quad meshes and hair geometries"); 
       return;
     }
     atomic_sub(&parent->numIntersectionFilters16,occlusionFilter16 != NULL);
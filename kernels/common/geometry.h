@@ -24,7 +24,7 @@ namespace embree
   class Scene;
 
   /*! type of geometry */
-  enum GeometryTy { TRIANGLE_MESH = 1, USER_GEOMETRY = 2, BEZIER_CURVES = 4, SUBDIV_MESH = 8 /*, INSTANCES = 16*/ };
+  enum GeometryTy { TRIANGLE_MESH = 1, USER_GEOMETRY = 2, BEZIER_CURVES = 4, SUBDIV_MESH = 8 /*, INSTANCES = 16*/, QUAD_MESH = 32, INSTANCE_ARRAY = 64 };
   
 #if defined(__SSE__)
   typedef void (*ISPCFilterFunc4)(void* ptr, RTCRay4& ray, __m128 valid);
@@ -116,6 +116,13 @@ namespace embree
       process_error(RTC_INVALID_OPERATION,"operation not supported for this geometry"); 
     }
 
+  protected:
+
+    /*! Updates the ray mask and the number of runtime ray masks of the scene. */
+    void updateMask (unsigned mask);
+
+  public:
+
     /*! Maps specified buffer. */
     virtual void* map(RTCBufferType type) { 
       process_error(RTC_INVALID_OPERATION,"operation not supported for this geometry"); 
@@ -137,6 +144,11 @@ namespace embree
       process_error(RTC_INVALID_OPERATION,"operation not supported for this geometry"); 
     }
 
+    /*! Sets the camera for view dependent tessellation levels. */
+    virtual void setViewDependentTessellation (const Vec3fa& position, float fovy, size_t resolution, float edgeLength) {
+      process_error(RTC_INVALID_OPERATION,"operation not supported for this geometry"); 
+    }
+
     /*! Set intersection filter function for single rays. */
     virtual void setIntersectionFilterFunction (RTCFilterFunc filter, bool ispc = false);
     
@@ -223,6 +235,22 @@ namespace embree
       process_error(RTC_INVALID_OPERATION,"operation not supported for this geometry"); 
     }
 
+    /*! Set intersect function for streams of ray/item pairs. */
+    virtual void setIntersectFunctionN (RTCIntersectFuncN intersectN) { 
+      process_error(RTC_INVALID_OPERATION,"operation not supported for this geometry"); 
+    }
+
+    /*! Set occlusion function for streams of ray/item pairs. */
+    virtual void setOccludedFunctionN (RTCOccludedFuncN occludedN) { 
+      process_error(RTC_INVALID_OPERATION,"operation not supported for this geometry"); 
+    }
+
+    /*! Interpolates the user attributes src at the specified hit locations. */
+    virtual void interpolateN(const unsigned* primIDs, const float* u, const float* v, size_t numUVs, 
+                              const float* src, size_t byteStride, float* P, float* dPdu, float* dPdv, size_t numFloats) {
+      process_error(RTC_INVALID_OPERATION,"operation not supported for this geometry"); 
+    }
+
   public:
 
     virtual void write(std::ofstream& file) {
@@ -233,11 +261,12 @@ namespace embree
     Scene* parent;   //!< pointer to scene this mesh belongs to
     GeometryTy type;
     ssize_t numPrimitives;    //!< number of primitives of this geometry
-    unsigned int numTimeSteps;        //!< number of time steps (1 or 2)
+    unsigned int numTimeSteps;        //!< number of time steps (1 for static geometry)
     unsigned int id;       //!< internal geometry ID
     RTCGeometryFlags flags;    //!< flags of geometry
     State state;       //!< state of the geometry 
     void* userPtr;     //!< user pointer
+    unsigned int mask; //!< for masking out geometry
 
   public:
     RTCFilterFunc intersectionFilter1;
@@ -258,14 +287,26 @@ namespace embree
     void* ispcIntersectionFilter16;
     void* ispcOcclusionFilter16;
 
-    __forceinline bool hasIntersectionFilter1() const { return intersectionFilter1 != NULL; }
-    __forceinline bool hasIntersectionFilter4() const { return intersectionFilter4 != NULL; }
-    __forceinline bool hasIntersectionFilter8() const { return intersectionFilter8 != NULL; }
+    /*! Without RTCORE_RAY_MASK the geometry mask is tested by the
+     *  filter functions, thus a geometry with a mask other than -1
+     *  always takes the filter path. The Xeon Phi kernels only
+     *  support masks through RTCORE_RAY_MASK. */
+    __forceinline bool hasRayMask() const { 
+#if defined(RTCORE_RAY_MASK) || defined(__MIC__)
+      return false;
+#else
+      return mask != -1; 
+#endif
+    }
+
+    __forceinline bool hasIntersectionFilter1() const { return intersectionFilter1 != NULL || hasRayMask(); }
+    __forceinline bool hasIntersectionFilter4() const { return intersectionFilter4 != NULL || hasRayMask(); }
+    __forceinline bool hasIntersectionFilter8() const { return intersectionFilter8 != NULL || hasRayMask(); }
     __forceinline bool hasIntersectionFilter16() const { return intersectionFilter16 != NULL; }
 
-    __forceinline bool hasOcclusionFilter1() const { return occlusionFilter1 != NULL; }
-    __forceinline bool hasOcclusionFilter4() const { return occlusionFilter4 != NULL; }
-    __forceinline bool hasOcclusionFilter8() const { return occlusionFilter8 != NULL; }
+    __forceinline bool hasOcclusionFilter1() const { return occlusionFilter1 != NULL || hasRayMask(); }
+    __forceinline bool hasOcclusionFilter4() const { return occlusionFilter4 != NULL || hasRayMask(); }
+    __forceinline bool hasOcclusionFilter8() const { return occlusionFilter8 != NULL || hasRayMask(); }
     __forceinline bool hasOcclusionFilter16() const { return occlusionFilter16 != NULL; }
   };
 }
@@ -0,0 +1,338 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "raystream.h"
+#include "scene.h"
+#include "algorithms/sort.h"
+
+namespace embree
+{
+  /*! sort key of a ray, the upper bits store the direction octant,
+   *  the lower bits the morton code of the quantized origin */
+  struct __aligned(8) RayStreamKey
+  {
+    static const unsigned OCTANT_SHIFT = 27;
+    static const unsigned CELL_BITS = 9;
+
+    __forceinline unsigned octant() const { return code >> OCTANT_SHIFT; }
+    __forceinline bool operator<(const RayStreamKey& other) const { return code < other.code; }
+    __forceinline operator unsigned() const { return code; }
+
+  public:
+    unsigned code;
+    unsigned index;
+  };
+
+  /*! accesses rays of a stream in AoS layout */
+  struct RayStreamAOS
+  {
+    __forceinline RayStreamAOS (RTCRay* rays, size_t stride)
+      : ptr((char*)rays), stride(stride) {}
+
+    __forceinline RTCRay& get(size_t i) const {
+      return *(RTCRay*)(ptr + i*stride);
+    }
+
+    __forceinline Vec3fa org(size_t i) const {
+      const RTCRay& ray = get(i); return Vec3fa(ray.org[0],ray.org[1],ray.org[2]);
+    }
+
+    __forceinline Vec3fa dir(size_t i) const {
+      const RTCRay& ray = get(i); return Vec3fa(ray.dir[0],ray.dir[1],ray.dir[2]);
+    }
+
+    template<typename RTCRayK>
+    __forceinline void gather(RTCRayK& ray_o, size_t k, size_t i) const
+    {
+      const RTCRay& ray_i = get(i);
+      ray_o.orgx[k] = ray_i.org[0]; ray_o.orgy[k] = ray_i.org[1]; ray_o.orgz[k] = ray_i.org[2];
+      ray_o.dirx[k] = ray_i.dir[0]; ray_o.diry[k] = ray_i.dir[1]; ray_o.dirz[k] = ray_i.dir[2];
+      ray_o.tnear[k] = ray_i.tnear; ray_o.tfar[k] = ray_i.tfar;
+      ray_o.time[k] = ray_i.time; ray_o.mask[k] = ray_i.mask;
+      ray_o.Ngx[k] = ray_i.Ng[0]; ray_o.Ngy[k] = ray_i.Ng[1]; ray_o.Ngz[k] = ray_i.Ng[2];
+      ray_o.u[k] = ray_i.u; ray_o.v[k] = ray_i.v;
+      ray_o.geomID[k] = ray_i.geomID; ray_o.primID[k] = ray_i.primID; ray_o.instID[k] = ray_i.instID;
+    }
+
+    template<typename RTCRayK>
+    __forceinline void scatter(const RTCRayK& ray_i, size_t k, size_t i) const
+    {
+      RTCRay& ray_o = get(i);
+      ray_o.tfar = ray_i.tfar[k];
+      ray_o.Ng[0] = ray_i.Ngx[k]; ray_o.Ng[1] = ray_i.Ngy[k]; ray_o.Ng[2] = ray_i.Ngz[k];
+      ray_o.u = ray_i.u[k]; ray_o.v = ray_i.v[k];
+      ray_o.geomID = ray_i.geomID[k]; ray_o.primID = ray_i.primID[k]; ray_o.instID = ray_i.instID[k];
+    }
+
+    template<typename RTCRayK>
+    __forceinline void scatterOccluded(const RTCRayK& ray_i, size_t k, size_t i) const {
+      get(i).geomID = ray_i.geomID[k];
+    }
+
+    __forceinline void gather(RTCRay& ray_o, size_t i) const {
+      ray_o = get(i);
+    }
+
+    __forceinline void scatter(const RTCRay& ray_i, size_t i) const
+    {
+      RTCRay& ray_o = get(i);
+      ray_o.tfar = ray_i.tfar;
+      ray_o.Ng[0] = ray_i.Ng[0]; ray_o.Ng[1] = ray_i.Ng[1]; ray_o.Ng[2] = ray_i.Ng[2];
+      ray_o.u = ray_i.u; ray_o.v = ray_i.v;
+      ray_o.geomID = ray_i.geomID; ray_o.primID = ray_i.primID; ray_o.instID = ray_i.instID;
+    }
+
+    __forceinline void scatterOccluded(const RTCRay& ray_i, size_t i) const {
+      get(i).geomID = ray_i.geomID;
+    }
+
+  private:
+    char* ptr;
+    size_t stride;
+  };
+
+  /*! accesses rays of a stream in SoA layout */
+  struct RayStreamSOA
+  {
+    __forceinline RayStreamSOA (const RTCRayNp& rays)
+      : rays(rays) {}
+
+    __forceinline Vec3fa org(size_t i) const {
+      return Vec3fa(rays.orgx[i],rays.orgy[i],rays.orgz[i]);
+    }
+
+    __forceinline Vec3fa dir(size_t i) const {
+      return Vec3fa(rays.dirx[i],rays.diry[i],rays.dirz[i]);
+    }
+
+    template<typename RTCRayK>
+    __forceinline void gather(RTCRayK& ray_o, size_t k, size_t i) const
+    {
+      ray_o.orgx[k] = rays.orgx[i]; ray_o.orgy[k] = rays.orgy[i]; ray_o.orgz[k] = rays.orgz[i];
+      ray_o.dirx[k] = rays.dirx[i]; ray_o.diry[k] = rays.diry[i]; ray_o.dirz[k] = rays.dirz[i];
+      ray_o.tnear[k] = rays.tnear[i]; ray_o.tfar[k] = rays.tfar[i];
+      ray_o.time[k] = rays.time[i]; ray_o.mask[k] = rays.mask[i];
+      ray_o.Ngx[k] = rays.Ngx[i]; ray_o.Ngy[k] = rays.Ngy[i]; ray_o.Ngz[k] = rays.Ngz[i];
+      ray_o.u[k] = rays.u[i]; ray_o.v[k] = rays.v[i];
+      ray_o.geomID[k] = rays.geomID[i]; ray_o.primID[k] = rays.primID[i]; ray_o.instID[k] = rays.instID[i];
+    }
+
+    template<typename RTCRayK>
+    __forceinline void scatter(const RTCRayK& ray_i, size_t k, size_t i) const
+    {
+      rays.tfar[i] = ray_i.tfar[k];
+      rays.Ngx[i] = ray_i.Ngx[k]; rays.Ngy[i] = ray_i.Ngy[k]; rays.Ngz[i] = ray_i.Ngz[k];
+      rays.u[i] = ray_i.u[k]; rays.v[i] = ray_i.v[k];
+      rays.geomID[i] = ray_i.geomID[k]; rays.primID[i] = ray_i.primID[k]; rays.instID[i] = ray_i.instID[k];
+    }
+
+    template<typename RTCRayK>
+    __forceinline void scatterOccluded(const RTCRayK& ray_i, size_t k, size_t i) const {
+      rays.geomID[i] = ray_i.geomID[k];
+    }
+
+    __forceinline void gather(RTCRay& ray_o, size_t i) const
+    {
+      ray_o.org[0] = rays.orgx[i]; ray_o.org[1] = rays.orgy[i]; ray_o.org[2] = rays.orgz[i];
+      ray_o.dir[0] = rays.dirx[i]; ray_o.dir[1] = rays.diry[i]; ray_o.dir[2] = rays.dirz[i];
+      ray_o.tnear = rays.tnear[i]; ray_o.tfar = rays.tfar[i];
+      ray_o.time = rays.time[i]; ray_o.mask = rays.mask[i];
+      ray_o.Ng[0] = rays.Ngx[i]; ray_o.Ng[1] = rays.Ngy[i]; ray_o.Ng[2] = rays.Ngz[i];
+      ray_o.u = rays.u[i]; ray_o.v = rays.v[i];
+      ray_o.geomID = rays.geomID[i]; ray_o.primID = rays.primID[i]; ray_o.instID = rays.instID[i];
+    }
+
+    __forceinline void scatter(const RTCRay& ray_i, size_t i) const
+    {
+      rays.tfar[i] = ray_i.tfar;
+      rays.Ngx[i] = ray_i.Ng[0]; rays.Ngy[i] = ray_i.Ng[1]; rays.Ngz[i] = ray_i.Ng[2];
+      rays.u[i] = ray_i.u; rays.v[i] = ray_i.v;
+      rays.geomID[i] = ray_i.geomID; rays.primID[i] = ray_i.primID; rays.instID[i] = ray_i.instID;
+    }
+
+    __forceinline void scatterOccluded(const RTCRay& ray_i, size_t i) const {
+      rays.geomID[i] = ray_i.geomID;
+    }
+
+  private:
+    const RTCRayNp& rays;
+  };
+
+  /*! calculates the sort keys of all rays of the stream */
+  template<typename Stream>
+  static void computeKeys(const Stream& stream, size_t N, RayStreamKey* keys)
+  {
+    /* calculate bounds of all ray origins */
+    BBox3fa bounds = empty;
+    for (size_t i=0; i<N; i++) {
+      const Vec3fa org = stream.org(i);
+      if (inFloatRange(org)) bounds.extend(org);
+    }
+    if (bounds.empty()) bounds = BBox3fa(Vec3fa(zero));
+
+    /* quantize origins and compute morton codes */
+    const float cells = float(1 << RayStreamKey::CELL_BITS) * 0.99f;
+    const Vec3fa base = bounds.lower;
+    const Vec3fa diag = bounds.size();
+    const Vec3fa scale(diag.x > 1E-19f ? cells/diag.x : 0.0f,
+                       diag.y > 1E-19f ? cells/diag.y : 0.0f,
+                       diag.z > 1E-19f ? cells/diag.z : 0.0f);
+    const int maxCell = (1 << RayStreamKey::CELL_BITS)-1;
+
+    for (size_t i=0; i<N; i++)
+    {
+      const Vec3fa org = stream.org(i);
+      const Vec3fa dir = stream.dir(i);
+      unsigned code = 0;
+      if (inFloatRange(org)) {
+        const unsigned x = min(int(max(0.0f,(org.x-base.x)*scale.x)),maxCell);
+        const unsigned y = min(int(max(0.0f,(org.y-base.y)*scale.y)),maxCell);
+        const unsigned z = min(int(max(0.0f,(org.z-base.z)*scale.z)),maxCell);
+        code = bitInterleave(x,y,z);
+      }
+      const unsigned octant = (dir.x < 0.0f ? 1 : 0) | (dir.y < 0.0f ? 2 : 0) | (dir.z < 0.0f ? 4 : 0);
+      keys[i].code  = (octant << RayStreamKey::OCTANT_SHIFT) | code;
+      keys[i].index = i;
+    }
+  }
+
+  __forceinline void tracePacket(Scene* scene, const void* valid, RTCRay4& ray, bool occluded) {
+    if (occluded) scene->occluded4(valid,ray); else scene->intersect4(valid,ray);
+  }
+
+  __forceinline void tracePacket(Scene* scene, const void* valid, RTCRay8& ray, bool occluded) {
+    if (occluded) scene->occluded8(valid,ray); else scene->intersect8(valid,ray);
+  }
+
+  __forceinline void tracePacket(Scene* scene, const void* valid, RTCRay16& ray, bool occluded) {
+    if (occluded) scene->occluded16(valid,ray); else scene->intersect16(valid,ray);
+  }
+
+  /*! traces the stream as packets of K rays */
+  template<typename RTCRayK, size_t K, bool occluded, typename Stream>
+  static void traceStreamK(Scene* scene, const Stream& stream, size_t N)
+  {
+    __aligned(64) int valid[K];
+    RTCRayK packet;
+    size_t ids[K];
+
+    /* traces the first k rays of the packet and writes back the hits */
+    auto flush = [&] (size_t k)
+    {
+      for (size_t l=0; l<K; l++) valid[l] = l<k ? -1 : 0;
+      tracePacket(scene,valid,packet,occluded);
+      for (size_t l=0; l<k; l++) {
+        if (occluded) stream.scatterOccluded(packet,l,ids[l]);
+        else          stream.scatter(packet,l,ids[l]);
+      }
+    };
+
+    /* small streams are traced in their original order */
+    if (N < RayStream::MIN_SORT_SIZE)
+    {
+      for (size_t i=0; i<N; i+=K) {
+        const size_t k = min(K,N-i);
+        for (size_t l=0; l<k; l++) { stream.gather(packet,l,i+l); ids[l] = i+l; }
+        flush(k);
+      }
+      return;
+    }
+
+    /* sort rays by direction octant and origin */
+    std::vector<RayStreamKey> keys(N), tmp(N);
+    computeKeys(stream,N,keys.data());
+    radix_sort_serial_u32(keys.data(),tmp.data(),N);
+
+    /* fill packets in sort order, never mix octants inside a packet */
+    size_t k = 0;
+    unsigned octant = keys[0].octant();
+    for (size_t j=0; j<N; j++)
+    {
+      const RayStreamKey& key = keys[j];
+      if (k == K || (k && key.octant() != octant)) {
+        flush(k); k = 0;
+      }
+      octant = key.octant();
+      stream.gather(packet,k,key.index);
+      ids[k++] = key.index;
+    }
+    if (k) flush(k);
+  }
+
+  /*! traces the stream as single rays */
+  template<bool occluded, typename Stream>
+  static void traceStream1(Scene* scene, const Stream& stream, size_t N)
+  {
+    RTCRay ray;
+    for (size_t i=0; i<N; i++)
+    {
+      stream.gather(ray,i);
+      if (occluded) {
+        scene->occluded(ray);
+        stream.scatterOccluded(ray,i);
+      } else {
+        scene->intersect(ray);
+        stream.scatter(ray,i);
+      }
+    }
+  }
+
+  /*! selects the widest packet size enabled for the scene */
+  template<bool occluded, typename Stream>
+  static void traceStream(Scene* scene, const Stream& stream, size_t N)
+  {
+    if (N == 0) return;
+
+#if defined(__TARGET_SIMD16__)
+    if (scene->aflags & RTC_INTERSECT16) {
+      traceStreamK<RTCRay16,16,occluded>(scene,stream,N);
+      return;
+    }
+#endif
+
+#if defined(__TARGET_SIMD8__)
+    if ((scene->aflags & RTC_INTERSECT8) && has_feature(AVX)) {
+      traceStreamK<RTCRay8,8,occluded>(scene,stream,N);
+      return;
+    }
+#endif
+
+#if defined(__TARGET_SIMD4__)
+    if (scene->aflags & RTC_INTERSECT4) {
+      traceStreamK<RTCRay4,4,occluded>(scene,stream,N);
+      return;
+    }
+#endif
+
+    traceStream1<occluded>(scene,stream,N);
+  }
+
+  void RayStream::intersect (Scene* scene, RTCRay* rays, size_t N, size_t stride) {
+    traceStream<false>(scene,RayStreamAOS(rays,stride),N);
+  }
+
+  void RayStream::intersect (Scene* scene, const RTCRayNp& rays, size_t N) {
+    traceStream<false>(scene,RayStreamSOA(rays),N);
+  }
+
+  void RayStream::occluded (Scene* scene, RTCRay* rays, size_t N, size_t stride) {
+    traceStream<true>(scene,RayStreamAOS(rays,stride),N);
+  }
+
+  void RayStream::occluded (Scene* scene, const RTCRayNp& rays, size_t N) {
+    traceStream<true>(scene,RayStreamSOA(rays),N);
+  }
+}
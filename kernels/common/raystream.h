@@ -0,0 +1,48 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "default.h"
+#include "embree2/rtcore_ray.h"
+
+namespace embree
+{
+  class Scene;
+
+  /*! Traces streams of rays of arbitrary length. The rays of a stream
+   *  are sorted by direction octant and origin and then dispatched
+   *  as packets to the widest packet intersector of the scene. */
+  class RayStream
+  {
+  public:
+
+    /*! streams smaller than this are traced in their original order */
+    static const size_t MIN_SORT_SIZE = 64;
+
+    /*! Intersects N rays in AoS layout with the scene. */
+    static void intersect (Scene* scene, RTCRay* rays, size_t N, size_t stride);
+
+    /*! Intersects N rays in SoA layout with the scene. */
+    static void intersect (Scene* scene, const RTCRayNp& rays, size_t N);
+
+    /*! Tests if N rays in AoS layout are occluded by the scene. */
+    static void occluded (Scene* scene, RTCRay* rays, size_t N, size_t stride);
+
+    /*! Tests if N rays in SoA layout are occluded by the scene. */
+    static void occluded (Scene* scene, const RTCRayNp& rays, size_t N);
+  };
+}
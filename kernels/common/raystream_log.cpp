@@ -41,29 +41,198 @@ namespace embree
     return active;
   }
 
+  RayStreamLogger::Block::Block (size_t stream, size_t recordBytes)
+    : stream(stream), recordBytes(recordBytes), maxRecords(BLOCK_BYTES/(2*recordBytes)), numRecords(0)
+  {
+    data = (char*) alignedMalloc(2*maxRecords*recordBytes);
+  }
+
+  RayStreamLogger::Block::~Block () {
+    alignedFree(data);
+  }
+
   RayStreamLogger::RayStreamLogger()
+    : threadLogTls(createTls()), writerThreadID(NULL), writerRunning(false), writerBusy(false), terminate(false),
+      loggedScene(NULL), frame(-1), firstFrame(0), numFrames(0), compression(false)
   {
     std::string path(DEFAULT_PATH_BINARY_FILES);
-    ray16        = new DataStream( path + DEFAULT_FILENAME_RAY16 );
-    ray16_verify = new DataStream( path + DEFAULT_FILENAME_RAY16_VERIFY );
-    ray8         = new DataStream( path + DEFAULT_FILENAME_RAY8 );
-    ray8_verify  = new DataStream( path + DEFAULT_FILENAME_RAY8_VERIFY );
-    ray4         = new DataStream( path + DEFAULT_FILENAME_RAY4 );
-    ray4_verify  = new DataStream( path + DEFAULT_FILENAME_RAY4_VERIFY );
-    ray1         = new DataStream( path + DEFAULT_FILENAME_RAY1 );
-    ray1_verify  = new DataStream( path + DEFAULT_FILENAME_RAY1_VERIFY );
+    streams       [STREAM_RAY16] = new DataStream( path + DEFAULT_FILENAME_RAY16 );
+    streams_verify[STREAM_RAY16] = new DataStream( path + DEFAULT_FILENAME_RAY16_VERIFY );
+    streams       [STREAM_RAY8 ] = new DataStream( path + DEFAULT_FILENAME_RAY8 );
+    streams_verify[STREAM_RAY8 ] = new DataStream( path + DEFAULT_FILENAME_RAY8_VERIFY );
+    streams       [STREAM_RAY4 ] = new DataStream( path + DEFAULT_FILENAME_RAY4 );
+    streams_verify[STREAM_RAY4 ] = new DataStream( path + DEFAULT_FILENAME_RAY4_VERIFY );
+    streams       [STREAM_RAY1 ] = new DataStream( path + DEFAULT_FILENAME_RAY1 );
+    streams_verify[STREAM_RAY1 ] = new DataStream( path + DEFAULT_FILENAME_RAY1_VERIFY );
   }
 
   RayStreamLogger::~RayStreamLogger()
   {
-    if (ray16)        { delete ray16;        ray16        = NULL; }
-    if (ray16_verify) { delete ray16_verify; ray16_verify = NULL; }
-    if (ray8)         { delete ray8;         ray8         = NULL; }
-    if (ray8_verify)  { delete ray8_verify;  ray8_verify  = NULL; }
-    if (ray4)         { delete ray4;         ray4         = NULL; }
-    if (ray4_verify)  { delete ray4_verify;  ray4_verify  = NULL; }
-    if (ray1)         { delete ray1;         ray1         = NULL; }
-    if (ray1_verify)  { delete ray1_verify;  ray1_verify  = NULL; }
+    flush();
+
+    if (writerRunning) 
+    {
+      mutex.lock();
+      terminate = true;
+      condition.notify_all();
+      mutex.unlock();
+      join(writerThreadID);
+    }
+
+    for (size_t i=0; i<threadLogs.size(); i++) delete threadLogs[i];
+    for (size_t s=0; s<NUM_STREAMS; s++) {
+      for (size_t i=0; i<freeBlocks[s].size(); i++) delete freeBlocks[s][i];
+      delete streams[s];        streams[s]        = NULL;
+      delete streams_verify[s]; streams_verify[s] = NULL;
+    }
+    destroyTls(threadLogTls);
+  }
+
+  RayStreamLogger::ThreadLog* RayStreamLogger::threadLog()
+  {
+    ThreadLog* log = (ThreadLog*) getTls(threadLogTls);
+    if (likely(log != NULL)) return log;
+
+    log = new ThreadLog;
+    setTls(threadLogTls,log);
+    Lock<MutexSys> lock(mutex);
+    threadLogs.push_back(log);
+    return log;
+  }
+
+  void RayStreamLogger::add(size_t stream, const void* start, const void* end, size_t recordBytes)
+  {
+    Block*& block = threadLog()->blocks[stream];
+
+    if (unlikely(block == NULL)) 
+    {
+      Lock<MutexSys> lock(mutex);
+      if (freeBlocks[stream].size()) {
+        block = freeBlocks[stream].back();
+        freeBlocks[stream].pop_back();
+      }
+      else 
+        block = new Block(stream,recordBytes);
+    }
+
+    block->add(start,end);
+
+    if (unlikely(block->full())) {
+      submit(block);
+      block = NULL;
+    }
+  }
+
+  void RayStreamLogger::submit(Block* block)
+  {
+    Lock<MutexSys> lock(mutex);
+
+    if (unlikely(!writerRunning)) {
+      writerThreadID = createThread(writerThread,this);
+      writerRunning = true;
+    }
+
+    while (queue.size() >= MAX_QUEUED_BLOCKS)
+      condition.wait(mutex);
+
+    queue.push_back(block);
+    condition.notify_all();
+  }
+
+  void RayStreamLogger::writerThread(void* ptr) {
+    ((RayStreamLogger*)ptr)->writer();
+  }
+
+  void RayStreamLogger::writer()
+  {
+    while (true)
+    {
+      Block* block = NULL;
+      {
+        Lock<MutexSys> lock(mutex);
+        while (queue.empty() && !terminate)
+          condition.wait(mutex);
+        if (queue.empty()) break;
+        block = queue.front();
+        queue.pop_front();
+        writerBusy = true;
+        condition.notify_all();
+      }
+
+      const size_t bytes = block->numRecords*block->recordBytes;
+      streams       [block->stream]->write(block->data,bytes,compression);
+      streams_verify[block->stream]->write(block->data+block->maxRecords*block->recordBytes,bytes,compression);
+
+      {
+        Lock<MutexSys> lock(mutex);
+        block->numRecords = 0;
+        freeBlocks[block->stream].push_back(block);
+        writerBusy = false;
+        condition.notify_all();
+      }
+    }
+  }
+
+  void RayStreamLogger::flush()
+  {
+    /* this is only called when no rays are traced, thus the thread
+     * local blocks can get accessed from the calling thread */
+    std::vector<Block*> blocks;
+    {
+      Lock<MutexSys> lock(mutex);
+      for (size_t i=0; i<threadLogs.size(); i++) {
+        for (size_t s=0; s<NUM_STREAMS; s++) {
+          Block*& block = threadLogs[i]->blocks[s];
+          if (block && block->numRecords) { blocks.push_back(block); block = NULL; }
+        }
+      }
+    }
+
+    for (size_t i=0; i<blocks.size(); i++)
+      submit(blocks[i]);
+
+    Lock<MutexSys> lock(mutex);
+    while (queue.size() || writerBusy)
+      condition.wait(mutex);
+
+    for (size_t s=0; s<NUM_STREAMS; s++) {
+      streams[s]->flush();
+      streams_verify[s]->flush();
+    }
+  }
+
+  void RayStreamLogger::setLoggedScene(void* scene)
+  {
+    Lock<MutexSys> lock(mutex);
+    if (loggedScene == scene) return;
+
+    /* the configuration is valid once rtcInit got called */
+    if (frame == -1) 
+    {
+      firstFrame  = g_raystream_log_first_frame;
+      numFrames   = g_raystream_log_frames;
+      compression = g_raystream_log_compression;
+      frame = 0;
+      if (capturing()) dumpGeometry(scene);
+    }
+    loggedScene = scene;
+  }
+
+  void RayStreamLogger::beginFrame(void* scene)
+  {
+    /* only commits of the logged scene start a new frame */
+    if (scene != loggedScene) 
+      return;
+
+    const bool wasCapturing = capturing();
+    frame++;
+
+    /* write out all rays once the capture window got closed */
+    if (wasCapturing && !capturing())
+      flush();
+
+    if (capturing())
+      dumpGeometry(scene);
   }
 
   void RayStreamLogger::dumpGeometry(void* ptr)
@@ -81,170 +250,138 @@ namespace embree
 
   void RayStreamLogger::logRay16Intersect(const void* valid_i, void* scene, RTCRay16& start, RTCRay16& end)
   {
-    mutex.lock();
-
-    LogRay16 logRay16;
+    if (unlikely(scene != loggedScene)) setLoggedScene(scene);
+    if (!capturing()) return;
 
-    logRay16.type    = RAY_INTERSECT;
+    LogRay16 logStart;
+    logStart.type    = RAY_INTERSECT;
 #if defined(__MIC__)
-    logRay16.m_valid = *(mic_i*)valid_i != mic_i(0);
-    logRay16.numRays = countbits(logRay16.m_valid);
+    logStart.m_valid = *(mic_i*)valid_i != mic_i(0);
+    logStart.numRays = countbits(logStart.m_valid);
 #endif
-    /* ray16 before intersect */
-    logRay16.ray16 = start;
-    ray16->write((char*)&logRay16 ,sizeof(logRay16));
+    logStart.ray16   = start;
 
-    /* ray16 after intersect */
-    logRay16.ray16   = end;
-    ray16_verify->write((char*)&logRay16 ,sizeof(logRay16));
+    LogRay16 logEnd = logStart;
+    logEnd.ray16     = end;
 
-    mutex.unlock();
+    add(STREAM_RAY16,&logStart,&logEnd,sizeof(LogRay16));
   }
 
   void RayStreamLogger::logRay16Occluded(const void* valid_i, void* scene, RTCRay16& start, RTCRay16& end)
   {
-    mutex.lock();
+    if (unlikely(scene != loggedScene)) setLoggedScene(scene);
+    if (!capturing()) return;
 
-    LogRay16 logRay16;
-
-    logRay16.type    = RAY_OCCLUDED;
+    LogRay16 logStart;
+    logStart.type    = RAY_OCCLUDED;
 #if defined(__MIC__)
-    logRay16.m_valid = *(mic_i*)valid_i != mic_i(0);
-    logRay16.numRays = countbits(logRay16.m_valid);
+    logStart.m_valid = *(mic_i*)valid_i != mic_i(0);
+    logStart.numRays = countbits(logStart.m_valid);
 #endif
-    /* ray16 before intersect */
-    logRay16.ray16 = start;
-    ray16->write((char*)&logRay16 ,sizeof(logRay16));
+    logStart.ray16   = start;
 
-    /* ray16 after intersect */
-    logRay16.ray16 = end;
-    ray16_verify->write((char*)&logRay16 ,sizeof(logRay16));
+    LogRay16 logEnd = logStart;
+    logEnd.ray16     = end;
 
-    mutex.unlock();
+    add(STREAM_RAY16,&logStart,&logEnd,sizeof(LogRay16));
   }
 
   void RayStreamLogger::logRay8Intersect(const void* valid_i, void* scene, RTCRay8& start, RTCRay8& end)
   {
-    mutex.lock();
-
-    LogRay8 logRay8;
-
-    logRay8.type    = RAY_INTERSECT;
-    logRay8.m_valid = getMask((int*)valid_i,8);
-    logRay8.numRays = numActive((int*)valid_i,8);
+    if (unlikely(scene != loggedScene)) setLoggedScene(scene);
+    if (!capturing()) return;
 
-    /* ray8 before intersect */
-    logRay8.ray8 = start;
-    ray8->write((char*)&logRay8 ,sizeof(logRay8));
+    LogRay8 logStart;
+    logStart.type    = RAY_INTERSECT;
+    logStart.m_valid = getMask((int*)valid_i,8);
+    logStart.numRays = numActive((int*)valid_i,8);
+    logStart.ray8   = start;
 
-    /* ray8 after intersect */
-    logRay8.ray8 = end;
-    ray8_verify->write((char*)&logRay8 ,sizeof(logRay8));
+    LogRay8 logEnd = logStart;
+    logEnd.ray8     = end;
 
-    mutex.unlock();
+    add(STREAM_RAY8,&logStart,&logEnd,sizeof(LogRay8));
   }
 
   void RayStreamLogger::logRay8Occluded(const void* valid_i, void* scene, RTCRay8& start, RTCRay8& end)
   {
-    mutex.lock();
+    if (unlikely(scene != loggedScene)) setLoggedScene(scene);
+    if (!capturing()) return;
 
-    LogRay8 logRay8;
+    LogRay8 logStart;
+    logStart.type    = RAY_OCCLUDED;
+    logStart.m_valid = getMask((int*)valid_i,8);
+    logStart.numRays = numActive((int*)valid_i,8);
+    logStart.ray8   = start;
 
-    logRay8.type    = RAY_OCCLUDED;
-    logRay8.m_valid = getMask((int*)valid_i,8);
-    logRay8.numRays = numActive((int*)valid_i,8);
+    LogRay8 logEnd = logStart;
+    logEnd.ray8     = end;
 
-    /* ray8 before intersect */
-    logRay8.ray8 = start;
-    ray8->write((char*)&logRay8 ,sizeof(logRay8));
-
-    /* ray8 after intersect */
-    logRay8.ray8   = end;
-    ray8_verify->write((char*)&logRay8 ,sizeof(logRay8));
-
-    mutex.unlock();
+    add(STREAM_RAY8,&logStart,&logEnd,sizeof(LogRay8));
   }
 
-
   void RayStreamLogger::logRay4Intersect(const void* valid_i, void* scene, RTCRay4& start, RTCRay4& end)
   {
-    mutex.lock();
+    if (unlikely(scene != loggedScene)) setLoggedScene(scene);
+    if (!capturing()) return;
 
-    LogRay4 logRay4;
+    LogRay4 logStart;
+    logStart.type    = RAY_INTERSECT;
+    logStart.m_valid = getMask((int*)valid_i,4);
+    logStart.numRays = numActive((int*)valid_i,4);
+    logStart.ray4   = start;
 
-    logRay4.type    = RAY_INTERSECT;
-    logRay4.m_valid = getMask((int*)valid_i,4);
-    logRay4.numRays = numActive((int*)valid_i,4);
+    LogRay4 logEnd = logStart;
+    logEnd.ray4     = end;
 
-    /* ray4 before intersect */
-    logRay4.ray4 = start;
-    ray4->write((char*)&logRay4 ,sizeof(logRay4));
-
-    /* ray4 after intersect */
-    logRay4.ray4   = end;
-    ray4_verify->write((char*)&logRay4 ,sizeof(logRay4));
-
-    mutex.unlock();
+    add(STREAM_RAY4,&logStart,&logEnd,sizeof(LogRay4));
   }
 
   void RayStreamLogger::logRay4Occluded(const void* valid_i, void* scene, RTCRay4& start, RTCRay4& end)
   {
-    mutex.lock();
-
-    LogRay4 logRay4;
+    if (unlikely(scene != loggedScene)) setLoggedScene(scene);
+    if (!capturing()) return;
 
-    logRay4.type    = RAY_OCCLUDED;
-    logRay4.m_valid = getMask((int*)valid_i,4);
-    logRay4.numRays = numActive((int*)valid_i,4);
+    LogRay4 logStart;
+    logStart.type    = RAY_OCCLUDED;
+    logStart.m_valid = getMask((int*)valid_i,4);
+    logStart.numRays = numActive((int*)valid_i,4);
+    logStart.ray4   = start;
 
-    /* ray4 before intersect */    
-    logRay4.ray4 = start;
-    ray4->write((char*)&logRay4 ,sizeof(logRay4));
+    LogRay4 logEnd = logStart;
+    logEnd.ray4     = end;
 
-    /* ray4 after intersect */
-    logRay4.ray4   = end;
-    ray4_verify->write((char*)&logRay4 ,sizeof(logRay4));
-
-    mutex.unlock();
+    add(STREAM_RAY4,&logStart,&logEnd,sizeof(LogRay4));
   }
 
-
- void RayStreamLogger::logRay1Intersect(void* scene, RTCRay& start, RTCRay& end)
+  void RayStreamLogger::logRay1Intersect(void* scene, RTCRay& start, RTCRay& end)
   {
-    mutex.lock();
-
-    LogRay1 logRay1;
+    if (unlikely(scene != loggedScene)) setLoggedScene(scene);
+    if (!capturing()) return;
 
-    logRay1.type  = RAY_INTERSECT;
+    LogRay1 logStart;
+    logStart.type = RAY_INTERSECT;
+    logStart.ray  = start;
 
-    /* ray before intersect */
-    logRay1.ray   = start;
-    ray1->write((char*)&logRay1 ,sizeof(logRay1));
+    LogRay1 logEnd = logStart;
+    logEnd.ray     = end;
 
-    /* ray after intersect */
-    logRay1.ray   = end;
-    ray1_verify->write((char*)&logRay1 ,sizeof(logRay1));
-
-    mutex.unlock();
+    add(STREAM_RAY1,&logStart,&logEnd,sizeof(LogRay1));
   }
 
   void RayStreamLogger::logRay1Occluded(void* scene, RTCRay& start, RTCRay& end)
   {
-    mutex.lock();
-
-    LogRay1 logRay1;
-
-    logRay1.type  = RAY_OCCLUDED;
+    if (unlikely(scene != loggedScene)) setLoggedScene(scene);
+    if (!capturing()) return;
 
-    /* ray before intersect */
-    logRay1.ray   = start;
-    ray1->write((char*)&logRay1 ,sizeof(logRay1));
+    LogRay1 logStart;
+    logStart.type = RAY_OCCLUDED;
+    logStart.ray  = start;
 
-    /* ray after intersect */
-    logRay1.ray   = end;
-    ray1_verify->write((char*)&logRay1 ,sizeof(logRay1));
+    LogRay1 logEnd = logStart;
+    logEnd.ray     = end;
 
-    mutex.unlock();
+    add(STREAM_RAY1,&logStart,&logEnd,sizeof(LogRay1));
   }
 
   RayStreamLogger RayStreamLogger::rayStreamLogger;
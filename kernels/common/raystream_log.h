@@ -18,9 +18,11 @@
 
 #include "../kernels/common/default.h"
 #include "embree2/rtcore_ray.h"
+#include "sys/thread.h"
+#include "sys/sync/condition.h"
 #include <iostream>
 #include <fstream>
-//#include <pthread.h>
+#include <deque>
 
 namespace embree
 {
@@ -45,17 +47,44 @@ namespace embree
 #define DEFAULT_FILENAME_RAY1          "ray1.bin"
 #define DEFAULT_FILENAME_RAY1_VERIFY   "ray1_verify.bin"
 
+  /*! Ray stream logger. Each thread appends its records into its
+   *  own block of memory without taking any lock, full blocks are
+   *  handed over to a background thread that (optionally compressed)
+   *  writes them to disk. Only rays traced in the capture window
+   *  (specified in frames, where each rtcCommit starts a new frame)
+   *  get recorded. */
   class RayStreamLogger
   {
   public:
 
+    /*! magic number at the beginning of compressed ray stream files */
+    static const unsigned int COMPRESSED_STREAM_MAGIC = 0x5a4c5352;
+
+    /*! a compressed file is a sequence of chunks, each starting with this header */
+    struct CompressedChunkHeader {
+      unsigned int rawBytes;
+      unsigned int compressedBytes;
+    };
+
+    /*! returns the maximal size of the compressed representation of N bytes */
+    static __forceinline size_t compressBound(size_t N) {
+      return N + N/255 + 16;
+    }
+
+    /*! LZ4 style compression of src into dst, returns number of bytes written to dst */
+    static size_t compress(const char* src, size_t N, char* dst);
+
+    /*! decompresses N bytes of src into dst, returns number of bytes written to dst */
+    static size_t decompress(const char* src, size_t N, char* dst);
 
     class DataStream {
     private:
       bool initialized;
+      bool compressed;
 
       std::string filename;
       std::ofstream data;
+      std::vector<char> buffer;
 
       void open() 
       {
@@ -67,11 +96,16 @@ namespace embree
             DBG_PRINT(filename);
             FATAL("could not open data stream");
           }
+
+        if (compressed) {
+          const unsigned int magic = COMPRESSED_STREAM_MAGIC;
+          data.write((char*)&magic,sizeof(magic));
+        }
       }
       
     public:
 
-    DataStream(std::string name) : initialized(false) 
+    DataStream(std::string name) : initialized(false), compressed(false)
         {
           filename = name;
         }
@@ -82,37 +116,132 @@ namespace embree
             data.close();
           }
       }
-    
-      void write(void *ptr, const size_t size)
+
+      /*! writes a block of records, only called by the writer thread */
+      void write(void *ptr, const size_t size, const bool compress)
       {
         if (unlikely(!initialized))
           {
+            compressed = compress;
             open();
             initialized = true;
           }
 
-        data.write((char*)ptr,size);
-        data << std::flush;
+        if (!compressed) {
+          data.write((char*)ptr,size);
+          return;
+        }
+
+        buffer.resize(compressBound(size));
+        CompressedChunkHeader header;
+        header.rawBytes = (unsigned int)size;
+        header.compressedBytes = (unsigned int)RayStreamLogger::compress((char*)ptr,size,&buffer[0]);
+        data.write((char*)&header,sizeof(header));
+        data.write(&buffer[0],header.compressedBytes);
       }
 
+      void flush() {
+        if (initialized) data.flush();
+      }
+    };
+
+    /*! one stream per packet width */
+    enum { STREAM_RAY1 = 0, STREAM_RAY4 = 1, STREAM_RAY8 = 2, STREAM_RAY16 = 3, NUM_STREAMS = 4 };
+
+    /*! Block of log records of one thread. The records before
+     *  intersection are stored in the first half, the matching
+     *  records after intersection at the same index in the second
+     *  half, thus both files see the records in the same order. */
+    struct Block
+    {
+      Block (size_t stream, size_t recordBytes);
+      ~Block ();
+
+      __forceinline bool full() const { return numRecords == maxRecords; }
+
+      __forceinline void add(const void* start, const void* end)
+      {
+        assert(!full());
+        memcpy(data+numRecords*recordBytes,start,recordBytes);
+        memcpy(data+(maxRecords+numRecords)*recordBytes,end,recordBytes);
+        numRecords++;
+      }
+
+    public:
+      size_t stream;       //!< stream this block belongs to
+      size_t recordBytes;  //!< size of one log record
+      size_t maxRecords;   //!< maximal number of records per half
+      size_t numRecords;   //!< number of records stored
+      char* data;          //!< record storage
+    };
+
+    /*! per thread state, only accessed by its owning thread while capturing */
+    struct ThreadLog {
+      ThreadLog () { for (size_t i=0; i<NUM_STREAMS; i++) blocks[i] = NULL; }
+      Block* blocks[NUM_STREAMS];
     };
 
+    static const size_t BLOCK_BYTES = 4*1024*1024;  //!< memory per block
+    static const size_t MAX_QUEUED_BLOCKS = 32;     //!< producers wait if the writer falls this much behind
+
   private:
 
-    MutexSys mutex;
+    /*! returns the log of the calling thread */
+    ThreadLog* threadLog();
+
+    /*! appends a record pair of the calling thread */
+    void add(size_t stream, const void* start, const void* end, size_t recordBytes);
+
+    /*! hands a block over to the writer thread */
+    void submit(Block* block);
+
+    /*! writer thread */
+    static void writerThread(void* ptr);
+    void writer();
 
-    DataStream *ray16;
-    DataStream *ray16_verify;
-    DataStream *ray8;
-    DataStream *ray8_verify;
-    DataStream *ray4;
-    DataStream *ray4_verify;
-    DataStream *ray1;
-    DataStream *ray1_verify;
+    /*! makes the scene rays got traced against the logged scene */
+    void setLoggedScene(void* scene);
 
+    /*! checks if the current frame is inside the capture window */
+    __forceinline bool capturing() const {
+      return frame >= firstFrame && (numFrames == 0 || frame < firstFrame+numFrames);
+    }
+
+  private:
+
+    MutexSys mutex;
+    ConditionSys condition;
+    tls_t threadLogTls;
+    std::vector<ThreadLog*> threadLogs;
+    std::deque<Block*> queue;
+    std::vector<Block*> freeBlocks[NUM_STREAMS];
+    thread_t writerThreadID;
+    bool writerRunning;
+    bool writerBusy;
+    bool terminate;
+
+    void* volatile loggedScene;
+    volatile ssize_t frame;
+    ssize_t firstFrame;
+    ssize_t numFrames;
+    bool compression;
+
+    DataStream *streams[NUM_STREAMS];
+    DataStream *streams_verify[NUM_STREAMS];
 
   public:
 
+    /*! Starts a new frame, called for each rtcCommit but not for
+     *  rtcCommitAsync. Frames are counted per logged scene, which is
+     *  the scene rays got last traced against. Commits of other
+     *  scenes (e.g. instanced scenes) do not start a new frame and
+     *  frame 0 lasts until the logged scene gets committed after the
+     *  first ray got traced. */
+    void beginFrame(void* scene);
+
+    /*! writes all buffered records to disk */
+    void flush();
+
     enum { 
       RAY_INTERSECT = 0,
       RAY_OCCLUDED  = 1
@@ -184,4 +313,87 @@ namespace embree
 
   void dumpGeometry(void* scene);
   };
+
+  __forceinline unsigned int rayStreamRead32(const char* ptr) {
+    unsigned int v; memcpy(&v,ptr,sizeof(v)); return v;
+  }
+
+  __forceinline void rayStreamWriteLength(char*& op, size_t len)
+  {
+    for (; len >= 255; len -= 255) *op++ = (char)255;
+    *op++ = (char)len;
+  }
+
+  __forceinline void rayStreamWriteSequence(char*& op, const char* literals, size_t numLiterals, size_t offset, size_t matchLength)
+  {
+    char* token = op++;
+    const size_t matchCode = matchLength ? matchLength-4 : 0;
+    *token = (char)(((numLiterals < 15 ? numLiterals : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+    if (numLiterals >= 15) rayStreamWriteLength(op,numLiterals-15);
+    memcpy(op,literals,numLiterals); op += numLiterals;
+    if (matchLength == 0) return;
+    *op++ = (char)(offset & 0xFF);
+    *op++ = (char)(offset >> 8);
+    if (matchCode >= 15) rayStreamWriteLength(op,matchCode-15);
+  }
+
+  inline size_t RayStreamLogger::compress(const char* src, size_t N, char* dst)
+  {
+    static const size_t HASH_BITS = 14;
+    static const size_t MAX_OFFSET = 65535;
+    unsigned int* table = new unsigned int[1 << HASH_BITS];
+    for (size_t i=0; i<(1 << HASH_BITS); i++) table[i] = (unsigned int)-1;
+
+    /* the last bytes are always stored as literals */
+    const size_t limit = N > 12 ? N-12 : 0;
+    size_t ip = 0, anchor = 0;
+    char* op = dst;
+
+    while (ip < limit)
+    {
+      const unsigned int seq = rayStreamRead32(src+ip);
+      const size_t h = (seq * 2654435761u) >> (32-HASH_BITS);
+      const size_t ref = table[h];
+      table[h] = (unsigned int)ip;
+      if (ref == (unsigned int)-1 || ip-ref > MAX_OFFSET || rayStreamRead32(src+ref) != seq) {
+        ip++; continue;
+      }
+
+      size_t len = 4;
+      while (ip+len < N-5 && src[ref+len] == src[ip+len]) len++;
+      rayStreamWriteSequence(op,src+anchor,ip-anchor,ip-ref,len);
+      ip += len; anchor = ip;
+    }
+    rayStreamWriteSequence(op,src+anchor,N-anchor,0,0);
+    delete[] table;
+    return op-dst;
+  }
+
+  inline size_t RayStreamLogger::decompress(const char* src, size_t N, char* dst)
+  {
+    const unsigned char* ip = (const unsigned char*) src;
+    const unsigned char* end = ip+N;
+    char* op = dst;
+
+    while (ip < end)
+    {
+      const size_t token = *ip++;
+
+      size_t numLiterals = token >> 4;
+      if (numLiterals == 15) { size_t l; do { l = *ip++; numLiterals += l; } while (l == 255); }
+      memcpy(op,ip,numLiterals); op += numLiterals; ip += numLiterals;
+      if (ip >= end) break;
+
+      const size_t offset = ip[0] | (ip[1] << 8); ip += 2;
+      size_t matchLength = token & 15;
+      if (matchLength == 15) { size_t l; do { l = *ip++; matchLength += l; } while (l == 255); }
+      matchLength += 4;
+
+      /* matches may overlap with the output, thus copy byte by byte */
+      const char* match = op-offset;
+      for (size_t i=0; i<matchLength; i++) op[i] = match[i];
+      op += matchLength;
+    }
+    return op-dst;
+  }
 };
@@ -24,9 +24,11 @@
 #include "common/alloc.h"
 #include "embree2/rtcore.h"
 #include "common/scene.h"
+#include "common/subdiv/tessellation_cache.h"
 #include "tasking/taskscheduler.h"
 #include "sys/thread.h"
 #include "raystream_log.h"
+#include "raystream.h"
 
 #define TRACE(x) //std::cout << #x << std::endl;
 
@@ -79,6 +81,8 @@ namespace embree
   std::string g_tri_builder = "default";               //!< builder to use for triangles
   std::string g_tri_traverser = "default";             //!< traverser to use for triangles
   double      g_tri_builder_replication_factor = 2.0f; //!< maximally factor*N many primitives in accel
+  size_t      g_build_chunk_size = 0;                  //!< scenes with more primitives get build in spatial chunks
+  float       g_tri_refit_restructure = 1.2f;          //!< relative SAH cost increase that triggers restructuring of refitted BVHs
 
   std::string g_tri_accel_mb = "default";              //!< acceleration structure to use for motion blur triangles
   std::string g_tri_builder_mb = "default";            //!< builder to use for motion blur triangles
@@ -90,7 +94,10 @@ namespace embree
   double      g_hair_builder_replication_factor = 3.0f; //!< maximally factor*N many primitives in accel
   float       g_memory_preallocation_factor     = 1.0f; 
   size_t      g_tessellation_cache_size         = 0;    //!< size of the shared tessellation cache 
+  size_t      g_hugepages                       = 0;    //!< backs BVH memory by huge pages (1 = transparent, 2 = explicit)
+  size_t      g_numa_interleave                 = 0;    //!< interleaves BVH memory across NUMA nodes
   std::string g_subdiv_accel = "default";               //!< acceleration structure to use for subdivision surfaces
+  size_t      g_subdiv_tight_bounds = 0;                //!< evaluates displacements during build instead of using the user specified bounds
 
   int g_scene_flags = -1;                               //!< scene flags to use
   size_t g_verbose = 0;                                 //!< verbosity of output
@@ -98,6 +105,10 @@ namespace embree
   size_t g_benchmark = 0;
   size_t g_regression_testing = 0;                      //!< enables regression tests at startup
 
+  ssize_t g_raystream_log_first_frame = 0;               //!< first frame the ray stream logger records
+  ssize_t g_raystream_log_frames = 0;                    //!< number of frames to record, 0 records all frames
+  bool    g_raystream_log_compression = false;           //!< compresses the recorded ray streams
+
 #if defined(TASKING_TBB)
   bool g_tbb_threads_initialized = false;
   tbb::task_scheduler_init tbb_threads(tbb::task_scheduler_init::deferred);
@@ -118,6 +129,8 @@ namespace embree
     g_tri_builder = "default";
     g_tri_traverser = "default";
     g_tri_builder_replication_factor = 2.0f;
+    g_build_chunk_size = 0;
+    g_tri_refit_restructure = 1.2f;
 
     g_tri_accel_mb = "default";
     g_tri_builder_mb = "default";
@@ -128,13 +141,20 @@ namespace embree
     g_hair_traverser = "default";
     g_hair_builder_replication_factor = 3.0f;
     g_memory_preallocation_factor = 1.0f;
+    g_hugepages = 0;
+    g_numa_interleave = 0;
 
     g_subdiv_accel = "default";
+    g_subdiv_tight_bounds = 0;
 
     g_scene_flags = -1;
     g_verbose = 0;
     g_numThreads = 0;
     g_benchmark = 0;
+
+    g_raystream_log_first_frame = 0;
+    g_raystream_log_frames = 0;
+    g_raystream_log_compression = false;
   }
 
   void printSettings()
@@ -148,6 +168,8 @@ namespace embree
     std::cout << "  builder       = " << g_tri_builder << std::endl;
     std::cout << "  traverser     = " << g_tri_traverser << std::endl;
     std::cout << "  replications  = " << g_tri_builder_replication_factor << std::endl;
+    std::cout << "  chunk size    = " << g_build_chunk_size << std::endl;
+    std::cout << "  restructure   = " << g_tri_refit_restructure << std::endl;
 
     std::cout << "motion blur triangles:" << std::endl;
     std::cout << "  accel         = " << g_tri_accel_mb << std::endl;
@@ -162,6 +184,18 @@ namespace embree
 
     std::cout << "subdivision surfaces:" << std::endl;
     std::cout << "  accel         = " << g_subdiv_accel << std::endl;
+    std::cout << "  tight bounds  = " << g_subdiv_tight_bounds << std::endl;
+
+    std::cout << "memory:" << std::endl;
+    std::cout << "  hugepages     = " << g_hugepages << std::endl;
+    std::cout << "  interleave    = " << g_numa_interleave << std::endl;
+
+#if defined(RTCORE_ENABLE_RAYSTREAM_LOGGER)
+    std::cout << "ray stream logger:" << std::endl;
+    std::cout << "  first frame   = " << g_raystream_log_first_frame << std::endl;
+    std::cout << "  frames        = " << g_raystream_log_frames << std::endl;
+    std::cout << "  compression   = " << g_raystream_log_compression << std::endl;
+#endif
 
 #if defined(__MIC__)
     std::cout << "memory allocation:" << std::endl;
@@ -327,6 +361,10 @@ namespace embree
             g_tri_traverser = parseIdentifier (cfg,pos);
 	else if (tok == "tri_builder_replication_factor" && parseSymbol (cfg,'=',pos))
             g_tri_builder_replication_factor = parseInt (cfg,pos);
+	else if (tok == "build_chunk_size" && parseSymbol (cfg,'=',pos))
+            g_build_chunk_size = parseInt (cfg,pos);
+	else if (tok == "tri_refit_restructure" && parseSymbol (cfg,'=',pos))
+            g_tri_refit_restructure = parseFloat (cfg,pos);
 
       	else if ((tok == "tri_accel_mb" || tok == "accel_mb") && parseSymbol (cfg,'=',pos))
             g_tri_accel_mb = parseIdentifier (cfg,pos);
@@ -346,12 +384,21 @@ namespace embree
 
         else if (tok == "subdiv_accel" && parseSymbol (cfg,'=',pos))
             g_subdiv_accel = parseIdentifier (cfg,pos);
+        else if (tok == "subdiv_tight_bounds" && parseSymbol (cfg,'=',pos))
+            g_subdiv_tight_bounds = parseInt (cfg,pos);
 	
         else if (tok == "verbose" && parseSymbol (cfg,'=',pos))
             g_verbose = parseInt (cfg,pos);
 	else if (tok == "benchmark" && parseSymbol (cfg,'=',pos))
             g_benchmark = parseInt (cfg,pos);
 
+        else if (tok == "raystream_log_first_frame" && parseSymbol (cfg,'=',pos))
+            g_raystream_log_first_frame = parseInt (cfg,pos);
+        else if (tok == "raystream_log_frames" && parseSymbol (cfg,'=',pos))
+            g_raystream_log_frames = parseInt (cfg,pos);
+        else if (tok == "raystream_log_compression" && parseSymbol (cfg,'=',pos))
+            g_raystream_log_compression = parseInt (cfg,pos);
+
         else if (tok == "flags") {
           g_scene_flags = 0;
           if (parseSymbol (cfg,'=',pos)) {
@@ -367,6 +414,10 @@ namespace embree
             } while (parseSymbol (cfg,',',pos));
           }
         }
+	else if (tok == "hugepages" && parseSymbol (cfg,'=',pos))
+            g_hugepages = parseInt (cfg,pos);
+	else if (tok == "numa_interleave" && parseSymbol (cfg,'=',pos))
+            g_numa_interleave = parseInt (cfg,pos);
 	else if (tok == "memory_preallocation_factor" && parseSymbol (cfg,'=',pos))
 	  {
 	    g_memory_preallocation_factor = parseFloat (cfg,pos);
@@ -502,11 +553,16 @@ namespace embree
     if (!g_initialized) {
       return;
     }
+#if defined(RTCORE_ENABLE_RAYSTREAM_LOGGER)
+    RayStreamLogger::rayStreamLogger.flush();
+#endif
+
 #if defined(TASKING_LOCKSTEP)
     TaskScheduler::destroy();
 #endif
 
 #if defined(TASKING_TBB_INTERNAL)
+    Scene::destroyAsyncScheduler();
     TaskSchedulerNew::destroy();
 #endif
 
@@ -583,6 +639,41 @@ namespace embree
     g_memory_monitor_function = func;
   }
 
+  RTCORE_API void rtcSetTessellationCacheSize(size_t bytes)
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetTessellationCacheSize);
+    Lock<MutexSys> lock(g_mutex);
+    if (bytes <= 1024*1024 || bytes >= 0xffffffff) {
+      process_error(RTC_INVALID_ARGUMENT,"invalid tessellation cache size");
+      return;
+    }
+    if (bytes != SharedLazyTessellationCache::sharedLazyTessellationCache.getSize())
+      SharedLazyTessellationCache::sharedLazyTessellationCache.realloc(bytes);
+    g_tessellation_cache_size = bytes;
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcGetTessellationCacheStatistics(RTCTessellationCacheStatistics* stats)
+  {
+    CATCH_BEGIN;
+    TRACE(rtcGetTessellationCacheStatistics);
+    VERIFY_HANDLE(stats);
+    SharedLazyTessellationCache& cache = SharedLazyTessellationCache::sharedLazyTessellationCache;
+    stats->size      = cache.getSize();
+    stats->bytesUsed = cache.getNumUsedBytes();
+    cache.getStatistics(stats->hits,stats->misses,stats->copies,stats->flushes);
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcResetTessellationCacheStatistics()
+  {
+    CATCH_BEGIN;
+    TRACE(rtcResetTessellationCacheStatistics);
+    SharedLazyTessellationCache::sharedLazyTessellationCache.resetStatistics();
+    CATCH_END;
+  }
+
   RTCORE_API void rtcDebug()
   {
     Lock<MutexSys> lock(g_mutex);
@@ -623,6 +714,26 @@ namespace embree
     ((Scene*)scene)->setProgressMonitorFunction(func,ptr);
     CATCH_END;
   }
+
+  RTCORE_API void rtcSetSceneCacheFile(RTCScene hscene, const char* fileName) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetSceneCacheFile);
+    VERIFY_HANDLE(hscene);
+    VERIFY_HANDLE(fileName);
+    Scene* scene = (Scene*) hscene;
+    if (!scene->isStatic()) {
+      process_error(RTC_INVALID_OPERATION,"only static scenes can get cached");
+      return;
+    }
+    if (scene->isBuild()) {
+      process_error(RTC_INVALID_OPERATION,"scene cache file has to get set before commit");
+      return;
+    }
+    delete scene->cache;
+    scene->cache = new SceneCache(scene,fileName);
+    CATCH_END;
+  }
   
   RTCORE_API void rtcCommit (RTCScene scene) 
   {
@@ -631,13 +742,41 @@ namespace embree
     VERIFY_HANDLE(scene);
 
 #if defined(RTCORE_ENABLE_RAYSTREAM_LOGGER)
-    RayStreamLogger::rayStreamLogger.dumpGeometry(scene);
+    RayStreamLogger::rayStreamLogger.beginFrame(scene);
 #endif
 
+    ((Scene*)scene)->waitAsync();
     ((Scene*)scene)->build(0,0);
     CATCH_END;
   }
 
+  RTCORE_API void rtcCommitAsync (RTCScene hscene) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcCommitAsync);
+    VERIFY_HANDLE(hscene);
+    Scene* scene = (Scene*) hscene;
+    if (!scene->isAsyncCommit()) {
+      process_error(RTC_INVALID_OPERATION,"asynchronous commit requires the RTC_SCENE_ASYNC_COMMIT scene flag");
+      return;
+    }
+
+    /* rays may get traced while the asynchronous commit runs, thus
+     * this commit does not start a new frame of the ray stream logger
+     * which would flush the blocks of the tracing threads */
+    scene->buildAsync();
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcWaitCommit (RTCScene scene) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcWaitCommit);
+    VERIFY_HANDLE(scene);
+    ((Scene*)scene)->waitAsync();
+    CATCH_END;
+  }
+
   RTCORE_API void rtcCommitThread(RTCScene scene, unsigned int threadID, unsigned int numThreads) 
   {
     CATCH_BEGIN;
@@ -651,6 +790,7 @@ namespace embree
       FATAL("MIC requires numThreads % 4 == 0 in rtcCommitThread");
 #endif
     
+    ((Scene*)scene)->waitAsync();
     ((Scene*)scene)->build(threadID,numThreads);
 
     CATCH_END;
@@ -859,6 +999,48 @@ namespace embree
 #endif
   }
   
+  RTCORE_API void rtcIntersectN (RTCScene scene, RTCRay* rays, size_t N, size_t stride) 
+  {
+    TRACE(rtcIntersectN);
+#if defined(DEBUG)
+    if (!((Scene*)scene)->is_build) process_error(RTC_INVALID_OPERATION,"scene got not committed");
+    if (stride < sizeof(RTCRay)) process_error(RTC_INVALID_ARGUMENT,"ray stride smaller than ray size");   
+#endif
+    STAT3(normal.travs,1,N,N);
+    RayStream::intersect((Scene*)scene,rays,N,stride);
+  }
+
+  RTCORE_API void rtcIntersectNp (RTCScene scene, const RTCRayNp& rays, size_t N) 
+  {
+    TRACE(rtcIntersectNp);
+#if defined(DEBUG)
+    if (!((Scene*)scene)->is_build) process_error(RTC_INVALID_OPERATION,"scene got not committed");
+#endif
+    STAT3(normal.travs,1,N,N);
+    RayStream::intersect((Scene*)scene,rays,N);
+  }
+
+  RTCORE_API void rtcOccludedN (RTCScene scene, RTCRay* rays, size_t N, size_t stride) 
+  {
+    TRACE(rtcOccludedN);
+#if defined(DEBUG)
+    if (!((Scene*)scene)->is_build) process_error(RTC_INVALID_OPERATION,"scene got not committed");
+    if (stride < sizeof(RTCRay)) process_error(RTC_INVALID_ARGUMENT,"ray stride smaller than ray size");   
+#endif
+    STAT3(shadow.travs,1,N,N);
+    RayStream::occluded((Scene*)scene,rays,N,stride);
+  }
+
+  RTCORE_API void rtcOccludedNp (RTCScene scene, const RTCRayNp& rays, size_t N) 
+  {
+    TRACE(rtcOccludedNp);
+#if defined(DEBUG)
+    if (!((Scene*)scene)->is_build) process_error(RTC_INVALID_OPERATION,"scene got not committed");
+#endif
+    STAT3(shadow.travs,1,N,N);
+    RayStream::occluded((Scene*)scene,rays,N);
+  }
+  
   RTCORE_API void rtcDeleteScene (RTCScene scene) 
   {
     CATCH_BEGIN;
@@ -879,6 +1061,33 @@ namespace embree
     return -1;
   }
 
+  RTCORE_API unsigned rtcNewInstanceArray (RTCScene target, RTCScene source, size_t numInstances) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcNewInstanceArray);
+    VERIFY_HANDLE(target);
+    VERIFY_HANDLE(source);
+    return ((Scene*) target)->newInstanceArray((Scene*) source,numInstances);
+    CATCH_END;
+    return -1;
+  }
+
+  RTCORE_API unsigned rtcGetInstanceArrayBaseID (RTCScene scene, unsigned geomID) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcGetInstanceArrayBaseID);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    Geometry* geom = ((Scene*) scene)->get_locked(geomID);
+    if (geom == NULL || geom->type != INSTANCE_ARRAY) {
+      process_error(RTC_INVALID_ARGUMENT,"geometry is no instance array");
+      return -1;
+    }
+    return ((InstanceArray*) geom)->baseID;
+    CATCH_END;
+    return -1;
+  }
+
   RTCORE_API void rtcSetTransform (RTCScene scene, unsigned geomID, RTCMatrixType layout, const float* xfm) 
   {
     CATCH_BEGIN;
@@ -940,6 +1149,16 @@ namespace embree
     return -1;
   }
 
+  RTCORE_API unsigned rtcNewQuadMesh (RTCScene scene, RTCGeometryFlags flags, size_t numQuads, size_t numVertices, size_t numTimeSteps) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcNewQuadMesh);
+    VERIFY_HANDLE(scene);
+    return ((Scene*)scene)->newQuadMesh(flags,numQuads,numVertices,numTimeSteps);
+    CATCH_END;
+    return -1;
+  }
+
   RTCORE_API unsigned rtcNewHairGeometry (RTCScene scene, RTCGeometryFlags flags, size_t numCurves, size_t numVertices, size_t numTimeSteps) 
   {
     CATCH_BEGIN;
@@ -1062,6 +1281,30 @@ namespace embree
     return NULL;
   }
 
+  RTCORE_API void rtcInterpolateN (RTCScene hscene, unsigned geomID, 
+                                   const unsigned* primIDs, const float* u, const float* v, size_t numUVs, 
+                                   const float* src, size_t byteStride,
+                                   float* P, float* dPdu, float* dPdv, size_t numFloats)
+  {
+    CATCH_BEGIN;
+    TRACE(rtcInterpolateN);
+    VERIFY_HANDLE(hscene);
+    VERIFY_GEOMID(geomID);
+    Scene* scene = (Scene*) hscene;
+    if (scene == NULL || geomID == -1) return;
+    if (!scene->is_build) {
+      process_error(RTC_INVALID_OPERATION,"scene got not committed");
+      return;
+    }
+    Geometry* geom = geomID < scene->size() ? scene->get(geomID) : NULL;
+    if (geom == NULL) {
+      process_error(RTC_INVALID_ARGUMENT,"invalid geometry ID");
+      return;
+    }
+    geom->interpolateN(primIDs,u,v,numUVs,src,byteStride,P,dPdu,dPdv,numFloats);
+    CATCH_END;
+  }
+
   RTCORE_API void rtcSetBoundsFunction (RTCScene scene, unsigned geomID, RTCBoundsFunc bounds)
   {
     CATCH_BEGIN;
@@ -1082,6 +1325,17 @@ namespace embree
     CATCH_END;
   }
 
+  RTCORE_API void rtcSetViewDependentTessellation (RTCScene scene, unsigned geomID, const float* pos, float fovy, size_t resolution, float edgeLength)
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetViewDependentTessellation);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    VERIFY_HANDLE(pos);
+    ((Scene*)scene)->get_locked(geomID)->setViewDependentTessellation(Vec3fa(pos[0],pos[1],pos[2]),fovy,resolution,edgeLength);
+    CATCH_END;
+  }
+
   RTCORE_API void rtcSetIntersectFunction (RTCScene scene, unsigned geomID, RTCIntersectFunc intersect) 
   {
     CATCH_BEGIN;
@@ -1162,6 +1416,26 @@ namespace embree
     CATCH_END;
   }
 
+  RTCORE_API void rtcSetIntersectFunctionN (RTCScene scene, unsigned geomID, RTCIntersectFuncN intersectN) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetIntersectFunctionN);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    ((Scene*)scene)->get_locked(geomID)->setIntersectFunctionN(intersectN);
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcSetOccludedFunctionN (RTCScene scene, unsigned geomID, RTCOccludedFuncN occludedN) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetOccludedFunctionN);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    ((Scene*)scene)->get_locked(geomID)->setOccludedFunctionN(occludedN);
+    CATCH_END;
+  }
+
   RTCORE_API void rtcSetIntersectionFilterFunction (RTCScene scene, unsigned geomID, RTCFilterFunc intersect) 
   {
     CATCH_BEGIN;
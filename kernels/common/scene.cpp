@@ -29,12 +29,12 @@ namespace embree
 {
   Scene::Scene (RTCSceneFlags sflags, RTCAlgorithmFlags aflags)
     : flags(sflags), aflags(aflags), numMappedBuffers(0), is_build(false), modified(true), needTriangles(false), needVertices(false),
-      numTriangles(0), numTriangles2(0), 
+      numTriangles(0), numTriangles2(0), numQuads(0), numTimeStepsMB(0),
       numBezierCurves(0), numBezierCurves2(0), 
       numSubdivPatches(0), numSubdivPatches2(0), 
-      numUserGeometries1(0), 
-      numIntersectionFilters4(0), numIntersectionFilters8(0), numIntersectionFilters16(0),
-      commitCounter(0), 
+      numUserGeometries1(0), numArrayInstances(0), numInstanceArrayIDs(0),
+      numIntersectionFilters4(0), numIntersectionFilters8(0), numIntersectionFilters16(0), numRayMasks(0),
+      cache(NULL), commitCounter(0), committed(&committedBuilds[0]), asyncBuildThread(NULL), asyncError(RTC_NO_ERROR),
       progress_monitor_function(NULL), progress_monitor_ptr(NULL), progress_monitor_counter(0)
   {
 #if defined(TASKING_LOCKSTEP) 
@@ -49,6 +49,7 @@ namespace embree
       flags = (RTCSceneFlags) g_scene_flags;
 
 #if defined(__MIC__)
+    flags = (RTCSceneFlags) (flags & ~RTC_SCENE_ASYNC_COMMIT);
     accels.add( BVH4mb::BVH4mbTriangle1ObjectSplitBinnedSAH(this) );
     accels.add( BVH4i::BVH4iVirtualGeometryBinnedSAH(this, isRobust()));
     accels.add( BVH4Hair::BVH4HairBinnedSAH(this));
@@ -107,19 +108,48 @@ namespace embree
     else THROW_RUNTIME_ERROR("unknown accel "+g_tri_accel);
     
 #else
-    createTriangleAccel();
-    accels.add(BVH4::BVH4Triangle4vMB(this));
-    accels.add(BVH4::BVH4UserGeometry(this));
-    createHairAccel();
-    accels.add(BVH4::BVH4OBBBezier1iMB(this,false));
-    createSubdivAccel();
+    if (isAsyncCommit()) 
+    {
+      /* rays see an empty scene until the first commit finished */
+      committedBuilds[0].accels = new AccelN;
+      committedBuilds[0].accels->build(0,0);
+      committedBuilds[0].intersectors = restrictIntersectors(committedBuilds[0].accels->intersectors);
+
+      /* all rays get dispatched to the currently committed build */
+      intersectors.ptr = this;
+      intersectors.intersector1 = Intersector1(&intersectAsync,&occludedAsync,"Scene::intersector1.async");
+      intersectors.intersector4 = Intersector4(&intersectAsync4,&occludedAsync4,"Scene::intersector4.async");
+      intersectors.intersector8 = Intersector8(&intersectAsync8,&occludedAsync8,"Scene::intersector8.async");
+      intersectors.intersector16= Intersector16(&intersectAsync16,&occludedAsync16,"Scene::intersector16.async");
+      intersectors = restrictIntersectors(intersectors);
+    }
+    else
+      createAccels(accels);
 #endif
   }
 
 #if !defined(__MIC__)
 
-  void Scene::createTriangleAccel()
+  void Scene::createAccels(AccelN& accels)
   {
+    createTriangleAccel(accels);
+    accels.add(BVH4::BVH4Quad4v(this));
+    accels.add(BVH4::BVH4Triangle4vMB(this));
+    accels.add(BVH4::BVH4Triangle4iMB(this));
+    accels.add(BVH4::BVH4UserGeometry(this));
+    accels.add(BVH4::BVH4InstanceArray(this));
+    createHairAccel(accels);
+    accels.add(BVH4::BVH4OBBBezier1iMB(this,false));
+    createSubdivAccel(accels);
+  }
+
+  void Scene::createTriangleAccel(AccelN& accels)
+  {
+    /* there are no backface culling kernels for the Triangle1, Triangle1v and Triangle8 leaves */
+    if (isBackfaceCulling() && g_tri_accel != "default" &&
+        (g_tri_accel.find("triangle1") != std::string::npos || g_tri_accel.find("triangle8") != std::string::npos))
+      THROW_RUNTIME_ERROR("backface culling is not supported by triangle acceleration structure "+g_tri_accel);
+
     if (g_tri_accel == "default") 
     {
       if (isStatic()) {
@@ -173,7 +203,7 @@ namespace embree
     else THROW_RUNTIME_ERROR("unknown triangle acceleration structure "+g_tri_accel);
   }
 
-  void Scene::createHairAccel()
+  void Scene::createHairAccel(AccelN& accels)
   {
     if (g_hair_accel == "default") 
     {
@@ -201,14 +231,19 @@ namespace embree
     else if (g_hair_accel == "bvh4.bezier1i"    ) accels.add(BVH4::BVH4Bezier1i(this));
     else if (g_hair_accel == "bvh4obb.bezier1v" ) accels.add(BVH4::BVH4OBBBezier1v(this,false));
     else if (g_hair_accel == "bvh4obb.bezier1i" ) accels.add(BVH4::BVH4OBBBezier1i(this,false));
+    else if (g_hair_accel == "bvh4obb.bezier4q" ) accels.add(BVH4::BVH4OBBBezier4q(this,false));
     else THROW_RUNTIME_ERROR("unknown hair acceleration structure "+g_hair_accel);
   }
 
-  void Scene::createSubdivAccel()
+  void Scene::createSubdivAccel(AccelN& accels)
   {
+    /* only the cached subdiv patch kernels support backface culling */
+    if (isBackfaceCulling() && g_subdiv_accel != "default" && g_subdiv_accel != "bvh4.subdivpatch1cached")
+      THROW_RUNTIME_ERROR("backface culling is not supported by subdiv acceleration structure "+g_subdiv_accel);
+
     if (g_subdiv_accel == "default") 
     {
-      if (isIncoherent(flags) && isStatic())
+      if (isIncoherent(flags) && isStatic() && !isBackfaceCulling())
         accels.add(BVH4::BVH4SubdivGridEager(this));
       else
         accels.add(BVH4::BVH4SubdivPatch1Cached(this));
@@ -225,9 +260,16 @@ namespace embree
 
   Scene::~Scene () 
   {
+    waitAsync();
+    for (size_t i=0; i<2; i++) {
+      delete committedBuilds[i].accels; committedBuilds[i].accels = NULL;
+    }
+
     for (size_t i=0; i<geometries.size(); i++)
       delete geometries[i];
 
+    delete cache; cache = NULL;
+
 #if TASKING_TBB
     delete group; group = NULL;
 #endif
@@ -244,6 +286,42 @@ namespace embree
     return geom->id;
   }
 
+  unsigned Scene::newInstanceArray (Scene* scene, size_t numInstances) 
+  {
+#if defined(__MIC__)
+    process_error(RTC_INVALID_OPERATION,"instance arrays are not supported on this device");
+    return -1;
+#endif
+
+    /* every array gets its own range of instance IDs */
+    unsigned baseID = 0;
+    {
+      Lock<AtomicMutex> lock(geometriesMutex);
+      if (numInstances > RTC_MAX_INSTANCE_ARRAY_SIZE-numInstanceArrayIDs) {
+        process_error(RTC_INVALID_ARGUMENT,"too many instances");
+        return -1;
+      }
+      baseID = 0x80000000u | unsigned(numInstanceArrayIDs);
+      numInstanceArrayIDs += numInstances;
+    }
+
+    Geometry* geom = new InstanceArray(this,scene,numInstances,baseID);
+    return geom->id;
+  }
+
+  size_t Scene::liveTimeStepsMB()
+  {
+    Lock<AtomicMutex> lock(geometriesMutex);
+    for (size_t i=0; i<geometries.size(); i++) 
+    {
+      const Geometry* geom = geometries[i];
+      if (geom == NULL || geom->type != TRIANGLE_MESH || geom->state == Geometry::ERASING) continue;
+      const size_t numTimeSteps = ((const TriangleMesh*)geom)->numTimeSteps;
+      if (numTimeSteps > 1) return numTimeSteps;
+    }
+    return 0;
+  }
+
   unsigned Scene::newTriangleMesh (RTCGeometryFlags gflags, size_t numTriangles, size_t numVertices, size_t numTimeSteps) 
   {
     if (isStatic() && (gflags != RTC_GEOMETRY_STATIC)) {
@@ -251,15 +329,54 @@ namespace embree
       return -1;
     }
 
+#if defined(__MIC__)
     if (numTimeSteps == 0 || numTimeSteps > 2) {
       process_error(RTC_INVALID_OPERATION,"only 1 or 2 time steps supported");
       return -1;
     }
+#else
+    if (numTimeSteps == 0 || numTimeSteps > RTC_MAX_TIME_STEPS) {
+      process_error(RTC_INVALID_OPERATION,"only 1 to RTC_MAX_TIME_STEPS time steps supported");
+      return -1;
+    }
+#endif
+
+    /* all motion blurred triangle meshes share the same time segments */
+    if (numTimeSteps > 1) 
+    {
+      const size_t liveTimeSteps = liveTimeStepsMB();
+      if (liveTimeSteps && liveTimeSteps != numTimeSteps) {
+        process_error(RTC_INVALID_OPERATION,"all motion blur triangle meshes have to use the same number of time steps");
+        return -1;
+      }
+      numTimeStepsMB = numTimeSteps;
+    }
     
     Geometry* geom = new TriangleMesh(this,gflags,numTriangles,numVertices,numTimeSteps);
     return geom->id;
   }
 
+  unsigned Scene::newQuadMesh (RTCGeometryFlags gflags, size_t numQuads, size_t numVertices, size_t numTimeSteps) 
+  {
+#if defined(__MIC__)
+    process_error(RTC_INVALID_OPERATION,"quad meshes are not supported on this device");
+    return -1;
+#endif
+
+    if (isStatic() && (gflags != RTC_GEOMETRY_STATIC)) {
+      process_error(RTC_INVALID_OPERATION,"static scenes can only contain static geometries");
+      return -1;
+    }
+
+    if (numTimeSteps != 1) {
+      process_error(RTC_INVALID_OPERATION,"only 1 time step supported for quad meshes");
+      return -1;
+    }
+    
+    Geometry* geom = new QuadMesh(this,gflags,numQuads,numVertices);
+    return geom->id;
+  }
+
   unsigned Scene::newSubdivisionMesh (RTCGeometryFlags gflags, size_t numFaces, size_t numEdges, size_t numVertices, size_t numEdgeCreases, size_t numVertexCreases, size_t numHoles, size_t numTimeSteps) 
   {
     if (isStatic() && (gflags != RTC_GEOMETRY_STATIC)) {
@@ -320,8 +437,22 @@ namespace embree
   {
     /* update bounds */
     is_build = true;
-    bounds = accels.bounds;
-    intersectors = accels.intersectors;
+
+    /* scenes with asynchronous commit keep their dispatch intersectors */
+    if (isAsyncCommit()) 
+      bounds = committed->accels->bounds;
+    else {
+      bounds = accels.bounds;
+      intersectors = restrictIntersectors(accels.intersectors);
+    }
+
+    /* update commit counter */
+    commitCounter++;
+  }
+
+  Accel::Intersectors Scene::restrictIntersectors(const Accel::Intersectors& in) const
+  {
+    Accel::Intersectors intersectors = in;
 
     /* enable only algorithms choosen by application */
     if ((aflags & RTC_INTERSECT1) == 0) {
@@ -340,20 +471,49 @@ namespace embree
       intersectors.intersector16.intersect = NULL;
       intersectors.intersector16.occluded = NULL;
     }
+    return intersectors;
+  }
 
-    /* update commit counter */
-    commitCounter++;
+  void Scene::updateGeometryStates()
+  {
+    /* delete geometry that is scheduled for delete */
+    for (size_t i=0; i<geometries.size(); i++) // FIXME: this late deletion is inefficient in case of many geometries
+    {
+      Geometry* geom = geometries[i];
+      if (!geom) continue;
+      if (geom->state == Geometry::ENABLING) geom->state = Geometry::ENABLED;
+      if (geom->state == Geometry::MODIFIED) geom->state = Geometry::ENABLED;
+      if (geom->state == Geometry::DISABLING) geom->state = Geometry::DISABLED;
+      if (geom->state == Geometry::ERASING) remove(geom);
+    }
   }
 
   void Scene::build_task ()
   {
     progress_monitor_counter = 0;
 
-    /* select fast code path if no intersection filter is present */
-    accels.select(numIntersectionFilters4,numIntersectionFilters8,numIntersectionFilters16);
+    /* deleting all motion blur meshes releases their number of time steps */
+    numTimeStepsMB = liveTimeStepsMB();
+
+#if !defined(__MIC__)
+    /* scenes with asynchronous commit build into fresh hierarchies */
+    if (isAsyncCommit()) {
+      build_async_task();
+      return;
+    }
+#endif
+
+    /* select fast code path if no intersection filter or runtime ray mask is present */
+    accels.select(numIntersectionFilters4 || numRayMasks,numIntersectionFilters8 || numRayMasks,numIntersectionFilters16);
   
+    /* map cached hierarchies */
+    const bool cached = cache && cache->load();
+
     /* build all hierarchies of this scene */
     accels.build(0,0);
+
+    /* store hierarchies for later runs */
+    if (cache && !cached) cache->store();
     
     /* make static geometry immutable */
     if (isStatic()) 
@@ -363,24 +523,220 @@ namespace embree
         if (geometries[i]) geometries[i]->immutable();
     }
 
-    /* delete geometry that is scheduled for delete */
-    for (size_t i=0; i<geometries.size(); i++) // FIXME: this late deletion is inefficient in case of many geometries
+    updateGeometryStates();
+    updateInterface();
+
+    if (g_verbose >= 2) {
+      std::cout << "created scene intersector" << std::endl;
+      accels.print(2);
+      std::cout << "selected scene intersector" << std::endl;
+      intersectors.print(2);
+    }
+  }
+
+#if !defined(__MIC__)
+
+  void Scene::build_async_task ()
+  {
+    /* build into the buffer that is currently not traced, its hierarchies are kept to allow refits and incremental updates */
+    Committed* next = committed == &committedBuilds[0] ? &committedBuilds[1] : &committedBuilds[0];
+    if (next->accels == NULL || next->accels->N == 0) {
+      delete next->accels;
+      next->accels = new AccelN;
+      createAccels(*next->accels);
+    }
+
+    /* record the geometry changes of this commit, erased geometries of the last commit are still in the ERASING state */
+    std::vector<bool> erased(geometries.size(),false);
+    for (size_t i=0; i<pendingStates.size(); i++)
+      if (pendingStates[i].second == Geometry::ERASING) erased[pendingStates[i].first] = true;
+
+    std::vector<std::pair<unsigned,Geometry::State> > changes;
+    for (size_t i=0; i<geometries.size(); i++) {
+      Geometry* geom = geometries[i];
+      if (geom && !erased[i] && geom->state != Geometry::ENABLED && geom->state != Geometry::DISABLED)
+        changes.push_back(std::make_pair(unsigned(i),geom->state));
+    }
+
+    /* the changes of the last commit were only seen by the other build, thus replay them for this build */
+    for (size_t i=0; i<pendingStates.size(); i++)
+    {
+      Geometry* geom = geometries[pendingStates[i].first];
+      if (!geom) continue;
+      switch (pendingStates[i].second) {
+      case Geometry::ENABLING : if (geom->state == Geometry::ENABLED || geom->state == Geometry::MODIFIED) geom->state = Geometry::ENABLING; break;
+      case Geometry::MODIFIED : if (geom->state == Geometry::ENABLED) geom->state = Geometry::MODIFIED; break;
+      case Geometry::DISABLING: if (geom->state == Geometry::DISABLED) geom->state = Geometry::DISABLING; break;
+      default: break;
+      }
+    }
+
+    next->accels->select(numIntersectionFilters4 || numRayMasks,numIntersectionFilters8 || numRayMasks,numIntersectionFilters16);
+    next->accels->build(0,0);
+    next->intersectors = restrictIntersectors(next->accels->intersectors);
+
+    /* switch all new traversals over to the new build */
+    Committed* prev = atomic_xchg_ptr(&committed,next);
+
+    /* the previous build becomes the target of the next commit once the last traversal through it finished */
+    while (prev->readers) {
+      __pause_cpu();
+      yield();
+    }
+
+    /* geometries may only change once no traversal of the previous build can see them */
+    if (isStatic()) 
+    {
+      next->accels->immutable();
+      for (size_t i=0; i<geometries.size(); i++)
+        if (geometries[i]) geometries[i]->immutable();
+    }
+
+    /* geometries erased in this commit are still referenced by the previous build and get removed after the next commit */
+    for (size_t i=0; i<geometries.size(); i++)
     {
       Geometry* geom = geometries[i];
       if (!geom) continue;
       if (geom->state == Geometry::ENABLING) geom->state = Geometry::ENABLED;
       if (geom->state == Geometry::MODIFIED) geom->state = Geometry::ENABLED;
       if (geom->state == Geometry::DISABLING) geom->state = Geometry::DISABLED;
-      if (geom->state == Geometry::ERASING) remove(geom);
+      if (geom->state == Geometry::ERASING && i < erased.size() && erased[i]) remove(geom);
     }
-
+    pendingStates.swap(changes);
     updateInterface();
 
     if (g_verbose >= 2) {
       std::cout << "created scene intersector" << std::endl;
-      accels.print(2);
+      next->accels->print(2);
       std::cout << "selected scene intersector" << std::endl;
-      intersectors.print(2);
+      next->intersectors.print(2);
+    }
+  }
+
+  void Scene::build_async_thread () 
+  {
+    try {
+#if defined(TASKING_TBB_INTERNAL)
+      /* the global scheduler only runs one root task at a time, thus
+       * asynchronous builds run one after the other on a scheduler of their own */
+      Lock<MutexSys> lock(buildMutex);
+      Lock<MutexSys> slock(asyncSchedulerMutex);
+      if (asyncScheduler == NULL) asyncScheduler = new TaskSchedulerNew(g_numThreads);
+      asyncScheduler->spawn_root([&]() { build_task(); });
+#else
+      build(0,0);
+#endif
+    } 
+    /* errors are recorded in the scene as the error state of this thread is not visible to the application */
+    catch (const std::bad_alloc&) {
+      asyncError = RTC_OUT_OF_MEMORY; asyncErrorMessage = "out of memory";
+    } catch (const my_runtime_error& e) {
+      asyncError = e.error; asyncErrorMessage = e.what();
+    } catch (const std::exception& e) {
+      asyncError = RTC_UNKNOWN_ERROR; asyncErrorMessage = e.what();
+    } catch (...) {
+      asyncError = RTC_UNKNOWN_ERROR; asyncErrorMessage = "unknown exception caught";
+    }
+  }
+
+#if defined(TASKING_TBB_INTERNAL)
+  TaskSchedulerNew* Scene::asyncScheduler = NULL;
+  MutexSys Scene::asyncSchedulerMutex;
+
+  void Scene::destroyAsyncScheduler() 
+  {
+    Lock<MutexSys> lock(asyncSchedulerMutex);
+    delete asyncScheduler; asyncScheduler = NULL;
+  }
+#endif
+
+  void Scene::asyncBuildThreadFunc(void* ptr) {
+    ((Scene*)ptr)->build_async_thread();
+  }
+
+  void Scene::buildAsync ()
+  {
+    /* only one build can be pending at a time */
+    waitAsync();
+
+    if (!ready()) {
+      process_error(RTC_INVALID_OPERATION,"not all buffers are unmapped");
+      return;
+    }
+
+    Lock<MutexSys> lock(asyncMutex);
+    asyncBuildThread = createThread(asyncBuildThreadFunc,this);
+  }
+
+  void Scene::intersectAsync (void* ptr, RTCRay& ray) 
+  {
+    Committed* c = Committed::acquire(((Scene*)ptr)->committed);
+    c->intersectors.intersector1.intersect(c->intersectors.ptr,ray);
+    c->release();
+  }
+
+  void Scene::intersectAsync4 (const void* valid, void* ptr, RTCRay4& ray) 
+  {
+    Committed* c = Committed::acquire(((Scene*)ptr)->committed);
+    c->intersectors.intersector4.intersect(valid,c->intersectors.ptr,ray);
+    c->release();
+  }
+
+  void Scene::intersectAsync8 (const void* valid, void* ptr, RTCRay8& ray) 
+  {
+    Committed* c = Committed::acquire(((Scene*)ptr)->committed);
+    c->intersectors.intersector8.intersect(valid,c->intersectors.ptr,ray);
+    c->release();
+  }
+
+  void Scene::intersectAsync16 (const void* valid, void* ptr, RTCRay16& ray) 
+  {
+    Committed* c = Committed::acquire(((Scene*)ptr)->committed);
+    c->intersectors.intersector16.intersect(valid,c->intersectors.ptr,ray);
+    c->release();
+  }
+
+  void Scene::occludedAsync (void* ptr, RTCRay& ray) 
+  {
+    Committed* c = Committed::acquire(((Scene*)ptr)->committed);
+    c->intersectors.intersector1.occluded(c->intersectors.ptr,ray);
+    c->release();
+  }
+
+  void Scene::occludedAsync4 (const void* valid, void* ptr, RTCRay4& ray) 
+  {
+    Committed* c = Committed::acquire(((Scene*)ptr)->committed);
+    c->intersectors.intersector4.occluded(valid,c->intersectors.ptr,ray);
+    c->release();
+  }
+
+  void Scene::occludedAsync8 (const void* valid, void* ptr, RTCRay8& ray) 
+  {
+    Committed* c = Committed::acquire(((Scene*)ptr)->committed);
+    c->intersectors.intersector8.occluded(valid,c->intersectors.ptr,ray);
+    c->release();
+  }
+
+  void Scene::occludedAsync16 (const void* valid, void* ptr, RTCRay16& ray) 
+  {
+    Committed* c = Committed::acquire(((Scene*)ptr)->committed);
+    c->intersectors.intersector16.occluded(valid,c->intersectors.ptr,ray);
+    c->release();
+  }
+
+#endif
+
+  void Scene::waitAsync ()
+  {
+    Lock<MutexSys> lock(asyncMutex);
+    if (asyncBuildThread == NULL) return;
+    join(asyncBuildThread);
+    asyncBuildThread = NULL;
+
+    /* report errors of the build to the waiting thread */
+    if (asyncError != RTC_NO_ERROR) {
+      const RTCError error = asyncError; asyncError = RTC_NO_ERROR;
+      process_error(error,asyncErrorMessage.c_str());
     }
   }
 
@@ -402,6 +758,9 @@ namespace embree
 
     progress_monitor_counter = 0;
 
+    /* deleting all motion blur meshes releases their number of time steps */
+    numTimeStepsMB = liveTimeStepsMB();
+
     //if (isStatic() && isBuild()) {
     //  process_error(RTC_INVALID_OPERATION,"static geometries cannot get committed twice");
     //  return;
@@ -412,8 +771,8 @@ namespace embree
       return;
     }
 
-    /* select fast code path if no intersection filter is present */
-    accels.select(numIntersectionFilters4,numIntersectionFilters8,numIntersectionFilters16);
+    /* select fast code path if no intersection filter or runtime ray mask is present */
+    accels.select(numIntersectionFilters4 || numRayMasks,numIntersectionFilters8 || numRayMasks,numIntersectionFilters16);
 
     /* if user provided threads use them */
     if (threadCount)
@@ -436,17 +795,7 @@ namespace embree
         if (geometries[i]) geometries[i]->immutable();
     }
 
-    /* delete geometry that is scheduled for delete */
-    for (size_t i=0; i<geometries.size(); i++) // FIXME: this late deletion is inefficient in case of many geometries
-    {
-      Geometry* geom = geometries[i];
-      if (!geom) continue;
-      if (geom->state == Geometry::ENABLING) geom->state = Geometry::ENABLED;
-      if (geom->state == Geometry::MODIFIED) geom->state = Geometry::ENABLED;
-      if (geom->state == Geometry::DISABLING) geom->state = Geometry::DISABLED;
-      if (geom->state == Geometry::ERASING) remove(geom);
-    }
-
+    updateGeometryStates();
     updateInterface();
 
     if (g_verbose >= 2) {
@@ -19,6 +19,7 @@
 #include "common/default.h"
 
 #include "scene_triangle_mesh.h"
+#include "scene_quad_mesh.h"
 #include "scene_user_geometry.h"
 #include "scene_bezier_curves.h"
 #include "scene_subdiv_mesh.h"
@@ -26,6 +27,7 @@
 #include "common/subdiv/tessellation_cache.h"
 
 #include "common/acceln.h"
+#include "common/scene_cache.h"
 #include "geometry.h"
 
 namespace embree
@@ -51,7 +53,7 @@ namespace embree
         if (geom == NULL) return NULL;
         if (!geom->isEnabled()) return NULL;
         if (geom->type != Ty::geom_type) return NULL;
-        if (geom->numTimeSteps != timeSteps) return NULL;
+        if (min(size_t(geom->numTimeSteps),size_t(2)) != timeSteps) return NULL; // all geometries with more than one time step are motion blurred
         return (Ty*) geom;
       }
 
@@ -87,9 +89,10 @@ namespace embree
     /*! Scene construction */
     Scene (RTCSceneFlags flags, RTCAlgorithmFlags aflags);
 
-    void createTriangleAccel();
-    void createHairAccel();
-    void createSubdivAccel();
+    void createAccels(AccelN& accels);
+    void createTriangleAccel(AccelN& accels);
+    void createHairAccel(AccelN& accels);
+    void createSubdivAccel(AccelN& accels);
 
     /*! Scene destruction */
     ~Scene ();
@@ -100,9 +103,15 @@ namespace embree
     /*! Creates a new scene instance. */
     unsigned int newInstance (Scene* scene);
 
+    /*! Creates a new array of scene instances. */
+    unsigned int newInstanceArray (Scene* scene, size_t numInstances);
+
     /*! Creates a new triangle mesh. */
     unsigned int newTriangleMesh (RTCGeometryFlags flags, size_t maxTriangles, size_t maxVertices, size_t numTimeSteps);
 
+    /*! Creates a new quad mesh. */
+    unsigned int newQuadMesh (RTCGeometryFlags flags, size_t maxQuads, size_t maxVertices, size_t numTimeSteps);
+
     /*! Creates a new collection of quadratic bezier curves. */
     unsigned int newBezierCurves (RTCGeometryFlags flags, size_t maxCurves, size_t maxVertices, size_t numTimeSteps);
 
@@ -113,10 +122,38 @@ namespace embree
     void build (size_t threadIndex, size_t threadCount);
     void build_task ();
 
+    /*! Builds the acceleration structures in a background thread, rays use the previous build until the new one is finished. */
+    void buildAsync ();
+
+    /*! Waits for a pending background build to finish. */
+    void waitAsync ();
+
     /*! stores scene into binary file */
     void write(std::ofstream& file);
 
     void updateInterface();
+    void updateGeometryStates();
+
+    /*! returns the number of time steps of all motion blur triangle meshes that are not deleted, 0 if there are none */
+    size_t liveTimeStepsMB();
+    Accel::Intersectors restrictIntersectors(const Accel::Intersectors& in) const;
+
+  private:
+    void build_async_task ();
+    void build_async_thread ();
+    static void asyncBuildThreadFunc(void* ptr);
+
+    /*! ray dispatch of scenes with asynchronous commit */
+    static void intersectAsync (void* ptr, RTCRay& ray);
+    static void intersectAsync4 (const void* valid, void* ptr, RTCRay4& ray);
+    static void intersectAsync8 (const void* valid, void* ptr, RTCRay8& ray);
+    static void intersectAsync16 (const void* valid, void* ptr, RTCRay16& ray);
+    static void occludedAsync (void* ptr, RTCRay& ray);
+    static void occludedAsync4 (const void* valid, void* ptr, RTCRay4& ray);
+    static void occludedAsync8 (const void* valid, void* ptr, RTCRay8& ray);
+    static void occludedAsync16 (const void* valid, void* ptr, RTCRay16& ray);
+
+  public:
 
     /*! build task */
     TASK_RUN_FUNCTION(Scene,task_build_parallel);
@@ -170,6 +207,18 @@ namespace embree
       if (geometries[i]->type != TRIANGLE_MESH) return NULL;
       else return (TriangleMesh*) geometries[i]; 
     }
+    __forceinline QuadMesh* getQuadMesh(size_t i) { 
+      assert(i < geometries.size()); 
+      assert(geometries[i]);
+      assert(geometries[i]->type == QUAD_MESH);
+      return (QuadMesh*) geometries[i]; 
+    }
+    __forceinline const QuadMesh* getQuadMesh(size_t i) const { 
+      assert(i < geometries.size()); 
+      assert(geometries[i]);
+      assert(geometries[i]->type == QUAD_MESH);
+      return (QuadMesh*) geometries[i]; 
+    }
     __forceinline SubdivMesh* getSubdivMesh(size_t i) { 
       assert(i < geometries.size()); 
       assert(geometries[i]);
@@ -201,10 +250,14 @@ namespace embree
     /* test if this is a dynamic scene */
     __forceinline bool isDynamic() const { return embree::isDynamic(flags); }
 
+    /* test if the scene keeps tracing the previous build during commit */
+    __forceinline bool isAsyncCommit() const { return embree::isAsyncCommit(flags); }
+
     __forceinline bool isCompact() const { return embree::isCompact(flags); }
     __forceinline bool isCoherent() const { return embree::isCoherent(flags); }
     __forceinline bool isRobust() const { return embree::isRobust(flags); }
     __forceinline bool isHighQuality() const { return embree::isHighQuality(flags); }
+    __forceinline bool isBackfaceCulling() const { return embree::isBackfaceCulling(flags); }
 
     /* test if scene got already build */
     __forceinline bool isBuild() const { return is_build; }
@@ -215,6 +268,7 @@ namespace embree
     
   public:
     AccelN accels;
+    SceneCache* cache;                 //!< optional file cache for acceleration structures
     unsigned int commitCounter;
     atomic_t numMappedBuffers;         //!< number of mapped buffers
     RTCSceneFlags flags;
@@ -225,6 +279,47 @@ namespace embree
     MutexSys buildMutex;
     AtomicMutex geometriesMutex;
     bool modified;                   //!< true if scene got modified
+
+  public:
+
+    /*! One build of the acceleration structures of a scene with asynchronous commit. */
+    struct Committed
+    {
+      Committed () : accels(NULL), readers(0) {}
+
+      /*! registers a traversal of the currently committed build */
+      static __forceinline Committed* acquire(Committed* volatile& current)
+      {
+        while (true)
+        {
+          Committed* c = current;
+          atomic_add(&c->readers,1);
+          if (likely(c == current)) return c;
+          atomic_add(&c->readers,-1);
+        }
+      }
+
+      /*! unregisters a traversal */
+      __forceinline void release() { atomic_add(&readers,-1); }
+
+    public:
+      AccelN* accels;                    //!< acceleration structures of this build
+      Accel::Intersectors intersectors;  //!< intersectors of this build restricted to the enabled algorithms
+      volatile atomic_t readers;         //!< number of traversals currently using this build
+    };
+
+    Committed committedBuilds[2];      //!< double buffered builds, the one not traced is the target of the next build
+    Committed* volatile committed;     //!< build rays are currently traced through
+    std::vector<std::pair<unsigned,Geometry::State> > pendingStates; //!< geometry changes of the last commit the other build did not see yet
+    thread_t asyncBuildThread;         //!< thread of a pending asynchronous build
+    MutexSys asyncMutex;
+    RTCError asyncError;               //!< error of the last asynchronous build, reported by waitAsync
+    std::string asyncErrorMessage;
+#if defined(TASKING_TBB_INTERNAL)
+    static TaskSchedulerNew* asyncScheduler; //!< scheduler shared by all asynchronous builds, the global one only runs one root task at a time
+    static MutexSys asyncSchedulerMutex;
+    static void destroyAsyncScheduler();
+#endif
     
     /*! global lock step task scheduler */
 #if defined(TASKING_LOCKSTEP)
@@ -246,14 +341,18 @@ namespace embree
   public:
     atomic_t numTriangles;             //!< number of enabled triangles
     atomic_t numTriangles2;            //!< number of enabled motion blur triangles
+    atomic_t numQuads;                 //!< number of enabled quads
+    size_t numTimeStepsMB;             //!< number of time steps of all motion blur triangle meshes
     atomic_t numBezierCurves;          //!< number of enabled curves
     atomic_t numBezierCurves2;         //!< number of enabled motion blur curves
     atomic_t numSubdivPatches;         //!< number of enabled subdivision patches
     atomic_t numSubdivPatches2;        //!< number of enabled motion blur subdivision patches
     atomic_t numUserGeometries1;       //!< number of enabled user geometries
+    atomic_t numArrayInstances;        //!< number of enabled instances of instance arrays
+    size_t numInstanceArrayIDs;        //!< number of instance IDs handed out to instance arrays
 
     __forceinline size_t numPrimitives() const {
-    return numTriangles + numTriangles2 + numBezierCurves + numBezierCurves2 + numSubdivPatches + numSubdivPatches2 + numUserGeometries1;
+    return numTriangles + numTriangles2 + numQuads + numBezierCurves + numBezierCurves2 + numSubdivPatches + numSubdivPatches2 + numUserGeometries1 + numArrayInstances;
    }
 
     template<typename Mesh, int timeSteps> __forceinline size_t getNumPrimitives                    () const { THROW_RUNTIME_ERROR("NOT IMPLEMENTED"); }
@@ -261,13 +360,16 @@ namespace embree
     atomic_t numIntersectionFilters4;   //!< number of enabled intersection/occlusion filters for 4-wide ray packets
     atomic_t numIntersectionFilters8;   //!< number of enabled intersection/occlusion filters for 8-wide ray packets
     atomic_t numIntersectionFilters16;  //!< number of enabled intersection/occlusion filters for 16-wide ray packets
+    atomic_t numRayMasks;               //!< number of enabled geometries with a ray mask other than -1
   };
 
   template<> __forceinline size_t Scene::getNumPrimitives<TriangleMesh,1>() const { return numTriangles; } 
   template<> __forceinline size_t Scene::getNumPrimitives<TriangleMesh,2>() const { return numTriangles2; } 
+  template<> __forceinline size_t Scene::getNumPrimitives<QuadMesh,1>() const { return numQuads; } 
   template<> __forceinline size_t Scene::getNumPrimitives<BezierCurves,1>() const { return numBezierCurves; } 
   template<> __forceinline size_t Scene::getNumPrimitives<BezierCurves,2>() const { return numBezierCurves2; } 
   template<> __forceinline size_t Scene::getNumPrimitives<SubdivMesh,1>() const { return numSubdivPatches; } 
   template<> __forceinline size_t Scene::getNumPrimitives<SubdivMesh,2>() const { return numSubdivPatches2; } 
   template<> __forceinline size_t Scene::getNumPrimitives<UserGeometryBase,1>() const { return numUserGeometries1; } 
+  template<> __forceinline size_t Scene::getNumPrimitives<InstanceArray,1>() const { return numArrayInstances; } 
 }
@@ -21,7 +21,7 @@ namespace embree
 {
   BezierCurves::BezierCurves (Scene* parent, RTCGeometryFlags flags, size_t numCurves, size_t numVertices, size_t numTimeSteps) 
     : Geometry(parent,BEZIER_CURVES,numCurves,numTimeSteps,flags), 
-      mask(-1), numTimeSteps(numTimeSteps), numCurves(numCurves), numVertices(numVertices)
+      numTimeSteps(numTimeSteps), numCurves(numCurves), numVertices(numVertices)
   {
     curves.init(numCurves,sizeof(int));
     for (size_t i=0; i<numTimeSteps; i++) {
@@ -48,7 +48,7 @@ namespace embree
       process_error(RTC_INVALID_OPERATION,"static geometries cannot get modified");
       return;
     }
-    this->mask = mask; 
+    updateMask(mask);
   }
 
   void BezierCurves::setBuffer(RTCBufferType type, void* ptr, size_t offset, size_t stride) 
@@ -0,0 +1,194 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "scene_cache.h"
+#include "scene.h"
+
+#if defined(__WIN32__)
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace embree
+{
+  /*! Header of a scene cache file. The acceleration structures follow
+   *  the header, each starting at a 64 byte aligned file offset. */
+  struct SceneCacheHeader
+  {
+    char magick[8];          //!< identifies scene cache files
+    unsigned version;        //!< version of the file format
+    unsigned pointerBytes;   //!< size of pointers of the writing process
+    uint64 hash;             //!< hash of the cached scene data
+    size_t offset[16];       //!< file offset of each acceleration structure
+    size_t bytes[16];        //!< size of each acceleration structure, 0 if not stored
+  };
+
+  static const char* magick = "EMBRBVH";
+
+  /*! FNV-1a hash over 32 bit words */
+  struct Hash
+  {
+    Hash () : h(0xcbf29ce484222325ULL) {}
+
+    __forceinline void add (unsigned int w) { 
+      h = (h ^ w) * 0x100000001b3ULL; 
+    }
+
+    __forceinline void add (const void* ptr, size_t bytes) 
+    {
+      const unsigned char* p = (const unsigned char*) ptr;
+      for (size_t i=0; i<bytes; i++) add((unsigned int)p[i]);
+    }
+
+    uint64 h;
+  };
+
+  SceneCache::SceneCache (Scene* scene, const std::string& fileName)
+    : scene(scene), fileName(fileName), ptr(NULL), bytes(0) {}
+
+  SceneCache::~SceneCache () {
+    unmap();
+  }
+
+  void SceneCache::unmap() 
+  {
+    os_unmap_file(ptr,bytes);
+    ptr = NULL; bytes = 0;
+  }
+
+  uint64 SceneCache::hash() const
+  {
+    Hash h;
+    h.add(VERSION);
+    h.add(scene->flags);
+    h.add(scene->aflags);
+    h.add(g_tri_accel.c_str(),g_tri_accel.size());
+    h.add(g_tri_builder.c_str(),g_tri_builder.size());
+    h.add(scene->size());
+
+    for (size_t i=0; i<scene->size(); i++)
+    {
+      const Geometry* geom = scene->get(i);
+      if (geom == NULL) { h.add(0); continue; }
+      h.add(geom->type);
+      h.add(geom->isEnabled());
+      if (geom->type != TRIANGLE_MESH) continue;
+
+      /* triangle mesh indices and vertices */
+      const TriangleMesh* mesh = (const TriangleMesh*) geom;
+      h.add(mesh->mask);
+      h.add(mesh->numTimeSteps);
+      h.add(mesh->numTriangles);
+      h.add(mesh->numVertices);
+      h.add(mesh->getVertexBufferStride());
+      for (size_t j=0; j<mesh->numTriangles; j++) {
+        const TriangleMesh::Triangle& tri = mesh->triangle(j);
+        h.add(tri.v[0]); h.add(tri.v[1]); h.add(tri.v[2]);
+      }
+      for (size_t j=0; j<mesh->numVertices; j++) {
+        const unsigned int* v = (const unsigned int*) mesh->vertexPtr(j);
+        h.add(v[0]); h.add(v[1]); h.add(v[2]);
+      }
+    }
+    return h.h;
+  }
+
+  bool SceneCache::load()
+  {
+    /* the file is already mapped by a previous commit */
+    if (ptr) return true;
+
+    ptr = (char*) os_map_file(fileName.c_str(),bytes);
+    if (ptr == NULL) return false;
+
+    const SceneCacheHeader& header = *(SceneCacheHeader*) ptr;
+    bool valid = bytes >= sizeof(SceneCacheHeader);
+    valid = valid && strncmp(header.magick,magick,sizeof(header.magick)) == 0;
+    valid = valid && header.version == VERSION;
+    valid = valid && header.pointerBytes == sizeof(void*);
+    valid = valid && header.hash == hash();
+    for (size_t i=0; valid && i<16; i++) {
+      valid = header.bytes[i] == 0 || (header.offset[i] % 64 == 0 && header.offset[i]+header.bytes[i] <= bytes);
+      valid = valid && (header.bytes[i] == 0 || i < scene->accels.N);
+    }
+    if (!valid) {
+      unmap();
+      return false;
+    }
+
+    /* acceleration structures that are not stored get build */
+    for (size_t i=0; i<scene->accels.N; i++)
+    {
+      if (header.bytes[i] == 0) continue;
+      if (!scene->accels.accels[i]->load(ptr+header.offset[i],header.bytes[i])) {
+        if (g_verbose >= 1) std::cout << "scene cache " << fileName << " contains invalid acceleration structure" << std::endl;
+      }
+    }
+    if (g_verbose >= 2) std::cout << "mapped scene cache " << fileName << std::endl;
+    return true;
+  }
+
+  void SceneCache::store()
+  {
+    /* write to a temporary file first, such that other processes never map a partially written file */
+    std::stringstream tmpFileName_;
+    tmpFileName_ << fileName << "." << getpid() << "." << this << ".tmp";
+    const std::string tmpFileName = tmpFileName_.str();
+    std::ofstream file(tmpFileName.c_str(),std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+      if (g_verbose >= 1) std::cout << "cannot write scene cache " << fileName << std::endl;
+      return;
+    }
+
+    SceneCacheHeader header;
+    memset(&header,0,sizeof(header));
+    strncpy(header.magick,magick,sizeof(header.magick));
+    header.version = VERSION;
+    header.pointerBytes = sizeof(void*);
+    header.hash = hash();
+    file.write((char*)&header,sizeof(header));
+
+    const char zeros[64] = { 0 };
+    size_t numStored = 0;
+    for (size_t i=0; i<scene->accels.N; i++)
+    {
+      size_t offset = file.tellp();
+      if (offset % 64) file.write(zeros,64-offset%64);
+      offset = file.tellp();
+      if (!scene->accels.accels[i]->store(file)) continue;
+      header.offset[i] = offset;
+      header.bytes[i] = size_t(file.tellp())-offset;
+      numStored++;
+    }
+    file.seekp(0);
+    file.write((char*)&header,sizeof(header));
+    file.close();
+
+    /* a file without acceleration structures would only get mapped to build everything again */
+    if (numStored == 0) {
+      std::remove(tmpFileName.c_str());
+      if (g_verbose >= 1) std::cout << "scene " << fileName << " contains no acceleration structure that can get cached" << std::endl;
+      return;
+    }
+
+    if (file.fail() || std::rename(tmpFileName.c_str(),fileName.c_str()) != 0) {
+      std::remove(tmpFileName.c_str());
+      if (g_verbose >= 1) std::cout << "cannot write scene cache " << fileName << std::endl;
+    }
+  }
+}
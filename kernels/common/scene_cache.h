@@ -0,0 +1,61 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "default.h"
+
+namespace embree
+{
+  class Scene;
+
+  /*! Stores the acceleration structures of a static scene in a file
+   *  and maps them back into memory when the same geometry gets
+   *  committed again, e.g. by a later process. */
+  class SceneCache
+  {
+  public:
+
+    /*! version of the file format */
+    static const unsigned VERSION = 2;
+
+    SceneCache (Scene* scene, const std::string& fileName);
+    ~SceneCache ();
+
+    /*! Maps the cache file and loads all acceleration structures
+     *  stored in it. Returns false if the file does not exist or was
+     *  written for different geometry. */
+    bool load();
+
+    /*! Writes all acceleration structures of the scene that support
+     *  caching to the cache file. */
+    void store();
+
+  private:
+
+    /*! calculates a hash over all data the cached acceleration structures depend on */
+    uint64 hash() const;
+
+    /*! unmaps the cache file */
+    void unmap();
+
+  private:
+    Scene* scene;
+    std::string fileName;
+    char* ptr;               //!< pointer to the mapped cache file
+    size_t bytes;            //!< size of the mapped cache file
+  };
+}
@@ -0,0 +1,199 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "scene_quad_mesh.h"
+#include "scene.h"
+
+namespace embree
+{
+  QuadMesh::QuadMesh (Scene* parent, RTCGeometryFlags flags, size_t numQuads, size_t numVertices)
+    : Geometry(parent,QUAD_MESH,numQuads,1,flags),
+      numQuads(numQuads), numVertices(numVertices)
+  {
+    quads.init(numQuads,sizeof(Quad));
+    vertices.init(numVertices,sizeof(Vec3fa));
+    enabling();
+  }
+
+  void QuadMesh::enabling() {
+    atomic_add(&parent->numQuads,numQuads);
+  }
+
+  void QuadMesh::disabling() {
+    atomic_add(&parent->numQuads,-(ssize_t)numQuads);
+  }
+
+  void QuadMesh::setMask (unsigned mask)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      process_error(RTC_INVALID_OPERATION,"static geometries cannot get modified");
+      return;
+    }
+    updateMask(mask);
+  }
+
+  void QuadMesh::setBuffer(RTCBufferType type, void* ptr, size_t offset, size_t stride)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      process_error(RTC_INVALID_OPERATION,"static geometries cannot get modified");
+      return;
+    }
+
+    /* verify that all accesses are 4 bytes aligned */
+    if (((size_t(ptr) + offset) & 0x3) || (stride & 0x3)) {
+      process_error(RTC_INVALID_OPERATION,"data must be 4 bytes aligned");
+      return;
+    }
+
+    switch (type) {
+    case RTC_INDEX_BUFFER  :
+      quads.set(ptr,offset,stride);
+      break;
+    case RTC_VERTEX_BUFFER0:
+      vertices.set(ptr,offset,stride);
+      if (numVertices) {
+        /* test if array is properly padded */
+        volatile int w = *((int*)vertices.getPtr(numVertices-1)+3); // FIXME: is failing hard avoidable?
+      }
+      break;
+    default:
+      process_error(RTC_INVALID_ARGUMENT,"unknown buffer type");
+      break;
+    }
+  }
+
+  void* QuadMesh::map(RTCBufferType type)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      process_error(RTC_INVALID_OPERATION,"static geometries cannot get modified");
+      return NULL;
+    }
+
+    switch (type) {
+    case RTC_INDEX_BUFFER  : return quads   .map(parent->numMappedBuffers);
+    case RTC_VERTEX_BUFFER0: return vertices.map(parent->numMappedBuffers);
+    default                : process_error(RTC_INVALID_ARGUMENT,"unknown buffer type"); return NULL;
+    }
+  }
+
+  void QuadMesh::unmap(RTCBufferType type)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      process_error(RTC_INVALID_OPERATION,"static geometries cannot get modified");
+      return;
+    }
+
+    switch (type) {
+    case RTC_INDEX_BUFFER  : quads   .unmap(parent->numMappedBuffers); break;
+    case RTC_VERTEX_BUFFER0: vertices.unmap(parent->numMappedBuffers); break;
+    default                : process_error(RTC_INVALID_ARGUMENT,"unknown buffer type"); break;
+    }
+  }
+
+  void QuadMesh::immutable ()
+  {
+    bool freeQuads    = !parent->needTriangles;
+    bool freeVertices = !parent->needVertices;
+    if (freeQuads   ) quads.free();
+    if (freeVertices) vertices.free();
+  }
+
+  bool QuadMesh::verify ()
+  {
+    for (size_t i=0; i<numQuads; i++) {
+      if (quads[i].v[0] >= numVertices) return false;
+      if (quads[i].v[1] >= numVertices) return false;
+      if (quads[i].v[2] >= numVertices) return false;
+      if (quads[i].v[3] >= numVertices) return false;
+    }
+    for (size_t i=0; i<numVertices; i++) {
+      if (!inFloatRange(vertices[i]))
+        return false;
+    }
+    return true;
+  }
+
+  void QuadMesh::interpolateN(const unsigned* primIDs, const float* u, const float* v, size_t numUVs, 
+                              const float* src, size_t byteStride, float* P, float* dPdu, float* dPdv, size_t numFloats)
+  {
+    if (!quads) {
+      process_error(RTC_INVALID_OPERATION,"index buffer got released, share it to interpolate in static scenes");
+      return;
+    }
+
+    for (size_t i=0; i<numUVs; i++) {
+      if (primIDs[i] >= numQuads) {
+        process_error(RTC_INVALID_ARGUMENT,"invalid primitive ID");
+        return;
+      }
+    }
+
+    const char* data = (const char*) src;
+    for (size_t i=0; i<numUVs; i+=4)
+    {
+      /* gather 4 hits, the last hit is replicated to fill the SIMD lanes */
+      const size_t n = min(numUVs-i,size_t(4));
+      const char* ptr0[4]; const char* ptr1[4]; const char* ptr2[4]; const char* ptr3[4];
+      ssef U, V;
+      for (size_t j=0; j<4; j++) 
+      {
+        const size_t k = i+min(j,n-1);
+        const Quad& q = quad(primIDs[k]);
+        ptr0[j] = data + q.v[0]*byteStride;
+        ptr1[j] = data + q.v[1]*byteStride;
+        ptr2[j] = data + q.v[2]*byteStride;
+        ptr3[j] = data + q.v[3]*byteStride;
+        U[j] = u[k]; V[j] = v[k];
+      }
+
+      /* the hit coordinates of the second triangle v2,v3,v1 are mapped by (u,v) -> (1-u,1-v) */
+      const sseb first = U+V <= 1.0f;
+      const ssef W0 = 1.0f-U-V, W2 = U+V-1.0f;
+
+      /* interpolate all attribute components of the 4 hits in SIMD */
+      for (size_t c=0; c<numFloats; c++)
+      {
+        const size_t ofs = c*sizeof(float);
+        const ssef p0(*(float*)(ptr0[0]+ofs),*(float*)(ptr0[1]+ofs),*(float*)(ptr0[2]+ofs),*(float*)(ptr0[3]+ofs));
+        const ssef p1(*(float*)(ptr1[0]+ofs),*(float*)(ptr1[1]+ofs),*(float*)(ptr1[2]+ofs),*(float*)(ptr1[3]+ofs));
+        const ssef p2(*(float*)(ptr2[0]+ofs),*(float*)(ptr2[1]+ofs),*(float*)(ptr2[2]+ofs),*(float*)(ptr2[3]+ofs));
+        const ssef p3(*(float*)(ptr3[0]+ofs),*(float*)(ptr3[1]+ofs),*(float*)(ptr3[2]+ofs),*(float*)(ptr3[3]+ofs));
+        const ssef Pi = select(first, W0*p0 + U*p1 + V*p3, W2*p2 + (1.0f-V)*p1 + (1.0f-U)*p3);
+        const ssef dPdui = select(first, p1-p0, p2-p3);
+        const ssef dPdvi = select(first, p3-p0, p2-p1);
+        for (size_t j=0; j<n; j++) {
+          if (P   ) P   [c*numUVs+i+j] = Pi[j];
+          if (dPdu) dPdu[c*numUVs+i+j] = dPdui[j];
+          if (dPdv) dPdv[c*numUVs+i+j] = dPdvi[j];
+        }
+      }
+    }
+  }
+
+  void QuadMesh::write(std::ofstream& file)
+  {
+    int type = QUAD_MESH;
+    file.write((char*)&type,sizeof(int));
+    file.write((char*)&numVertices,sizeof(int));
+    file.write((char*)&numQuads,sizeof(int));
+
+    while ((file.tellp() % 16) != 0) { char c = 0; file.write(&c,1); }
+    for (size_t i=0; i<numVertices; i++) file.write((char*)vertices.getPtr(i),sizeof(Vec3fa));
+
+    while ((file.tellp() % 16) != 0) { char c = 0; file.write(&c,1); }
+    for (size_t i=0; i<numQuads; i++) file.write((char*)&quad(i),sizeof(Quad));
+  }
+}
@@ -0,0 +1,112 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "common/geometry.h"
+#include "common/buffer.h"
+
+namespace embree
+{
+  /*! Quad Mesh. Each quad v0,v1,v2,v3 gets intersected as the two
+   *  triangles v0,v1,v3 and v2,v3,v1. */
+  struct QuadMesh : public Geometry
+  {
+    static const GeometryTy geom_type = QUAD_MESH;
+
+    struct Quad {
+      unsigned int v[4];
+    };
+
+  public:
+    QuadMesh (Scene* parent, RTCGeometryFlags flags, size_t numQuads, size_t numVertices);
+
+    void write(std::ofstream& file);
+
+    /* geometry interface */
+  public:
+    void enabling();
+    void disabling();
+    void setMask (unsigned mask);
+    void setBuffer(RTCBufferType type, void* ptr, size_t offset, size_t stride);
+    void* map(RTCBufferType type);
+    void unmap(RTCBufferType type);
+    void immutable ();
+    bool verify ();
+    void interpolateN(const unsigned* primIDs, const float* u, const float* v, size_t numUVs, 
+                      const float* src, size_t byteStride, float* P, float* dPdu, float* dPdv, size_t numFloats);
+
+  public:
+
+    /*! returns number of quads */
+    __forceinline size_t size() const {
+      return numQuads;
+    }
+
+    /*! returns i'th quad */
+    __forceinline const Quad& quad(size_t i) const {
+      assert(i < numQuads);
+      return quads[i];
+    }
+
+    /*! returns i'th vertex */
+    __forceinline const Vec3fa vertex(size_t i) const
+    {
+      assert(i < numVertices);
+      return vertices[i];
+    }
+
+    /*! check if the i'th primitive is valid */
+    __forceinline bool valid(size_t i, BBox3fa* bbox = NULL) const
+    {
+      const Quad& q = quad(i);
+      if (q.v[0] >= numVertices) return false;
+      if (q.v[1] >= numVertices) return false;
+      if (q.v[2] >= numVertices) return false;
+      if (q.v[3] >= numVertices) return false;
+
+      const Vec3fa v0 = vertex(q.v[0]);
+      const Vec3fa v1 = vertex(q.v[1]);
+      const Vec3fa v2 = vertex(q.v[2]);
+      const Vec3fa v3 = vertex(q.v[3]);
+      if (!inFloatRange(v0) || !inFloatRange(v1) || !inFloatRange(v2) || !inFloatRange(v3))
+        return false;
+
+      if (bbox)
+	*bbox = BBox3fa(min(min(v0,v1),min(v2,v3)),max(max(v0,v1),max(v2,v3)));
+      return true;
+    }
+
+    /*! calculates the bounds of the i'th quad */
+    __forceinline BBox3fa bounds(size_t i) const
+    {
+      const Quad& q = quad(i);
+      const Vec3fa v0 = vertex(q.v[0]);
+      const Vec3fa v1 = vertex(q.v[1]);
+      const Vec3fa v2 = vertex(q.v[2]);
+      const Vec3fa v3 = vertex(q.v[3]);
+      return BBox3fa(min(min(v0,v1),min(v2,v3)),max(max(v0,v1),max(v2,v3)));
+    }
+
+  public:
+
+    BufferT<Quad> quads;              //!< array of quads
+    size_t numQuads;                  //!< number of quads
+
+    BufferT<Vec3fa> vertices;         //!< vertex array
+    size_t numVertices;               //!< number of vertices
+  };
+}
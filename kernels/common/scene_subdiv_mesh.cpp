@@ -16,17 +16,18 @@
 
 #include "scene_subdiv_mesh.h"
 #include "scene.h"
+#include "subdiv/feature_adaptive_eval.h"
 
 #include "algorithms/sort.h"
 #include "algorithms/prefix.h"
 #include "algorithms/parallel_for.h"
+#include "algorithms/parallel_reduce.h"
 
 namespace embree
 {
   SubdivMesh::SubdivMesh (Scene* parent, RTCGeometryFlags flags, size_t numFaces, size_t numEdges, size_t numVertices, 
 			  size_t numEdgeCreases, size_t numVertexCreases, size_t numHoles, size_t numTimeSteps)
     : Geometry(parent,SUBDIV_MESH,numFaces,numTimeSteps,flags), 
-      mask(-1), 
       numTimeSteps(numTimeSteps),
       numFaces(numFaces), 
       numEdges(numEdges), 
@@ -34,7 +35,14 @@ namespace embree
       numVertices(numVertices),
       displFunc(NULL), 
       displBounds(empty),
-      levelUpdate(false)
+      levelUpdate(false),
+      topologyUpdate(true),
+      patchUpdate(true),
+      viewDependent(false),
+      viewModified(false),
+      viewPosition(zero),
+      viewScale(0.0f),
+      faceLevelUpdate(false)
   {
     for (size_t i=0; i<numTimeSteps; i++)
        vertices[i].init(numVertices,sizeof(Vec3fa));
@@ -71,7 +79,7 @@ namespace embree
       process_error(RTC_INVALID_OPERATION,"static geometries cannot get modified");
       return;
     }
-    this->mask = mask; 
+    updateMask(mask);
   }
 
   void SubdivMesh::setBuffer(RTCBufferType type, void* ptr, size_t offset, size_t stride) 
@@ -215,6 +223,252 @@ namespace embree
     this->displFunc   = func;
     if (bounds) this->displBounds = *(BBox3fa*)bounds; 
     else        this->displBounds = empty;
+
+    /* the bounds of all patches depend on the displacement */
+    vertices[0].setModified(true);
+  }
+
+  void SubdivMesh::setViewDependentTessellation (const Vec3fa& position, float fovy, size_t resolution, float edgeLength)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      process_error(RTC_INVALID_OPERATION,"static geometries cannot get modified");
+      return;
+    }
+    if (edgeLength > 0.0f && (fovy <= 0.0f || fovy >= 180.0f || resolution == 0)) {
+      process_error(RTC_INVALID_ARGUMENT,"invalid camera parameters");
+      return;
+    }
+
+    /* an edge of length L at distance d covers L*viewScale/d target edge lengths */
+    viewDependent = edgeLength > 0.0f;
+    viewPosition = position;
+    viewScale = viewDependent ? float(resolution)/(2.0f*tanf(0.5f*deg2rad(fovy))*edgeLength) : 0.0f;
+    viewModified = true;
+
+    /* restore the levels of the level buffer when disabled */
+    if (!viewDependent) levels.setModified(true);
+    Geometry::update();
+  }
+
+  bool SubdivMesh::updateViewDependentLevels(bool trackFaces)
+  {
+    if (trackFaces) faceLevelUpdates.resize(numFaces);
+
+    return parallel_reduce(size_t(0),numFaces,size_t(4096),false,[&](const range<size_t>& r) -> bool
+    {
+      bool modified = false;
+      for (size_t f=r.begin(); f<r.end(); f++) 
+      {
+        /* both half edges of an edge get the same level, thus no cracks occur */
+        bool faceModified = false;
+        HalfEdge* edge = &halfEdges[faceStartEdge[f]];
+        for (size_t i=0; i<faceVertices[f]; i++)
+        {
+          const Vec3fa p0 = vertices[0][edge[i].vtx_index];
+          const Vec3fa p1 = vertices[0][edge[i].next()->vtx_index];
+          const float dist = max(length(0.5f*(p0+p1)-viewPosition),1E-6f);
+
+          /* levels are rounded up such that small camera moves keep most patches */
+          const float level = clamp(ceilf(viewScale*length(p1-p0)/dist),1.0f,4096.0f);
+          faceModified |= level != edge[i].edge_level;
+          edge[i].edge_level = level;
+        }
+        if (trackFaces) faceLevelUpdates[f] = faceModified;
+        modified |= faceModified;
+      }
+      return modified;
+    }, [](const bool a, const bool b) { return a || b; });
+  }
+
+  /*! location of an interpolated hit in the local coordinates of a sub-patch */
+  struct SubPatchHit 
+  {
+    size_t index;        //!< index of the hit in the arguments of interpolateN
+    float x, y;          //!< local coordinates inside the sub-patch
+    Vec2f duvdx, duvdy;  //!< derivatives of the face UVs with respect to the local coordinates
+  };
+
+  /*! finds the local coordinates xy of uv inside a sub-patch by
+   *  inverting the bilinear map of its corner UVs, returns how far xy
+   *  lies outside of the unit square */
+  static float invertSubPatchUVs(const Vec2f uvs[4], const Vec2f& uv, Vec2f& xy)
+  {
+    xy = Vec2f(0.5f,0.5f);
+    for (size_t iter=0; iter<8; iter++) 
+    {
+      const Vec2f uv01 = (1.0f-xy.x)*uvs[0] + xy.x*uvs[1];
+      const Vec2f uv32 = (1.0f-xy.x)*uvs[3] + xy.x*uvs[2];
+      const Vec2f uvxy = (1.0f-xy.y)*uv01 + xy.y*uv32;
+      const Vec2f duvdx = (1.0f-xy.y)*(uvs[1]-uvs[0]) + xy.y*(uvs[2]-uvs[3]);
+      const Vec2f duvdy = uv32-uv01;
+      const float det = duvdx.x*duvdy.y - duvdx.y*duvdy.x;
+      const Vec2f d = uv-uvxy;
+      xy.x += ( duvdy.y*d.x - duvdy.x*d.y)/det;
+      xy.y += (-duvdx.y*d.x + duvdx.x*d.y)/det;
+    }
+    const float dist = max(max(-xy.x,xy.x-1.0f),max(-xy.y,xy.y-1.0f));
+    return dist == dist ? dist : float(inf); // NaN if the iteration diverged
+  }
+
+  /*! evaluates the limit surface of a sub-patch and its partial
+   *  derivatives for all hits inside the sub-patch, each level of the
+   *  subdivision towards the regular sub-patches is shared by all hits
+   *  that fall into it */
+  template<typename Output>
+  static void evalLimitSurface(const CatmullClarkPatch& patch, size_t depth, float scale, SubPatchHit* hits, size_t N, const Output& output)
+  {
+    if (patch.isRegularOrFinal2(depth)) 
+    {
+      if (patch.isRegular()) 
+      {
+        BSplinePatch bpatch; bpatch.init(patch);
+#if defined(__MIC__)
+        for (size_t i=0; i<N; i++) {
+          const float x = hits[i].x, y = hits[i].y;
+          output(hits[i],bpatch.eval(x,y),bpatch.tangentU(x,y)*(scale/12.0f),bpatch.tangentV(x,y)*(scale/12.0f));
+        }
+#else
+        /* evaluate 4 hits at once, the last group repeats its last hit */
+        for (size_t i=0; i<N; i+=4) 
+        {
+          const size_t M = min(N-i,size_t(4));
+          const SubPatchHit& h0 = hits[i], &h1 = hits[i+min(size_t(1),M-1)], &h2 = hits[i+min(size_t(2),M-1)], &h3 = hits[i+M-1];
+          const ssef x(h0.x,h1.x,h2.x,h3.x), y(h0.y,h1.y,h2.y,h3.y);
+          const sse3f Pxy  = bpatch.eval4(x,y);
+          const sse3f dPdx = bpatch.tangentV4(x,y)*ssef(3.0f*scale); // tangentV4 differentiates in x and includes the 1/36 normalization
+          const sse3f dPdy = bpatch.tangentU4(x,y)*ssef(3.0f*scale);
+          for (size_t k=0; k<M; k++)
+            output(hits[i+k],Vec3fa(Pxy.x[k],Pxy.y[k],Pxy.z[k]),Vec3fa(dPdx.x[k],dPdx.y[k],dPdx.z[k]),Vec3fa(dPdy.x[k],dPdy.y[k],dPdy.z[k]));
+        }
+#endif
+      }
+      else 
+      {
+        const Vec3fa P0 = patch.ring[0].getLimitVertex();
+        const Vec3fa P1 = patch.ring[1].getLimitVertex();
+        const Vec3fa P2 = patch.ring[2].getLimitVertex();
+        const Vec3fa P3 = patch.ring[3].getLimitVertex();
+        for (size_t i=0; i<N; i++) {
+          const float x = hits[i].x, y = hits[i].y;
+          const Vec3fa P01 = (1.0f-x)*P0 + x*P1;
+          const Vec3fa P32 = (1.0f-x)*P3 + x*P2;
+          output(hits[i],(1.0f-y)*P01 + y*P32,((1.0f-y)*(P1-P0) + y*(P2-P3))*scale,(P32-P01)*scale);
+        }
+      }
+      return;
+    }
+
+    /* sort the hits into the quadrants of the sub-patches */
+    CatmullClarkPatch patches[4]; 
+    patch.subdivide(patches);
+    SubPatchHit* const end = hits+N;
+    SubPatchHit* const mid = std::partition(hits,end,[] (const SubPatchHit& hit) { return hit.y < 0.5f; });
+    SubPatchHit* const quadrant[5] = { hits, std::partition(hits,mid,[] (const SubPatchHit& hit) { return hit.x < 0.5f; }), mid, 
+                                       std::partition(mid,end,[] (const SubPatchHit& hit) { return hit.x >= 0.5f; }), end };
+    for (SubPatchHit* hit=hits; hit!=end; hit++) {
+      hit->x = 2.0f*hit->x - float(hit->x >= 0.5f);
+      hit->y = 2.0f*hit->y - float(hit->y >= 0.5f);
+    }
+    for (size_t i=0; i<4; i++) {
+      if (quadrant[i] == quadrant[i+1]) continue;
+      evalLimitSurface(patches[i],depth+1,2.0f*scale,quadrant[i],quadrant[i+1]-quadrant[i],output);
+    }
+  }
+
+  void SubdivMesh::interpolateN(const unsigned* primIDs, const float* u, const float* v, size_t numUVs, 
+                                const float* src, size_t byteStride, float* P, float* dPdu, float* dPdv, size_t numFloats)
+  {
+    for (size_t i=0; i<numUVs; i++) {
+      if (primIDs[i] >= numFaces) {
+        process_error(RTC_INVALID_ARGUMENT,"invalid primitive ID");
+        return;
+      }
+    }
+
+    /* group the hits by face, thus the patches of a face get build only once for all its hits */
+    std::vector<unsigned> order(numUVs);
+    for (size_t i=0; i<numUVs; i++) order[i] = i;
+    std::sort(order.begin(),order.end(),[&] (unsigned a, unsigned b) { return primIDs[a] < primIDs[b]; });
+
+    /* the attribute is evaluated in chunks of 3 components like the vertex positions */
+    std::vector<BufferT<Vec3fa> > buffers((numFloats+2)/3);
+    for (size_t c=0; c<buffers.size(); c++) {
+      buffers[c].init(numVertices,sizeof(Vec3fa));
+      buffers[c].set((char*)src+3*c*sizeof(float),0,byteStride);
+    }
+
+    std::vector<SubPatchHit> located, hits;
+    std::vector<size_t> subPatchOf;
+    std::vector<float> dist;
+    for (size_t b=0, e=0; b<numUVs; b=e)
+    {
+      const unsigned f = primIDs[order[b]];
+      for (e=b+1; e<numUVs && primIDs[order[e]] == f; e++);
+      const size_t N = e-b;
+
+      /* locate each hit in the sub-patch containing it, or in the nearest sub-patch if the inversion fails */
+      located.resize(N); subPatchOf.assign(N,size_t(-1)); dist.assign(N,float(inf));
+      size_t numSubPatches = 0;
+      feature_adaptive_subdivision_eval(getHalfEdge(f),buffers[0],
+                                        [&](const CatmullClarkPatch& patch, const Vec2f uvs[4], const int subdiv[4], const int id)
+      {
+        for (size_t i=0; i<N; i++) 
+        {
+          if (dist[i] <= 0.0f) continue;
+          Vec2f xy; const float d = invertSubPatchUVs(uvs,Vec2f(u[order[b+i]],v[order[b+i]]),xy);
+          if (subPatchOf[i] != size_t(-1) && d >= dist[i]) continue;
+          xy.x = d == float(inf) ? 0.5f : clamp(xy.x,0.0f,1.0f);
+          xy.y = d == float(inf) ? 0.5f : clamp(xy.y,0.0f,1.0f);
+          SubPatchHit& hit = located[i];
+          hit.index = order[b+i]; hit.x = xy.x; hit.y = xy.y;
+          hit.duvdx = (1.0f-xy.y)*(uvs[1]-uvs[0]) + xy.y*(uvs[2]-uvs[3]);
+          hit.duvdy = ((1.0f-xy.x)*uvs[3] + xy.x*uvs[2]) - ((1.0f-xy.x)*uvs[0] + xy.x*uvs[1]);
+          subPatchOf[i] = numSubPatches; dist[i] = d;
+        }
+        numSubPatches++;
+      });
+
+      /* faces without sub-patches, e.g. holes, evaluate to zero */
+      if (numSubPatches == 0) 
+      {
+        for (size_t i=b; i<e; i++) {
+          for (size_t j=0; j<numFloats; j++) {
+            if (P   ) P   [j*numUVs+order[i]] = 0.0f;
+            if (dPdu) dPdu[j*numUVs+order[i]] = 0.0f;
+            if (dPdv) dPdv[j*numUVs+order[i]] = 0.0f;
+          }
+        }
+        continue;
+      }
+
+      for (size_t c=0; c<buffers.size(); c++)
+      {
+        const size_t numComponents = min(numFloats-3*c,size_t(3));
+        auto output = [&] (const SubPatchHit& hit, const Vec3fa& Pxy, const Vec3fa& dPdx, const Vec3fa& dPdy)
+        {
+          /* transform the derivatives into the UV space of the face */
+          const float rcpDet = 1.0f/(hit.duvdx.x*hit.duvdy.y - hit.duvdx.y*hit.duvdy.x);
+          const Vec3fa dPdui = ( dPdx*hit.duvdy.y - dPdy*hit.duvdx.y)*rcpDet;
+          const Vec3fa dPdvi = (-dPdx*hit.duvdy.x + dPdy*hit.duvdx.x)*rcpDet;
+          for (size_t j=0; j<numComponents; j++) {
+            if (P   ) P   [(3*c+j)*numUVs+hit.index] = Pxy[j];
+            if (dPdu) dPdu[(3*c+j)*numUVs+hit.index] = dPdui[j];
+            if (dPdv) dPdv[(3*c+j)*numUVs+hit.index] = dPdvi[j];
+          }
+        };
+
+        size_t subPatch = 0;
+        feature_adaptive_subdivision_eval(getHalfEdge(f),buffers[c],
+                                          [&](const CatmullClarkPatch& patch, const Vec2f uvs[4], const int subdiv[4], const int id)
+        {
+          hits.clear();
+          for (size_t i=0; i<N; i++)
+            if (subPatchOf[i] == subPatch) hits.push_back(located[i]);
+          subPatch++;
+          if (hits.size()) evalLimitSurface(patch,0,1.0f,hits.data(),hits.size(),output);
+        });
+      }
+    }
   }
 
   void SubdivMesh::immutable () 
@@ -394,6 +648,9 @@ namespace embree
     recalculate |= faceVertices.isModified();
     recalculate |= holes.isModified();
 
+    /* check if the creases got modified */
+    const bool updateCreases = edge_creases.isModified() || edge_crease_weights.isModified() || vertex_creases.isModified() || vertex_crease_weights.isModified();
+
     /* check if we can simply update the half edges */
     bool update = false;
     update |= edge_creases.isModified();
@@ -402,14 +659,28 @@ namespace embree
     update |= vertex_crease_weights.isModified(); 
     update |= levels.isModified();
 
+    /* now either recalculate or update the half edges */
+    if (recalculate) calculateHalfEdges();
+    else if (update) updateHalfEdges();
+
+    /* calculate view dependent edge levels, if only the camera moved we track which faces changed */
+    const bool onlyViewModified = !(recalculate || update || vertices[0].isModified() || vertices[1].isModified());
+    bool viewLevelsModified = false;
+    faceLevelUpdate = false;
+    if (viewDependent && (viewModified || !onlyViewModified)) {
+      viewLevelsModified = updateViewDependentLevels(onlyViewModified);
+      faceLevelUpdate = onlyViewModified;
+    }
+    viewModified = false;
+
     /* check whether we can simply update the bvh in cached mode */
     levelUpdate = false;
-    if (!(recalculate || edge_creases.size() != 0 || vertex_creases.size() !=0) && levels.isModified())
+    if (!(recalculate || edge_creases.size() != 0 || vertex_creases.size() !=0) && (levels.isModified() || viewLevelsModified))
       levelUpdate = true;
 
-    /* now either recalculate or update the half edges */
-    if (recalculate) calculateHalfEdges();
-    else if (update) updateHalfEdges();
+    /* check whether the patches have to get regenerated and whether their number might have changed */
+    topologyUpdate = recalculate || updateCreases;
+    patchUpdate = topologyUpdate || vertices[0].isModified() || vertices[1].isModified() || levels.isModified() || viewLevelsModified;
 
     /* cleanup some state for static scenes */
     if (parent->isStatic()) 
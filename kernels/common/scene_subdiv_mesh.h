@@ -339,6 +339,9 @@ namespace embree
     void immutable ();
     bool verify ();
     void setDisplacementFunction (RTCDisplacementFunc func, RTCBounds* bounds);
+    void setViewDependentTessellation (const Vec3fa& position, float fovy, size_t resolution, float edgeLength);
+    void interpolateN(const unsigned* primIDs, const float* u, const float* v, size_t numUVs, 
+                      const float* src, size_t byteStride, float* P, float* dPdu, float* dPdv, size_t numFloats);
 
   public:
 
@@ -360,7 +363,6 @@ namespace embree
 
     /*! initializes the half edge data structure */
     void initializeHalfEdgeStructures ();
-
   private:
 
     /*! recalculates the half edges */
@@ -369,6 +371,9 @@ namespace embree
     /*! updates half edges when recalculation is not necessary */
     void updateHalfEdges();
 
+    /*! calculates the view dependent edge levels, returns true if some level changed */
+    bool updateViewDependentLevels(bool trackFaces);
+
   public:
     /*! returns the start half edge for some face */
     __forceinline const HalfEdge* getHalfEdge ( const size_t f ) const { 
@@ -383,7 +388,6 @@ namespace embree
     //__forceinline const Vec3fa*   getVertexPositionPtr( const unsigned t = 0 ) const { return (Vec3fa*)vertices[t].getPtr(); } // FIXME: this function should never get used, always pass BufferT<Vec3fa> object
 
   public:
-    unsigned int mask;                //!< for masking out geometry
     unsigned int numTimeSteps;        //!< number of time steps (1 or 2)  // FIXME: remove
 
     RTCDisplacementFunc displFunc;    //!< displacement function
@@ -455,9 +459,35 @@ namespace embree
      *  allows for simple bvh update instead of full rebuild in cached mode */
     bool levelUpdate;
 
+    /*! flag whether the number of patches of the mesh might have changed,
+     *  as the indices, faces, holes, or creases got modified */
+    bool topologyUpdate;
+
+    /*! flag whether the patches of the mesh have to get regenerated */
+    bool patchUpdate;
+
+    /*! camera for view dependent edge levels */
+    bool viewDependent;
+    bool viewModified;
+    Vec3fa viewPosition;
+    float viewScale;
+
+    /*! flag whether only the view dependent levels of the faces marked in faceLevelUpdates changed */
+    bool faceLevelUpdate;
+    std::vector<char> faceLevelUpdates;
+
   public:
     /* check for simple edge level update */
     __forceinline bool checkLevelUpdate() { return levelUpdate; }
 
+    /* check for modified topology */
+    __forceinline bool checkTopologyUpdate() { return topologyUpdate; }
+
+    /* check for modified patches */
+    __forceinline bool checkPatchUpdate() { return patchUpdate; }
+
+    /* check for modified patches of some face */
+    __forceinline bool checkFaceUpdate(size_t f) { return patchUpdate && (!faceLevelUpdate || faceLevelUpdates[f]); }
+
   };
 };
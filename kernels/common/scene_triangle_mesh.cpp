@@ -21,7 +21,7 @@ namespace embree
 {
   TriangleMesh::TriangleMesh (Scene* parent, RTCGeometryFlags flags, size_t numTriangles, size_t numVertices, size_t numTimeSteps)
     : Geometry(parent,TRIANGLE_MESH,numTriangles,numTimeSteps,flags), 
-      mask(-1), numTimeSteps(numTimeSteps),
+      numTimeSteps(numTimeSteps),
       numTriangles(numTriangles), numVertices(numVertices)
   {
     triangles.init(numTriangles,sizeof(Triangle));
@@ -49,7 +49,7 @@ namespace embree
       process_error(RTC_INVALID_OPERATION,"static geometries cannot get modified");
       return;
     }
-    this->mask = mask; 
+    updateMask(mask);
   }
 
   void TriangleMesh::setBuffer(RTCBufferType type, void* ptr, size_t offset, size_t stride) 
@@ -79,21 +79,16 @@ namespace embree
     case RTC_INDEX_BUFFER  : 
       triangles.set(ptr,offset,stride); 
       break;
-    case RTC_VERTEX_BUFFER0: 
-      vertices[0].set(ptr,offset,stride); 
-      if (numVertices) {
-        /* test if array is properly padded */
-        volatile int w = *((int*)vertices[0].getPtr(numVertices-1)+3); // FIXME: is failing hard avoidable?
-      }
-      break;
-    case RTC_VERTEX_BUFFER1: 
-      vertices[1].set(ptr,offset,stride); 
-      if (numVertices) {
-        /* test if array is properly padded */
-        volatile int w = *((int*)vertices[1].getPtr(numVertices-1)+3); // FIXME: is failing hard avoidable?
-      }
-      break;
     default: 
+      if (type >= RTC_VERTEX_BUFFER0 && type < RTC_VERTEX_BUFFER0+numTimeSteps) {
+        const size_t t = type - RTC_VERTEX_BUFFER0;
+        vertices[t].set(ptr,offset,stride); 
+        if (numVertices) {
+          /* test if array is properly padded */
+          volatile int w = *((int*)vertices[t].getPtr(numVertices-1)+3); // FIXME: is failing hard avoidable?
+        }
+        break;
+      }
       process_error(RTC_INVALID_ARGUMENT,"unknown buffer type");
       break;
     }
@@ -106,12 +101,12 @@ namespace embree
       return NULL;
     }
 
-    switch (type) {
-    case RTC_INDEX_BUFFER  : return triangles  .map(parent->numMappedBuffers);
-    case RTC_VERTEX_BUFFER0: return vertices[0].map(parent->numMappedBuffers);
-    case RTC_VERTEX_BUFFER1: return vertices[1].map(parent->numMappedBuffers);
-    default                : process_error(RTC_INVALID_ARGUMENT,"unknown buffer type"); return NULL;
-    }
+    if (type == RTC_INDEX_BUFFER) 
+      return triangles.map(parent->numMappedBuffers);
+    if (type >= RTC_VERTEX_BUFFER0 && type < RTC_VERTEX_BUFFER0+numTimeSteps) 
+      return vertices[type-RTC_VERTEX_BUFFER0].map(parent->numMappedBuffers);
+    process_error(RTC_INVALID_ARGUMENT,"unknown buffer type"); 
+    return NULL;
   }
 
   void TriangleMesh::unmap(RTCBufferType type) 
@@ -121,12 +116,12 @@ namespace embree
       return;
     }
 
-    switch (type) {
-    case RTC_INDEX_BUFFER  : triangles  .unmap(parent->numMappedBuffers); break;
-    case RTC_VERTEX_BUFFER0: vertices[0].unmap(parent->numMappedBuffers); break;
-    case RTC_VERTEX_BUFFER1: vertices[1].unmap(parent->numMappedBuffers); break;
-    default                : process_error(RTC_INVALID_ARGUMENT,"unknown buffer type"); break;
-    }
+    if (type == RTC_INDEX_BUFFER) 
+      triangles.unmap(parent->numMappedBuffers);
+    else if (type >= RTC_VERTEX_BUFFER0 && type < RTC_VERTEX_BUFFER0+numTimeSteps) 
+      vertices[type-RTC_VERTEX_BUFFER0].unmap(parent->numMappedBuffers);
+    else 
+      process_error(RTC_INVALID_ARGUMENT,"unknown buffer type");
   }
 
   void TriangleMesh::immutable () 
@@ -134,8 +129,8 @@ namespace embree
     bool freeTriangles = !parent->needTriangles;
     bool freeVertices  = !parent->needVertices;
     if (freeTriangles) triangles.free();
-    if (freeVertices ) vertices[0].free();
-    if (freeVertices ) vertices[1].free();
+    if (freeVertices ) 
+      for (size_t j=0; j<numTimeSteps; j++) vertices[j].free();
   }
 
   bool TriangleMesh::verify () 
@@ -155,6 +150,58 @@ namespace embree
     return true;
   }
 
+  void TriangleMesh::interpolateN(const unsigned* primIDs, const float* u, const float* v, size_t numUVs, 
+                                  const float* src, size_t byteStride, float* P, float* dPdu, float* dPdv, size_t numFloats)
+  {
+    if (!triangles) {
+      process_error(RTC_INVALID_OPERATION,"index buffer got released, share it to interpolate in static scenes");
+      return;
+    }
+
+    for (size_t i=0; i<numUVs; i++) {
+      if (primIDs[i] >= numTriangles) {
+        process_error(RTC_INVALID_ARGUMENT,"invalid primitive ID");
+        return;
+      }
+    }
+
+    const char* data = (const char*) src;
+    for (size_t i=0; i<numUVs; i+=4)
+    {
+      /* gather 4 hits, the last hit is replicated to fill the SIMD lanes */
+      const size_t n = min(numUVs-i,size_t(4));
+      const char* ptr0[4]; const char* ptr1[4]; const char* ptr2[4];
+      ssef U, V;
+      for (size_t j=0; j<4; j++) 
+      {
+        const size_t k = i+min(j,n-1);
+        const Triangle& tri = triangle(primIDs[k]);
+        ptr0[j] = data + tri.v[0]*byteStride;
+        ptr1[j] = data + tri.v[1]*byteStride;
+        ptr2[j] = data + tri.v[2]*byteStride;
+        U[j] = u[k]; V[j] = v[k];
+      }
+      const ssef W = 1.0f-U-V;
+
+      /* interpolate all attribute components of the 4 hits in SIMD */
+      for (size_t c=0; c<numFloats; c++)
+      {
+        const size_t ofs = c*sizeof(float);
+        const ssef p0(*(float*)(ptr0[0]+ofs),*(float*)(ptr0[1]+ofs),*(float*)(ptr0[2]+ofs),*(float*)(ptr0[3]+ofs));
+        const ssef p1(*(float*)(ptr1[0]+ofs),*(float*)(ptr1[1]+ofs),*(float*)(ptr1[2]+ofs),*(float*)(ptr1[3]+ofs));
+        const ssef p2(*(float*)(ptr2[0]+ofs),*(float*)(ptr2[1]+ofs),*(float*)(ptr2[2]+ofs),*(float*)(ptr2[3]+ofs));
+        const ssef Pi = W*p0 + U*p1 + V*p2;
+        const ssef dPdui = p1-p0;
+        const ssef dPdvi = p2-p0;
+        for (size_t j=0; j<n; j++) {
+          if (P   ) P   [c*numUVs+i+j] = Pi[j];
+          if (dPdu) dPdu[c*numUVs+i+j] = dPdui[j];
+          if (dPdv) dPdv[c*numUVs+i+j] = dPdvi[j];
+        }
+      }
+    }
+  }
+
   void TriangleMesh::write(std::ofstream& file)
   {
     int type = TRIANGLE_MESH;
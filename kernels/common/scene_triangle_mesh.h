@@ -45,6 +45,8 @@ namespace embree
     void unmap(RTCBufferType type);
     void immutable ();
     bool verify ();
+    void interpolateN(const unsigned* primIDs, const float* u, const float* v, size_t numUVs, 
+                      const float* src, size_t byteStride, float* P, float* dPdu, float* dPdv, size_t numFloats);
 
   public:
 
@@ -120,6 +122,16 @@ namespace embree
       return BBox3fa(min(v0,v1,v2),max(v0,v1,v2));
     }
 
+    /*! calculates the bounds of the i'th triangle at the j'th timestep */
+    __forceinline BBox3fa bounds(size_t i, size_t j) const 
+    {
+      const Triangle& tri = triangle(i);
+      const Vec3fa v0 = vertex(tri.v[0],j);
+      const Vec3fa v1 = vertex(tri.v[1],j);
+      const Vec3fa v2 = vertex(tri.v[2],j);
+      return BBox3fa(min(v0,v1,v2),max(v0,v1,v2));
+    }
+
 #if defined(__MIC__)
 
 
@@ -181,13 +193,12 @@ namespace embree
 #endif
     
   public:
-    unsigned int mask;                //!< for masking out geometry
-    unsigned int numTimeSteps;        //!< number of time steps (1 or 2) // FIXME: remove
+    unsigned int numTimeSteps;        //!< number of time steps (1 to RTC_MAX_TIME_STEPS) // FIXME: remove
     
     BufferT<Triangle> triangles;      //!< array of triangles
     size_t numTriangles;              //!< number of triangles
     
-    BufferT<Vec3fa> vertices[2];    //!< vertex array
+    BufferT<Vec3fa> vertices[RTC_MAX_TIME_STEPS]; //!< vertex array for each time step
     size_t numVertices;               //!< number of vertices
   };
 
@@ -88,6 +88,14 @@ namespace embree
     intersectors.intersector16.ispc = ispc;
   }
 
+  void UserGeometry::setIntersectFunctionN (RTCIntersectFuncN intersectN) {
+    intersectors.intersectorN.intersect = intersectN;
+  }
+
+  void UserGeometry::setOccludedFunctionN (RTCOccludedFuncN occludedN) {
+    intersectors.intersectorN.occluded = occludedN;
+  }
+
   extern RTCBoundsFunc InstanceBoundsFunc;
   extern AccelSet::Intersector1 InstanceIntersector1;
   extern AccelSet::Intersector4 InstanceIntersector4;
@@ -95,7 +103,7 @@ namespace embree
   extern AccelSet::Intersector16 InstanceIntersector16;
 
   Instance::Instance (Scene* parent, Accel* object) 
-    : UserGeometryBase(parent,USER_GEOMETRY,1), local2world(one), world2local(one), object(object)
+    : UserGeometryBase(parent,USER_GEOMETRY,1), local2world(one), world2local(one), translation(true), object(object)
   {
     intersectors.ptr = this;
     boundsFunc = InstanceBoundsFunc;
@@ -109,5 +117,66 @@ namespace embree
   {
     local2world = xfm;
     world2local = rcp(xfm);
+    translation = xfm.l == LinearSpace3fa(one);
+  }
+
+  InstanceArray::InstanceArray (Scene* parent, Accel* object, size_t numInstances, unsigned baseID) 
+    : Geometry(parent,INSTANCE_ARRAY,numInstances,1,RTC_GEOMETRY_STATIC), object(object), baseID(baseID)
+  {
+    transforms.init(numInstances,sizeof(Transform));
+    enabling();
+  }
+
+  void InstanceArray::enabling () { 
+    atomic_add(&parent->numArrayInstances,size()); 
+  }
+  
+  void InstanceArray::disabling() { 
+    atomic_add(&parent->numArrayInstances,-(ssize_t)size()); 
+  }
+
+  void InstanceArray::setBuffer(RTCBufferType type, void* ptr, size_t offset, size_t stride)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      process_error(RTC_INVALID_OPERATION,"static geometries cannot get modified");
+      return;
+    }
+
+    /* verify that all accesses are 4 bytes aligned */
+    if (((size_t(ptr) + offset) & 0x3) || (stride & 0x3)) {
+      process_error(RTC_INVALID_OPERATION,"data must be 4 bytes aligned");
+      return;
+    }
+
+    switch (type) {
+    case RTC_TRANSFORM_BUFFER: transforms.set(ptr,offset,stride); break;
+    default                  : process_error(RTC_INVALID_ARGUMENT,"unknown buffer type"); break;
+    }
+  }
+
+  void* InstanceArray::map(RTCBufferType type)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      process_error(RTC_INVALID_OPERATION,"static geometries cannot get modified");
+      return NULL;
+    }
+
+    switch (type) {
+    case RTC_TRANSFORM_BUFFER: return transforms.map(parent->numMappedBuffers);
+    default                  : process_error(RTC_INVALID_ARGUMENT,"unknown buffer type"); return NULL;
+    }
+  }
+
+  void InstanceArray::unmap(RTCBufferType type)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      process_error(RTC_INVALID_OPERATION,"static geometries cannot get modified");
+      return;
+    }
+
+    switch (type) {
+    case RTC_TRANSFORM_BUFFER: transforms.unmap(parent->numMappedBuffers); break;
+    default                  : process_error(RTC_INVALID_ARGUMENT,"unknown buffer type"); break;
+    }
   }
 }
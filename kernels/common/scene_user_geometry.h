@@ -20,6 +20,7 @@
 #include "common/accel.h"
 #include "common/accelset.h"
 #include "common/geometry.h"
+#include "common/buffer.h"
 
 namespace embree
 {
@@ -60,6 +61,8 @@ namespace embree
     virtual void setOccludedFunction4 (RTCOccludedFunc4 occluded4, bool ispc);
     virtual void setOccludedFunction8 (RTCOccludedFunc8 occluded8, bool ispc);
     virtual void setOccludedFunction16 (RTCOccludedFunc16 occluded16, bool ispc);
+    virtual void setIntersectFunctionN (RTCIntersectFuncN intersectN);
+    virtual void setOccludedFunctionN (RTCOccludedFuncN occludedN);
     virtual void build(size_t threadIndex, size_t threadCount) {}
   };
   
@@ -73,6 +76,63 @@ namespace embree
   public:
     AffineSpace3fa local2world;
     AffineSpace3fa world2local;
+    bool translation;   //!< true if the transformation is a pure translation
     Accel* object;
   };
+
+  struct InstanceArray : public Geometry
+  {
+    static const GeometryTy geom_type = INSTANCE_ARRAY;
+
+    /*! column major transformation as stored in the transform buffer */
+    struct Transform { 
+      float vx[3], vy[3], vz[3], p[3]; 
+    };
+
+  public:
+    InstanceArray (Scene* parent, Accel* object, size_t numInstances, unsigned baseID); 
+    virtual void setBuffer(RTCBufferType type, void* ptr, size_t offset, size_t stride);
+    virtual void* map(RTCBufferType type);
+    virtual void unmap(RTCBufferType type);
+    void enabling ();
+    void disabling();
+
+    /*! returns the number of instances */
+    __forceinline size_t size() const {
+      return transforms.size();
+    }
+
+    /*! returns the local to world transformation of the i'th instance */
+    __forceinline AffineSpace3fa getTransform(size_t i) const 
+    {
+      const Transform& xfm = transforms[i];
+      return AffineSpace3fa(Vec3fa(xfm.vx[0],xfm.vx[1],xfm.vx[2]),
+                            Vec3fa(xfm.vy[0],xfm.vy[1],xfm.vy[2]),
+                            Vec3fa(xfm.vz[0],xfm.vz[1],xfm.vz[2]),
+                            Vec3fa(xfm.p [0],xfm.p [1],xfm.p [2]));
+    }
+
+    /*! calculates the bounds of the i'th instance */
+    __forceinline BBox3fa bounds(size_t i) const {
+      return xfmBounds(getTransform(i),object->bounds);
+    }
+
+    /*! check if the i'th instance is valid */
+    __forceinline bool valid(size_t i, BBox3fa* bbox = NULL) const 
+    {
+      const BBox3fa b = bounds(i);
+      if (bbox) *bbox = b;
+      return inFloatRange(b);
+    }
+
+    /*! returns the instance ID reported for hits of the i'th instance */
+    __forceinline int instID(size_t i) const {
+      return baseID + unsigned(i);
+    }
+    
+  public:
+    BufferT<Transform> transforms;  //!< local to world transformation of each instance
+    Accel* object;
+    unsigned baseID;                //!< instance ID of the first instance
+  };
 }
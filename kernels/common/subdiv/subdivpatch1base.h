@@ -736,6 +736,68 @@ namespace embree
     return o;
   } 
 
+#if !defined(__MIC__)
+
+  /* displaces the first N points of an evaluated grid, the displacement function is called for batches of up to 256
+     points with 64 byte aligned arrays that are padded to a multiple of 16 points by replicating the last point */
+  static __noinline void displaceGrid(const SubdivPatch1Base &patch,
+                                      float *__restrict__ const grid_x,
+                                      float *__restrict__ const grid_y,
+                                      float *__restrict__ const grid_z,
+                                      const float *__restrict__ const grid_u,
+                                      const float *__restrict__ const grid_v,
+                                      const SubdivMesh* const geom,
+                                      const size_t N)
+  {
+    static const size_t BATCH_SIZE = 256;
+    __aligned(64) float patch_u[BATCH_SIZE], patch_v[BATCH_SIZE];
+    __aligned(64) float nx[BATCH_SIZE], ny[BATCH_SIZE], nz[BATCH_SIZE];
+    __aligned(64) float px[BATCH_SIZE], py[BATCH_SIZE], pz[BATCH_SIZE];
+
+    const Vec2f uv0 = patch.getUV(0);
+    const Vec2f uv1 = patch.getUV(1);
+    const Vec2f uv2 = patch.getUV(2);
+    const Vec2f uv3 = patch.getUV(3);
+
+    /* N is a multiple of the SIMD width */
+    for (size_t i0=0; i0<N; i0+=BATCH_SIZE)
+    {
+      const size_t n = min(N-i0,BATCH_SIZE);
+      for (size_t i=0; i<n; i+=4)
+      {
+        const ssef uu = load4f(&grid_u[i0+i]);
+        const ssef vv = load4f(&grid_v[i0+i]);
+        const sse3f normal = normalize_safe(patch.normal4(uu,vv));
+        store4f(&nx[i],normal.x);
+        store4f(&ny[i],normal.y);
+        store4f(&nz[i],normal.z);
+        store4f(&patch_u[i],bilinear_interpolate(uv0.x,uv1.x,uv2.x,uv3.x,uu,vv));
+        store4f(&patch_v[i],bilinear_interpolate(uv0.y,uv1.y,uv2.y,uv3.y,uu,vv));
+        store4f(&px[i],loadu4f(&grid_x[i0+i]));
+        store4f(&py[i],loadu4f(&grid_y[i0+i]));
+        store4f(&pz[i],loadu4f(&grid_z[i0+i]));
+      }
+      for (size_t i=n; i<((n+15)&(-16)); i++)
+      {
+        patch_u[i] = patch_u[n-1]; patch_v[i] = patch_v[n-1];
+        nx[i] = nx[n-1]; ny[i] = ny[n-1]; nz[i] = nz[n-1];
+        px[i] = px[n-1]; py[i] = py[n-1]; pz[i] = pz[n-1];
+      }
+
+      geom->displFunc(geom->userPtr,patch.geom,patch.prim,
+                      patch_u,patch_v,nx,ny,nz,px,py,pz,n);
+
+      for (size_t i=0; i<n; i+=4)
+      {
+        storeu4f(&grid_x[i0+i],load4f(&px[i]));
+        storeu4f(&grid_y[i0+i],load4f(&py[i]));
+        storeu4f(&grid_z[i0+i],load4f(&pz[i]));
+      }
+    }
+  }
+
+#endif
+
   /* eval grid over patch and stich edges when required */      
   static __forceinline void evalGrid(const SubdivPatch1Base &patch,
                                      float *__restrict__ const grid_x,
@@ -826,33 +888,6 @@ namespace embree
         avxf uu = load8f(&grid_u[8*i]);
         avxf vv = load8f(&grid_v[8*i]);
         avx3f vtx = patch.eval8(uu,vv);
-                 
-        if (unlikely(((SubdivMesh*)geom)->displFunc != NULL))
-          {
-	    const Vec2f uv0 = patch.getUV(0);
-	    const Vec2f uv1 = patch.getUV(1);
-	    const Vec2f uv2 = patch.getUV(2);
-	    const Vec2f uv3 = patch.getUV(3);
-
-            avx3f normal = patch.normal8(uu,vv);
-            normal = normalize_safe(normal) ;
-            
-            const avxf patch_uu = bilinear_interpolate(uv0.x,uv1.x,uv2.x,uv3.x,uu,vv);
-            const avxf patch_vv = bilinear_interpolate(uv0.y,uv1.y,uv2.y,uv3.y,uu,vv);
-            
-            ((SubdivMesh*)geom)->displFunc(((SubdivMesh*)geom)->userPtr,
-                                           patch.geom,
-                                           patch.prim,
-                                           (const float*)&patch_uu,
-                                           (const float*)&patch_vv,
-                                           (const float*)&normal.x,
-                                           (const float*)&normal.y,
-                                           (const float*)&normal.z,
-                                           (float*)&vtx.x,
-                                           (float*)&vtx.y,
-                                           (float*)&vtx.z,
-                                           8);
-          }
         *(avxf*)&grid_x[8*i] = vtx.x;
         *(avxf*)&grid_y[8*i] = vtx.y;
         *(avxf*)&grid_z[8*i] = vtx.z;        
@@ -863,40 +898,15 @@ namespace embree
         ssef uu = load4f(&grid_u[4*i]);
         ssef vv = load4f(&grid_v[4*i]);
         sse3f vtx = patch.eval4(uu,vv);
-          
-          
-        if (unlikely(((SubdivMesh*)geom)->displFunc != NULL))
-          {
-	    const Vec2f uv0 = patch.getUV(0);
-	    const Vec2f uv1 = patch.getUV(1);
-	    const Vec2f uv2 = patch.getUV(2);
-	    const Vec2f uv3 = patch.getUV(3);
-
-            sse3f normal = patch.normal4(uu,vv);
-            normal = normalize_safe(normal);
-
-            const ssef patch_uu = bilinear_interpolate(uv0.x,uv1.x,uv2.x,uv3.x,uu,vv);
-            const ssef patch_vv = bilinear_interpolate(uv0.y,uv1.y,uv2.y,uv3.y,uu,vv);
-            
-            ((SubdivMesh*)geom)->displFunc(((SubdivMesh*)geom)->userPtr,
-                                           patch.geom,
-                                           patch.prim,
-                                           (const float*)&patch_uu,
-                                           (const float*)&patch_vv,
-                                           (const float*)&normal.x,
-                                           (const float*)&normal.y,
-                                           (const float*)&normal.z,
-                                           (float*)&vtx.x,
-                                           (float*)&vtx.y,
-                                           (float*)&vtx.z,
-                                           4);
-          }
-          
         *(ssef*)&grid_x[4*i] = vtx.x;
         *(ssef*)&grid_y[4*i] = vtx.y;
         *(ssef*)&grid_z[4*i] = vtx.z;        
       }
 #endif
+
+    /* eval displacement function */
+    if (unlikely(geom->displFunc != NULL))
+      displaceGrid(patch,grid_x,grid_y,grid_z,grid_u,grid_v,geom,patch.grid_size_simd_blocks*SIMD_WIDTH);
 #endif        
   }
 
@@ -34,7 +34,7 @@ namespace embree
 
   void clearTessellationCache()
   {
-    SharedLazyTessellationCache::sharedLazyTessellationCache.addCurrentIndex(SharedLazyTessellationCache::NUM_CACHE_REGIONS);
+    SharedLazyTessellationCache::sharedLazyTessellationCache.invalidate();
   }
   
   /* alloc cache memory */
@@ -59,6 +59,8 @@ namespace embree
     index                  = 0; // 1
     next_block             = 0;
     numRenderThreads       = 0;
+    numFlushes             = 0;
+    reset_index            = 0;
 #if FORCE_SIMPLE_FLUSH == 1
     switch_block_threshold = maxBlocks;
 #else
@@ -149,6 +151,7 @@ namespace embree
 #endif
 
 	    CACHE_STATS(SharedTessellationCacheStats::cache_flushes++);
+	    numFlushes++;
 
 	    for (size_t i=0;i<numRenderThreads;i++)
 	      unlockThread(i);
@@ -165,20 +168,75 @@ namespace embree
 
   void SharedLazyTessellationCache::realloc(const size_t new_size)
   {
+    /* report growing cache before allocating memory, such that the memory monitor can cancel */
+    if (new_size > size)
+      memoryMonitor(new_size-size,false);
+
     if (data)
       {
 	os_free(data,size);
       }
+    const size_t old_size = size;
     size      = new_size;
     data      = (float*)os_malloc(size);
     maxBlocks = size/64;    
+
+    if (new_size < old_size)
+      memoryMonitor(-(ssize_t)(old_size-new_size),true);
+
+    /* all entries point into the old memory */
+    invalidate();
+
+    if (g_verbose >= 1)
+      std::cout << "Reallocating tessellation cache to " << size << " bytes, " << maxBlocks << " 64-byte blocks" << std::endl;
+  }
+
+  void SharedLazyTessellationCache::invalidate()
+  {
+    addCurrentIndex(NUM_CACHE_REGIONS);
+    reset_index = index;
 #if FORCE_SIMPLE_FLUSH == 1
+    next_block = 0;
     switch_block_threshold = maxBlocks;
 #else
-    switch_block_threshold = maxBlocks/NUM_CACHE_REGIONS;
+    const size_t region = index % NUM_CACHE_REGIONS;
+    next_block = region * (maxBlocks/NUM_CACHE_REGIONS);
+    switch_block_threshold = next_block + (maxBlocks/NUM_CACHE_REGIONS);
 #endif
+  }
 
-    std::cout << "Reallocating tessellation cache to " << size << " bytes, " << maxBlocks << " 64-byte blocks" << std::endl;
+  size_t SharedLazyTessellationCache::getNumUsedBytes()
+  {
+#if FORCE_SIMPLE_FLUSH == 1
+    return min((size_t)next_block,maxBlocks) * 64;
+#else
+    const size_t regionBlocks = maxBlocks/NUM_CACHE_REGIONS;
+    const size_t regionStart  = switch_block_threshold - regionBlocks;
+    const size_t oldRegions   = min(index - reset_index,NUM_CACHE_REGIONS-1);
+    return (oldRegions*regionBlocks + min(next_block - regionStart,regionBlocks)) * 64;
+#endif
+  }
+
+  void SharedLazyTessellationCache::getStatistics(size_t& hits, size_t& misses, size_t& copies, size_t& flushes)
+  {
+    hits = misses = copies = 0;
+    mtx_threads.lock();
+    for (size_t i=0;i<numRenderThreads;i++) {
+      hits   += threadWorkState[i].hits;
+      misses += threadWorkState[i].misses;
+      copies += threadWorkState[i].copies;
+    }
+    mtx_threads.unlock();
+    flushes = numFlushes;
+  }
+
+  void SharedLazyTessellationCache::resetStatistics()
+  {
+    mtx_threads.lock();
+    for (size_t i=0;i<numRenderThreads;i++)
+      threadWorkState[i].resetStatistics();
+    mtx_threads.unlock();
+    numFlushes = 0;
   }
 
 
@@ -190,6 +248,7 @@ namespace embree
   AtomicCounter SharedTessellationCacheStats::cache_hits               = 0;
   AtomicCounter SharedTessellationCacheStats::cache_misses             = 0;
   AtomicCounter SharedTessellationCacheStats::cache_flushes            = 0;                
+  AtomicCounter SharedTessellationCacheStats::cache_copies             = 0;
 
   void SharedTessellationCacheStats::printStats()
   {
@@ -197,6 +256,7 @@ namespace embree
     DBG_PRINT(cache_misses);
     DBG_PRINT(cache_hits);
     DBG_PRINT(cache_flushes);
+    DBG_PRINT(cache_copies);
     DBG_PRINT(100.0f * cache_hits / cache_accesses);
     assert(cache_hits + cache_misses == cache_accesses);                
   }
@@ -207,6 +267,7 @@ namespace embree
     SharedTessellationCacheStats::cache_hits      = 0;
     SharedTessellationCacheStats::cache_misses    = 0;
     SharedTessellationCacheStats::cache_flushes   = 0;          
+    SharedTessellationCacheStats::cache_copies    = 0;
   }
 
 };
@@ -75,8 +75,12 @@ namespace embree
 
    struct __aligned(64) ThreadWorkState {
      AtomicCounter counter;
-     ThreadWorkState() { counter = 0; }
-   __forceinline void reset() { counter = 0; }
+     size_t hits;
+     size_t misses;
+     size_t copies;
+     ThreadWorkState() { reset(); }
+   __forceinline void reset() { counter = 0; resetStatistics(); }
+   __forceinline void resetStatistics() { hits = misses = copies = 0; }
    };
 
    float *data;
@@ -91,12 +95,14 @@ namespace embree
    __aligned(64) AtomicCounter switch_block_threshold;
    __aligned(64) AtomicCounter numRenderThreads;
    __aligned(64) AtomicMutex   mtx_threads;
+   __aligned(64) AtomicCounter numFlushes;
+   size_t reset_index;
 
 
 
  public:
 
-   static const size_t NUM_CACHE_REGIONS = 4;
+   static const size_t NUM_CACHE_REGIONS = 8;
 
       
    SharedLazyTessellationCache();
@@ -109,6 +115,11 @@ namespace embree
    __forceinline unsigned int lockThread  (const unsigned int threadID) { return threadWorkState[threadID].counter.add(1);  }
    __forceinline unsigned int unlockThread(const unsigned int threadID) { return threadWorkState[threadID].counter.add(-1); }
 
+   /* per thread statistics, only written by the owning thread */
+   __forceinline void countHit   (const unsigned int threadID) { threadWorkState[threadID].hits++;   }
+   __forceinline void countMiss  (const unsigned int threadID) { threadWorkState[threadID].misses++; }
+   __forceinline void countCopy  (const unsigned int threadID) { threadWorkState[threadID].copies++; }
+
    __forceinline bool validCacheIndex(const size_t i)
    {
 #if FORCE_SIMPLE_FLUSH == 1
@@ -118,6 +129,22 @@ namespace embree
 #endif
    }
 
+   /* accesses to entries of the second oldest region mark them as used */
+   __forceinline bool referenceCacheIndex(const size_t i)
+   {
+     return i+(NUM_CACHE_REGIONS-2) <= index;
+   }
+
+   /* used entries of the oldest region get a second chance and are copied into the current region */
+   __forceinline bool secondChanceCacheIndex(const size_t i)
+   {
+#if FORCE_SIMPLE_FLUSH == 1
+     return false;
+#else
+     return i+(NUM_CACHE_REGIONS-1) <= index;
+#endif
+   }
+
    void waitForUsersLessEqual(const unsigned int threadID,
 			      const unsigned int users);
     
@@ -135,13 +162,22 @@ namespace embree
    }
 
    __forceinline void*  getDataPtr()      { return data; }
-   __forceinline size_t getNumUsedBytes() { return next_block * 64; }
    __forceinline size_t getMaxBlocks()    { return maxBlocks; }
    __forceinline size_t getSize()         { return size; }
 
+   /* returns number of bytes of all regions that hold valid entries */
+   size_t getNumUsedBytes();
+
+   /* sums up statistics of all render threads */
+   void getStatistics(size_t& hits, size_t& misses, size_t& copies, size_t& flushes);
+   void resetStatistics();
+
    void resetCache();
    void realloc(const size_t newSize);
 
+   /* invalidates all entries, must not be called while rendering */
+   void invalidate();
+
    static SharedLazyTessellationCache sharedLazyTessellationCache;
     
  };
@@ -159,6 +195,7 @@ namespace embree
    static AtomicCounter cache_hits;
    static AtomicCounter cache_misses;
    static AtomicCounter cache_flushes;                
+   static AtomicCounter cache_copies;
 
     /* print stats for debugging */                 
     static void printStats();
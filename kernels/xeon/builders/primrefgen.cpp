@@ -18,6 +18,8 @@
 
 #include "algorithms/parallel_for_for.h"
 #include "algorithms/parallel_for_for_prefix_sum.h"
+#include "algorithms/parallel_reduce.h"
+#include <algorithm>
 
 namespace embree
 {
@@ -112,6 +114,55 @@ namespace embree
       return pinfo;
     }
 
+    template<typename Mesh>
+    PrimInfo createPrimRefArrayMB(Scene* scene, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor)
+    {
+      ParallelForForPrefixSumState<PrimInfo> pstate;
+      Scene::Iterator<Mesh,2> iter(scene);
+      
+      /* first try */
+      progressMonitor(0);
+      pstate.init(iter,size_t(1024));
+      PrimInfo pinfo = parallel_for_for_prefix_sum( pstate, iter, PrimInfo(empty), [&](Mesh* mesh, const range<size_t>& r, size_t k, const PrimInfo& base) -> PrimInfo
+      {
+        PrimInfo pinfo(empty);
+        for (size_t j=r.begin(); j<r.end(); j++)
+        {
+          if (!mesh->valid(j)) continue;
+          BBox3fa bounds = empty;
+          for (size_t t=0; t<mesh->numTimeSteps; t++)
+            bounds.extend(mesh->bounds(j,t));
+          const PrimRef prim(bounds,mesh->id,j);
+          pinfo.add(prim.bounds(),prim.center2());
+          prims[k++] = prim;
+        }
+        return pinfo;
+      }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
+      
+      /* if we need to filter out geometry, run again */
+      if (pinfo.size() != prims.size())
+      {
+        progressMonitor(0);
+        pinfo = parallel_for_for_prefix_sum( pstate, iter, PrimInfo(empty), [&](Mesh* mesh, const range<size_t>& r, size_t k, const PrimInfo& base) -> PrimInfo
+        {
+          k = base.size();
+          PrimInfo pinfo(empty);
+          for (size_t j=r.begin(); j<r.end(); j++)
+          {
+            if (!mesh->valid(j)) continue;
+            BBox3fa bounds = empty;
+            for (size_t t=0; t<mesh->numTimeSteps; t++)
+              bounds.extend(mesh->bounds(j,t));
+            const PrimRef prim(bounds,mesh->id,j);
+            pinfo.add(prim.bounds(),prim.center2());
+            prims[k++] = prim;
+          }
+          return pinfo;
+        }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
+      }
+      return pinfo;
+    }
+
     template<typename Mesh, size_t timeSteps>
       PrimInfo createPrimRefList(Scene* scene, PrimRefList& prims_o, BuildProgressMonitor& progressMonitor)
     {
@@ -214,19 +265,148 @@ namespace embree
       return pinfo;
     }
     
+    template<typename Mesh, size_t timeSteps>
+    void createPrimRefChunks(Scene* scene, const size_t maxChunkSize, PrimRefChunks& chunks, BuildProgressMonitor& progressMonitor)
+    {
+      Scene::Iterator<Mesh,timeSteps> iter(scene);
+
+      /* calculate bounds of all primitives without storing PrimRefs */
+      progressMonitor(0);
+      chunks.pinfo = parallel_for_for_reduce( iter, size_t(1024), PrimInfo(empty), [&](Mesh* mesh, const range<size_t>& r, size_t k) -> PrimInfo
+      {
+        PrimInfo pinfo(empty);
+        for (size_t j=r.begin(); j<r.end(); j++)
+        {
+          BBox3fa bounds = empty;
+          if (!mesh->valid(j,&bounds)) continue;
+          pinfo.add(bounds,center2(bounds));
+        }
+        return pinfo;
+      }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
+
+      /* map the centroid bounds to the grid */
+      const Vec3fa diag = chunks.pinfo.centBounds.size();
+      chunks.base = chunks.pinfo.centBounds.lower;
+      chunks.scale.x = diag.x > 1E-19f ? 0.99f*float(PrimRefChunks::CELLS_PER_DIM)/diag.x : 0.0f;
+      chunks.scale.y = diag.y > 1E-19f ? 0.99f*float(PrimRefChunks::CELLS_PER_DIM)/diag.y : 0.0f;
+      chunks.scale.z = diag.z > 1E-19f ? 0.99f*float(PrimRefChunks::CELLS_PER_DIM)/diag.z : 0.0f;
+
+      /* count primitives per grid cell */
+      progressMonitor(0);
+      std::vector<atomic_t> counts(PrimRefChunks::NUM_CELLS,0);
+      parallel_for_for( iter, size_t(1024), [&](Mesh* mesh, const range<size_t>& r, size_t k)
+      {
+        for (size_t j=r.begin(); j<r.end(); j++)
+        {
+          BBox3fa bounds = empty;
+          if (!mesh->valid(j,&bounds)) continue;
+          atomic_add(&counts[chunks.cell(center2(bounds))],1);
+        }
+      });
+
+      /* store the primitive IDs sorted by grid cell */
+      progressMonitor(0);
+      std::vector<size_t> cellOffsets(PrimRefChunks::NUM_CELLS+1);
+      cellOffsets[0] = 0;
+      for (size_t i=0; i<PrimRefChunks::NUM_CELLS; i++) {
+        cellOffsets[i+1] = cellOffsets[i]+counts[i];
+        counts[i] = cellOffsets[i];
+      }
+      chunks.ids.resize(cellOffsets[PrimRefChunks::NUM_CELLS]);
+      parallel_for_for( iter, size_t(1024), [&](Mesh* mesh, const range<size_t>& r, size_t k)
+      {
+        for (size_t j=r.begin(); j<r.end(); j++)
+        {
+          BBox3fa bounds = empty;
+          if (!mesh->valid(j,&bounds)) continue;
+          const size_t slot = atomic_add(&counts[chunks.cell(center2(bounds))],1);
+          chunks.ids[slot] = PrimRefChunks::PrimID(mesh->id,j);
+        }
+      });
+
+      /* sort the IDs of each cell to make the build deterministic */
+      parallel_for( size_t(0), size_t(PrimRefChunks::NUM_CELLS), size_t(1024), [&](const range<size_t>& r) 
+      {
+        for (size_t i=r.begin(); i<r.end(); i++)
+          std::sort(chunks.ids.begin()+cellOffsets[i],chunks.ids.begin()+cellOffsets[i+1]);
+      });
+
+      /* group consecutive cells into chunks */
+      chunks.cells.clear();
+      chunks.sizes.clear();
+      chunks.offsets.clear();
+      chunks.cells.push_back(0);
+      chunks.offsets.push_back(0);
+      for (size_t i=0; i<PrimRefChunks::NUM_CELLS; i++)
+      {
+        const size_t N = cellOffsets[i]-chunks.offsets.back();
+        const size_t M = cellOffsets[i+1]-cellOffsets[i];
+        if (N && N+M > maxChunkSize) {
+          chunks.cells.push_back(i);
+          chunks.sizes.push_back(N);
+          chunks.offsets.push_back(cellOffsets[i]);
+        }
+      }
+      chunks.cells.push_back(PrimRefChunks::NUM_CELLS);
+      chunks.sizes.push_back(cellOffsets[PrimRefChunks::NUM_CELLS]-chunks.offsets.back());
+    }
+
+    template<typename Mesh, size_t timeSteps>
+    PrimInfo createPrimRefArray(Scene* scene, const PrimRefChunks& chunks, const size_t chunkID, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor)
+    {
+      Scene::Iterator<Mesh,timeSteps> iter(scene);
+      const size_t begin = chunks.offsets[chunkID];
+      const size_t end   = begin+chunks.sizes[chunkID];
+
+      /* only the primitives of the chunk get visited */
+      progressMonitor(0);
+      return parallel_reduce( begin, end, size_t(1024), PrimInfo(empty), [&](const range<size_t>& r) -> PrimInfo
+      {
+        PrimInfo pinfo(empty);
+        for (size_t j=r.begin(); j<r.end(); j++)
+        {
+          const PrimRefChunks::PrimID& id = chunks.ids[j];
+          BBox3fa bounds = empty;
+          iter[id.geomID]->valid(id.primID,&bounds);
+          const PrimRef prim(bounds,id.geomID,id.primID);
+          pinfo.add(prim.bounds(),prim.center2());
+          prims[j-begin] = prim;
+        }
+        return pinfo;
+      }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
+    }
+    
     template PrimInfo createPrimRefArray<TriangleMesh>(TriangleMesh* mesh, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+    template PrimInfo createPrimRefArray<QuadMesh>(QuadMesh* mesh, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
     template PrimInfo createPrimRefArray<BezierCurves>(BezierCurves* mesh, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
     template PrimInfo createPrimRefArray<UserGeometryBase>(UserGeometryBase* mesh, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+    template PrimInfo createPrimRefArray<InstanceArray>(InstanceArray* mesh, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
 
     template PrimInfo createPrimRefArray<TriangleMesh,1>(Scene* scene, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
     template PrimInfo createPrimRefArray<TriangleMesh,2>(Scene* scene, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+    template PrimInfo createPrimRefArray<QuadMesh,1>(Scene* scene, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
     template PrimInfo createPrimRefArray<BezierCurves,1>(Scene* scene, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
     template PrimInfo createPrimRefArray<SubdivMesh,1>(Scene* scene, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
     template PrimInfo createPrimRefArray<UserGeometryBase,1>(Scene* scene, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+    template PrimInfo createPrimRefArray<InstanceArray,1>(Scene* scene, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+
+    template PrimInfo createPrimRefArrayMB<TriangleMesh>(Scene* scene, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
 
     template PrimInfo createBezierRefArray<1>(Scene* scene, vector<BezierPrim>& prims, BuildProgressMonitor& progressMonitor);
     template PrimInfo createBezierRefArray<2>(Scene* scene, vector<BezierPrim>& prims, BuildProgressMonitor& progressMonitor);
 
+    template void createPrimRefChunks<TriangleMesh,1>(Scene* scene, const size_t maxChunkSize, PrimRefChunks& chunks, BuildProgressMonitor& progressMonitor);
+    template void createPrimRefChunks<QuadMesh,1>(Scene* scene, const size_t maxChunkSize, PrimRefChunks& chunks, BuildProgressMonitor& progressMonitor);
+    template void createPrimRefChunks<BezierCurves,1>(Scene* scene, const size_t maxChunkSize, PrimRefChunks& chunks, BuildProgressMonitor& progressMonitor);
+    template void createPrimRefChunks<UserGeometryBase,1>(Scene* scene, const size_t maxChunkSize, PrimRefChunks& chunks, BuildProgressMonitor& progressMonitor);
+    template void createPrimRefChunks<InstanceArray,1>(Scene* scene, const size_t maxChunkSize, PrimRefChunks& chunks, BuildProgressMonitor& progressMonitor);
+
+    template PrimInfo createPrimRefArray<TriangleMesh,1>(Scene* scene, const PrimRefChunks& chunks, const size_t chunkID, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+    template PrimInfo createPrimRefArray<QuadMesh,1>(Scene* scene, const PrimRefChunks& chunks, const size_t chunkID, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+    template PrimInfo createPrimRefArray<BezierCurves,1>(Scene* scene, const PrimRefChunks& chunks, const size_t chunkID, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+    template PrimInfo createPrimRefArray<UserGeometryBase,1>(Scene* scene, const PrimRefChunks& chunks, const size_t chunkID, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+    template PrimInfo createPrimRefArray<InstanceArray,1>(Scene* scene, const PrimRefChunks& chunks, const size_t chunkID, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+
     template PrimInfo createPrimRefList<TriangleMesh,1>(Scene* scene, PrimRefList& prims, BuildProgressMonitor& progressMonitor);
   }
 }
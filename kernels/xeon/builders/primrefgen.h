@@ -31,11 +31,72 @@ namespace embree
     template<typename Mesh, size_t timeSteps>
       PrimInfo createPrimRefArray(Scene* scene, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
 
+    /*! creates the PrimRefs of all motion blurred geometries of the scene, bounding all time steps */
+    template<typename Mesh>
+      PrimInfo createPrimRefArrayMB(Scene* scene, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+
     template<typename Mesh, size_t timeSteps>
       PrimInfo createPrimRefList(Scene* scene, PrimRefList& prims, BuildProgressMonitor& progressMonitor);
 
     template<size_t timeSteps>
       PrimInfo createBezierRefArray(Scene* scene, vector<BezierPrim>& prims, BuildProgressMonitor& progressMonitor);
+
+    /*! Partitioning of the primitives of a scene into chunks of
+     *  spatially close primitives. The centroids get mapped to a
+     *  regular grid whose cells are ordered along a Morton curve, a
+     *  chunk is a range of consecutive cells. This allows to build
+     *  large scenes chunk by chunk without ever storing the PrimRefs of
+     *  all primitives, only the much smaller primitive IDs are stored
+     *  sorted by chunk. */
+    struct PrimRefChunks
+    {
+      enum { BITS_PER_DIM = 6, CELLS_PER_DIM = 1 << BITS_PER_DIM, NUM_CELLS = 1 << (3*BITS_PER_DIM) };
+
+      /*! identifies a primitive of the scene */
+      struct PrimID 
+      {
+        __forceinline PrimID () {}
+        __forceinline PrimID (unsigned geomID, unsigned primID) : geomID(geomID), primID(primID) {}
+
+        __forceinline friend bool operator< (const PrimID& a, const PrimID& b) {
+          return a.geomID < b.geomID || (a.geomID == b.geomID && a.primID < b.primID);
+        }
+
+        unsigned geomID, primID;
+      };
+
+      __forceinline PrimRefChunks () : pinfo(empty), base(zero), scale(zero) {}
+
+      /*! returns the number of chunks */
+      __forceinline size_t size() const { return sizes.size(); }
+
+      /*! returns the grid cell of a primitive centroid */
+      __forceinline unsigned cell(const Vec3fa& center2) const
+      {
+        const Vec3fa p = (center2-base)*scale;
+        const unsigned x = min(int(max(p.x,0.0f)),int(CELLS_PER_DIM-1));
+        const unsigned y = min(int(max(p.y,0.0f)),int(CELLS_PER_DIM-1));
+        const unsigned z = min(int(max(p.z,0.0f)),int(CELLS_PER_DIM-1));
+        return bitInterleave(x,y,z);
+      }
+
+    public:
+      PrimInfo pinfo;              //!< bounds and number of all primitives
+      Vec3fa base;                 //!< lower corner of the grid
+      Vec3fa scale;                //!< maps centroids to grid coordinates
+      std::vector<unsigned> cells; //!< chunk i contains the grid cells [cells[i],cells[i+1])
+      std::vector<size_t> sizes;   //!< number of primitives of each chunk
+      std::vector<size_t> offsets; //!< the primitives of chunk i are stored at ids[offsets[i],offsets[i]+sizes[i])
+      std::vector<PrimID> ids;     //!< IDs of all primitives grouped by chunk
+    };
+
+    /*! partitions the primitives of the scene into chunks of at most maxChunkSize primitives, only single cells can exceed that size */
+    template<typename Mesh, size_t timeSteps>
+      void createPrimRefChunks(Scene* scene, const size_t maxChunkSize, PrimRefChunks& chunks, BuildProgressMonitor& progressMonitor);
+
+    /*! creates the PrimRefs of all primitives of the specified chunk, the prims array has to be large enough for the chunk */
+    template<typename Mesh, size_t timeSteps>
+      PrimInfo createPrimRefArray(Scene* scene, const PrimRefChunks& chunks, const size_t chunkID, vector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
   }
 }
 
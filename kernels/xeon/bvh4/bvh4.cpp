@@ -19,13 +19,16 @@
 
 #include "geometry/bezier1v.h"
 #include "geometry/bezier1i.h"
+#include "geometry/bezier4q.h"
 #include "geometry/triangle1.h"
 #include "geometry/triangle4.h"
 #include "geometry/triangle8.h"
 #include "geometry/triangle1v.h"
 #include "geometry/triangle4v.h"
 #include "geometry/triangle4v_mb.h"
+#include "geometry/triangle4i_mb.h"
 #include "geometry/triangle4i.h"
+#include "geometry/quad4v.h"
 #include "geometry/subdivpatch1.h"
 #include "geometry/subdivpatch1cached.h"
 #include "geometry/virtual_accel.h"
@@ -38,51 +41,84 @@ namespace embree
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Bezier1iIntersector1);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Bezier1vIntersector1_OBB);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Bezier1iIntersector1_OBB);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Bezier4qIntersector1_OBB);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Bezier1iMBIntersector1_OBB);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle1Intersector1Moeller);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4Intersector1Moeller);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4Intersector1MoellerCulling);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle8Intersector1Moeller);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle1vIntersector1Pluecker);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4vIntersector1Pluecker);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4vIntersector1PlueckerCulling);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4iIntersector1Pluecker);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4iIntersector1PlueckerCulling);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4iQuantizedIntersector1Pluecker);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4iQuantizedIntersector1PlueckerCulling);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Quad4vIntersector1Moeller);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Quad4vIntersector1MoellerCulling);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle1vMBIntersector1Moeller);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle1vMBIntersector1MoellerCulling);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4vMBIntersector1Moeller);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4vMBIntersector1MoellerCulling);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4iMBIntersector1Moeller);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4iMBIntersector1MoellerCulling);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Subdivpatch1Intersector1);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Subdivpatch1CachedIntersector1);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Subdivpatch1CachedIntersector1Culling);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4GridIntersector1);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4GridLazyIntersector1);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4VirtualIntersector1);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4InstanceArrayIntersector1);
 
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Bezier1vIntersector4Chunk);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Bezier1iIntersector4Chunk);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Bezier1vIntersector4Single_OBB);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Bezier1iIntersector4Single_OBB);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Bezier4qIntersector4Single_OBB);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Bezier1iMBIntersector4Single_OBB);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle1Intersector4ChunkMoeller);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4Intersector4ChunkMoeller);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4Intersector4ChunkMoellerNoFilter);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4Intersector4ChunkMoellerCulling);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4Intersector4ChunkMoellerNoFilterCulling);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle8Intersector4ChunkMoeller);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle8Intersector4ChunkMoellerNoFilter);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4Intersector4HybridMoeller);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4Intersector4HybridMoellerNoFilter);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4Intersector4HybridMoellerCulling);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4Intersector4HybridMoellerNoFilterCulling);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle8Intersector4HybridMoeller);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle8Intersector4HybridMoellerNoFilter);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle1vIntersector4ChunkPluecker);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4vIntersector4ChunkPluecker);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4vIntersector4HybridPluecker);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4vIntersector4ChunkPlueckerCulling);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4vIntersector4HybridPlueckerCulling);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4iIntersector4ChunkPluecker);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4iIntersector4ChunkPlueckerCulling);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4iQuantizedIntersector4ChunkPluecker);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4iQuantizedIntersector4ChunkPlueckerCulling);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Quad4vIntersector4ChunkMoeller);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Quad4vIntersector4ChunkMoellerCulling);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle1vMBIntersector4ChunkMoeller);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle1vMBIntersector4ChunkMoellerCulling);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4vMBIntersector4ChunkMoeller);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4vMBIntersector4ChunkMoellerCulling);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4iMBIntersector4Moeller);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4iMBIntersector4MoellerCulling);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Subdivpatch1Intersector4);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Subdivpatch1CachedIntersector4);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Subdivpatch1CachedIntersector4Culling);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4GridIntersector4);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4GridLazyIntersector4);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4VirtualIntersector4Chunk);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4InstanceArrayIntersector4Chunk);
   
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Bezier1vIntersector8Chunk);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Bezier1iIntersector8Chunk);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Bezier1vIntersector8Single_OBB);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Bezier1iIntersector8Single_OBB);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Bezier4qIntersector8Single_OBB);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Bezier1iMBIntersector8Single_OBB);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle1Intersector8ChunkMoeller);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4Intersector8ChunkMoeller);
@@ -91,24 +127,39 @@ namespace embree
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle8Intersector8ChunkMoellerNoFilter);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4Intersector8HybridMoeller);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4Intersector8HybridMoellerNoFilter);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4Intersector8HybridMoellerCulling);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4Intersector8HybridMoellerNoFilterCulling);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle8Intersector8HybridMoeller);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle8Intersector8HybridMoellerNoFilter);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle1vIntersector8ChunkPluecker);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4vIntersector8ChunkPluecker);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4vIntersector8HybridPluecker);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4vIntersector8HybridPlueckerCulling);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4iIntersector8ChunkPluecker);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4iIntersector8ChunkPlueckerCulling);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4iQuantizedIntersector8ChunkPluecker);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4iQuantizedIntersector8ChunkPlueckerCulling);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Quad4vIntersector8ChunkMoeller);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Quad4vIntersector8ChunkMoellerCulling);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle1vMBIntersector8ChunkMoeller);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle1vMBIntersector8ChunkMoellerCulling);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4vMBIntersector8ChunkMoeller);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4vMBIntersector8ChunkMoellerCulling);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4iMBIntersector8Moeller);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4iMBIntersector8MoellerCulling);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Subdivpatch1Intersector8);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Subdivpatch1CachedIntersector8);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Subdivpatch1CachedIntersector8Culling);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4GridIntersector8);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4GridLazyIntersector8);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4VirtualIntersector8Chunk);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4InstanceArrayIntersector8Chunk);
 
   DECLARE_TOPLEVEL_BUILDER(BVH4BuilderTwoLevelSAH);
 
   DECLARE_SCENE_BUILDER(BVH4Bezier1vBuilder_OBB_New);
   DECLARE_SCENE_BUILDER(BVH4Bezier1iBuilder_OBB_New);
+  DECLARE_SCENE_BUILDER(BVH4Bezier4qBuilder_OBB_New);
   DECLARE_SCENE_BUILDER(BVH4Bezier1iMBBuilder_OBB_New);
 
   DECLARE_SCENE_BUILDER(BVH4Triangle1SceneBuilderSAH);
@@ -118,6 +169,8 @@ namespace embree
   DECLARE_SCENE_BUILDER(BVH4Triangle4vSceneBuilderSAH);
   DECLARE_SCENE_BUILDER(BVH4Triangle4iSceneBuilderSAH);
   DECLARE_SCENE_BUILDER(BVH4Triangle4vMBSceneBuilderSAH);
+  DECLARE_SCENE_BUILDER(BVH4Triangle4iMBSceneBuilderSAH);
+  DECLARE_SCENE_BUILDER(BVH4Quad4vSceneBuilderSAH);
 
   DECLARE_SCENE_BUILDER(BVH4Triangle1SceneBuilderSpatialSAH);
   DECLARE_SCENE_BUILDER(BVH4Triangle4SceneBuilderSpatialSAH);
@@ -135,6 +188,7 @@ namespace embree
   DECLARE_SCENE_BUILDER(BVH4Bezier1vSceneBuilderSAH);
   DECLARE_SCENE_BUILDER(BVH4Bezier1iSceneBuilderSAH);
   DECLARE_SCENE_BUILDER(BVH4VirtualSceneBuilderSAH);
+  DECLARE_SCENE_BUILDER(BVH4InstanceArraySceneBuilderSAH);
 
   DECLARE_SCENE_BUILDER(BVH4SubdivPatch1BuilderBinnedSAH);
   DECLARE_SCENE_BUILDER(BVH4SubdivPatch1CachedBuilderBinnedSAH);
@@ -155,6 +209,7 @@ namespace embree
   DECLARE_SCENE_BUILDER(BVH4Triangle1vSceneBuilderMortonGeneral);
   DECLARE_SCENE_BUILDER(BVH4Triangle4vSceneBuilderMortonGeneral);
   DECLARE_SCENE_BUILDER(BVH4Triangle4iSceneBuilderMortonGeneral);
+  DECLARE_SCENE_BUILDER(BVH4Quad4vSceneBuilderMortonGeneral);
 
   DECLARE_TRIANGLEMESH_BUILDER(BVH4Triangle1MeshBuilderMortonGeneral);
   DECLARE_TRIANGLEMESH_BUILDER(BVH4Triangle4MeshBuilderMortonGeneral);
@@ -172,6 +227,7 @@ namespace embree
 
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Bezier1vBuilder_OBB_New);
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Bezier1iBuilder_OBB_New);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Bezier4qBuilder_OBB_New);
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Bezier1iMBBuilder_OBB_New);
 
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle1SceneBuilderSAH);
@@ -181,6 +237,8 @@ namespace embree
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4vSceneBuilderSAH);
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4iSceneBuilderSAH);
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4vMBSceneBuilderSAH);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4iMBSceneBuilderSAH);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Quad4vSceneBuilderSAH);
 
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle1SceneBuilderSpatialSAH);
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4SceneBuilderSpatialSAH);
@@ -198,6 +256,7 @@ namespace embree
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Bezier1vSceneBuilderSAH);
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Bezier1iSceneBuilderSAH);
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4VirtualSceneBuilderSAH);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4InstanceArraySceneBuilderSAH);
 
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4SubdivPatch1BuilderBinnedSAH);
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4SubdivPatch1CachedBuilderBinnedSAH);
@@ -218,6 +277,7 @@ namespace embree
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle1vSceneBuilderMortonGeneral);
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4vSceneBuilderMortonGeneral);
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4iSceneBuilderMortonGeneral);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Quad4vSceneBuilderMortonGeneral);
 
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle1MeshBuilderMortonGeneral);
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4MeshBuilderMortonGeneral);
@@ -231,56 +291,92 @@ namespace embree
     SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4Bezier1iIntersector1);
     SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4Bezier1vIntersector1_OBB);
     SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4Bezier1iIntersector1_OBB);
+    SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4Bezier4qIntersector1_OBB);
     SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4Bezier1iMBIntersector1_OBB);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle1Intersector1Moeller);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4Intersector1Moeller);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4Intersector1MoellerCulling);
     SELECT_SYMBOL_AVX_AVX2              (features,BVH4Triangle8Intersector1Moeller);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle1vIntersector1Pluecker);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4vIntersector1Pluecker);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4vIntersector1PlueckerCulling);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4iIntersector1Pluecker);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4iIntersector1PlueckerCulling);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4iQuantizedIntersector1Pluecker);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4iQuantizedIntersector1PlueckerCulling);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Quad4vIntersector1Moeller);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Quad4vIntersector1MoellerCulling);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle1vMBIntersector1Moeller);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle1vMBIntersector1MoellerCulling);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4vMBIntersector1Moeller);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4vMBIntersector1MoellerCulling);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4iMBIntersector1Moeller);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4iMBIntersector1MoellerCulling);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Subdivpatch1Intersector1);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Subdivpatch1CachedIntersector1);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Subdivpatch1CachedIntersector1Culling);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4GridIntersector1);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4GridLazyIntersector1);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4VirtualIntersector1);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4InstanceArrayIntersector1);
 
     /* select intersectors4 */
     SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4Bezier1vIntersector4Chunk);
     SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4Bezier1iIntersector4Chunk);
     SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4Bezier1vIntersector4Single_OBB);
     SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4Bezier1iIntersector4Single_OBB);
+    SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4Bezier4qIntersector4Single_OBB);
     SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4Bezier1iMBIntersector4Single_OBB);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle1Intersector4ChunkMoeller);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4Intersector4ChunkMoeller);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4Intersector4ChunkMoellerNoFilter);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4Intersector4ChunkMoellerCulling);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4Intersector4ChunkMoellerNoFilterCulling);
     SELECT_SYMBOL_AVX_AVX2              (features,BVH4Triangle8Intersector4ChunkMoeller);
     SELECT_SYMBOL_DEFAULT2              (features,BVH4Triangle4Intersector4HybridMoeller,BVH4Triangle4Intersector4ChunkMoeller); // hybrid not supported below SSE4.2
     SELECT_SYMBOL_AVX_AVX2              (features,BVH4Triangle8Intersector4ChunkMoellerNoFilter);
     SELECT_SYMBOL_DEFAULT2              (features,BVH4Triangle4Intersector4HybridMoellerNoFilter,BVH4Triangle4Intersector4ChunkMoellerNoFilter); // hybrid not supported below SSE4.2
     SELECT_SYMBOL_SSE42_AVX_AVX2        (features,BVH4Triangle4Intersector4HybridMoeller);
     SELECT_SYMBOL_SSE42_AVX_AVX2        (features,BVH4Triangle4Intersector4HybridMoellerNoFilter);
+    SELECT_SYMBOL_DEFAULT2              (features,BVH4Triangle4Intersector4HybridMoellerCulling,BVH4Triangle4Intersector4ChunkMoellerCulling); // hybrid not supported below SSE4.2
+    SELECT_SYMBOL_DEFAULT2              (features,BVH4Triangle4Intersector4HybridMoellerNoFilterCulling,BVH4Triangle4Intersector4ChunkMoellerNoFilterCulling); // hybrid not supported below SSE4.2
+    SELECT_SYMBOL_SSE42_AVX_AVX2        (features,BVH4Triangle4Intersector4HybridMoellerCulling);
+    SELECT_SYMBOL_SSE42_AVX_AVX2        (features,BVH4Triangle4Intersector4HybridMoellerNoFilterCulling);
     SELECT_SYMBOL_AVX_AVX2              (features,BVH4Triangle8Intersector4HybridMoeller);
     SELECT_SYMBOL_AVX_AVX2              (features,BVH4Triangle8Intersector4HybridMoellerNoFilter);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle1vIntersector4ChunkPluecker);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4vIntersector4ChunkPluecker);
     SELECT_SYMBOL_DEFAULT2              (features,BVH4Triangle4vIntersector4HybridPluecker,BVH4Triangle4vIntersector4ChunkPluecker); // hybrid not supported below SSE4.2
     SELECT_SYMBOL_SSE42_AVX             (features,BVH4Triangle4vIntersector4HybridPluecker);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4vIntersector4ChunkPlueckerCulling);
+    SELECT_SYMBOL_DEFAULT2              (features,BVH4Triangle4vIntersector4HybridPlueckerCulling,BVH4Triangle4vIntersector4ChunkPlueckerCulling); // hybrid not supported below SSE4.2
+    SELECT_SYMBOL_SSE42_AVX             (features,BVH4Triangle4vIntersector4HybridPlueckerCulling);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4iIntersector4ChunkPluecker);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4iIntersector4ChunkPlueckerCulling);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4iQuantizedIntersector4ChunkPluecker);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4iQuantizedIntersector4ChunkPlueckerCulling);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Quad4vIntersector4ChunkMoeller);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Quad4vIntersector4ChunkMoellerCulling);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle1vMBIntersector4ChunkMoeller);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle1vMBIntersector4ChunkMoellerCulling);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4vMBIntersector4ChunkMoeller);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4vMBIntersector4ChunkMoellerCulling);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4iMBIntersector4Moeller);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4iMBIntersector4MoellerCulling);
     SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4Subdivpatch1Intersector4);
     SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4Subdivpatch1CachedIntersector4);
+    SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4Subdivpatch1CachedIntersector4Culling);
     SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4GridIntersector4);
     SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4GridLazyIntersector4);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4VirtualIntersector4Chunk);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4InstanceArrayIntersector4Chunk);
    
     /* select intersectors8 */
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Bezier1vIntersector8Chunk);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Bezier1iIntersector8Chunk);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Bezier1vIntersector8Single_OBB);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Bezier1iIntersector8Single_OBB);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Bezier4qIntersector8Single_OBB);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Bezier1iMBIntersector8Single_OBB);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle1Intersector8ChunkMoeller);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle4Intersector8ChunkMoeller);
@@ -289,24 +385,38 @@ namespace embree
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle8Intersector8ChunkMoellerNoFilter);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle4Intersector8HybridMoeller);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle4Intersector8HybridMoellerNoFilter);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle4Intersector8HybridMoellerCulling);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle4Intersector8HybridMoellerNoFilterCulling);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle8Intersector8HybridMoeller);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle8Intersector8HybridMoellerNoFilter);
     SELECT_SYMBOL_AVX     (features,BVH4Triangle1vIntersector8ChunkPluecker);
     SELECT_SYMBOL_AVX     (features,BVH4Triangle4vIntersector8ChunkPluecker);
     SELECT_SYMBOL_AVX     (features,BVH4Triangle4vIntersector8HybridPluecker);
+    SELECT_SYMBOL_AVX     (features,BVH4Triangle4vIntersector8HybridPlueckerCulling);
     SELECT_SYMBOL_AVX     (features,BVH4Triangle4iIntersector8ChunkPluecker);
+    SELECT_SYMBOL_AVX     (features,BVH4Triangle4iIntersector8ChunkPlueckerCulling);
+    SELECT_SYMBOL_AVX     (features,BVH4Triangle4iQuantizedIntersector8ChunkPluecker);
+    SELECT_SYMBOL_AVX     (features,BVH4Triangle4iQuantizedIntersector8ChunkPlueckerCulling);
+    SELECT_SYMBOL_AVX     (features,BVH4Quad4vIntersector8ChunkMoeller);
+    SELECT_SYMBOL_AVX     (features,BVH4Quad4vIntersector8ChunkMoellerCulling);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle1vMBIntersector8ChunkMoeller);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle1vMBIntersector8ChunkMoellerCulling);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle4vMBIntersector8ChunkMoeller);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle4vMBIntersector8ChunkMoellerCulling);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle4iMBIntersector8Moeller);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle4iMBIntersector8MoellerCulling);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Subdivpatch1Intersector8);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Subdivpatch1CachedIntersector8);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Subdivpatch1CachedIntersector8Culling);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4GridIntersector8);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4GridLazyIntersector8);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4VirtualIntersector8Chunk);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4InstanceArrayIntersector8Chunk);
   }
 
   BVH4::BVH4 (const PrimitiveType& primTy, Scene* scene, bool listMode)
     : primTy(primTy), scene(scene), listMode(listMode),
-      root(emptyNode), numPrimitives(0), numVertices(0), data_mem(NULL), size_data_mem(0) {}
+      root(emptyNode), numPrimitives(0), numVertices(0), numTimeSteps(0), data_mem(NULL), size_data_mem(0) {}
 
   BVH4::~BVH4 () 
   {
@@ -407,6 +517,38 @@ namespace embree
     else return node;
   }
 
+  void BVH4::quantize()
+  {
+    FastAllocator::ThreadLocal& alloc0 = alloc.threadLocal2()->alloc0;
+    root = quantizeRecursion(alloc0,root);
+  }
+
+  BVH4::NodeRef BVH4::quantizeRecursion(FastAllocator::ThreadLocal& alloc0, NodeRef node)
+  {
+    if (!node.isNode()) 
+      return node;
+
+    /* parents are allocated before their children to get a depth first layout */
+    Node* oldnode = node.node();
+    QuantizedNode* newnode = (QuantizedNode*) alloc0.malloc(sizeof(QuantizedNode),sizeof(QuantizedNode)); 
+    newnode->clear();
+    newnode->set(oldnode->bounds());
+
+    bool reachable = true;
+    for (size_t c=0; c<BVH4::N; c++) {
+      if (oldnode->child(c) == BVH4::emptyNode) continue;
+      oldnode->child(c) = quantizeRecursion(alloc0,oldnode->child(c));
+      reachable &= newnode->set(c,oldnode->bounds(c),oldnode->child(c));
+    }
+    if (likely(reachable)) 
+      return encodeNode(newnode);
+
+    /* keep an uncompressed node if some child is out of reach of the 32 bit offsets */
+    Node* fullnode = (Node*) alloc0.malloc(sizeof(Node)); 
+    *fullnode = *oldnode;
+    return encodeNode(fullnode);
+  }
+
   std::pair<BBox3fa,BBox3fa> BVH4::refit(Scene* scene, NodeRef node)
   {
     /*! merge bounds of triangles for both time steps */
@@ -515,6 +657,17 @@ namespace embree
     return intersectors;
   }
 
+  Accel::Intersectors BVH4Bezier4qIntersectors_OBB(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors;
+    intersectors.ptr = bvh;
+    intersectors.intersector1 = BVH4Bezier4qIntersector1_OBB;
+    intersectors.intersector4 = BVH4Bezier4qIntersector4Single_OBB;
+    intersectors.intersector8 = BVH4Bezier4qIntersector8Single_OBB;
+    intersectors.intersector16 = NULL;
+    return intersectors;
+  }
+
   Accel::Intersectors BVH4Bezier1iMBIntersectors_OBB(BVH4* bvh)
   {
     Accel::Intersectors intersectors;
@@ -541,6 +694,15 @@ namespace embree
   {
     Accel::Intersectors intersectors;
     intersectors.ptr = bvh;
+    if (bvh->scene->isBackfaceCulling()) {
+      intersectors.intersector1 = BVH4Triangle4Intersector1MoellerCulling;
+      intersectors.intersector4_filter   = BVH4Triangle4Intersector4ChunkMoellerCulling;
+      intersectors.intersector4_nofilter = BVH4Triangle4Intersector4ChunkMoellerNoFilterCulling;
+      intersectors.intersector8_filter   = BVH4Triangle4Intersector8HybridMoellerCulling;
+      intersectors.intersector8_nofilter = BVH4Triangle4Intersector8HybridMoellerNoFilterCulling;
+      intersectors.intersector16 = NULL;
+      return intersectors;
+    }
     intersectors.intersector1 = BVH4Triangle4Intersector1Moeller;
     intersectors.intersector4_filter   = BVH4Triangle4Intersector4ChunkMoeller;
     intersectors.intersector4_nofilter = BVH4Triangle4Intersector4ChunkMoellerNoFilter;
@@ -554,6 +716,15 @@ namespace embree
   {
     Accel::Intersectors intersectors;
     intersectors.ptr = bvh;
+    if (bvh->scene->isBackfaceCulling()) {
+      intersectors.intersector1 = BVH4Triangle4Intersector1MoellerCulling;
+      intersectors.intersector4_filter   = BVH4Triangle4Intersector4HybridMoellerCulling;
+      intersectors.intersector4_nofilter = BVH4Triangle4Intersector4HybridMoellerNoFilterCulling;
+      intersectors.intersector8_filter   = BVH4Triangle4Intersector8HybridMoellerCulling;
+      intersectors.intersector8_nofilter = BVH4Triangle4Intersector8HybridMoellerNoFilterCulling;
+      intersectors.intersector16 = NULL;
+      return intersectors;
+    }
     intersectors.intersector1 = BVH4Triangle4Intersector1Moeller;
     intersectors.intersector4_filter   = BVH4Triangle4Intersector4HybridMoeller;
     intersectors.intersector4_nofilter = BVH4Triangle4Intersector4HybridMoellerNoFilter;
@@ -605,6 +776,13 @@ namespace embree
   {
     Accel::Intersectors intersectors;
     intersectors.ptr = bvh;
+    if (bvh->scene->isBackfaceCulling()) {
+      intersectors.intersector1 = BVH4Triangle1vMBIntersector1MoellerCulling;
+      intersectors.intersector4 = BVH4Triangle1vMBIntersector4ChunkMoellerCulling;
+      intersectors.intersector8 = BVH4Triangle1vMBIntersector8ChunkMoellerCulling;
+      intersectors.intersector16 = NULL;
+      return intersectors;
+    }
     intersectors.intersector1 = BVH4Triangle1vMBIntersector1Moeller;
     intersectors.intersector4 = BVH4Triangle1vMBIntersector4ChunkMoeller;
     intersectors.intersector8 = BVH4Triangle1vMBIntersector8ChunkMoeller;
@@ -616,6 +794,13 @@ namespace embree
   {
     Accel::Intersectors intersectors;
     intersectors.ptr = bvh;
+    if (bvh->scene->isBackfaceCulling()) {
+      intersectors.intersector1 = BVH4Triangle4vMBIntersector1MoellerCulling;
+      intersectors.intersector4 = BVH4Triangle4vMBIntersector4ChunkMoellerCulling;
+      intersectors.intersector8 = BVH4Triangle4vMBIntersector8ChunkMoellerCulling;
+      intersectors.intersector16 = NULL;
+      return intersectors;
+    }
     intersectors.intersector1 = BVH4Triangle4vMBIntersector1Moeller;
     intersectors.intersector4 = BVH4Triangle4vMBIntersector4ChunkMoeller;
     intersectors.intersector8 = BVH4Triangle4vMBIntersector8ChunkMoeller;
@@ -623,10 +808,35 @@ namespace embree
     return intersectors;
   }
 
+  Accel::Intersectors BVH4Triangle4iMBIntersectors(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors;
+    intersectors.ptr = bvh;
+    if (bvh->scene->isBackfaceCulling()) {
+      intersectors.intersector1 = BVH4Triangle4iMBIntersector1MoellerCulling;
+      intersectors.intersector4 = BVH4Triangle4iMBIntersector4MoellerCulling;
+      intersectors.intersector8 = BVH4Triangle4iMBIntersector8MoellerCulling;
+      intersectors.intersector16 = NULL;
+      return intersectors;
+    }
+    intersectors.intersector1 = BVH4Triangle4iMBIntersector1Moeller;
+    intersectors.intersector4 = BVH4Triangle4iMBIntersector4Moeller;
+    intersectors.intersector8 = BVH4Triangle4iMBIntersector8Moeller;
+    intersectors.intersector16 = NULL;
+    return intersectors;
+  }
+
   Accel::Intersectors BVH4Triangle4vIntersectorsChunk(BVH4* bvh)
   {
     Accel::Intersectors intersectors;
     intersectors.ptr = bvh;
+    if (bvh->scene->isBackfaceCulling()) {
+      intersectors.intersector1 = BVH4Triangle4vIntersector1PlueckerCulling;
+      intersectors.intersector4 = BVH4Triangle4vIntersector4ChunkPlueckerCulling;
+      intersectors.intersector8 = BVH4Triangle4vIntersector8HybridPlueckerCulling;
+      intersectors.intersector16 = NULL;
+      return intersectors;
+    }
     intersectors.intersector1 = BVH4Triangle4vIntersector1Pluecker;
     intersectors.intersector4 = BVH4Triangle4vIntersector4ChunkPluecker;
     intersectors.intersector8 = BVH4Triangle4vIntersector8HybridPluecker;
@@ -638,6 +848,13 @@ namespace embree
   {
     Accel::Intersectors intersectors;
     intersectors.ptr = bvh;
+    if (bvh->scene->isBackfaceCulling()) {
+      intersectors.intersector1 = BVH4Triangle4vIntersector1PlueckerCulling;
+      intersectors.intersector4 = BVH4Triangle4vIntersector4HybridPlueckerCulling;
+      intersectors.intersector8 = BVH4Triangle4vIntersector8HybridPlueckerCulling;
+      intersectors.intersector16 = NULL;
+      return intersectors;
+    }
     intersectors.intersector1 = BVH4Triangle4vIntersector1Pluecker;
     intersectors.intersector4 = BVH4Triangle4vIntersector4HybridPluecker;
     intersectors.intersector8 = BVH4Triangle4vIntersector8HybridPluecker;
@@ -649,6 +866,13 @@ namespace embree
   {
     Accel::Intersectors intersectors;
     intersectors.ptr = bvh;
+    if (bvh->scene->isBackfaceCulling()) {
+      intersectors.intersector1 = BVH4Triangle4iIntersector1PlueckerCulling;
+      intersectors.intersector4 = BVH4Triangle4iIntersector4ChunkPlueckerCulling;
+      intersectors.intersector8 = BVH4Triangle4iIntersector8ChunkPlueckerCulling;
+      intersectors.intersector16 = NULL;
+      return intersectors;
+    }
     intersectors.intersector1 = BVH4Triangle4iIntersector1Pluecker;
     intersectors.intersector4 = BVH4Triangle4iIntersector4ChunkPluecker;
     intersectors.intersector8 = BVH4Triangle4iIntersector8ChunkPluecker;
@@ -656,6 +880,42 @@ namespace embree
     return intersectors;
   }
 
+  Accel::Intersectors BVH4Triangle4iQuantizedIntersectors(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors;
+    intersectors.ptr = bvh;
+    if (bvh->scene->isBackfaceCulling()) {
+      intersectors.intersector1 = BVH4Triangle4iQuantizedIntersector1PlueckerCulling;
+      intersectors.intersector4 = BVH4Triangle4iQuantizedIntersector4ChunkPlueckerCulling;
+      intersectors.intersector8 = BVH4Triangle4iQuantizedIntersector8ChunkPlueckerCulling;
+      intersectors.intersector16 = NULL;
+      return intersectors;
+    }
+    intersectors.intersector1 = BVH4Triangle4iQuantizedIntersector1Pluecker;
+    intersectors.intersector4 = BVH4Triangle4iQuantizedIntersector4ChunkPluecker;
+    intersectors.intersector8 = BVH4Triangle4iQuantizedIntersector8ChunkPluecker;
+    intersectors.intersector16 = NULL;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH4Quad4vIntersectors(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors;
+    intersectors.ptr = bvh;
+    if (bvh->scene->isBackfaceCulling()) {
+      intersectors.intersector1 = BVH4Quad4vIntersector1MoellerCulling;
+      intersectors.intersector4 = BVH4Quad4vIntersector4ChunkMoellerCulling;
+      intersectors.intersector8 = BVH4Quad4vIntersector8ChunkMoellerCulling;
+      intersectors.intersector16 = NULL;
+      return intersectors;
+    }
+    intersectors.intersector1 = BVH4Quad4vIntersector1Moeller;
+    intersectors.intersector4 = BVH4Quad4vIntersector4ChunkMoeller;
+    intersectors.intersector8 = BVH4Quad4vIntersector8ChunkMoeller;
+    intersectors.intersector16 = NULL;
+    return intersectors;
+  }
+
   Accel* BVH4::BVH4Bezier1v(Scene* scene)
   { 
     BVH4* accel = new BVH4(Bezier1vType::type,scene,LeafMode);
@@ -690,6 +950,14 @@ namespace embree
     return new AccelInstance(accel,builder,intersectors);
   }
 
+  Accel* BVH4::BVH4OBBBezier4q(Scene* scene, bool highQuality)
+  {
+    BVH4* accel = new BVH4(Bezier4qType::type,scene,LeafMode);
+    Accel::Intersectors intersectors = BVH4Bezier4qIntersectors_OBB(accel);
+    Builder* builder = BVH4Bezier4qBuilder_OBB_New(accel,scene,MODE_HIGH_QUALITY);
+    return new AccelInstance(accel,builder,intersectors);
+  }
+
    Accel* BVH4::BVH4OBBBezier1iMB(Scene* scene, bool highQuality)
   { 
     scene->needVertices = true;
@@ -785,6 +1053,17 @@ namespace embree
     return new AccelInstance(accel,builder,intersectors);
   }
 
+  Accel* BVH4::BVH4Triangle4iMB(Scene* scene)
+  {
+    BVH4* accel = new BVH4(Triangle4iMBType::type,scene,LeafMode);
+    Accel::Intersectors intersectors = BVH4Triangle4iMBIntersectors(accel);
+    Builder* builder = NULL;
+    if       (g_tri_builder_mb == "default"    ) builder = BVH4Triangle4iMBSceneBuilderSAH(accel,scene,0);
+    else  if (g_tri_builder_mb == "sah") builder = BVH4Triangle4iMBSceneBuilderSAH(accel,scene,0);
+    else THROW_RUNTIME_ERROR("unknown builder "+g_tri_builder_mb+" for BVH4<Triangle4iMB>");
+    return new AccelInstance(accel,builder,intersectors);
+  }
+
   Accel* BVH4::BVH4Triangle4v(Scene* scene)
   {
     BVH4* accel = new BVH4(Triangle4vType::type,scene,LeafMode);
@@ -823,6 +1102,21 @@ namespace embree
     return new AccelInstance(accel,builder,intersectors);
   }
 
+  Accel* BVH4::BVH4Quad4v(Scene* scene)
+  {
+    BVH4* accel = new BVH4(Quad4vType::type,scene,LeafMode);
+    Accel::Intersectors intersectors = BVH4Quad4vIntersectors(accel);
+
+    Builder* builder = NULL;
+    /* the triangle builder settings are shared, quads have no spatial split builder */
+    if (g_tri_builder == "morton" || (g_tri_builder == "default" && !scene->isStatic()))
+      builder = BVH4Quad4vSceneBuilderMortonGeneral(accel,scene,0);
+    else
+      builder = BVH4Quad4vSceneBuilderSAH(accel,scene,0);
+
+    return new AccelInstance(accel,builder,intersectors);
+  }
+
   void createTriangleMeshTriangle1Morton(TriangleMesh* mesh, AccelData*& accel, Builder*& builder)
   {
     if (mesh->numTimeSteps != 1) THROW_RUNTIME_ERROR("internal error");
@@ -1009,8 +1303,8 @@ namespace embree
   Accel* BVH4::BVH4Triangle4iObjectSplit(Scene* scene)
   {
     BVH4* accel = new BVH4(Triangle4iType::type,scene,LeafMode);
-    Builder* builder = BVH4Triangle4iSceneBuilderSAH(accel,scene,LeafMode);
-    Accel::Intersectors intersectors = BVH4Triangle4iIntersectors(accel);
+    Builder* builder = BVH4Triangle4iSceneBuilderSAH(accel,scene,LeafMode | MODE_QUANTIZED);
+    Accel::Intersectors intersectors = BVH4Triangle4iQuantizedIntersectors(accel);
     scene->needVertices = true;
     return new AccelInstance(accel,builder,intersectors);
   }
@@ -1033,9 +1327,15 @@ namespace embree
     BVH4* accel = new BVH4(SubdivPatch1Cached::type,scene,LeafMode);
     Accel::Intersectors intersectors;
     intersectors.ptr = accel; 
-    intersectors.intersector1 = BVH4Subdivpatch1CachedIntersector1;
-    intersectors.intersector4 = BVH4Subdivpatch1CachedIntersector4;
-    intersectors.intersector8 = BVH4Subdivpatch1CachedIntersector8;
+    if (scene->isBackfaceCulling()) {
+      intersectors.intersector1 = BVH4Subdivpatch1CachedIntersector1Culling;
+      intersectors.intersector4 = BVH4Subdivpatch1CachedIntersector4Culling;
+      intersectors.intersector8 = BVH4Subdivpatch1CachedIntersector8Culling;
+    } else {
+      intersectors.intersector1 = BVH4Subdivpatch1CachedIntersector1;
+      intersectors.intersector4 = BVH4Subdivpatch1CachedIntersector4;
+      intersectors.intersector8 = BVH4Subdivpatch1CachedIntersector8;
+    }
     intersectors.intersector16 = NULL;
     Builder* builder = BVH4SubdivPatch1CachedBuilderBinnedSAH(accel,scene,LeafMode);
     return new AccelInstance(accel,builder,intersectors);
@@ -1093,6 +1393,19 @@ namespace embree
     return new AccelInstance(accel,builder,intersectors);
   }
 
+  Accel* BVH4::BVH4InstanceArray(Scene* scene)
+  {
+    BVH4* accel = new BVH4(InstanceArrayItemType::type,scene,LeafMode);
+    Accel::Intersectors intersectors;
+    intersectors.ptr = accel; 
+    intersectors.intersector1 = BVH4InstanceArrayIntersector1;
+    intersectors.intersector4 = BVH4InstanceArrayIntersector4Chunk;
+    intersectors.intersector8 = BVH4InstanceArrayIntersector8Chunk;
+    intersectors.intersector16 = NULL;
+    Builder* builder = BVH4InstanceArraySceneBuilderSAH(accel,scene,LeafMode);
+    return new AccelInstance(accel,builder,intersectors);
+  }
+
   Accel* BVH4::BVH4Triangle1ObjectSplit(TriangleMesh* mesh)
   {
     BVH4* accel = new BVH4(TriangleMeshTriangle1::type,mesh->parent,LeafMode);
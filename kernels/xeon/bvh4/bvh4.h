@@ -38,6 +38,8 @@ namespace embree
     struct NodeMB;
     struct UnalignedNode;
     struct UnalignedNodeMB;
+    struct QuantizedNode;
+    struct SegmentNodeMB;
 
     /*! branching width of the tree */
     static const size_t N = 4;
@@ -59,6 +61,8 @@ namespace embree
     static const size_t tyNodeMB = 1;
     static const size_t tyUnalignedNode = 2;
     static const size_t tyUnalignedNodeMB = 3;
+    static const size_t tyQuantizedNode = 4;
+    static const size_t tySegmentNodeMB = 5;
     static const size_t tyLeaf = 8;
 
     /*! Empty node */
@@ -97,7 +101,7 @@ namespace embree
       __forceinline void prefetch(int types) const {
 	prefetchL1(((char*)ptr)+0*64);
 	prefetchL1(((char*)ptr)+1*64);
-	if (types > 0x1) {
+	if (types & ~0x10001) {
 	  prefetchL1(((char*)ptr)+2*64);
 	  prefetchL1(((char*)ptr)+3*64);
 	  /*prefetchL1(((char*)ptr)+4*64);
@@ -144,6 +148,14 @@ namespace embree
       __forceinline int isUnalignedNodeMB() const { return (ptr & (size_t)align_mask) == tyUnalignedNodeMB; }
       __forceinline int isUnalignedNodeMB(int types) const { return (types == 0x1000) || ((types & 0x1000) && isUnalignedNodeMB()); }
 
+      /*! checks if this is a node with quantized bounding boxes */
+      __forceinline int isQuantizedNode() const { return (ptr & (size_t)align_mask) == tyQuantizedNode; }
+      __forceinline int isQuantizedNode(int types) const { return (types == 0x10000) || ((types & 0x10000) && isQuantizedNode()); }
+
+      /*! checks if this is a motion blur node with bounds for each time step */
+      __forceinline int isSegmentNodeMB() const { return (ptr & (size_t)align_mask) == tySegmentNodeMB; }
+      __forceinline int isSegmentNodeMB(int types) const { return (types == 0x100000) || ((types & 0x100000) && isSegmentNodeMB()); }
+
       /*! returns base node pointer */
       __forceinline BaseNode* baseNode(int types) { 
 	assert(!isLeaf()); 
@@ -171,6 +183,17 @@ namespace embree
       /*! returns unaligned motion blur node pointer */
       __forceinline       UnalignedNodeMB* unalignedNodeMB()       { assert(isUnalignedNodeMB()); return (      UnalignedNodeMB*)(ptr & ~(size_t)align_mask); }
       __forceinline const UnalignedNodeMB* unalignedNodeMB() const { assert(isUnalignedNodeMB()); return (const UnalignedNodeMB*)(ptr & ~(size_t)align_mask); }
+
+      /*! returns quantized node pointer */
+      __forceinline       QuantizedNode* quantizedNode()       { assert(isQuantizedNode()); return (      QuantizedNode*)(ptr & ~(size_t)align_mask); }
+      __forceinline const QuantizedNode* quantizedNode() const { assert(isQuantizedNode()); return (const QuantizedNode*)(ptr & ~(size_t)align_mask); }
+
+      /*! returns motion blur node pointer with bounds for each time step */
+      __forceinline       SegmentNodeMB* segmentNodeMB()       { assert(isSegmentNodeMB()); return (      SegmentNodeMB*)(ptr & ~(size_t)align_mask); }
+      __forceinline const SegmentNodeMB* segmentNodeMB() const { assert(isSegmentNodeMB()); return (const SegmentNodeMB*)(ptr & ~(size_t)align_mask); }
+
+      /*! returns the i'th child of an inner node of one of the specified types */
+      __forceinline NodeRef child(int types, size_t i) const;
             
       /*! returns leaf pointer */
       __forceinline char* leaf(size_t& num) const {
@@ -439,6 +462,272 @@ namespace embree
       ssef upper_z;           //!< Z dimension of upper bounds of all 4 children.
     };
 
+    /*! BVH4 Node with quantized bounds and compressed child references. The
+     *  bounds of the children are stored as 8 bit offsets relative to the
+     *  bounds of the node, using a power of two scale per dimension, thus
+     *  decoding is exact and conservative. The children are stored as 32 bit
+     *  offsets relative to the node, which lets the node fit into a single
+     *  cache line. */
+    struct __aligned(64) QuantizedNode
+    {
+      /*! Clears the node. */
+      __forceinline void clear() 
+      {
+        start_x = start_y = start_z = 0.0f;
+        exp_x = exp_y = exp_z = 0;
+        valid = 0;
+        for (size_t i=0; i<N; i++) {
+          lower_x[i] = lower_y[i] = lower_z[i] = 255;
+          upper_x[i] = upper_y[i] = upper_z[i] = 0;
+          offset[i] = 0; type[i] = tyLeaf;
+        }
+      }
+
+      /*! Sets the bounds of the node, the bounds of the children get quantized relative to. */
+      __forceinline void set(const BBox3fa& bounds)
+      {
+        start_x = bounds.lower.x; exp_x = exponent(bounds.lower.x,bounds.upper.x);
+        start_y = bounds.lower.y; exp_y = exponent(bounds.lower.y,bounds.upper.y);
+        start_z = bounds.lower.z; exp_z = exponent(bounds.lower.z,bounds.upper.z);
+      }
+
+      /*! Sets bounding box and ID of child. Returns false if the child is out of reach of the compressed reference. */
+      __forceinline bool set(size_t i, const BBox3fa& bounds, const NodeRef& childID)
+      {
+        assert(i < N);
+        const ssize_t ofs = ssize_t(childID & ~(size_t)align_mask) - ssize_t(this);
+        if (ofs < 16*ssize_t(-0x7fffffff-1) || ofs > 16*ssize_t(0x7fffffff)) 
+          return false;
+
+        const Vec3fa s = scale();
+        lower_x[i] = quantizeLower(start_x,s.x,bounds.lower.x); upper_x[i] = quantizeUpper(start_x,s.x,bounds.upper.x);
+        lower_y[i] = quantizeLower(start_y,s.y,bounds.lower.y); upper_y[i] = quantizeUpper(start_y,s.y,bounds.upper.y);
+        lower_z[i] = quantizeLower(start_z,s.z,bounds.lower.z); upper_z[i] = quantizeUpper(start_z,s.z,bounds.upper.z);
+        offset[i] = int(ofs/16);
+        type[i] = (unsigned char) (childID & (size_t)align_mask);
+        valid |= 1 << i;
+        return true;
+      }
+
+      /*! Returns the scale of the quantized bounds. */
+      __forceinline Vec3fa scale() const {
+        return Vec3fa(cast_i2f((int(exp_x)+127) << 23),cast_i2f((int(exp_y)+127) << 23),cast_i2f((int(exp_z)+127) << 23));
+      }
+
+      /*! Returns bounds of node. */
+      __forceinline BBox3fa bounds() const {
+        BBox3fa bounds = empty;
+        for (size_t i=0; i<N; i++) 
+          if (valid & (1 << i)) bounds.extend(this->bounds(i));
+        return bounds;
+      }
+
+      /*! Returns bounds of specified child. */
+      __forceinline BBox3fa bounds(size_t i) const 
+      {
+        assert(i < N);
+        const Vec3fa s = scale();
+        const Vec3fa lower(start_x+float(lower_x[i])*s.x,start_y+float(lower_y[i])*s.y,start_z+float(lower_z[i])*s.z);
+        const Vec3fa upper(start_x+float(upper_x[i])*s.x,start_y+float(upper_y[i])*s.y,start_z+float(upper_z[i])*s.z);
+        return BBox3fa(lower,upper);
+      }
+
+      /*! Returns extent of bounds of specified child. */
+      __forceinline Vec3fa extend(size_t i) const {
+	return bounds(i).size();
+      }
+
+      /*! Returns reference to specified child */
+      __forceinline NodeRef child(size_t i) const { 
+        assert(i<N); 
+        if (!(valid & (1 << i))) return emptyNode;
+        return NodeRef(size_t(this) + 16*ssize_t(offset[i]) + type[i]);
+      }
+
+      /*! intersection with single rays */
+      template<bool robust>
+      __forceinline size_t intersect(size_t nearX, size_t nearY, size_t nearZ,
+				     const sse3f& org, const sse3f& rdir, const sse3f& org_rdir, const ssef& tnear, const ssef& tfar, 
+				     ssef& dist) const
+      {
+        /* the offsets select the lower or upper bounds of a Node, which are 4 times larger than ours */
+        const size_t qnearX = nearX/4, qnearY = nearY/4, qnearZ = nearZ/4;
+        const size_t qfarX  = qnearX ^ 4, qfarY = qnearY ^ 4, qfarZ = qnearZ ^ 4;
+        const Vec3fa s = scale();
+        const ssef near_x = madd(ssef::load(lower_x+qnearX),ssef(s.x),ssef(start_x));
+        const ssef near_y = madd(ssef::load(lower_x+qnearY),ssef(s.y),ssef(start_y));
+        const ssef near_z = madd(ssef::load(lower_x+qnearZ),ssef(s.z),ssef(start_z));
+        const ssef far_x  = madd(ssef::load(lower_x+qfarX ),ssef(s.x),ssef(start_x));
+        const ssef far_y  = madd(ssef::load(lower_x+qfarY ),ssef(s.y),ssef(start_y));
+        const ssef far_z  = madd(ssef::load(lower_x+qfarZ ),ssef(s.z),ssef(start_z));
+
+#if defined (__AVX2__)
+	const ssef tNearX = msub(near_x, rdir.x, org_rdir.x);
+	const ssef tNearY = msub(near_y, rdir.y, org_rdir.y);
+	const ssef tNearZ = msub(near_z, rdir.z, org_rdir.z);
+	const ssef tFarX  = msub(far_x , rdir.x, org_rdir.x);
+	const ssef tFarY  = msub(far_y , rdir.y, org_rdir.y);
+	const ssef tFarZ  = msub(far_z , rdir.z, org_rdir.z);
+#else
+	const ssef tNearX = (near_x - org.x) * rdir.x;
+	const ssef tNearY = (near_y - org.y) * rdir.y;
+	const ssef tNearZ = (near_z - org.z) * rdir.z;
+	const ssef tFarX  = (far_x  - org.x) * rdir.x;
+	const ssef tFarY  = (far_y  - org.y) * rdir.y;
+	const ssef tFarZ  = (far_z  - org.z) * rdir.z;
+#endif
+
+        if (robust) {
+          const float round_down = 1.0f-2.0f*float(ulp);
+          const float round_up   = 1.0f+2.0f*float(ulp);
+          const ssef tNear = max(tNearX,tNearY,tNearZ,tnear);
+          const ssef tFar  = min(tFarX ,tFarY ,tFarZ ,tfar);
+          const sseb vmask = (round_down*tNear <= round_up*tFar);
+          const size_t mask = movemask(vmask) & valid;
+          dist = tNear;
+          return mask;
+        }
+
+#if defined(__SSE4_1__)
+	const ssef tNear = maxi(maxi(tNearX,tNearY),maxi(tNearZ,tnear));
+	const ssef tFar  = mini(mini(tFarX ,tFarY ),mini(tFarZ ,tfar ));
+	const sseb vmask = cast(tNear) > cast(tFar);
+	const size_t mask = (movemask(vmask)^0xf) & valid;
+#else
+	const ssef tNear = max(tNearX,tNearY,tNearZ,tnear);
+	const ssef tFar  = min(tFarX ,tFarY ,tFarZ ,tfar);
+	const sseb vmask = tNear <= tFar;
+	const size_t mask = movemask(vmask) & valid;
+#endif
+	dist = tNear;
+	return mask;
+      }
+
+      /*! intersection with ray packet of size 4 */
+      template<bool robust>
+      __forceinline sseb intersect(size_t i, const sse3f& org, const sse3f& rdir, const sse3f& org_rdir, const ssef& tnear, const ssef& tfar, ssef& dist) const
+      {
+        const BBox3fa box = bounds(i);
+#if defined(__AVX2__)
+	const ssef lclipMinX = msub(ssef(box.lower.x),rdir.x,org_rdir.x);
+	const ssef lclipMinY = msub(ssef(box.lower.y),rdir.y,org_rdir.y);
+	const ssef lclipMinZ = msub(ssef(box.lower.z),rdir.z,org_rdir.z);
+	const ssef lclipMaxX = msub(ssef(box.upper.x),rdir.x,org_rdir.x);
+	const ssef lclipMaxY = msub(ssef(box.upper.y),rdir.y,org_rdir.y);
+	const ssef lclipMaxZ = msub(ssef(box.upper.z),rdir.z,org_rdir.z);
+#else
+	const ssef lclipMinX = (ssef(box.lower.x) - org.x) * rdir.x;
+	const ssef lclipMinY = (ssef(box.lower.y) - org.y) * rdir.y;
+	const ssef lclipMinZ = (ssef(box.lower.z) - org.z) * rdir.z;
+	const ssef lclipMaxX = (ssef(box.upper.x) - org.x) * rdir.x;
+	const ssef lclipMaxY = (ssef(box.upper.y) - org.y) * rdir.y;
+	const ssef lclipMaxZ = (ssef(box.upper.z) - org.z) * rdir.z;
+#endif
+
+        if (robust) {
+          const float round_down = 1.0f-2.0f*float(ulp);
+          const float round_up   = 1.0f+2.0f*float(ulp);
+          const ssef lnearP = max(max(min(lclipMinX, lclipMaxX), min(lclipMinY, lclipMaxY)), min(lclipMinZ, lclipMaxZ));
+          const ssef lfarP  = min(min(max(lclipMinX, lclipMaxX), max(lclipMinY, lclipMaxY)), max(lclipMinZ, lclipMaxZ));
+          const sseb lhit   = round_down*max(lnearP,tnear) <= round_up*min(lfarP,tfar);      
+          dist = lnearP;
+          return lhit;
+        }
+
+	const ssef lnearP = max(max(min(lclipMinX, lclipMaxX), min(lclipMinY, lclipMaxY)), min(lclipMinZ, lclipMaxZ));
+	const ssef lfarP  = min(min(max(lclipMinX, lclipMaxX), max(lclipMinY, lclipMaxY)), max(lclipMinZ, lclipMaxZ));
+	const sseb lhit   = max(lnearP,tnear) <= min(lfarP,tfar);      
+	dist = lnearP;
+	return lhit;
+      }
+      
+      /*! intersection with ray packet of size 8 */
+#if defined(__AVX__)
+      template<bool robust>
+      __forceinline avxb intersect8(size_t i, const avx3f& org, const avx3f& rdir, const avx3f& org_rdir, const avxf& tnear, const avxf& tfar, avxf& dist) const
+      {
+        const BBox3fa box = bounds(i);
+#if defined(__AVX2__)
+	const avxf lclipMinX = msub(avxf(box.lower.x),rdir.x,org_rdir.x);
+	const avxf lclipMinY = msub(avxf(box.lower.y),rdir.y,org_rdir.y);
+	const avxf lclipMinZ = msub(avxf(box.lower.z),rdir.z,org_rdir.z);
+	const avxf lclipMaxX = msub(avxf(box.upper.x),rdir.x,org_rdir.x);
+	const avxf lclipMaxY = msub(avxf(box.upper.y),rdir.y,org_rdir.y);
+	const avxf lclipMaxZ = msub(avxf(box.upper.z),rdir.z,org_rdir.z);
+#else
+	const avxf lclipMinX = (avxf(box.lower.x) - org.x) * rdir.x;
+	const avxf lclipMinY = (avxf(box.lower.y) - org.y) * rdir.y;
+	const avxf lclipMinZ = (avxf(box.lower.z) - org.z) * rdir.z;
+	const avxf lclipMaxX = (avxf(box.upper.x) - org.x) * rdir.x;
+	const avxf lclipMaxY = (avxf(box.upper.y) - org.y) * rdir.y;
+	const avxf lclipMaxZ = (avxf(box.upper.z) - org.z) * rdir.z;
+#endif
+
+        if (robust) {
+          const float round_down = 1.0f-2.0f*float(ulp);
+          const float round_up   = 1.0f+2.0f*float(ulp);
+          const avxf lnearP = max(max(min(lclipMinX, lclipMaxX), min(lclipMinY, lclipMaxY)), min(lclipMinZ, lclipMaxZ));
+          const avxf lfarP  = min(min(max(lclipMinX, lclipMaxX), max(lclipMinY, lclipMaxY)), max(lclipMinZ, lclipMaxZ));
+          const avxb lhit   = round_down*max(lnearP,tnear) <= round_up*min(lfarP,tfar);      
+          dist = lnearP;
+          return lhit;
+        }
+
+	const avxf lnearP = max(max(min(lclipMinX, lclipMaxX), min(lclipMinY, lclipMaxY)), min(lclipMinZ, lclipMaxZ));
+	const avxf lfarP  = min(min(max(lclipMinX, lclipMaxX), max(lclipMinY, lclipMaxY)), max(lclipMinZ, lclipMaxZ));
+	const avxb lhit   = max(lnearP,tnear) <= min(lfarP,tfar);      
+	dist = lnearP;
+	return lhit;
+      }
+#endif
+
+    private:
+
+      /*! calculates the smallest power of two scale that covers the range [lower,upper] with 255 steps */
+      static __forceinline signed char exponent(const float lower, const float upper)
+      {
+        int e = -126;
+        const float d = (upper-lower)/255.0f;
+        if (d > 0.0f) frexpf(d,&e);
+        e = max(e,-126);
+        while (e < 127 && lower+255.0f*cast_i2f((e+127) << 23) < upper) e++;
+        return (signed char) e;
+      }
+
+      /*! quantizes lower bound such that the decoded value is never larger */
+      static __forceinline unsigned char quantizeLower(const float start, const float scale, const float x)
+      {
+        int q = (int) clamp(floorf((x-start)/scale),0.0f,255.0f);
+        while (q > 0 && start+float(q)*scale > x) q--;
+        return (unsigned char) q;
+      }
+
+      /*! quantizes upper bound such that the decoded value is never smaller */
+      static __forceinline unsigned char quantizeUpper(const float start, const float scale, const float x)
+      {
+        int q = (int) clamp(ceilf((x-start)/scale),0.0f,255.0f);
+        while (q < 255 && start+float(q)*scale < x) q++;
+        return (unsigned char) q;
+      }
+
+    public:
+      float start_x;               //!< X dimension of lower bounds of the node.
+      float start_y;               //!< Y dimension of lower bounds of the node.
+      float start_z;               //!< Z dimension of lower bounds of the node.
+      signed char exp_x;           //!< X dimension of exponent of quantization scale.
+      signed char exp_y;           //!< Y dimension of exponent of quantization scale.
+      signed char exp_z;           //!< Z dimension of exponent of quantization scale.
+      unsigned char valid;         //!< Bitmask of the non empty children.
+      unsigned char lower_x[N];    //!< X dimension of quantized lower bounds of all 4 children.
+      unsigned char upper_x[N];    //!< X dimension of quantized upper bounds of all 4 children.
+      unsigned char lower_y[N];    //!< Y dimension of quantized lower bounds of all 4 children.
+      unsigned char upper_y[N];    //!< Y dimension of quantized upper bounds of all 4 children.
+      unsigned char lower_z[N];    //!< Z dimension of quantized lower bounds of all 4 children.
+      unsigned char upper_z[N];    //!< Z dimension of quantized upper bounds of all 4 children.
+      int offset[N];               //!< Offset of the 4 children relative to the node in 16 byte units.
+      unsigned char type[N];       //!< Node type or number of leaf items of the 4 children.
+    };
+
     /*! Motion Blur Node */
     struct NodeMB : public BaseNode
     {
@@ -664,6 +953,89 @@ namespace embree
       ssef upper_dz;        //!< Z dimension of upper bounds of all 4 children.
     };
 
+    /*! Motion Blur Node that stores the bounds of the children for
+     *  each time step. The bounds of the two time steps enclosing the
+     *  ray time are linearly interpolated, which is conservative for
+     *  primitives that move linearly between neighboring time
+     *  steps. Only the bounds of the first numTimeSteps keys are
+     *  allocated. */
+    struct SegmentNodeMB : public BaseNode
+    {
+      struct Bounds
+      {
+        ssef lower_x;        //!< X dimension of lower bounds of all 4 children.
+        ssef upper_x;        //!< X dimension of upper bounds of all 4 children.
+        ssef lower_y;        //!< Y dimension of lower bounds of all 4 children.
+        ssef upper_y;        //!< Y dimension of upper bounds of all 4 children.
+        ssef lower_z;        //!< Z dimension of lower bounds of all 4 children.
+        ssef upper_z;        //!< Z dimension of upper bounds of all 4 children.
+      };
+
+      /*! Returns the number of bytes of a node with bounds for numTimeSteps time steps. */
+      static __forceinline size_t bytes(size_t numTimeSteps) {
+        return sizeof(BaseNode)+numTimeSteps*sizeof(Bounds);
+      }
+
+      /*! Clears the node. */
+      __forceinline void clear(size_t numTimeSteps)
+      {
+        for (size_t t=0; t<numTimeSteps; t++) {
+          keys[t].lower_x = keys[t].lower_y = keys[t].lower_z = pos_inf;
+          keys[t].upper_x = keys[t].upper_y = keys[t].upper_z = neg_inf;
+        }
+	BaseNode::clear();
+      }
+
+      /*! Sets ID of child. */
+      __forceinline void set(size_t i, NodeRef childID) {
+	children[i] = childID;
+      }
+
+      /*! Sets bounding box of child for time step t. */
+      __forceinline void set(size_t i, size_t t, const BBox3fa& bounds)
+      {
+        assert(i < N);
+        keys[t].lower_x[i] = bounds.lower.x; keys[t].lower_y[i] = bounds.lower.y; keys[t].lower_z[i] = bounds.lower.z;
+        keys[t].upper_x[i] = bounds.upper.x; keys[t].upper_y[i] = bounds.upper.y; keys[t].upper_z[i] = bounds.upper.z;
+      }
+
+      /*! Returns bounding box of child for time step t. */
+      __forceinline BBox3fa bounds(size_t i, size_t t) const {
+        return BBox3fa(Vec3fa(keys[t].lower_x[i],keys[t].lower_y[i],keys[t].lower_z[i]),
+                       Vec3fa(keys[t].upper_x[i],keys[t].upper_y[i],keys[t].upper_z[i]));
+      }
+
+      /*! Returns extent of bounds of specified child for time step 0. */
+      __forceinline Vec3fa extend0(size_t i) const {
+	return bounds(i,0).size();
+      }
+
+      /*! intersection with single rays, itime is the time segment and ftime the time inside the segment */
+      __forceinline size_t intersect(size_t nearX, size_t nearY, size_t nearZ,
+				     const sse3f& org, const sse3f& rdir, const sse3f& org_rdir, const ssef& tnear, const ssef& tfar,
+                                     const size_t itime, const float ftime, ssef& dist) const
+      {
+	const size_t farX  = nearX ^ sizeof(ssef), farY  = nearY ^ sizeof(ssef), farZ  = nearZ ^ sizeof(ssef);
+        const char* p0 = (const char*)&keys[itime+0];
+        const char* p1 = (const char*)&keys[itime+1];
+        const ssef t0 = ssef(1.0f-ftime), t1 = ssef(ftime);
+	const ssef tNearX = (t0*load4f(p0+nearX) + t1*load4f(p1+nearX) - org.x) * rdir.x;
+	const ssef tNearY = (t0*load4f(p0+nearY) + t1*load4f(p1+nearY) - org.y) * rdir.y;
+	const ssef tNearZ = (t0*load4f(p0+nearZ) + t1*load4f(p1+nearZ) - org.z) * rdir.z;
+	const ssef tNear = max(tnear,tNearX,tNearY,tNearZ);
+	const ssef tFarX = (t0*load4f(p0+farX) + t1*load4f(p1+farX) - org.x) * rdir.x;
+	const ssef tFarY = (t0*load4f(p0+farY) + t1*load4f(p1+farY) - org.y) * rdir.y;
+	const ssef tFarZ = (t0*load4f(p0+farZ) + t1*load4f(p1+farZ) - org.z) * rdir.z;
+	const ssef tFar = min(tfar,tFarX,tFarY,tFarZ);
+	const size_t mask = movemask(tNear <= tFar);
+	dist = tNear;
+	return mask;
+      }
+
+    public:
+      Bounds keys[RTC_MAX_TIME_STEPS];   //!< bounds of all 4 children for each time step
+    };
+
     /*! Node with unaligned bounds */
     struct UnalignedNode : public BaseNode
     {
@@ -948,12 +1320,14 @@ namespace embree
 
     /*! BVH4 instantiations */
     static Accel* BVH4Triangle4vMB(Scene* scene);
+    static Accel* BVH4Triangle4iMB(Scene* scene);
 
     static Accel* BVH4Bezier1v(Scene* scene);
     static Accel* BVH4Bezier1i(Scene* scene);
     
     static Accel* BVH4OBBBezier1v(Scene* scene, bool highQuality);
     static Accel* BVH4OBBBezier1i(Scene* scene, bool highQuality);
+    static Accel* BVH4OBBBezier4q(Scene* scene, bool highQuality);
     static Accel* BVH4OBBBezier1iMB(Scene* scene, bool highQuality);
 
     static Accel* BVH4Triangle1(Scene* scene);
@@ -962,12 +1336,14 @@ namespace embree
     static Accel* BVH4Triangle1v(Scene* scene);
     static Accel* BVH4Triangle4v(Scene* scene);
     static Accel* BVH4Triangle4i(Scene* scene);
+    static Accel* BVH4Quad4v(Scene* scene);
     static Accel* BVH4SubdivPatch1(Scene* scene);
     static Accel* BVH4SubdivPatch1Cached(Scene* scene);
     static Accel* BVH4SubdivGrid(Scene* scene);
     static Accel* BVH4SubdivGridEager(Scene* scene);
     static Accel* BVH4SubdivGridLazy(Scene* scene);
     static Accel* BVH4UserGeometry(Scene* scene);
+    static Accel* BVH4InstanceArray(Scene* scene);
     
     static Accel* BVH4BVH4Triangle1Morton(Scene* scene);
     static Accel* BVH4BVH4Triangle1ObjectSplit(Scene* scene);
@@ -1008,8 +1384,18 @@ namespace embree
     void layoutLargeNodes(size_t N);
     NodeRef layoutLargeNodesRecursion(NodeRef& node);
 
+    /*! converts all nodes of the BVH into quantized nodes */
+    void quantize();
+    NodeRef quantizeRecursion(FastAllocator::ThreadLocal& alloc0, NodeRef node);
+
     /*! Propagate bounds for time t0 and time t1 up the tree. */
     std::pair<BBox3fa,BBox3fa> refit(Scene* scene, NodeRef node);
+
+    /*! writes the BVH in relocatable form to a stream */
+    bool store(std::ostream& stream);
+
+    /*! initializes the BVH from data written by store */
+    bool load(char* ptr, size_t bytes);
     
     /*! calculates the amount of bytes allocated */
     size_t bytesAllocated() {
@@ -1045,6 +1431,18 @@ namespace embree
     static __forceinline NodeRef encodeNode(UnalignedNodeMB* node) { 
       return NodeRef((size_t) node | tyUnalignedNodeMB);
     }
+
+    /*! Encodes a quantized node */
+    static __forceinline NodeRef encodeNode(QuantizedNode* node) { 
+      assert(!((size_t)node & align_mask)); 
+      return NodeRef((size_t) node | tyQuantizedNode);
+    }
+
+    /*! Encodes a motion blur node with bounds for each time step */
+    static __forceinline NodeRef encodeNode(SegmentNodeMB* node) { 
+      assert(!((size_t)node & align_mask)); 
+      return NodeRef((size_t) node | tySegmentNodeMB);
+    }
     
     /*! Encodes a leaf */
     static __forceinline NodeRef encodeLeaf(void* tri, size_t num) {
@@ -1074,6 +1472,7 @@ namespace embree
   public:
     size_t numPrimitives;              //!< number of primitives the BVH is build over
     size_t numVertices;                //!< number of vertices the BVH references
+    size_t numTimeSteps;               //!< number of time steps stored in the SegmentNodeMB nodes
     
     /*! data arrays for special builders */
   public:
@@ -1081,4 +1480,10 @@ namespace embree
     void* data_mem;                   //!< additional memory, currently used for subdivpatch1cached memory
     size_t size_data_mem;
   };
+
+  __forceinline BVH4::NodeRef BVH4::NodeRef::child(int types, size_t i) const 
+  {
+    if (isQuantizedNode(types)) return quantizedNode()->child(i);
+    else                        return baseNode(types)->child(i);
+  }
 }
@@ -19,6 +19,7 @@
 
 #include "geometry/bezier1v.h"
 #include "geometry/bezier1i.h"
+#include "geometry/bezier4q.h"
 
 namespace embree
 {
@@ -30,9 +31,11 @@ namespace embree
       BVH4* bvh;
       Scene* scene;
       vector<BezierPrim> prims;
+      const size_t minLeafSize;
+      const size_t maxLeafSize;
 
-      BVH4HairBuilderSAH (BVH4* bvh, Scene* scene)
-        : bvh(bvh), scene(scene) {}
+      BVH4HairBuilderSAH (BVH4* bvh, Scene* scene, const size_t minLeafSize = 1, const size_t maxLeafSize = BVH4::maxLeafBlocks)
+        : bvh(bvh), scene(scene), minLeafSize(minLeafSize), maxLeafSize(maxLeafSize) {}
       
       void build(size_t, size_t) 
       {
@@ -88,7 +91,7 @@ namespace embree
 
             [&] (size_t depth, const PrimInfo& pinfo, FastAllocator::ThreadLocal2* alloc) -> BVH4::NodeRef
             {
-              size_t items = pinfo.size();
+              size_t items = Primitive::blocks(pinfo.size());
               size_t start = pinfo.begin;
               Primitive* accel = (Primitive*) alloc->alloc1.malloc(items*sizeof(Primitive));
               BVH4::NodeRef node = bvh->encodeLeaf((char*)accel,items);
@@ -98,7 +101,7 @@ namespace embree
               return node;
             },
             progress,
-            prims.data(),pinfo,BVH4::N,BVH4::maxBuildDepthLeaf,1,1,BVH4::maxLeafBlocks);
+            prims.data(),pinfo,BVH4::N,BVH4::maxBuildDepthLeaf,1,minLeafSize,maxLeafSize);
         
         bvh->set(root,pinfo.geomBounds,pinfo.size());
         
@@ -193,7 +196,9 @@ namespace embree
             progress,
             prims.data(),pinfo,BVH4::N,BVH4::maxBuildDepthLeaf,1,1,BVH4::maxLeafBlocks);
         
-        bvh->set(root,pinfo.geomBounds,pinfo.size());
+        /* the primrefs store the curves at the center time, but the bounds have to enclose both time steps */
+        const std::pair<BBox3fa,BBox3fa> rootBounds = HeuristicArrayBinningSAH<BezierPrim>(prims.data()).computePrimInfoMB(scene,pinfo);
+        bvh->set(root,merge(rootBounds.first,rootBounds.second),pinfo.size());
 
         //});
         
@@ -211,6 +216,7 @@ namespace embree
     /*! entry functions for the builder */
     Builder* BVH4Bezier1vBuilder_OBB_New   (void* bvh, Scene* scene, size_t mode) { return new BVH4HairBuilderSAH<Bezier1v>((BVH4*)bvh,scene); }
     Builder* BVH4Bezier1iBuilder_OBB_New   (void* bvh, Scene* scene, size_t mode) { return new BVH4HairBuilderSAH<Bezier1i>((BVH4*)bvh,scene); }
+    Builder* BVH4Bezier4qBuilder_OBB_New   (void* bvh, Scene* scene, size_t mode) { return new BVH4HairBuilderSAH<Bezier4q>((BVH4*)bvh,scene,4,4*BVH4::maxLeafBlocks); }
     Builder* BVH4Bezier1iMBBuilder_OBB_New (void* bvh, Scene* scene, size_t mode) { return new BVH4HairMBBuilderSAH<Bezier1iMB>((BVH4*)bvh,scene); }
   }
 }
@@ -30,6 +30,7 @@
 #include "geometry/triangle1v.h"
 #include "geometry/triangle4v.h"
 #include "geometry/triangle4i.h"
+#include "geometry/quad4v.h"
 
 #define ROTATE_TREE 1 // specifies number of tree rotation rounds to perform
 #define PROFILE 0
@@ -437,6 +438,62 @@ namespace embree
       size_t encodeMask;
     };
 
+    struct CreateQuad4vLeaf
+    {
+      __forceinline CreateQuad4vLeaf (Scene* scene, MortonID32Bit* morton, size_t encodeShift, size_t encodeMask)
+        : scene(scene), morton(morton), encodeShift(encodeShift), encodeMask(encodeMask) {}
+
+      void operator() (MortonBuildRecord<BVH4::NodeRef>& current, FastAllocator::ThreadLocal2* alloc, BBox3fa& box_o)
+      {
+        ssef lower(pos_inf);
+        ssef upper(neg_inf);
+        size_t items = current.size();
+        size_t start = current.begin;
+        assert(items<=4);
+        
+        /* allocate leaf node */
+        Quad4v* accel = (Quad4v*) alloc->alloc1.malloc(sizeof(Quad4v));
+        *current.parent = BVH4::encodeLeaf((char*)accel,1);
+        
+        ssei vgeomID = -1, vprimID = -1, vmask = -1;
+        sse3f v0 = zero, v1 = zero, v2 = zero, v3 = zero;
+        
+        for (size_t i=0; i<items; i++)
+        {
+          const size_t index = morton[start+i].index;
+          const size_t primID = index & encodeMask; 
+          const size_t geomID = index >> encodeShift; 
+          const QuadMesh* mesh = scene->getQuadMesh(geomID);
+          const QuadMesh::Quad& quad = mesh->quad(primID);
+          const Vec3fa& p0 = mesh->vertex(quad.v[0]);
+          const Vec3fa& p1 = mesh->vertex(quad.v[1]);
+          const Vec3fa& p2 = mesh->vertex(quad.v[2]);
+          const Vec3fa& p3 = mesh->vertex(quad.v[3]);
+          lower = min(lower,(ssef)p0,(ssef)p1,(ssef)p2,(ssef)p3);
+          upper = max(upper,(ssef)p0,(ssef)p1,(ssef)p2,(ssef)p3);
+          vgeomID [i] = geomID;
+          vprimID [i] = primID;
+          vmask   [i] = mesh->mask;
+          v0.x[i] = p0.x; v0.y[i] = p0.y; v0.z[i] = p0.z;
+          v1.x[i] = p1.x; v1.y[i] = p1.y; v1.z[i] = p1.z;
+          v2.x[i] = p2.x; v2.y[i] = p2.y; v2.z[i] = p2.z;
+          v3.x[i] = p3.x; v3.y[i] = p3.y; v3.z[i] = p3.z;
+        }
+        Quad4v::store_nt(accel,Quad4v(v0,v1,v2,v3,vgeomID,vprimID,vmask,false));
+        box_o = BBox3fa((Vec3fa)lower,(Vec3fa)upper);
+#if ROTATE_TREE
+        box_o.lower.a = current.size();
+#endif
+      }
+    
+    private:
+      Scene* scene;
+      MortonID32Bit* morton;
+      size_t encodeShift;
+      size_t encodeMask;
+    };
+
+    template<typename Mesh>
     struct CalculateBounds
     {
       __forceinline CalculateBounds (Scene* scene, size_t encodeShift, size_t encodeMask)
@@ -447,7 +504,7 @@ namespace embree
         const size_t index = morton.index;
         const size_t primID = index & encodeMask; 
         const size_t geomID = index >> encodeShift; 
-        const TriangleMesh* mesh = scene->getTriangleMesh(geomID);
+        const Mesh* mesh = (const Mesh*) scene->get(geomID);
         return mesh->bounds(primID);
       }
       
@@ -762,7 +819,7 @@ namespace embree
             AllocBVH4Node allocNode;
             SetBVH4Bounds setBounds(bvh);
             CreateLeaf createLeaf(scene,morton.data(),encodeShift,encodeMask);
-            CalculateBounds calculateBounds(scene,encodeShift,encodeMask);
+            CalculateBounds<Mesh> calculateBounds(scene,encodeShift,encodeMask);
             auto node_bounds = bvh_builder_morton_internal<BVH4::NodeRef>(
               [&] () { return bvh->alloc.threadLocal2(); },
                 BBox3fa(empty),
@@ -810,6 +867,8 @@ namespace embree
     Builder* BVH4Triangle4vSceneBuilderMortonGeneral (void* bvh, Scene* scene, size_t mode) { return new class BVH4SceneBuilderMorton<TriangleMesh,CreateTriangle4vLeaf>((BVH4*)bvh,scene,4,4*BVH4::maxLeafBlocks); }
     Builder* BVH4Triangle4iSceneBuilderMortonGeneral (void* bvh, Scene* scene, size_t mode) { return new class BVH4SceneBuilderMorton<TriangleMesh,CreateTriangle4iLeaf>((BVH4*)bvh,scene,4,4*BVH4::maxLeafBlocks); }
 
+    Builder* BVH4Quad4vSceneBuilderMortonGeneral     (void* bvh, Scene* scene, size_t mode) { return new class BVH4SceneBuilderMorton<QuadMesh,CreateQuad4vLeaf>       ((BVH4*)bvh,scene,4,4*BVH4::maxLeafBlocks); }
+
   }
 }
 
@@ -29,7 +29,9 @@
 #include "geometry/triangle1v.h"
 #include "geometry/triangle4v.h"
 #include "geometry/triangle4i.h"
+#include "geometry/quad4v.h"
 #include "geometry/triangle4v_mb.h"
+#include "geometry/triangle4i_mb.h"
 #include "geometry/virtual_accel.h"
 
 #define ROTATE_TREE 0
@@ -51,11 +53,13 @@ namespace embree
 
     struct CreateBVH4Node
     {
-      __forceinline CreateBVH4Node (BVH4* bvh) : bvh(bvh) {}
+      __forceinline CreateBVH4Node (BVH4* bvh, FastAllocator* tmpNodes = NULL) : bvh(bvh), tmpNodes(tmpNodes) {}
       
       __forceinline BVH4::Node* operator() (const isa::BVHBuilderBinnedSAH::BuildRecord& current, BVHBuilderBinnedSAH::BuildRecord* children, const size_t N, Allocator* alloc) 
       {
-        BVH4::Node* node = (BVH4::Node*) alloc->alloc0.malloc(sizeof(BVH4::Node)); node->clear();
+        /* nodes that get quantized later on are only required temporarily */
+        BVH4::Node* node = tmpNodes ? (BVH4::Node*) tmpNodes->threadLocal()->malloc(sizeof(BVH4::Node)) : (BVH4::Node*) alloc->alloc0.malloc(sizeof(BVH4::Node)); 
+        node->clear();
         for (size_t i=0; i<N; i++) {
           node->set(i,children[i].pinfo.geomBounds);
           children[i].parent = (size_t*)&node->child(i);
@@ -65,6 +69,7 @@ namespace embree
       }
 
       BVH4* bvh;
+      FastAllocator* tmpNodes;
     };
 
     template<typename Primitive>
@@ -107,14 +112,16 @@ namespace embree
       const size_t minLeafSize;
       const size_t maxLeafSize;
       const float presplitFactor;
+      const bool quantize;
+      FastAllocator tmpNodes;
 
       BVH4BuilderSAH (BVH4* bvh, Scene* scene, const size_t leafBlockSize, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
         : bvh(bvh), scene(scene), mesh(NULL), sahBlockSize(sahBlockSize), intCost(intCost), minLeafSize(minLeafSize), maxLeafSize(min(maxLeafSize,leafBlockSize*BVH4::maxLeafBlocks)),
-          presplitFactor((mode & MODE_HIGH_QUALITY) ? 1.5f : 1.0f) {}
+          presplitFactor((mode & MODE_HIGH_QUALITY) ? 1.5f : 1.0f), quantize((mode & MODE_QUANTIZED) != 0) {}
 
       BVH4BuilderSAH (BVH4* bvh, Mesh* mesh, const size_t leafBlockSize, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
         : bvh(bvh), scene(NULL), mesh(mesh), sahBlockSize(sahBlockSize), intCost(intCost), minLeafSize(minLeafSize), maxLeafSize(min(maxLeafSize,leafBlockSize*BVH4::maxLeafBlocks)),
-          presplitFactor((mode & MODE_HIGH_QUALITY) ? 1.5f : 1.0f) {}
+          presplitFactor((mode & MODE_HIGH_QUALITY) ? 1.5f : 1.0f), quantize((mode & MODE_QUANTIZED) != 0) {}
 
       // FIXME: shrink bvh->alloc in destructor here an in other builders too
 
@@ -156,21 +163,93 @@ namespace embree
 	profile(2,20,numPrimitives,[&] (ProfileTimer& timer)
         {
 #endif
-          //bvh->alloc.init(0,0); // FIXME: this improves initial build time significantly but reduces rendering performance slightly
-            bvh->alloc.init(numSplitPrimitives*sizeof(PrimRef),numSplitPrimitives*sizeof(BVH4::Node));  // FIXME: better estimate
-	    prims.resize(numSplitPrimitives);
             auto progress = [&] (size_t dn) { bvh->scene->progressMonitor(dn); };
             auto virtualprogress = BuildProgressMonitorFromClosure(progress);
-	    PrimInfo pinfo = mesh ? createPrimRefArray<Mesh>(mesh,prims,virtualprogress) 
-              : createPrimRefArray<Mesh,1>(scene,prims,virtualprogress);
 
-            if (presplitFactor > 1.0f)
-              pinfo = presplit<Mesh>(scene, pinfo, prims);
+            /* large scenes can get build in chunks to limit the size of the PrimRef array */
+            size_t chunkSize = mesh ? 0 : g_build_chunk_size;
+            if (chunkSize >= numPrimitives) chunkSize = 0;
+
+            /* fall back to a chunked build if the PrimRef array for the entire scene cannot get allocated */
+            if (chunkSize == 0)
+            {
+              bool outOfMemory = false;
+              try {
+                //bvh->alloc.init(0,0); // FIXME: this improves initial build time significantly but reduces rendering performance slightly
+                bvh->alloc.init(numSplitPrimitives*sizeof(PrimRef),numSplitPrimitives*sizeof(BVH4::Node));  // FIXME: better estimate
+                prims.resize(numSplitPrimitives);
+              } 
+              catch (std::bad_alloc&) {
+                if (mesh) throw;
+                outOfMemory = true;
+              }
+              catch (my_runtime_error& e) {
+                if (mesh || e.error != RTC_OUT_OF_MEMORY) throw;
+                outOfMemory = true;
+              }
+              if (outOfMemory) {
+                prims.clear();
+                chunkSize = max(size_t(4096),numPrimitives/16);
+              }
+            }
 
 	    BVH4::NodeRef root;
-            BVHBuilderBinnedSAH::build_reduce<BVH4::NodeRef>
-	      (root,CreateAlloc(bvh),size_t(0),CreateBVH4Node(bvh),rotate,CreateLeaf<Primitive>(bvh,prims.data()),progress,
-	       prims.data(),pinfo,BVH4::N,BVH4::maxBuildDepthLeaf,sahBlockSize,minLeafSize,maxLeafSize,BVH4::travCost,intCost);
+            PrimInfo pinfo(empty);
+            if (chunkSize == 0)
+            {
+              pinfo = mesh ? createPrimRefArray<Mesh>(mesh,prims,virtualprogress) 
+                : createPrimRefArray<Mesh,1>(scene,prims,virtualprogress);
+
+              if (presplitFactor > 1.0f)
+                pinfo = presplit<Mesh>(scene, pinfo, prims);
+
+              BVHBuilderBinnedSAH::build_reduce<BVH4::NodeRef>
+                (root,CreateAlloc(bvh),size_t(0),CreateBVH4Node(bvh,quantize ? &tmpNodes : NULL),rotate,CreateLeaf<Primitive>(bvh,prims.data()),progress,
+                 prims.data(),pinfo,BVH4::N,BVH4::maxBuildDepthLeaf,sahBlockSize,minLeafSize,maxLeafSize,BVH4::travCost,intCost);
+            }
+            else
+            {
+              /* partition scene into spatially coherent chunks */
+              PrimRefChunks chunks;
+              createPrimRefChunks<Mesh,1>(scene,chunkSize,chunks,virtualprogress);
+              size_t maxChunkSize = 0;
+              for (size_t i=0; i<chunks.size(); i++) maxChunkSize = max(maxChunkSize,chunks.sizes[i]);
+              const size_t maxSplitChunkSize = max(maxChunkSize,size_t(presplitFactor*maxChunkSize));
+              bvh->alloc.init(maxSplitChunkSize*sizeof(PrimRef),maxSplitChunkSize*sizeof(BVH4::Node));
+
+              /* build hierarchy of each chunk, only the PrimRefs of a single chunk are stored at a time */
+              vector<PrimRef> refs(chunks.size());
+              std::vector<BVH4::NodeRef> roots(chunks.size());
+              std::vector<size_t> counts(chunks.size());
+              for (size_t i=0; i<chunks.size(); i++)
+              {
+                prims.resize(max(chunks.sizes[i],size_t(presplitFactor*chunks.sizes[i])));
+                PrimInfo cinfo = createPrimRefArray<Mesh,1>(scene,chunks,i,prims,virtualprogress);
+                if (presplitFactor > 1.0f)
+                  cinfo = presplit<Mesh>(scene, cinfo, prims);
+
+                counts[i] = BVHBuilderBinnedSAH::build_reduce<BVH4::NodeRef>
+                  (roots[i],CreateAlloc(bvh),size_t(0),CreateBVH4Node(bvh,quantize ? &tmpNodes : NULL),rotate,CreateLeaf<Primitive>(bvh,prims.data()),progress,
+                   prims.data(),cinfo,BVH4::N,BVH4::maxBuildDepthLeaf,sahBlockSize,minLeafSize,maxLeafSize,BVH4::travCost,intCost);
+                refs[i] = PrimRef(cinfo.geomBounds,i);
+                pinfo.add(cinfo.geomBounds,center2(cinfo.geomBounds),cinfo.size());
+              }
+              prims.resize(0,true);
+
+              /* link chunk hierarchies under a common toplevel hierarchy */
+              PrimInfo tinfo(empty);
+              for (size_t i=0; i<refs.size(); i++) tinfo.add(refs[i].bounds(),refs[i].center2());
+              BVHBuilderBinnedSAH::build_reduce<BVH4::NodeRef>
+                (root,CreateAlloc(bvh),size_t(0),CreateBVH4Node(bvh,quantize ? &tmpNodes : NULL),rotate,
+                 [&] (const BVHBuilderBinnedSAH::BuildRecord& current, Allocator* alloc) -> size_t
+                 {
+                   assert(current.prims.size() == 1);
+                   const size_t i = refs[current.prims.begin()].ID();
+                   *current.parent = roots[i];
+                   return counts[i];
+                 },
+                 [&] (size_t dn) {},refs.data(),tinfo,BVH4::N,BVH4::maxBuildDepthLeaf,1,1,1,1.0f,1.0f);
+            }
 	    bvh->set(root,pinfo.geomBounds,pinfo.size());
 
 #if ROTATE_TREE
@@ -179,7 +258,13 @@ namespace embree
             bvh->clearBarrier(bvh->root);
 #endif
 
-            bvh->layoutLargeNodes(pinfo.size()*0.005f);
+            /* quantization stores all nodes in depth first order anyway */
+            if (quantize) {
+              bvh->quantize();
+              tmpNodes.clear();
+            }
+            else
+              bvh->layoutLargeNodes(pinfo.size()*0.005f);
 
 #if PROFILE
         }); 
@@ -210,7 +295,10 @@ namespace embree
     Builder* BVH4Triangle4vSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVH4BuilderSAH<TriangleMesh,Triangle4v>((BVH4*)bvh,scene,2,2,1.0f,4,inf,mode); }
     Builder* BVH4Triangle4iSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVH4BuilderSAH<TriangleMesh,Triangle4i>((BVH4*)bvh,scene,2,2,1.0f,4,inf,mode); }
 
+    Builder* BVH4Quad4vSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVH4BuilderSAH<QuadMesh,Quad4v>((BVH4*)bvh,scene,4,4,1.0f,4,inf,mode); }
+
     Builder* BVH4VirtualSceneBuilderSAH    (void* bvh, Scene* scene, size_t mode) { return new BVH4BuilderSAH<UserGeometryBase,AccelSetItem>((BVH4*)bvh,scene,1,1,1.0f,1,1,mode); }
+    Builder* BVH4InstanceArraySceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVH4BuilderSAH<InstanceArray,InstanceArrayItem>((BVH4*)bvh,scene,1,1,1.0f,1,1,mode); }
 
     /* entry functions for the mesh builders */
     Builder* BVH4Triangle1MeshBuilderSAH  (void* bvh, TriangleMesh* mesh, size_t mode) { return new BVH4BuilderSAH<TriangleMesh,Triangle1>((BVH4*)bvh,mesh,1,1,1.0f,2,inf,mode); }
@@ -526,7 +614,7 @@ namespace embree
       {
 	/* skip build for empty scene */
 	const size_t numPrimitives = mesh ? mesh->size() : scene->getNumPrimitives<Mesh,2>();
-        if (numPrimitives == 0) {
+        if (numPrimitives == 0 || (scene && scene->numTimeStepsMB != 2)) {
           prims.clear();
           bvh->clear();
           return;
@@ -562,10 +650,12 @@ namespace embree
 	    const PrimInfo pinfo = mesh ? createPrimRefArray<Mesh>(mesh,prims,virtualprogress) 
               : createPrimRefArray<Mesh,2>(scene,prims,virtualprogress);
 	    BVH4::NodeRef root;
-            BVHBuilderBinnedSAH::build_reduce<BVH4::NodeRef>
+            const std::pair<BBox3fa,BBox3fa> rootBounds = BVHBuilderBinnedSAH::build_reduce<BVH4::NodeRef>
 	      (root,CreateAlloc(bvh),identity,CreateBVH4NodeMB(bvh),reduce,CreateLeafMB<Primitive>(bvh,prims.data()),progress,
 	       prims.data(),pinfo,BVH4::N,BVH4::maxBuildDepthLeaf,sahBlockSize,minLeafSize,maxLeafSize,BVH4::travCost,intCost);
-	    bvh->set(root,pinfo.geomBounds,pinfo.size());
+
+            /* bounds have to enclose both time steps */
+	    bvh->set(root,merge(rootBounds.first,rootBounds.second),pinfo.size());
             
             //bvh->layoutLargeNodes(pinfo.size()*0.005f); // FIXME: enable
 
@@ -584,5 +674,135 @@ namespace embree
     };
 
     Builder* BVH4Triangle4vMBSceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVH4BuilderMblurSAH<TriangleMesh,Triangle4vMB>((BVH4*)bvh,scene,4,4,1.0f,4,inf); }
+
+    /************************************************************************************/ 
+    /************************************************************************************/
+    /************************************************************************************/
+    /************************************************************************************/
+
+    /*! bounds of a subtree for each time step */
+    struct BoundsMB
+    {
+      __forceinline BoundsMB () {
+        for (size_t t=0; t<RTC_MAX_TIME_STEPS; t++) bounds[t] = empty;
+      }
+      BBox3fa bounds[RTC_MAX_TIME_STEPS];
+    };
+
+    struct CreateBVH4SegmentNodeMB
+    {
+      __forceinline CreateBVH4SegmentNodeMB (BVH4* bvh) : bvh(bvh) {}
+      
+      __forceinline BVH4::SegmentNodeMB* operator() (const isa::BVHBuilderBinnedSAH::BuildRecord& current, BVHBuilderBinnedSAH::BuildRecord* children, const size_t N, Allocator* alloc) 
+      {
+        BVH4::SegmentNodeMB* node = (BVH4::SegmentNodeMB*) alloc->alloc0.malloc(BVH4::SegmentNodeMB::bytes(bvh->numTimeSteps)); node->clear(bvh->numTimeSteps);
+        for (size_t i=0; i<N; i++) {
+          children[i].parent = (size_t*)&node->child(i);
+        }
+        *current.parent = bvh->encodeNode(node);
+	return node;
+      }
+
+      BVH4* bvh;
+    };
+
+    template<typename Primitive>
+    struct CreateLeafSegmentMB
+    {
+      __forceinline CreateLeafSegmentMB (BVH4* bvh, PrimRef* prims) : bvh(bvh), prims(prims) {}
+      
+      __forceinline BoundsMB operator() (const BVHBuilderBinnedSAH::BuildRecord& current, Allocator* alloc)
+      {
+        size_t items = Primitive::blocks(current.prims.size());
+        size_t start = current.prims.begin();
+        Primitive* accel = (Primitive*) alloc->alloc1.malloc(items*sizeof(Primitive));
+        BVH4::NodeRef node = bvh->encodeLeaf((char*)accel,items);
+        BoundsMB bounds;
+        for (size_t i=0; i<items; i++)
+          accel[i].fill(prims,start,current.prims.end(),bvh->scene,false,bounds.bounds,bvh->numTimeSteps);
+        *current.parent = node;
+	return bounds;
+      }
+
+      BVH4* bvh;
+      PrimRef* prims;
+    };
+
+    /*! builds a single hierarchy over motion blur meshes with more than
+     *  two time steps, storing the bounds of each time step in the nodes */
+    template<typename Mesh, typename Primitive>
+    struct BVH4BuilderMblurSegmentsSAH : public Builder
+    {
+      BVH4* bvh;
+      Scene* scene;
+      vector<PrimRef> prims; 
+      const size_t sahBlockSize;
+      const float intCost;
+      const size_t minLeafSize;
+      const size_t maxLeafSize;
+
+      BVH4BuilderMblurSegmentsSAH (BVH4* bvh, Scene* scene, const size_t leafBlockSize, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize)
+        : bvh(bvh), scene(scene), sahBlockSize(sahBlockSize), intCost(intCost), minLeafSize(minLeafSize), maxLeafSize(min(maxLeafSize,leafBlockSize*BVH4::maxLeafBlocks)) {}
+
+      void build(size_t, size_t) 
+      {
+	/* skip build for empty scene and for scenes handled by the two time step hierarchy */
+	const size_t numPrimitives = scene->getNumPrimitives<Mesh,2>();
+        const size_t numTimeSteps = scene->numTimeStepsMB;
+        if (numPrimitives == 0 || numTimeSteps <= 2) {
+          prims.clear();
+          bvh->clear();
+          return;
+        }
+
+        /* the leaves load the vertices of the time steps enclosing the ray time */
+        scene->needVertices = true;
+        bvh->numTimeSteps = numTimeSteps;
+      
+	/* reduction function */
+	auto reduce = [numTimeSteps] (BVH4::SegmentNodeMB* node, const BoundsMB* bounds, const size_t N) -> BoundsMB
+	{
+	  assert(N <= BVH4::N);
+          BoundsMB res;
+	  for (size_t i=0; i<N; i++) {
+            for (size_t t=0; t<numTimeSteps; t++) {
+              node->set(i,t,bounds[i].bounds[t]);
+              res.bounds[t].extend(bounds[i].bounds[t]);
+            }
+	  }
+	  return res;
+	};
+
+        double t0 = bvh->preBuild(TOSTRING(isa) "::BVH4BuilderMblurSegmentsSAH");
+
+        if (g_verbose >= 1) t0 = getSeconds();
+	    
+        bvh->alloc.init(numPrimitives*sizeof(PrimRef),numPrimitives*BVH4::SegmentNodeMB::bytes(numTimeSteps));  // FIXME: better estimate
+        prims.resize(numPrimitives);
+        auto progress = [&] (size_t dn) { bvh->scene->progressMonitor(dn); };
+        auto virtualprogress = BuildProgressMonitorFromClosure(progress);
+        const PrimInfo pinfo = createPrimRefArrayMB<Mesh>(scene,prims,virtualprogress);
+        BVH4::NodeRef root;
+        const BoundsMB rootBounds = BVHBuilderBinnedSAH::build_reduce<BVH4::NodeRef>
+          (root,CreateAlloc(bvh),BoundsMB(),CreateBVH4SegmentNodeMB(bvh),reduce,CreateLeafSegmentMB<Primitive>(bvh,prims.data()),progress,
+           prims.data(),pinfo,BVH4::N,BVH4::maxBuildDepthLeaf,sahBlockSize,minLeafSize,maxLeafSize,BVH4::travCost,intCost);
+
+        /* bounds have to enclose all time steps */
+        BBox3fa bounds = empty;
+        for (size_t t=0; t<numTimeSteps; t++) bounds.extend(rootBounds.bounds[t]);
+        bvh->set(root,bounds,pinfo.size());
+
+	/* clear temporary data for static geometry */
+	if (scene->isStatic()) prims.resize(0,true);
+	bvh->alloc.cleanup();
+        bvh->postBuild(t0);
+      }
+
+      void clear() {
+        prims.clear();
+      }
+    };
+
+    Builder* BVH4Triangle4iMBSceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVH4BuilderMblurSegmentsSAH<TriangleMesh,Triangle4iMB>((BVH4*)bvh,scene,4,4,1.0f,4,inf); }
   }
 }
@@ -738,6 +738,7 @@ namespace embree
       Scene* scene;
       vector<PrimRef> prims; 
       ParallelForForPrefixSumState<PrimInfo> pstate;
+      vector<size_t> numMeshFaces; //!< number of faces of each mesh at the last full build
       
       BVH4SubdivPatch1CachedBuilderBinnedSAHClass (BVH4* bvh, Scene* scene)
         : bvh(bvh), scene(scene) {}
@@ -791,6 +792,86 @@ namespace embree
                        Vec3fa(upper_x,upper_y,upper_z));
       }
       
+      /*! creates all patches and their primrefs, in refit mode the patches of
+       *  unmodified meshes and their cached tessellations are kept */
+      PrimInfo createPatches(Scene::Iterator<SubdivMesh>& iter, const size_t numPrimitives, const bool refitMode)
+      {
+        SubdivPatch1Cached *const subdiv_patches = (SubdivPatch1Cached *)this->bvh->data_mem;
+
+        return parallel_for_for_prefix_sum( pstate, iter, PrimInfo(empty), [&](SubdivMesh* mesh, const range<size_t>& r, size_t k, const PrimInfo& base) -> PrimInfo
+        {
+          PrimInfo s(empty);
+
+          /* patches of unmodified meshes are stored in face order, thus we only have to skip them */
+          if (refitMode && !mesh->checkPatchUpdate())
+          {
+            for (size_t patchIndex=base.size(); patchIndex<numPrimitives; patchIndex++) {
+              const SubdivPatch1Cached& patch = subdiv_patches[patchIndex];
+              if (patch.geom != mesh->id || patch.prim >= r.end()) break;
+              s.add(prims[patchIndex].bounds());
+            }
+            return s;
+          }
+
+          for (size_t f=r.begin(); f!=r.end(); ++f) 
+          {
+            if (!mesh->valid(f)) continue;
+
+            /* likewise for faces whose view dependent levels did not change */
+            if (refitMode && !mesh->checkFaceUpdate(f))
+            {
+              for (size_t patchIndex=base.size()+s.size(); patchIndex<numPrimitives; patchIndex++) {
+                const SubdivPatch1Cached& patch = subdiv_patches[patchIndex];
+                if (patch.geom != mesh->id || patch.prim != f) break;
+                s.add(prims[patchIndex].bounds());
+              }
+              continue;
+            }
+
+            feature_adaptive_subdivision_gregory(f,mesh->getHalfEdge(f),mesh->getVertexBuffer(),[&](const CatmullClarkPatch& ipatch, const Vec2f uv[4], const int subdiv[4])
+            {
+              /* the number of patches changed in refit mode, only count the patch as we rebuild anyway */
+              const size_t patchIndex = base.size()+s.size();
+              if (unlikely(patchIndex >= numPrimitives)) {
+                s.add(empty,empty);
+                return;
+              }
+
+              float edge_level[4] = {
+                ipatch.ring[0].edge_level,
+                ipatch.ring[1].edge_level,
+                ipatch.ring[2].edge_level,
+                ipatch.ring[3].edge_level
+              };
+              
+              for (size_t i=0;i<4;i++)
+                edge_level[i] = adjustDiscreteTessellationLevel(edge_level[i],subdiv[i]);
+              
+              subdiv_patches[patchIndex] = SubdivPatch1Cached(ipatch, mesh->id, f, mesh, uv, edge_level);
+              subdiv_patches[patchIndex].resetRootRef();
+              
+              /* compute patch bounds */
+              const BBox3fa bounds = getBounds1(subdiv_patches[patchIndex],mesh);
+              assert(bounds.lower.x <= bounds.upper.x);
+              assert(bounds.lower.y <= bounds.upper.y);
+              assert(bounds.lower.z <= bounds.upper.z);
+              
+              assert( std::isfinite(bounds.lower.x) );
+              assert( std::isfinite(bounds.lower.y) );
+              assert( std::isfinite(bounds.lower.z) );
+              
+              assert( std::isfinite(bounds.upper.x) );
+              assert( std::isfinite(bounds.upper.y) );
+              assert( std::isfinite(bounds.upper.z) );
+              
+              prims[patchIndex] = PrimRef(bounds,patchIndex);
+              s.add(bounds);
+            });
+          }
+          return s;
+        }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a, b); });
+      }
+
       void build(size_t, size_t) 
       {
         /* skip build for empty scene */
@@ -804,34 +885,55 @@ namespace embree
 
         double t0 = bvh->preBuild(TOSTRING(isa) "::BVH4SubdivPatch1CachedBuilderBinnedSAH");
 
-        bool fastUpdateMode = true;
-        size_t fastUpdateMode_numFaces = 0;
-
         auto progress = [&] (size_t dn) { bvh->scene->progressMonitor(dn); };
         auto virtualprogress = BuildProgressMonitorFromClosure(progress);
 
-        /* initialize all half edge structures */
+        /* we can refit the previous bvh if the topology of all meshes is unchanged */
         Scene::Iterator<SubdivMesh> iter(scene);
+        bool refitMode = bvh->root != BVH4::emptyNode && bvh->numPrimitives != 0 && 
+          prims.size() == bvh->numPrimitives && numMeshFaces.size() == iter.size();
+
+        /* initialize all half edge structures */
         for (size_t i=0; i<iter.size(); i++)
+        {
+          const size_t numFaces = iter[i] ? iter[i]->size() : 0;
+          if (refitMode && numMeshFaces[i] != numFaces) refitMode = false;
           if (iter[i]) 
           {
             iter[i]->initializeHalfEdgeStructures();
-            fastUpdateMode_numFaces += iter[i]->size();
-            if (!iter[i]->checkLevelUpdate()) fastUpdateMode = false;
+            if (iter[i]->checkTopologyUpdate()) refitMode = false;
           }
+        }
         
         this->bvh->scene = this->scene; // FIXME: remove
         
-        /* deactivate fast update mode */
-        if (bvh->numPrimitives == 0 || 
-            bvh->numPrimitives != fastUpdateMode_numFaces ||
-            bvh->root          == BVH4::emptyNode)
-          fastUpdateMode = false;
-        
-        /* initialize allocator and parallel_for_for_prefix_sum */
+        /* the prefix sums of the last build stay valid when the task partitioning is unchanged */
+        const size_t prevTaskCount = pstate.taskCount;
+        size_t prevCounts[ParallelForForState::MAX_TASKS];
+        for (size_t i=0; i<prevTaskCount; i++) 
+          prevCounts[i] = pstate.prefix_state.counts[i].size();
         pstate.init(iter,size_t(1024));
-        numPrimitives = fastUpdateMode_numFaces;
-        if (!fastUpdateMode) {
+        if (pstate.taskCount != prevTaskCount) refitMode = false;
+
+        /* regenerate modified patches and refit the bvh */
+        if (refitMode)
+        {
+          numPrimitives = bvh->numPrimitives;
+          createPatches(iter,numPrimitives,true);
+
+          /* faces may have become invalid, which changes the number of patches */
+          for (size_t i=0; i<pstate.taskCount; i++)
+            if (pstate.prefix_state.counts[i].size() != prevCounts[i]) refitMode = false;
+
+          if (refitMode) {
+            DBG_CACHE_BUILDER(std::cout << "refitting..." << std::endl);
+            bvh->bounds = refit(bvh->root);
+          }
+        }
+
+        /* otherwise rebuild from scratch */
+        if (!refitMode)
+        {
           PrimInfo pinfo = parallel_for_for_prefix_sum( pstate, iter, PrimInfo(empty), [&](SubdivMesh* mesh, const range<size_t>& r, size_t k, const PrimInfo& base) -> PrimInfo
           { 
             size_t s = 0;
@@ -848,179 +950,95 @@ namespace embree
             return PrimInfo(s,empty,empty);
           }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo(a.size()+b.size(),empty,empty); });
           numPrimitives = pinfo.size();
-        }
         
-        if (numPrimitives == 0) {
-          prims.resize(numPrimitives);
-          bvh->set(BVH4::emptyNode,empty,0);
-          return;
-        }
+          if (numPrimitives == 0) {
+            prims.resize(numPrimitives);
+            bvh->set(BVH4::emptyNode,empty,0);
+            return;
+          }
 
-        prims.resize(numPrimitives);
+          prims.resize(numPrimitives);
         
-      /* Allocate memory for gregory and b-spline patches */
-     if (this->bvh->size_data_mem < sizeof(SubdivPatch1Cached) * numPrimitives) 
-        {
-         DBG_CACHE_BUILDER(std::cout << "DEALLOCATING SUBDIVPATCH1CACHED MEMORY" << std::endl);
-          if (this->bvh->data_mem) 
-            os_free( this->bvh->data_mem, this->bvh->size_data_mem );
-          this->bvh->data_mem      = NULL;
-          this->bvh->size_data_mem = 0;
-        }
+          /* Allocate memory for gregory and b-spline patches */
+          if (this->bvh->size_data_mem < sizeof(SubdivPatch1Cached) * numPrimitives) 
+          {
+            DBG_CACHE_BUILDER(std::cout << "DEALLOCATING SUBDIVPATCH1CACHED MEMORY" << std::endl);
+            if (this->bvh->data_mem) 
+              os_free( this->bvh->data_mem, this->bvh->size_data_mem );
+            this->bvh->data_mem      = NULL;
+            this->bvh->size_data_mem = 0;
+          }
 
-     if (bvh->data_mem == NULL)
-       {
-         DBG_CACHE_BUILDER(std::cout << "ALLOCATING SUBDIVPATCH1CACHED MEMORY FOR " << numPrimitives << " PRIMITIVES" << std::endl);
-         this->bvh->size_data_mem = sizeof(SubdivPatch1Cached) * numPrimitives;
-         //DBG_PRINT(this->bvh->size_data_mem);
-	 if ( this->bvh->size_data_mem != 0)
-	   this->bvh->data_mem      = os_malloc( this->bvh->size_data_mem );        
-	 else
-	   this->bvh->data_mem      = NULL;
-       }
-     assert(this->bvh->data_mem);
-      SubdivPatch1Cached *const subdiv_patches = (SubdivPatch1Cached *)this->bvh->data_mem;
-
-      PrimInfo pinfo = parallel_for_for_prefix_sum( pstate, iter, PrimInfo(empty), [&](SubdivMesh* mesh, const range<size_t>& r, size_t k, const PrimInfo& base) -> PrimInfo
-      {
-        PrimInfo s(empty);
-        for (size_t f=r.begin(); f!=r.end(); ++f) 
-	{
-          if (!mesh->valid(f)) continue;
+          if (bvh->data_mem == NULL)
+          {
+            DBG_CACHE_BUILDER(std::cout << "ALLOCATING SUBDIVPATCH1CACHED MEMORY FOR " << numPrimitives << " PRIMITIVES" << std::endl);
+            this->bvh->size_data_mem = sizeof(SubdivPatch1Cached) * numPrimitives;
+            if ( this->bvh->size_data_mem != 0)
+              this->bvh->data_mem      = os_malloc( this->bvh->size_data_mem );        
+            else
+              this->bvh->data_mem      = NULL;
+          }
+          assert(this->bvh->data_mem);
 
-	  if (unlikely(fastUpdateMode == false))
-            {
-            
-              feature_adaptive_subdivision_gregory(f,mesh->getHalfEdge(f),mesh->getVertexBuffer(),[&](const CatmullClarkPatch& ipatch, const Vec2f uv[4], const int subdiv[4])
-                                                   {
-                                                     //std::cout.precision(12);
-
-                                                     float edge_level[4] = {
-                                                       ipatch.ring[0].edge_level,
-                                                       ipatch.ring[1].edge_level,
-                                                       ipatch.ring[2].edge_level,
-                                                       ipatch.ring[3].edge_level
-                                                     };
-              
-                                                     for (size_t i=0;i<4;i++)
-                                                       edge_level[i] = adjustDiscreteTessellationLevel(edge_level[i],subdiv[i]);
-              
-                                                     const unsigned int patchIndex = base.size()+s.size();
-                                                     assert(patchIndex < numPrimitives);
-                                                     subdiv_patches[patchIndex] = SubdivPatch1Cached(ipatch, mesh->id, f, mesh, uv, edge_level);
-						     subdiv_patches[patchIndex].resetRootRef();
+          pinfo = createPatches(iter,numPrimitives,false);
 
-              
-                                                     /* compute patch bounds */
-                                                     const BBox3fa bounds = getBounds1(subdiv_patches[patchIndex],mesh);
-                                                     assert(bounds.lower.x <= bounds.upper.x);
-                                                     assert(bounds.lower.y <= bounds.upper.y);
-                                                     assert(bounds.lower.z <= bounds.upper.z);
-              
-						     assert( std::isfinite(bounds.lower.x) );
-						     assert( std::isfinite(bounds.lower.y) );
-						     assert( std::isfinite(bounds.lower.z) );
-						     
-						     assert( std::isfinite(bounds.upper.x) );
-						     assert( std::isfinite(bounds.upper.y) );
-						     assert( std::isfinite(bounds.upper.z) );
-
-                                                     prims[patchIndex] = PrimRef(bounds,patchIndex);
-                                                     s.add(bounds);
-                                                   });
-            }
-	  else
-            {
-	      const SubdivMesh::HalfEdge* first_half_edge = mesh->getHalfEdge(f);
-
-	      float edge_level[4] = {
-		first_half_edge[0].edge_level,
-		first_half_edge[1].edge_level,
-		first_half_edge[2].edge_level,
-		first_half_edge[3].edge_level
-	      };
-              
-	      const unsigned int patchIndex = base.size()+s.size();
-	      subdiv_patches[patchIndex].updateEdgeLevels(edge_level,mesh);
-	      subdiv_patches[patchIndex].resetRootRef();
-              
-	      /* compute patch bounds */
-	      const BBox3fa bounds = getBounds1(subdiv_patches[patchIndex],mesh);
-
-	      assert(bounds.lower.x <= bounds.upper.x);
-	      assert(bounds.lower.y <= bounds.upper.y);
-	      assert(bounds.lower.z <= bounds.upper.z);
-
-	      assert( std::isfinite(bounds.lower.x) );
-	      assert( std::isfinite(bounds.lower.y) );
-	      assert( std::isfinite(bounds.lower.z) );
-	      
-	      assert( std::isfinite(bounds.upper.x) );
-	      assert( std::isfinite(bounds.upper.y) );
-	      assert( std::isfinite(bounds.upper.z) );
-
-	      
-	      prims[patchIndex] = PrimRef(bounds,patchIndex);
-	      s.add(bounds);	      
-	    }
-        }
-        return s;
-      }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a, b); });
+          DBG_CACHE_BUILDER(std::cout << "create prims in " << 1000.0f*t0 << "ms " << std::endl);
+          DBG_CACHE_BUILDER(std::cout << "pinfo.bounds " << pinfo << std::endl);
 
-      DBG_CACHE_BUILDER(std::cout << "create prims in " << 1000.0f*t0 << "ms " << std::endl);
-      DBG_CACHE_BUILDER(std::cout << "pinfo.bounds " << pinfo << std::endl);
+#if 0
+          // to dump tessellated patches in obj format
+          {
+            size_t numTotalTriangles = 0;
+            std::cout << "# OBJ FILE" << std::endl;
+            std::cout << "# " << numPrimitives << " base primitives" << std::endl;
+            SubdivPatch1Cached *const subdiv_patches = (SubdivPatch1Cached *)this->bvh->data_mem;
+            size_t vertex_index = 0;
+            for (size_t i=0;i<numPrimitives;i++)
+              subdiv_patches[i].evalToOBJ(scene,vertex_index,numTotalTriangles);
+            std::cout << "# " << vertex_index << " vertices " << (double)vertex_index * sizeof(Vec3fa) / 1024.0 / 1024.0f << " MB " << std::endl;
+            
+            std::cout << "# " << vertex_index << " normals " << (double)vertex_index * sizeof(Vec3fa) / 1024.0 / 1024.0f << " MB " << std::endl;
+            std::cout << "# " << numTotalTriangles << " numTotalTriangles" << std::endl;
+            
+            exit(0);
+          }
+#endif
 
- #if 0
-      // to dump tessellated patches in obj format
-        {
-	  size_t numTotalTriangles = 0;
-          std::cout << "# OBJ FILE" << std::endl;
-          std::cout << "# " << numPrimitives << " base primitives" << std::endl;
-          SubdivPatch1Cached *const subdiv_patches = (SubdivPatch1Cached *)this->bvh->data_mem;
-          size_t vertex_index = 0;
-          for (size_t i=0;i<numPrimitives;i++)
-            subdiv_patches[i].evalToOBJ(scene,vertex_index,numTotalTriangles);
-          std::cout << "# " << vertex_index << " vertices " << (double)vertex_index * sizeof(Vec3fa) / 1024.0 / 1024.0f << " MB " << std::endl;
-
-          std::cout << "# " << vertex_index << " normals " << (double)vertex_index * sizeof(Vec3fa) / 1024.0 / 1024.0f << " MB " << std::endl;
-          std::cout << "# " << numTotalTriangles << " numTotalTriangles" << std::endl;
- 
-          exit(0);
-        }
+          DBG_CACHE_BUILDER(std::cout << "start building..." << std::endl);
+
+          BVH4::NodeRef root;
+          BVHBuilderBinnedSAH::build<BVH4::NodeRef>
+            (root,CreateAlloc(bvh),CreateBVH4Node(bvh),
+             [&] (const BVHBuilderBinnedSAH::BuildRecord& current, Allocator* alloc) -> int {
+              size_t items = current.pinfo.size();
+              assert(items == 1);
+              const unsigned int patchIndex = prims[current.prims.begin()].ID();
+              SubdivPatch1Cached *const subdiv_patches = (SubdivPatch1Cached *)this->bvh->data_mem;
+              *current.parent = bvh->encodeLeaf((char*)&subdiv_patches[patchIndex],1);
+              return 0;
+            },
+             progress,
+             prims.data(),pinfo,BVH4::N,BVH4::maxBuildDepthLeaf,1,1,1,1.0f,1.0f);
+          bvh->set(root,pinfo.geomBounds,pinfo.size());
+          DBG_CACHE_BUILDER(std::cout << "finsihed building" << std::endl);
+
+          /* the builder reorders the primrefs, sort them by patch index again for later refits */
+          if (!scene->isStatic()) 
+          {
+            vector<PrimRef> sorted(numPrimitives);
+            parallel_for(size_t(0), numPrimitives, size_t(4096), [&](const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++) sorted[prims[i].ID()] = prims[i];
+            });
+            parallel_for(size_t(0), numPrimitives, size_t(4096), [&](const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++) prims[i] = sorted[i];
+            });
+          }
 
-#endif
-     
-      if (fastUpdateMode)
-      {
-        if (bvh->root != BVH4::emptyNode)
-          refit(bvh->root);
-      }
-      else
-      {
-	if (numPrimitives)
-	  {
-	    DBG_CACHE_BUILDER(std::cout << "start building..." << std::endl);
-
-	    BVH4::NodeRef root;
-            BVHBuilderBinnedSAH::build<BVH4::NodeRef>
-	      (root,CreateAlloc(bvh),CreateBVH4Node(bvh),
-	       [&] (const BVHBuilderBinnedSAH::BuildRecord& current, Allocator* alloc) -> int {
-		size_t items = current.pinfo.size();
-		assert(items == 1);
-		const unsigned int patchIndex = prims[current.prims.begin()].ID();
-		SubdivPatch1Cached *const subdiv_patches = (SubdivPatch1Cached *)this->bvh->data_mem;
-		*current.parent = bvh->encodeLeaf((char*)&subdiv_patches[patchIndex],1);
-		return 0;
-	      },
-	       progress,
-	       prims.data(),pinfo,BVH4::N,BVH4::maxBuildDepthLeaf,1,1,1,1.0f,1.0f);
-	    bvh->set(root,pinfo.geomBounds,pinfo.size());
-	    DBG_CACHE_BUILDER(std::cout << "finsihed building" << std::endl);
-
-	  }
-	else
-	  bvh->set(BVH4::emptyNode,empty,0);	  
-      }
+          /* remember the number of faces of each mesh to detect topology changes */
+          numMeshFaces.resize(iter.size());
+          for (size_t i=0; i<iter.size(); i++)
+            numMeshFaces[i] = iter[i] ? iter[i]->size() : 0;
+        }
       
 	/* clear temporary data for static geometry */
 	bool staticGeom = scene->isStatic();
@@ -1031,6 +1049,7 @@ namespace embree
 
       void clear() {
         prims.clear();
+        numMeshFaces.clear();
       }
     };
     
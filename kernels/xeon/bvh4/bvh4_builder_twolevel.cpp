@@ -15,6 +15,7 @@
 // ======================================================================== //
 
 #include "bvh4_builder_twolevel.h"
+#include "bvh4_refit.h"
 #include "bvh4_statistics.h"
 #include "common/profile.h"
 #include "builders/bvh_builder_sah.h"
@@ -26,8 +27,10 @@ namespace embree
 {
   namespace isa
   {
+    const float BVH4BuilderTwoLevel::maxSAHDegradation = 2.0f;
+
     BVH4BuilderTwoLevel::BVH4BuilderTwoLevel (BVH4* bvh, Scene* scene, const createTriangleMeshAccelTy createTriangleMeshAccel) 
-      : bvh(bvh), objects(bvh->objects), scene(scene), createTriangleMeshAccel(createTriangleMeshAccel) {}
+      : bvh(bvh), objects(bvh->objects), scene(scene), createTriangleMeshAccel(createTriangleMeshAccel), numObjects(0), sah(0.0f) {}
     
     BVH4BuilderTwoLevel::~BVH4BuilderTwoLevel ()
     {
@@ -52,6 +55,7 @@ namespace embree
       const size_t numPrimitives = scene->getNumPrimitives<TriangleMesh,1>();
       if (numPrimitives == 0) {
         prims.resize(0);
+        slots.clear();
         bvh->set(BVH4::emptyNode,empty,0);
         return;
       }
@@ -67,9 +71,7 @@ namespace embree
       if (objects.size() < N) {
         objects.resize(N);
         builders.resize(N);
-        refs.resize(N);
       }
-      nextRef = 0;
       
       /* create of acceleration structures */
       parallel_for(size_t(0), N, [&] (const range<size_t>& r) 
@@ -98,7 +100,17 @@ namespace embree
         }
       });
 
+      /* only rebuild modified objects and refit toplevel hierarchy if possible */
+#if !PROFILE
+      if (update_incremental(N,numPrimitives)) {
+        bvh->postBuild(t0);
+        return;
+      }
+#endif
+
       /* parallel build of acceleration structures */
+      refs.resize(N);
+      nextRef = 0;
       parallel_for(size_t(0), N, [&] (const range<size_t>& r) 
       {
         for (size_t objectID=r.begin(); objectID<r.end(); objectID++)
@@ -122,7 +134,7 @@ namespace embree
           
           /* create build primitive */
           if (!object->bounds.empty())
-            refs[nextRef++] = BVH4BuilderTwoLevel::BuildRef(object->bounds,object->root);
+            refs[nextRef++] = BVH4BuilderTwoLevel::BuildRef(object->bounds,object->root,objectID);
         }
       });
       
@@ -138,18 +150,21 @@ namespace embree
         PrimInfo pinfo(empty);
         for (size_t i=r.begin(); i<r.end(); i++) {
           pinfo.add(refs[i].bounds());
-          prims[i] = PrimRef(refs[i].bounds(),(size_t)refs[i].node);
+          prims[i] = PrimRef(refs[i].bounds(),i);
         }
         return pinfo;
       }, [] (const PrimInfo& a, const PrimInfo& b) { return PrimInfo::merge(a,b); });
 
       /* skip if all objects where empty */
-      if (pinfo.size() == 0)
+      if (pinfo.size() == 0) {
         bvh->set(BVH4::emptyNode,empty,0);
+        slots.clear();
+      }
 
       /* otherwise build toplevel hierarchy */
       else
       {
+        slots.resize(refs.size());
         BVH4::NodeRef root;
         BVHBuilderBinnedSAH::build<BVH4::NodeRef>
           (root,
@@ -167,13 +182,22 @@ namespace embree
            [&] (const BVHBuilderBinnedSAH::BuildRecord& current, FastAllocator::ThreadLocal2* alloc) -> int
            {
              assert(current.prims.size() == 1);
-             *current.parent = (BVH4::NodeRef) prims[current.prims.begin()].ID();
+             const size_t i = prims[current.prims.begin()].ID();
+             *current.parent = refs[i].node;
+             slots[i] = Slot((BVH4::NodeRef*)current.parent,i);
              return 1;
            },
            [&] (size_t dn) { bvh->scene->progressMonitor(0); },
            prims.data(),pinfo,BVH4::N,BVH4::maxBuildDepthLeaf,1,1,1,1.0f,1.0f);
         
         bvh->set(root,pinfo.geomBounds,numPrimitives);
+
+        /* remember where build primitives are stored for incremental updates */
+        for (size_t i=0; i<slots.size(); i++)
+          if (slots[i].first == &root) slots[i].first = &bvh->root;
+        std::sort(slots.begin(),slots.end());
+        numObjects = N;
+        sah = 0.0f; refit_toplevel(bvh->root,sah);
       }
 
 #if PROFILE
@@ -193,6 +217,119 @@ namespace embree
 	if (builders[i]) builders[i]->clear();
 
       refs.clear();
+      slots.clear();
+    }
+
+    bool BVH4BuilderTwoLevel::update_incremental(size_t N, size_t numPrimitives)
+    {
+      /* toplevel hierarchy has to exist and no objects may have been added, removed, enabled, or disabled */
+      if (slots.size() == 0 || N != numObjects)
+        return false;
+
+      std::vector<bool> modified(N,false);
+      std::vector<size_t> numRefs(N,0);
+      size_t numModified = 0;
+      for (size_t objectID=0; objectID<N; objectID++)
+      {
+        TriangleMesh* mesh = scene->getTriangleMeshSafe(objectID);
+        if (mesh == NULL || mesh->numTimeSteps != 1) 
+          continue;
+
+        if (mesh->state == Geometry::ENABLING || mesh->state == Geometry::DISABLING || mesh->state == Geometry::ERASING)
+          return false;
+        
+        if (mesh->isModified()) {
+          modified[objectID] = true;
+          numModified++;
+        }
+      }
+      if (numModified == 0) 
+        return true;
+
+      for (size_t i=0; i<refs.size(); i++) 
+        numRefs[refs[i].objectID()]++;
+      for (size_t objectID=0; objectID<N; objectID++)
+        if (modified[objectID] && numRefs[objectID] == 0)
+          return false;
+
+      /* parallel build of modified objects */
+      parallel_for(size_t(0), N, [&] (const range<size_t>& r) 
+      {
+        for (size_t objectID=r.begin(); objectID<r.end(); objectID++)
+        {
+          if (!modified[objectID]) continue;
+          TriangleMesh* mesh = scene->getTriangleMesh(objectID);
+          builders[objectID]->build(0,0);
+          mesh->state = Geometry::ENABLED;
+        }
+      });
+
+      /* refitted objects keep all their nodes, rebuild or restructured objects are reinserted at one of their references */
+      std::vector<bool> refit(N,false), inserted(N,false);
+      for (size_t objectID=0; objectID<N; objectID++) {
+        BVH4Refit* refitter = modified[objectID] ? dynamic_cast<BVH4Refit*>(builders[objectID]) : NULL;
+        refit[objectID] = refitter && refitter->numRestructured == 0;
+      }
+
+      /* update build primitives of modified objects */
+      for (size_t i=0; i<refs.size(); i++)
+      {
+        const unsigned objectID = refs[i].objectID();
+        if (!modified[objectID]) continue;
+
+        BVH4* object = objects[objectID];
+        BVH4::NodeRef node = refs[i].node;
+        BBox3fa bounds = empty;
+        if (!refit[objectID]) 
+        {
+          if (inserted[objectID]) node = BVH4::emptyNode;
+          else { node = object->root; bounds = object->bounds; }
+          inserted[objectID] = true;
+        }
+        else if (node == object->root) 
+          bounds = object->bounds;
+        else if (node.isNode()) 
+          bounds = node.node()->bounds();
+        else if (node != BVH4::emptyNode) {
+          size_t num; char* prim = node.leaf(num);
+          bounds = object->primTy.update(prim,num,scene->getTriangleMesh(objectID));
+        }
+        refs[i] = BuildRef(bounds,node,objectID);
+      }
+
+      /* write changed object roots into toplevel hierarchy */
+      for (size_t i=0; i<slots.size(); i++)
+        *slots[i].first = refs[slots[i].second].node;
+
+      /* refit toplevel hierarchy, rebuild it if its quality degrades too much */
+      float newSAH = 0.0f;
+      const BBox3fa bounds = refit_toplevel(bvh->root,newSAH);
+      if (newSAH > maxSAHDegradation*sah)
+        return false;
+
+      bvh->set(bvh->root,bounds,numPrimitives);
+      return true;
+    }
+
+    BBox3fa BVH4BuilderTwoLevel::refit_toplevel(BVH4::NodeRef& ref, float& sah)
+    {
+      /* this slot references a build primitive */
+      std::vector<Slot>::iterator slot = std::lower_bound(slots.begin(),slots.end(),Slot(&ref,0));
+      if (slot != slots.end() && slot->first == &ref)
+        return refs[slot->second].bounds();
+
+      /* recurse into toplevel nodes */
+      BVH4::Node* node = ref.node();
+      BBox3fa bounds = empty;
+      for (size_t i=0; i<BVH4::N; i++) 
+      {
+        if (node->child(i) == BVH4::emptyNode) { node->set(i,BBox3fa(empty)); continue; }
+        const BBox3fa cbounds = refit_toplevel(node->child(i),sah);
+        node->set(i,cbounds);
+        bounds.extend(cbounds);
+      }
+      if (!bounds.empty()) sah += area(bounds);
+      return bounds;
     }
 
     void BVH4BuilderTwoLevel::open_sequential()
@@ -208,13 +345,14 @@ namespace embree
       {
         std::pop_heap (refs.begin(),refs.end()); 
         BVH4::NodeRef ref = refs.back().node;
+        const unsigned objectID = refs.back().objectID();
         if (ref.isLeaf()) break;
         refs.pop_back();    
         
         BVH4::Node* node = ref.node();
         for (size_t i=0; i<4; i++) {
           if (node->child(i) == BVH4::emptyNode) continue;
-          refs.push_back(BuildRef(node->bounds(i),node->child(i)));
+          refs.push_back(BuildRef(node->bounds(i),node->child(i),objectID));
           std::push_heap (refs.begin(),refs.end()); 
         }
       }
@@ -33,18 +33,23 @@ namespace embree
     public:
       __forceinline BuildRef () {}
       
-      __forceinline BuildRef (const BBox3fa& bounds, BVH4::NodeRef node) 
+      __forceinline BuildRef (const BBox3fa& bounds, BVH4::NodeRef node, unsigned objectID) 
         : lower(bounds.lower), upper(bounds.upper), node(node)
       {
         if (node.isLeaf())
           lower.w = 0.0f;
         else
           lower.w = area(this->bounds());
+        upper.u = objectID;
       }
       
       __forceinline BBox3fa bounds () const {
         return BBox3fa(lower,upper);
       }
+
+      __forceinline unsigned objectID () const {
+        return upper.u;
+      }
       
       friend bool operator< (const BuildRef& a, const BuildRef& b) {
         return a.lower.w < b.lower.w;
@@ -55,6 +60,12 @@ namespace embree
       Vec3fa upper;
       BVH4::NodeRef node;
     };
+
+      /*! slot of the toplevel hierarchy that references some build primitive */
+      typedef std::pair<BVH4::NodeRef*,size_t> Slot;
+
+      /*! toplevel hierarchy gets rebuild if its SAH cost grows larger than this factor by incremental updates */
+      static const float maxSAHDegradation;
       
       /*! Constructor. */
       BVH4BuilderTwoLevel (BVH4* bvh, Scene* scene, const createTriangleMeshAccelTy createTriangleMeshAccel);
@@ -68,6 +79,14 @@ namespace embree
       void clear();
 
       void open_sequential();
+
+    private:
+
+      /*! updates only the modified objects and refits the toplevel hierarchy, returns false if a full toplevel build is required */
+      bool update_incremental(size_t N, size_t numPrimitives);
+
+      /*! refits the toplevel hierarchy and calculates its SAH cost */
+      BBox3fa refit_toplevel(BVH4::NodeRef& ref, float& sah);
       
     public:
       BVH4* bvh;
@@ -81,6 +100,10 @@ namespace embree
       vector<BuildRef> refs;
       vector<PrimRef> prims;
       AlignedAtomicCounter32 nextRef;
+
+      std::vector<Slot> slots;        //!< toplevel slots of all build primitives sorted by address
+      size_t numObjects;              //!< number of objects of last toplevel build
+      float sah;                      //!< SAH cost of toplevel hierarchy after last toplevel build
     };
   }
 }
@@ -0,0 +1,245 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "bvh4.h"
+#include "geometry/triangle4.h"
+#include "geometry/triangle4v.h"
+#include "geometry/triangle4i.h"
+
+namespace embree
+{
+  /*! Header of a stored BVH4. All node references behind the header
+   *  store offsets relative to the start of the header instead of
+   *  pointers. */
+  struct BVH4CacheHeader
+  {
+    char primTy[32];         //!< name of the stored primitive type
+    size_t nodeBytes;        //!< size of a node
+    size_t primBytes;        //!< size of a primitive block
+    size_t bytes;            //!< total number of bytes including this header
+    size_t root;             //!< relative reference to the root node
+    BBox3fa bounds;          //!< bounds of the BVH
+    size_t numPrimitives;    //!< number of primitives the BVH is build over
+    size_t numVertices;      //!< number of vertices the BVH references
+  };
+
+  /*! size of the header rounded up to a cache line */
+  static const size_t headerBytes = (sizeof(BVH4CacheHeader)+63) & ~size_t(63);
+
+  /*! only BVHs with these leaf types can get cached */
+  static bool supportsCache(const PrimitiveType& primTy) {
+    return &primTy == &Triangle4Type::type || &primTy == &Triangle4vType::type || &primTy == &Triangle4iType::type;
+  }
+
+  /*! Triangle4i stores pointers into the vertex buffers which are
+   *  written as offsets relative to the vertex buffer of the mesh. When
+   *  loading, the geometry IDs and vertex offsets are validated against
+   *  the scene, as the cached data may not match the current scene. */
+  static bool relocateTriangle4i(Scene* scene, Triangle4i* tri, size_t num, bool store)
+  {
+    for (size_t i=0; i<num; i++) 
+    {
+      int geomID = tri[i].geomIDs[0];
+      for (size_t k=0; k<4; k++) 
+      {
+        if (tri[i].geomIDs[k] != -1) geomID = tri[i].geomIDs[k];
+        if (store) {
+          const char* base = scene->getTriangleMesh(geomID)->vertexPtr(0);
+          tri[i].v0[k] = (const Vec3f*) ((const char*)tri[i].v0[k] - base);
+          continue;
+        }
+
+        /* the geometry has to be an existing triangle mesh */
+        if (size_t(geomID) >= scene->size()) return false;
+        const Geometry* geometry = scene->get(geomID);
+        if (geometry == NULL || geometry->type != TRIANGLE_MESH) return false;
+        const TriangleMesh* mesh = (const TriangleMesh*) geometry;
+        if (mesh->numVertices == 0) return false;
+
+        /* all 3 vertices have to lie inside the vertex buffer */
+        const ssize_t bytes = mesh->numVertices*mesh->getVertexBufferStride();
+        const ssize_t ofs0 = (size_t) tri[i].v0[k];
+        const ssize_t ofs1 = ofs0 + ssize_t(sizeof(int))*tri[i].v1[k];
+        const ssize_t ofs2 = ofs0 + ssize_t(sizeof(int))*tri[i].v2[k];
+        if (ofs0 < 0 || ofs0+ssize_t(sizeof(Vec3f)) > bytes) return false;
+        if (ofs1 < 0 || ofs1+ssize_t(sizeof(Vec3f)) > bytes) return false;
+        if (ofs2 < 0 || ofs2+ssize_t(sizeof(Vec3f)) > bytes) return false;
+        tri[i].v0[k] = (const Vec3f*) (mesh->vertexPtr(0) + ofs0);
+      }
+    }
+    return true;
+  }
+
+  struct BVH4Writer
+  {
+    BVH4Writer (BVH4* bvh) : bvh(bvh), data(headerBytes) {}
+
+    /*! appends a memory block aligned to 64 bytes and returns its offset */
+    size_t append(const void* ptr, size_t bytes)
+    {
+      const size_t offset = (data.size()+63) & ~size_t(63);
+      data.resize(offset+bytes);
+      memcpy(&data[offset],ptr,bytes);
+      return offset;
+    }
+
+    /*! copies a subtree and returns the relative reference to it */
+    bool write(BVH4::NodeRef ref, BVH4::NodeRef& ref_o)
+    {
+      if (ref == BVH4::emptyNode) {
+        ref_o = BVH4::emptyNode;
+        return true;
+      }
+      
+      if (ref.isBarrier())
+        return false;
+      
+      if (ref.isLeaf()) 
+      {
+        size_t num; char* prim = ref.leaf(num);
+        const size_t offset = append(prim,num*bvh->primTy.bytes);
+        if (&bvh->primTy == &Triangle4iType::type)
+          relocateTriangle4i(bvh->scene,(Triangle4i*)&data[offset],num,true);
+        ref_o = BVH4::encodeLeaf((void*)offset,num);
+        return true;
+      }
+
+      /* children of quantized nodes are stored relative to the node, thus only their offsets change */
+      if (ref.isQuantizedNode())
+      {
+        const BVH4::QuantizedNode* node = ref.quantizedNode();
+        const size_t offset = append(node,sizeof(BVH4::QuantizedNode));
+        for (size_t i=0; i<BVH4::N; i++) {
+          BVH4::NodeRef child = node->child(i);
+          if (child == BVH4::emptyNode) continue;
+          if (!write(child,child)) return false;
+          const size_t ofs = (child & ~(size_t)BVH4::align_mask) - offset;
+          if (ofs > 16*size_t(0x7fffffff)) return false;
+          ((BVH4::QuantizedNode*)&data[offset])->offset[i] = int(ofs/16);
+          ((BVH4::QuantizedNode*)&data[offset])->type[i] = (unsigned char) (child & (size_t)BVH4::align_mask);
+        }
+        ref_o = BVH4::encodeNode((BVH4::QuantizedNode*)offset);
+        return true;
+      }
+
+      if (!ref.isNode())
+        return false;
+
+      const size_t offset = append(ref.node(),sizeof(BVH4::Node));
+      for (size_t i=0; i<BVH4::N; i++) {
+        BVH4::NodeRef child;
+        if (!write(ref.node()->child(i),child)) return false;
+        ((BVH4::Node*)&data[offset])->child(i) = child;
+      }
+      ref_o = BVH4::encodeNode((BVH4::Node*)offset);
+      return true;
+    }
+
+    BVH4* bvh;
+    std::vector<char> data;
+  };
+
+  bool BVH4::store(std::ostream& stream)
+  {
+    if (!supportsCache(primTy) || listMode || objects.size())
+      return false;
+
+    BVH4Writer writer(this);
+    NodeRef root_o;
+    if (!writer.write(root,root_o)) {
+      if (g_verbose >= 1) std::cout << "BVH4<" << primTy.name << "> contains nodes that cannot get cached" << std::endl;
+      return false;
+    }
+
+    BVH4CacheHeader header;
+    memset(&header,0,sizeof(header));
+    strncpy(header.primTy,primTy.name.c_str(),sizeof(header.primTy)-1);
+    header.nodeBytes = sizeof(Node);
+    header.primBytes = primTy.bytes;
+    header.bytes = writer.data.size();
+    header.root = root_o;
+    header.bounds = bounds;
+    header.numPrimitives = numPrimitives;
+    header.numVertices = numVertices;
+    memcpy(&writer.data[0],&header,sizeof(header));
+
+    stream.write(&writer.data[0],writer.data.size());
+    return !stream.fail();
+  }
+
+  /*! converts the relative references of a subtree into pointers,
+   *  children have to be stored behind their parent as written by
+   *  BVH4Writer, which also guarantees termination */
+  static bool relocate(BVH4* bvh, char* base, size_t bytes, BVH4::NodeRef& ref, size_t parent, size_t depth)
+  {
+    if (ref == BVH4::emptyNode) 
+      return true;
+
+    if (depth > BVH4::maxBuildDepthLeaf) 
+      return false;
+
+    if (ref.isLeaf()) 
+    {
+      size_t num; const size_t offset = (size_t) ref.leaf(num);
+      if (offset <= parent || offset+num*bvh->primTy.bytes > bytes) return false;
+      ref = BVH4::encodeLeaf(base+offset,num);
+      if (&bvh->primTy == &Triangle4iType::type)
+        return relocateTriangle4i(bvh->scene,(Triangle4i*)(base+offset),num,false);
+      return true;
+    }
+
+    if (ref.isQuantizedNode())
+    {
+      const size_t offset = ref & ~(size_t)BVH4::align_mask;
+      if (offset <= parent || offset+sizeof(BVH4::QuantizedNode) > bytes) return false;
+      ref = BVH4::encodeNode((BVH4::QuantizedNode*)(base+offset));
+      for (size_t i=0; i<BVH4::N; i++) {
+        const BVH4::NodeRef child = ref.quantizedNode()->child(i);
+        if (child == BVH4::emptyNode) continue;
+        BVH4::NodeRef child_rel = size_t(child) - size_t(base);
+        if (!relocate(bvh,base,bytes,child_rel,offset,depth+1)) return false;
+      }
+      return true;
+    }
+
+    const size_t offset = (size_t) ref;
+    if (!ref.isNode() || offset <= parent || offset+sizeof(BVH4::Node) > bytes) return false;
+    ref = BVH4::encodeNode((BVH4::Node*)(base+offset));
+    for (size_t i=0; i<BVH4::N; i++) 
+      if (!relocate(bvh,base,bytes,ref.node()->child(i),offset,depth+1)) return false;
+    return true;
+  }
+
+  bool BVH4::load(char* ptr, size_t bytes)
+  {
+    if (!supportsCache(primTy) || listMode || bytes < headerBytes)
+      return false;
+
+    const BVH4CacheHeader& header = *(BVH4CacheHeader*) ptr;
+    if (strncmp(header.primTy,primTy.name.c_str(),sizeof(header.primTy)) != 0) return false;
+    if (header.nodeBytes != sizeof(Node) || header.primBytes != primTy.bytes) return false;
+    if (header.bytes > bytes) return false;
+
+    NodeRef root = header.root;
+    if (!relocate(this,ptr,header.bytes,root,headerBytes-1,0))
+      return false;
+
+    alloc.clear();
+    set(root,header.bounds,header.numPrimitives);
+    numVertices = header.numVertices;
+    return true;
+  }
+}
@@ -18,6 +18,7 @@
 
 #include "geometry/bezier1v_intersector1.h"
 #include "geometry/bezier1i_intersector1.h"
+#include "geometry/bezier4q_intersector1.h"
 #include "geometry/triangle1_intersector1_moeller.h"
 #include "geometry/triangle4_intersector1_moeller.h"
 #if defined(__AVX__)
@@ -26,11 +27,14 @@
 #include "geometry/triangle1v_intersector1_pluecker.h"
 #include "geometry/triangle4v_intersector1_pluecker.h"
 #include "geometry/triangle4v_intersector1_moeller_mb.h"
+#include "geometry/triangle4i_mb_intersector1_moeller.h"
 #include "geometry/triangle4i_intersector1.h"
+#include "geometry/quad4v_intersector1_moeller.h"
 #include "geometry/subdivpatch1_intersector1.h"
 #include "geometry/subdivpatch1cached_intersector1.h"
 #include "geometry/grid_intersector1.h"
 #include "geometry/virtual_accel_intersector1.h"
+#include "geometry/instance_intersector1.h"
 #include "geometry/triangle1v_intersector1_moeller_mb.h"
 
 namespace embree
@@ -66,6 +70,10 @@ namespace embree
       const size_t nearY = ray_rdir.y >= 0.0f ? 2*sizeof(ssef) : 3*sizeof(ssef);
       const size_t nearZ = ray_rdir.z >= 0.0f ? 4*sizeof(ssef) : 5*sizeof(ssef);
 
+      /*! time segment of motion blur nodes with bounds for each time step */
+      float ftime = 0.0f;
+      const size_t itime = (types & 0x100000) ? getTimeSegment(ray.time,float(bvh->numTimeSteps-1),ftime) : 0;
+
       /* pop loop */
       while (true) pop:
       {
@@ -104,23 +112,31 @@ namespace embree
           else if (unlikely(cur.isUnalignedNodeMB(types)))
             mask = cur.unalignedNodeMB()->intersect(pre1,org,dir,ray_near,ray_far,ray.time,tNear);
 
+	  /*! process nodes with quantized bounds */
+          else if (likely(cur.isQuantizedNode(types)))
+	    mask = cur.quantizedNode()->intersect<robust>(nearX,nearY,nearZ,org,rdir,org_rdir,ray_near,ray_far,tNear); 
+
+	  /*! process motion blur nodes with bounds for each time step */
+          else if (likely(cur.isSegmentNodeMB(types)))
+	    mask = cur.segmentNodeMB()->intersect(nearX,nearY,nearZ,org,rdir,org_rdir,ray_near,ray_far,itime,ftime,tNear); 
+
           /*! if no child is hit, pop next node */
-	  const BVH4::BaseNode* node = cur.baseNode(types);
+	  const NodeRef node = cur;
           if (unlikely(mask == 0))
             goto pop;
           
           /*! one child is hit, continue with that child */
 	  size_t r = __bscf(mask);
 	  if (likely(mask == 0)) {
-            cur = node->child(r); cur.prefetch(types);
+            cur = node.child(types,r); cur.prefetch(types);
             assert(cur != BVH4::emptyNode);
             continue;
           }
           
           /*! two children are hit, push far child, and continue with closer child */
-          NodeRef c0 = node->child(r); c0.prefetch(types); const unsigned int d0 = ((unsigned int*)&tNear)[r];
+          NodeRef c0 = node.child(types,r); c0.prefetch(types); const unsigned int d0 = ((unsigned int*)&tNear)[r];
           r = __bscf(mask);
-          NodeRef c1 = node->child(r); c1.prefetch(types); const unsigned int d1 = ((unsigned int*)&tNear)[r];
+          NodeRef c1 = node.child(types,r); c1.prefetch(types); const unsigned int d1 = ((unsigned int*)&tNear)[r];
           assert(c0 != BVH4::emptyNode);
           assert(c1 != BVH4::emptyNode);
           if (likely(mask == 0)) {
@@ -139,7 +155,7 @@ namespace embree
           /*! three children are hit, push all onto stack and sort 3 stack items, continue with closest child */
           assert(stackPtr < stackEnd); 
           r = __bscf(mask);
-          NodeRef c = node->child(r); c.prefetch(types); unsigned int d = ((unsigned int*)&tNear)[r]; stackPtr->ptr = c; stackPtr->dist = d; stackPtr++;
+          NodeRef c = node.child(types,r); c.prefetch(types); unsigned int d = ((unsigned int*)&tNear)[r]; stackPtr->ptr = c; stackPtr->dist = d; stackPtr++;
 
 	  if (c == BVH4::emptyNode)
 	    {
@@ -155,7 +171,7 @@ namespace embree
           /*! four children are hit, push all onto stack and sort 4 stack items, continue with closest child */
           assert(stackPtr < stackEnd); 
           r = __bscf(mask);
-          c = node->child(r); c.prefetch(types); d = *(unsigned int*)&tNear[r]; stackPtr->ptr = c; stackPtr->dist = d; stackPtr++;
+          c = node.child(types,r); c.prefetch(types); d = *(unsigned int*)&tNear[r]; stackPtr->ptr = c; stackPtr->dist = d; stackPtr++;
           assert(c != BVH4::emptyNode);
           sort(stackPtr[-1],stackPtr[-2],stackPtr[-3],stackPtr[-4]);
           cur = (NodeRef) stackPtr[-1].ptr; stackPtr--;
@@ -205,6 +221,10 @@ namespace embree
       const size_t nearX = ray_rdir.x >= 0 ? 0*sizeof(ssef) : 1*sizeof(ssef);
       const size_t nearY = ray_rdir.y >= 0 ? 2*sizeof(ssef) : 3*sizeof(ssef);
       const size_t nearZ = ray_rdir.z >= 0 ? 4*sizeof(ssef) : 5*sizeof(ssef);      
+
+      /*! time segment of motion blur nodes with bounds for each time step */
+      float ftime = 0.0f;
+      const size_t itime = (types & 0x100000) ? getTimeSegment(ray.time,float(bvh->numTimeSteps-1),ftime) : 0;
       
       /* pop loop */
       while (true) pop:
@@ -240,23 +260,31 @@ namespace embree
           else if (unlikely(cur.isUnalignedNodeMB(types)))
             mask = cur.unalignedNodeMB()->intersect(pre1,org,dir,ray_near,ray_far,ray.time,tNear);
 
+	  /*! process nodes with quantized bounds */
+          else if (likely(cur.isQuantizedNode(types)))
+	    mask = cur.quantizedNode()->intersect<robust>(nearX,nearY,nearZ,org,rdir,org_rdir,ray_near,ray_far,tNear); 
+
+	  /*! process motion blur nodes with bounds for each time step */
+          else if (likely(cur.isSegmentNodeMB(types)))
+	    mask = cur.segmentNodeMB()->intersect(nearX,nearY,nearZ,org,rdir,org_rdir,ray_near,ray_far,itime,ftime,tNear); 
+
           /*! if no child is hit, pop next node */
-	  const BVH4::BaseNode* node = cur.baseNode(types);
+	  const NodeRef node = cur;
           if (unlikely(mask == 0))
             goto pop;
 	  
 	  /*! one child is hit, continue with that child */
           size_t r = __bscf(mask);
           if (likely(mask == 0)) {
-            cur = node->child(r); cur.prefetch(types); 
+            cur = node.child(types,r); cur.prefetch(types); 
             assert(cur != BVH4::emptyNode);
             continue;
           }
           
           /*! two children are hit, push far child, and continue with closer child */
-          NodeRef c0 = node->child(r); c0.prefetch(types); const unsigned int d0 = ((unsigned int*)&tNear)[r];
+          NodeRef c0 = node.child(types,r); c0.prefetch(types); const unsigned int d0 = ((unsigned int*)&tNear)[r];
           r = __bscf(mask);
-          NodeRef c1 = node->child(r); c1.prefetch(types); const unsigned int d1 = ((unsigned int*)&tNear)[r];
+          NodeRef c1 = node.child(types,r); c1.prefetch(types); const unsigned int d1 = ((unsigned int*)&tNear)[r];
           assert(c0 != BVH4::emptyNode);
           assert(c1 != BVH4::emptyNode);
           if (likely(mask == 0)) {
@@ -271,14 +299,14 @@ namespace embree
           
           /*! three children are hit */
           r = __bscf(mask);
-          cur = node->child(r); cur.prefetch(types);
+          cur = node.child(types,r); cur.prefetch(types);
           assert(cur != BVH4::emptyNode);
           if (likely(mask == 0)) continue;
           assert(stackPtr < stackEnd);
           *stackPtr = cur; stackPtr++;
           
           /*! four children are hit */
-          cur = node->child(3); cur.prefetch(types);
+          cur = node.child(types,3); cur.prefetch(types);
           assert(cur != BVH4::emptyNode);
         }
         
@@ -305,26 +333,41 @@ namespace embree
     
     DEFINE_INTERSECTOR1(BVH4Bezier1vIntersector1_OBB,BVH4Intersector1<0x101 COMMA false COMMA LeafIterator1<Bezier1vIntersector1<LeafMode> > >);
     DEFINE_INTERSECTOR1(BVH4Bezier1iIntersector1_OBB,BVH4Intersector1<0x101 COMMA false COMMA LeafIterator1<Bezier1iIntersector1<LeafMode> > >);
+    DEFINE_INTERSECTOR1(BVH4Bezier4qIntersector1_OBB,BVH4Intersector1<0x101 COMMA false COMMA LeafIterator1<Bezier4qIntersector1<LeafMode> > >);
     DEFINE_INTERSECTOR1(BVH4Bezier1iMBIntersector1_OBB,BVH4Intersector1<0x1010 COMMA false COMMA LeafIterator1<Bezier1iIntersector1MB<LeafMode> > >);
 
     DEFINE_INTERSECTOR1(BVH4Triangle1Intersector1Moeller,BVH4Intersector1<0x1 COMMA false COMMA LeafIterator1<Triangle1Intersector1MoellerTrumbore<LeafMode> > >);
     DEFINE_INTERSECTOR1(BVH4Triangle4Intersector1Moeller,BVH4Intersector1<0x1 COMMA false COMMA LeafIterator1<Triangle4Intersector1MoellerTrumbore<LeafMode> > >);
+    DEFINE_INTERSECTOR1(BVH4Triangle4Intersector1MoellerCulling,BVH4Intersector1<0x1 COMMA false COMMA LeafIterator1<Triangle4Intersector1MoellerTrumbore<LeafMode COMMA true> > >);
 #if defined(__AVX__)
     DEFINE_INTERSECTOR1(BVH4Triangle8Intersector1Moeller,BVH4Intersector1<0x1 COMMA false COMMA LeafIterator1<Triangle8Intersector1MoellerTrumbore<LeafMode> > >);
 #endif
     DEFINE_INTERSECTOR1(BVH4Triangle1vIntersector1Pluecker,BVH4Intersector1<0x1 COMMA true COMMA LeafIterator1<Triangle1vIntersector1Pluecker<LeafMode> > >);
     DEFINE_INTERSECTOR1(BVH4Triangle4vIntersector1Pluecker,BVH4Intersector1<0x1 COMMA true COMMA LeafIterator1<Triangle4vIntersector1Pluecker<LeafMode> > >);
+    DEFINE_INTERSECTOR1(BVH4Triangle4vIntersector1PlueckerCulling,BVH4Intersector1<0x1 COMMA true COMMA LeafIterator1<Triangle4vIntersector1Pluecker<LeafMode COMMA true> > >);
     DEFINE_INTERSECTOR1(BVH4Triangle4iIntersector1Pluecker,BVH4Intersector1<0x1 COMMA true COMMA LeafIterator1<Triangle4iIntersector1Pluecker<LeafMode> > >);
+    DEFINE_INTERSECTOR1(BVH4Triangle4iIntersector1PlueckerCulling,BVH4Intersector1<0x1 COMMA true COMMA LeafIterator1<Triangle4iIntersector1Pluecker<LeafMode COMMA true> > >);
+    DEFINE_INTERSECTOR1(BVH4Triangle4iQuantizedIntersector1Pluecker,BVH4Intersector1<0x10001 COMMA true COMMA LeafIterator1<Triangle4iIntersector1Pluecker<LeafMode> > >);
+    DEFINE_INTERSECTOR1(BVH4Triangle4iQuantizedIntersector1PlueckerCulling,BVH4Intersector1<0x10001 COMMA true COMMA LeafIterator1<Triangle4iIntersector1Pluecker<LeafMode COMMA true> > >);
+
+    DEFINE_INTERSECTOR1(BVH4Quad4vIntersector1Moeller,BVH4Intersector1<0x1 COMMA false COMMA LeafIterator1<Quad4vIntersector1MoellerTrumbore<LeafMode> > >);
+    DEFINE_INTERSECTOR1(BVH4Quad4vIntersector1MoellerCulling,BVH4Intersector1<0x1 COMMA false COMMA LeafIterator1<Quad4vIntersector1MoellerTrumbore<LeafMode COMMA true> > >);
 
     DEFINE_INTERSECTOR1(BVH4Subdivpatch1Intersector1,BVH4Intersector1<0x1 COMMA true COMMA LeafIterator1<SubdivPatch1Intersector1 > >);
     DEFINE_INTERSECTOR1(BVH4Subdivpatch1CachedIntersector1,BVH4Intersector1<0x1 COMMA true COMMA SubdivPatch1CachedIntersector1>);
+    DEFINE_INTERSECTOR1(BVH4Subdivpatch1CachedIntersector1Culling,BVH4Intersector1<0x1 COMMA true COMMA SubdivPatch1CachedIntersector1Culling>);
 
     DEFINE_INTERSECTOR1(BVH4GridIntersector1,BVH4Intersector1<0x1 COMMA true COMMA GridIntersector1>);
     DEFINE_INTERSECTOR1(BVH4GridLazyIntersector1,BVH4Intersector1<0x1 COMMA true COMMA Switch2Intersector1<GridIntersector1 COMMA GridLazyIntersector1> >);
 
     DEFINE_INTERSECTOR1(BVH4VirtualIntersector1,BVH4Intersector1<0x1 COMMA false COMMA LeafIterator1<VirtualAccelIntersector1> >);
+    DEFINE_INTERSECTOR1(BVH4InstanceArrayIntersector1,BVH4Intersector1<0x1 COMMA false COMMA LeafIterator1<InstanceArrayIntersector1> >);
 
     DEFINE_INTERSECTOR1(BVH4Triangle1vMBIntersector1Moeller,BVH4Intersector1<0x10 COMMA false COMMA LeafIterator1<Triangle1vIntersector1MoellerTrumboreMB<LeafMode> > >);
+    DEFINE_INTERSECTOR1(BVH4Triangle1vMBIntersector1MoellerCulling,BVH4Intersector1<0x10 COMMA false COMMA LeafIterator1<Triangle1vIntersector1MoellerTrumboreMB<LeafMode COMMA true> > >);
     DEFINE_INTERSECTOR1(BVH4Triangle4vMBIntersector1Moeller,BVH4Intersector1<0x10 COMMA false COMMA LeafIterator1<Triangle4vMBIntersector1MoellerTrumbore<LeafMode> > >);
+    DEFINE_INTERSECTOR1(BVH4Triangle4vMBIntersector1MoellerCulling,BVH4Intersector1<0x10 COMMA false COMMA LeafIterator1<Triangle4vMBIntersector1MoellerTrumbore<LeafMode COMMA true> > >);
+    DEFINE_INTERSECTOR1(BVH4Triangle4iMBIntersector1Moeller,BVH4Intersector1<0x100000 COMMA false COMMA LeafIterator1<Triangle4iMBIntersector1MoellerTrumbore<LeafMode> > >);
+    DEFINE_INTERSECTOR1(BVH4Triangle4iMBIntersector1MoellerCulling,BVH4Intersector1<0x100000 COMMA false COMMA LeafIterator1<Triangle4iMBIntersector1MoellerTrumbore<LeafMode COMMA true> > >);
   }
 }
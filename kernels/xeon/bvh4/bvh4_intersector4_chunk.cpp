@@ -26,7 +26,9 @@
 #include "geometry/triangle1v_intersector4_pluecker.h"
 #include "geometry/triangle4v_intersector4_pluecker.h"
 #include "geometry/triangle4i_intersector4.h"
+#include "geometry/quad4v_intersector4_moeller.h"
 #include "geometry/virtual_accel_intersector4.h"
+#include "geometry/instance_intersector4.h"
 #include "geometry/triangle1v_intersector4_moeller_mb.h"
 #include "geometry/triangle4v_intersector4_moeller_mb.h"
 
@@ -173,6 +175,54 @@ namespace embree
 	      }	      
 	    }
 	  }
+	  /* process nodes with quantized bounds */
+          else if (likely((types & 0x10000) && cur.isQuantizedNode()))
+	  {
+	    const sseb valid_node = ray_tfar > curDist;
+	    STAT3(normal.trav_nodes,1,popcnt(valid_node),8);
+	    const BVH4::QuantizedNode* __restrict__ const node = cur.quantizedNode();
+          
+	    /* pop of next node */
+	    assert(sptr_node > stack_node);
+	    sptr_node--;
+	    sptr_near--;
+	    cur = *sptr_node; 
+	    curDist = *sptr_near;
+	    
+#pragma unroll(4)
+	    for (unsigned i=0; i<BVH4::N; i++)
+	    {
+	      const NodeRef child = node->child(i);
+	      if (unlikely(child == BVH4::emptyNode)) break;
+	      ssef lnearP; const sseb lhit = node->intersect<robust>(i,org,rdir,org_rdir,ray_tnear,ray_tfar,lnearP);
+	      
+	      /* if we hit the child we choose to continue with that child if it 
+		 is closer than the current next child, or we push it onto the stack */
+	      if (likely(any(lhit)))
+	      {
+		assert(sptr_node < stackEnd);
+		assert(child != BVH4::emptyNode);
+		const ssef childDist = select(lhit,lnearP,inf);
+		sptr_node++;
+		sptr_near++;
+		
+		/* push cur node onto stack and continue with hit child */
+		if (any(childDist < curDist))
+		{
+		  *(sptr_node-1) = cur;
+		  *(sptr_near-1) = curDist; 
+		  curDist = childDist;
+		  cur = child;
+		}
+		
+		/* push hit child onto stack */
+		else {
+		  *(sptr_node-1) = child;
+		  *(sptr_near-1) = childDist; 
+		}
+	      }	      
+	    }
+	  }
 	  else 
 	    break;
         }
@@ -334,6 +384,54 @@ namespace embree
 	      }	      
 	    }
 	  }
+	  /* process nodes with quantized bounds */
+          else if (likely((types & 0x10000) && cur.isQuantizedNode()))
+	  {
+	    const sseb valid_node = ray_tfar > curDist;
+	    STAT3(normal.trav_nodes,1,popcnt(valid_node),8);
+	    const BVH4::QuantizedNode* __restrict__ const node = cur.quantizedNode();
+          
+	    /* pop of next node */
+	    assert(sptr_node > stack_node);
+	    sptr_node--;
+	    sptr_near--;
+	    cur = *sptr_node; 
+	    curDist = *sptr_near;
+	    
+#pragma unroll(4)
+	    for (unsigned i=0; i<BVH4::N; i++)
+	    {
+	      const NodeRef child = node->child(i);
+	      if (unlikely(child == BVH4::emptyNode)) break;
+	      ssef lnearP; const sseb lhit = node->intersect<robust>(i,org,rdir,org_rdir,ray_tnear,ray_tfar,lnearP);
+	      
+	      /* if we hit the child we choose to continue with that child if it 
+		 is closer than the current next child, or we push it onto the stack */
+	      if (likely(any(lhit)))
+	      {
+		assert(sptr_node < stackEnd);
+		assert(child != BVH4::emptyNode);
+		const ssef childDist = select(lhit,lnearP,inf);
+		sptr_node++;
+		sptr_near++;
+		
+		/* push cur node onto stack and continue with hit child */
+		if (any(childDist < curDist))
+		{
+		  *(sptr_node-1) = cur;
+		  *(sptr_near-1) = curDist; 
+		  curDist = childDist;
+		  cur = child;
+		}
+		
+		/* push hit child onto stack */
+		else {
+		  *(sptr_node-1) = child;
+		  *(sptr_near-1) = childDist; 
+		}
+	      }	      
+	    }
+	  }
 	  else 
 	    break;
         }
@@ -362,16 +460,27 @@ namespace embree
     DEFINE_INTERSECTOR4(BVH4Triangle1Intersector4ChunkMoeller, BVH4Intersector4Chunk<0x1 COMMA false COMMA LeafIterator4<Triangle1Intersector4MoellerTrumbore<LeafMode> > >);
     DEFINE_INTERSECTOR4(BVH4Triangle4Intersector4ChunkMoeller, BVH4Intersector4Chunk<0x1 COMMA false COMMA LeafIterator4<Triangle4Intersector4MoellerTrumbore<LeafMode COMMA true> > >);
     DEFINE_INTERSECTOR4(BVH4Triangle4Intersector4ChunkMoellerNoFilter, BVH4Intersector4Chunk<0x1 COMMA false COMMA LeafIterator4<Triangle4Intersector4MoellerTrumbore<LeafMode COMMA false> > >);
+    DEFINE_INTERSECTOR4(BVH4Triangle4Intersector4ChunkMoellerCulling, BVH4Intersector4Chunk<0x1 COMMA false COMMA LeafIterator4<Triangle4Intersector4MoellerTrumbore<LeafMode COMMA true COMMA true> > >);
+    DEFINE_INTERSECTOR4(BVH4Triangle4Intersector4ChunkMoellerNoFilterCulling, BVH4Intersector4Chunk<0x1 COMMA false COMMA LeafIterator4<Triangle4Intersector4MoellerTrumbore<LeafMode COMMA false COMMA true> > >);
 #if defined (__AVX__)
     DEFINE_INTERSECTOR4(BVH4Triangle8Intersector4ChunkMoeller, BVH4Intersector4Chunk<0x1 COMMA false COMMA LeafIterator4<Triangle8Intersector4MoellerTrumbore<LeafMode COMMA true> > >);
     DEFINE_INTERSECTOR4(BVH4Triangle8Intersector4ChunkMoellerNoFilter, BVH4Intersector4Chunk<0x1 COMMA false COMMA LeafIterator4<Triangle8Intersector4MoellerTrumbore<LeafMode COMMA false> > >);
 #endif
     DEFINE_INTERSECTOR4(BVH4Triangle1vIntersector4ChunkPluecker, BVH4Intersector4Chunk<0x1 COMMA true COMMA LeafIterator4<Triangle1vIntersector4Pluecker<LeafMode> > >);
     DEFINE_INTERSECTOR4(BVH4Triangle4vIntersector4ChunkPluecker, BVH4Intersector4Chunk<0x1 COMMA true COMMA LeafIterator4<Triangle4vIntersector4Pluecker<LeafMode> > >);
+    DEFINE_INTERSECTOR4(BVH4Triangle4vIntersector4ChunkPlueckerCulling, BVH4Intersector4Chunk<0x1 COMMA true COMMA LeafIterator4<Triangle4vIntersector4Pluecker<LeafMode COMMA true> > >);
     DEFINE_INTERSECTOR4(BVH4Triangle4iIntersector4ChunkPluecker, BVH4Intersector4Chunk<0x1 COMMA true COMMA LeafIterator4<Triangle4iIntersector4Pluecker<LeafMode> > >);
+    DEFINE_INTERSECTOR4(BVH4Triangle4iIntersector4ChunkPlueckerCulling, BVH4Intersector4Chunk<0x1 COMMA true COMMA LeafIterator4<Triangle4iIntersector4Pluecker<LeafMode COMMA true> > >);
+    DEFINE_INTERSECTOR4(BVH4Triangle4iQuantizedIntersector4ChunkPluecker, BVH4Intersector4Chunk<0x10001 COMMA true COMMA LeafIterator4<Triangle4iIntersector4Pluecker<LeafMode> > >);
+    DEFINE_INTERSECTOR4(BVH4Triangle4iQuantizedIntersector4ChunkPlueckerCulling, BVH4Intersector4Chunk<0x10001 COMMA true COMMA LeafIterator4<Triangle4iIntersector4Pluecker<LeafMode COMMA true> > >);
+    DEFINE_INTERSECTOR4(BVH4Quad4vIntersector4ChunkMoeller, BVH4Intersector4Chunk<0x1 COMMA false COMMA LeafIterator4<Quad4vIntersector4MoellerTrumbore<LeafMode COMMA true> > >);
+    DEFINE_INTERSECTOR4(BVH4Quad4vIntersector4ChunkMoellerCulling, BVH4Intersector4Chunk<0x1 COMMA false COMMA LeafIterator4<Quad4vIntersector4MoellerTrumbore<LeafMode COMMA true COMMA true> > >);
     DEFINE_INTERSECTOR4(BVH4VirtualIntersector4Chunk, BVH4Intersector4Chunk<0x1 COMMA false COMMA LeafIterator4<VirtualAccelIntersector4> >);
+    DEFINE_INTERSECTOR4(BVH4InstanceArrayIntersector4Chunk, BVH4Intersector4Chunk<0x1 COMMA false COMMA LeafIterator4<InstanceArrayIntersector4> >);
 
     DEFINE_INTERSECTOR4(BVH4Triangle1vMBIntersector4ChunkMoeller, BVH4Intersector4Chunk<0x10 COMMA false COMMA LeafIterator4<Triangle1vIntersector4MoellerTrumboreMB<LeafMode> > >);
+    DEFINE_INTERSECTOR4(BVH4Triangle1vMBIntersector4ChunkMoellerCulling, BVH4Intersector4Chunk<0x10 COMMA false COMMA LeafIterator4<Triangle1vIntersector4MoellerTrumboreMB<LeafMode COMMA true> > >);
     DEFINE_INTERSECTOR4(BVH4Triangle4vMBIntersector4ChunkMoeller, BVH4Intersector4Chunk<0x10 COMMA false COMMA LeafIterator4<Triangle4vMBIntersector4MoellerTrumbore<LeafMode COMMA true> > >);
+    DEFINE_INTERSECTOR4(BVH4Triangle4vMBIntersector4ChunkMoellerCulling, BVH4Intersector4Chunk<0x10 COMMA false COMMA LeafIterator4<Triangle4vMBIntersector4MoellerTrumbore<LeafMode COMMA true COMMA true> > >);
   }
 }
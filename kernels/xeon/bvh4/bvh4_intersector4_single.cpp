@@ -19,9 +19,11 @@
 
 #include "geometry/bezier1v_intersector4.h"
 #include "geometry/bezier1i_intersector4.h"
+#include "geometry/bezier4q_intersector4.h"
 #include "geometry/subdivpatch1_intersector1.h"
 #include "geometry/subdivpatch1cached_intersector1.h"
 #include "geometry/grid_intersector1.h"
+#include "geometry/triangle4i_mb_intersector1_moeller.h"
 
 namespace embree
 {
@@ -108,7 +110,7 @@ namespace embree
       ray.get(rays);
       size_t bits = movemask(*valid_i);
       for (size_t i=__bsf(bits); bits!=0; bits=__btc(bits,i), i=__bsf(bits)) {
-	Intersector1::intersect(bvh,rays[i]);
+	Intersector1::occluded(bvh,rays[i]);
       }
       ray.set(rays);
       AVX_ZERO_UPPER();
@@ -116,12 +118,17 @@ namespace embree
 
     DEFINE_INTERSECTOR4(BVH4Bezier1vIntersector4Single_OBB, BVH4Intersector4Single<0x101 COMMA false COMMA LeafIterator4_1<Bezier1vIntersector4<LeafMode> > >);
     DEFINE_INTERSECTOR4(BVH4Bezier1iIntersector4Single_OBB, BVH4Intersector4Single<0x101 COMMA false COMMA LeafIterator4_1<Bezier1iIntersector4<LeafMode> > >);
+    DEFINE_INTERSECTOR4(BVH4Bezier4qIntersector4Single_OBB, BVH4Intersector4Single<0x101 COMMA false COMMA LeafIterator4_1<Bezier4qIntersector4<LeafMode> > >);
     DEFINE_INTERSECTOR4(BVH4Bezier1iMBIntersector4Single_OBB,BVH4Intersector4Single<0x1010 COMMA false COMMA LeafIterator4_1<Bezier1iIntersector4MB<LeafMode> > >);
 
     DEFINE_INTERSECTOR4(BVH4Subdivpatch1Intersector4, BVH4Intersector4FromIntersector1<BVH4Intersector1<0x1 COMMA true COMMA LeafIterator1<SubdivPatch1Intersector1 > > >);
     DEFINE_INTERSECTOR4(BVH4Subdivpatch1CachedIntersector4,BVH4Intersector4FromIntersector1<BVH4Intersector1<0x1 COMMA true COMMA SubdivPatch1CachedIntersector1> >);
+    DEFINE_INTERSECTOR4(BVH4Subdivpatch1CachedIntersector4Culling,BVH4Intersector4FromIntersector1<BVH4Intersector1<0x1 COMMA true COMMA SubdivPatch1CachedIntersector1Culling> >);
 
     DEFINE_INTERSECTOR4(BVH4GridIntersector4, BVH4Intersector4FromIntersector1<BVH4Intersector1<0x1 COMMA true COMMA GridIntersector1> >);
     DEFINE_INTERSECTOR4(BVH4GridLazyIntersector4, BVH4Intersector4FromIntersector1<BVH4Intersector1<0x1 COMMA true COMMA Switch2Intersector1<GridIntersector1 COMMA GridLazyIntersector1> > >);
+
+    DEFINE_INTERSECTOR4(BVH4Triangle4iMBIntersector4Moeller, BVH4Intersector4FromIntersector1<BVH4Intersector1<0x100000 COMMA false COMMA LeafIterator1<Triangle4iMBIntersector1MoellerTrumbore<LeafMode> > > >);
+    DEFINE_INTERSECTOR4(BVH4Triangle4iMBIntersector4MoellerCulling, BVH4Intersector4FromIntersector1<BVH4Intersector1<0x100000 COMMA false COMMA LeafIterator1<Triangle4iMBIntersector1MoellerTrumbore<LeafMode COMMA true> > > >);
    }
 }
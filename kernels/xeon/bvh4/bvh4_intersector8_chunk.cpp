@@ -24,7 +24,9 @@
 #include "geometry/triangle1v_intersector8_pluecker.h"
 #include "geometry/triangle4v_intersector8_pluecker.h"
 #include "geometry/triangle4i_intersector8.h"
+#include "geometry/quad4v_intersector8_moeller.h"
 #include "geometry/virtual_accel_intersector8.h"
+#include "geometry/instance_intersector8.h"
 #include "geometry/triangle1v_intersector8_moeller_mb.h"
 #include "geometry/triangle4v_intersector8_moeller_mb.h"
 
@@ -171,6 +173,54 @@ namespace embree
 	      }	      
 	    }
 	  }
+	  /* process nodes with quantized bounds */
+          else if (likely((types & 0x10000) && cur.isQuantizedNode()))
+	  {
+	    const avxb valid_node = ray_tfar > curDist;
+	    STAT3(normal.trav_nodes,1,popcnt(valid_node),8);
+	    const BVH4::QuantizedNode* __restrict__ const node = cur.quantizedNode();
+          
+	    /* pop of next node */
+	    assert(sptr_node > stack_node);
+	    sptr_node--;
+	    sptr_near--;
+	    cur = *sptr_node; 
+	    curDist = *sptr_near;
+	    
+#pragma unroll(4)
+	    for (unsigned i=0; i<BVH4::N; i++)
+	    {
+	      const NodeRef child = node->child(i);
+	      if (unlikely(child == BVH4::emptyNode)) break;
+	      avxf lnearP; const avxb lhit = node->intersect8<robust>(i,org,rdir,org_rdir,ray_tnear,ray_tfar,lnearP);
+	      	      
+	      /* if we hit the child we choose to continue with that child if it 
+		 is closer than the current next child, or we push it onto the stack */
+	      if (likely(any(lhit)))
+	      {
+		assert(sptr_node < stackEnd);
+		assert(child != BVH4::emptyNode);
+		const avxf childDist = select(lhit,lnearP,inf);
+		sptr_node++;
+		sptr_near++;
+		
+		/* push cur node onto stack and continue with hit child */
+		if (any(childDist < curDist))
+		{
+		  *(sptr_node-1) = cur;
+		  *(sptr_near-1) = curDist; 
+		  curDist = childDist;
+		  cur = child;
+		}
+		
+		/* push hit child onto stack */
+		else {
+		  *(sptr_node-1) = child;
+		  *(sptr_near-1) = childDist; 
+		}
+	      }	      
+	    }
+	  }
 	  else 
 	    break;
 	}
@@ -332,6 +382,54 @@ namespace embree
 	      }	      
 	    }
 	  }
+	  /* process nodes with quantized bounds */
+          else if (likely((types & 0x10000) && cur.isQuantizedNode()))
+	  {
+	    const avxb valid_node = ray_tfar > curDist;
+	    STAT3(normal.trav_nodes,1,popcnt(valid_node),8);
+	    const BVH4::QuantizedNode* __restrict__ const node = cur.quantizedNode();
+          
+	    /* pop of next node */
+	    assert(sptr_node > stack_node);
+	    sptr_node--;
+	    sptr_near--;
+	    cur = *sptr_node; 
+	    curDist = *sptr_near;
+	    
+#pragma unroll(4)
+	    for (unsigned i=0; i<BVH4::N; i++)
+	    {
+	      const NodeRef child = node->child(i);
+	      if (unlikely(child == BVH4::emptyNode)) break;
+	      avxf lnearP; const avxb lhit = node->intersect8<robust>(i,org,rdir,org_rdir,ray_tnear,ray_tfar,lnearP);
+	      	      
+	      /* if we hit the child we choose to continue with that child if it 
+		 is closer than the current next child, or we push it onto the stack */
+	      if (likely(any(lhit)))
+	      {
+		assert(sptr_node < stackEnd);
+		assert(child != BVH4::emptyNode);
+		const avxf childDist = select(lhit,lnearP,inf);
+		sptr_node++;
+		sptr_near++;
+
+		/* push cur node onto stack and continue with hit child */
+		if (any(childDist < curDist))
+		{
+		  *(sptr_node-1) = cur;
+		  *(sptr_near-1) = curDist; 
+		  curDist = childDist;
+		  cur = child;
+		}
+		
+		/* push hit child onto stack */
+		else {
+		  *(sptr_node-1) = child;
+		  *(sptr_near-1) = childDist; 
+		}
+	      }	      
+	    }
+	  }
 	  else 
 	    break;
 	}
@@ -365,9 +463,17 @@ namespace embree
     DEFINE_INTERSECTOR8(BVH4Triangle1vIntersector8ChunkPluecker, BVH4Intersector8Chunk<0x1 COMMA true COMMA LeafIterator8<Triangle1vIntersector8Pluecker<LeafMode> > >);
     DEFINE_INTERSECTOR8(BVH4Triangle4vIntersector8ChunkPluecker, BVH4Intersector8Chunk<0x1 COMMA true COMMA LeafIterator8<Triangle4vIntersector8Pluecker<LeafMode> > >);
     DEFINE_INTERSECTOR8(BVH4Triangle4iIntersector8ChunkPluecker, BVH4Intersector8Chunk<0x1 COMMA true COMMA LeafIterator8<Triangle4iIntersector8Pluecker<LeafMode> > >);
+    DEFINE_INTERSECTOR8(BVH4Triangle4iIntersector8ChunkPlueckerCulling, BVH4Intersector8Chunk<0x1 COMMA true COMMA LeafIterator8<Triangle4iIntersector8Pluecker<LeafMode COMMA true> > >);
+    DEFINE_INTERSECTOR8(BVH4Triangle4iQuantizedIntersector8ChunkPluecker, BVH4Intersector8Chunk<0x10001 COMMA true COMMA LeafIterator8<Triangle4iIntersector8Pluecker<LeafMode> > >);
+    DEFINE_INTERSECTOR8(BVH4Triangle4iQuantizedIntersector8ChunkPlueckerCulling, BVH4Intersector8Chunk<0x10001 COMMA true COMMA LeafIterator8<Triangle4iIntersector8Pluecker<LeafMode COMMA true> > >);
+    DEFINE_INTERSECTOR8(BVH4Quad4vIntersector8ChunkMoeller, BVH4Intersector8Chunk<0x1 COMMA false COMMA LeafIterator8<Quad4vIntersector8MoellerTrumbore<LeafMode COMMA true> > >);
+    DEFINE_INTERSECTOR8(BVH4Quad4vIntersector8ChunkMoellerCulling, BVH4Intersector8Chunk<0x1 COMMA false COMMA LeafIterator8<Quad4vIntersector8MoellerTrumbore<LeafMode COMMA true COMMA true> > >);
     DEFINE_INTERSECTOR8(BVH4VirtualIntersector8Chunk, BVH4Intersector8Chunk<0x1 COMMA false COMMA LeafIterator8<VirtualAccelIntersector8> >);
+    DEFINE_INTERSECTOR8(BVH4InstanceArrayIntersector8Chunk, BVH4Intersector8Chunk<0x1 COMMA false COMMA LeafIterator8<InstanceArrayIntersector8> >);
 
     DEFINE_INTERSECTOR8(BVH4Triangle1vMBIntersector8ChunkMoeller, BVH4Intersector8Chunk<0x10 COMMA false COMMA LeafIterator8<Triangle1vIntersector8MoellerTrumboreMB<LeafMode> > >);
+    DEFINE_INTERSECTOR8(BVH4Triangle1vMBIntersector8ChunkMoellerCulling, BVH4Intersector8Chunk<0x10 COMMA false COMMA LeafIterator8<Triangle1vIntersector8MoellerTrumboreMB<LeafMode COMMA true> > >);
     DEFINE_INTERSECTOR8(BVH4Triangle4vMBIntersector8ChunkMoeller, BVH4Intersector8Chunk<0x10 COMMA false COMMA LeafIterator8<Triangle4vMBIntersector8MoellerTrumbore<LeafMode COMMA true> > >);
+    DEFINE_INTERSECTOR8(BVH4Triangle4vMBIntersector8ChunkMoellerCulling, BVH4Intersector8Chunk<0x10 COMMA false COMMA LeafIterator8<Triangle4vMBIntersector8MoellerTrumbore<LeafMode COMMA true COMMA true> > >);
   }
 }
@@ -19,9 +19,11 @@
 
 #include "geometry/bezier1v_intersector8.h"
 #include "geometry/bezier1i_intersector8.h"
+#include "geometry/bezier4q_intersector8.h"
 #include "geometry/subdivpatch1_intersector1.h"
 #include "geometry/subdivpatch1cached_intersector1.h"
 #include "geometry/grid_intersector1.h"
+#include "geometry/triangle4i_mb_intersector1_moeller.h"
 
 namespace embree
 {
@@ -107,7 +109,7 @@ namespace embree
       ray.get(rays);
       size_t bits = movemask(*valid_i);
       for (size_t i=__bsf(bits); bits!=0; bits=__btc(bits,i), i=__bsf(bits)) {
-	Intersector1::intersect(bvh,rays[i]);
+	Intersector1::occluded(bvh,rays[i]);
       }
       ray.set(rays);
       AVX_ZERO_UPPER();
@@ -115,12 +117,17 @@ namespace embree
     
     DEFINE_INTERSECTOR8(BVH4Bezier1vIntersector8Single_OBB, BVH4Intersector8Single<0x101 COMMA false COMMA LeafIterator8_1<Bezier1vIntersector8<LeafMode> > >);
     DEFINE_INTERSECTOR8(BVH4Bezier1iIntersector8Single_OBB, BVH4Intersector8Single<0x101 COMMA false COMMA LeafIterator8_1<Bezier1iIntersector8<LeafMode> > >);
+    DEFINE_INTERSECTOR8(BVH4Bezier4qIntersector8Single_OBB, BVH4Intersector8Single<0x101 COMMA false COMMA LeafIterator8_1<Bezier4qIntersector8<LeafMode> > >);
     DEFINE_INTERSECTOR8(BVH4Bezier1iMBIntersector8Single_OBB,BVH4Intersector8Single<0x1010 COMMA false COMMA LeafIterator8_1<Bezier1iIntersector8MB<LeafMode> > >);
 
     DEFINE_INTERSECTOR8(BVH4Subdivpatch1Intersector8, BVH4Intersector8FromIntersector1<BVH4Intersector1<0x1 COMMA true COMMA LeafIterator1<SubdivPatch1Intersector1 > > >);
     DEFINE_INTERSECTOR8(BVH4Subdivpatch1CachedIntersector8,BVH4Intersector8FromIntersector1<BVH4Intersector1<0x1 COMMA true COMMA SubdivPatch1CachedIntersector1> >);
+    DEFINE_INTERSECTOR8(BVH4Subdivpatch1CachedIntersector8Culling,BVH4Intersector8FromIntersector1<BVH4Intersector1<0x1 COMMA true COMMA SubdivPatch1CachedIntersector1Culling> >);
 
     DEFINE_INTERSECTOR8(BVH4GridIntersector8, BVH4Intersector8FromIntersector1<BVH4Intersector1<0x1 COMMA true COMMA GridIntersector1> >);
     DEFINE_INTERSECTOR8(BVH4GridLazyIntersector8, BVH4Intersector8FromIntersector1<BVH4Intersector1<0x1 COMMA true COMMA Switch2Intersector1<GridIntersector1 COMMA GridLazyIntersector1> > >);
+
+    DEFINE_INTERSECTOR8(BVH4Triangle4iMBIntersector8Moeller, BVH4Intersector8FromIntersector1<BVH4Intersector1<0x100000 COMMA false COMMA LeafIterator1<Triangle4iMBIntersector1MoellerTrumbore<LeafMode> > > >);
+    DEFINE_INTERSECTOR8(BVH4Triangle4iMBIntersector8MoellerCulling, BVH4Intersector8FromIntersector1<BVH4Intersector1<0x100000 COMMA false COMMA LeafIterator1<Triangle4iMBIntersector1MoellerTrumbore<LeafMode COMMA true> > > >);
   }
 }
@@ -15,6 +15,7 @@
 // ======================================================================== //
 
 #include "bvh4_refit.h"
+#include "bvh4_rotate.h"
 #include "bvh4_statistics.h"
 
 #include <algorithm>
@@ -24,6 +25,7 @@ namespace embree
   namespace isa
   {
     static const size_t block_size = 1024;
+    static const size_t restructure_passes = 2;
     
     __forceinline bool compare(const BVH4::NodeRef* a, const BVH4::NodeRef* b)
     {
@@ -33,7 +35,7 @@ namespace embree
     }
     
     BVH4Refit::BVH4Refit (BVH4* bvh, Builder* builder, TriangleMesh* mesh, size_t mode)
-      : builder(builder), mesh(mesh), primTy(bvh->primTy), bvh(bvh) {}
+      : builder(builder), mesh(mesh), primTy(bvh->primTy), bvh(bvh), numRestructured(0) {}
 
     BVH4Refit::~BVH4Refit () {
       delete builder;
@@ -47,13 +49,20 @@ namespace embree
     
     void BVH4Refit::build(size_t threadIndex, size_t threadCount) 
     {
+      numRestructured = 0;
+
       /* build initial BVH */
       if (builder) {
         builder->build(threadIndex,threadCount);
         if (bvh->numPrimitives > 50000) {
-          annotate_tree_sizes(bvh->root);
+          annotate_tree_sizes(bvh->root,0);
           calculate_refit_roots();
         }
+        if (roots.size() == 0) {
+          roots.push_back(&bvh->root);
+          depths.push_back(0);
+        }
+        costs.resize(roots.size(),0.0f);
         delete builder; builder = NULL;
       }
       
@@ -66,16 +75,15 @@ namespace embree
       
       /* schedule refit tasks */
       size_t numRoots = roots.size();
-      if (numRoots <= 1) {
+      if (numRoots == 1 && roots[0] == &bvh->root) {
         refit_sequential(threadIndex,threadCount);
       }
       else {
         parallel_for(size_t(0), roots.size(), [&] (const range<size_t>& r)
         {
           for (size_t i=r.begin(); i<r.end(); i++) {
-            NodeRef& ref = *roots[i];
-            recurse_bottom(ref);
-            ref.setBarrier();
+            refit_subtree(i);
+            roots[i]->setBarrier();
           }
         });
         bvh->bounds = recurse_top(bvh->root);
@@ -89,7 +97,7 @@ namespace embree
       }
     }
     
-    size_t BVH4Refit::annotate_tree_sizes(BVH4::NodeRef& ref)
+    size_t BVH4Refit::annotate_tree_sizes(BVH4::NodeRef& ref, size_t depth)
     {
       if (ref.isNode())
       {
@@ -98,9 +106,10 @@ namespace embree
         for (size_t i=0; i<BVH4::N; i++) {
           BVH4::NodeRef& child = node->child(i);
           if (child == BVH4::emptyNode) continue;
-          n += annotate_tree_sizes(child); 
+          n += annotate_tree_sizes(child,depth+1); 
         }
         *((size_t*)&node->lower_x) = n;
+        *((size_t*)&node->upper_x) = depth;
         return n;
       }
       else
@@ -123,8 +132,10 @@ namespace embree
         std::pop_heap(roots.begin(), roots.end(), compare);
         BVH4::NodeRef* node = roots.back();
         roots.pop_back();
-        if (*(size_t*)&node->node()->lower_x < block_size) 
+        if (*(size_t*)&node->node()->lower_x < block_size) {
+          roots.push_back(node);
           break;
+        }
         
         for (size_t i=0; i<BVH4::N; i++) {
           BVH4::NodeRef* child = &node->node()->child(i);
@@ -134,6 +145,9 @@ namespace embree
           }
         }
       }
+
+      for (size_t i=0; i<roots.size(); i++)
+        depths.push_back(*(size_t*)&roots[i]->node()->upper_x);
     }
     
     __forceinline BBox3fa BVH4Refit::leaf_bounds(NodeRef& ref)
@@ -231,15 +245,70 @@ namespace embree
                     Vec3fa(upper_x,upper_y,upper_z));
     }
     
+    float BVH4Refit::recurse_sah(NodeRef& ref)
+    {
+      if (ref.isLeaf()) return 0.0f;
+      
+      /* every child costs one box test, every primitive block one primitive test */
+      Node* node = ref.node();
+      float cost = 0.0f;
+      for (size_t i=0; i<BVH4::N; i++) 
+      {
+        NodeRef& child = node->child(i);
+        if (child == BVH4::emptyNode) continue;
+        size_t num = 1; 
+        if (child.isLeaf()) child.leaf(num);
+        cost += halfArea(node->bounds(i))*float(num) + recurse_sah(child);
+      }
+      return cost;
+    }
+
+    float BVH4Refit::sah(NodeRef& ref, const BBox3fa& bounds) 
+    {
+      const float A = halfArea(bounds);
+      if (A <= 0.0f) return 0.0f;
+      return recurse_sah(ref)/A;
+    }
+
+    BBox3fa BVH4Refit::refit_subtree(size_t i)
+    {
+      NodeRef& ref = *roots[i];
+      const BBox3fa bounds = recurse_bottom(ref);
+      if (g_tri_refit_restructure <= 0.0f) 
+        return bounds;
+
+      /* the first refit determines the reference cost */
+      const float cost = sah(ref,bounds);
+      if (costs[i] == 0.0f) {
+        costs[i] = cost;
+        return bounds;
+      }
+
+      /* restore quality of deformed subtrees through tree rotations */
+      if (cost > g_tri_refit_restructure*costs[i]) 
+      {
+        for (size_t j=0; j<restructure_passes; j++)
+          BVH4Rotate::rotate(bvh,ref,depths[i]+1);
+        atomic_add(&numRestructured,1);
+        costs[i] = sah(ref,bounds);
+
+        if (g_verbose >= 2) {
+          std::stringstream str;
+          str << "  restructured subtree " << i << ", SAH " << cost << " -> " << costs[i] << std::endl;
+          std::cout << str.str();
+        }
+      }
+      return bounds;
+    }
+    
     void BVH4Refit::task_refit_parallel(size_t threadIndex, size_t threadCount, size_t taskIndex, size_t taskCount) 
     {
-      NodeRef& ref = *roots[taskIndex];
-      recurse_bottom(ref);
-      ref.setBarrier();
+      refit_subtree(taskIndex);
+      roots[taskIndex]->setBarrier();
     }
     
     void BVH4Refit::refit_sequential(size_t threadIndex, size_t threadCount) {
-      bvh->bounds = recurse_bottom(bvh->root);
+      bvh->bounds = refit_subtree(0);
     }
 
     Builder* BVH4Triangle1MeshBuilderSAH  (void* bvh, TriangleMesh* mesh, size_t mode);
@@ -48,13 +48,20 @@ namespace embree
       TASK_SET_FUNCTION(BVH4Refit,task_refit_parallel);
       
     private:
-      size_t annotate_tree_sizes(NodeRef& ref);
+      size_t annotate_tree_sizes(NodeRef& ref, size_t depth);
       void calculate_refit_roots ();
       
       BBox3fa leaf_bounds(NodeRef& ref);
       BBox3fa node_bounds(NodeRef& ref);
       BBox3fa recurse_bottom(NodeRef& ref);
       BBox3fa recurse_top(NodeRef& ref);
+
+      /*! refits the i'th subtree and restructures it if its quality degraded too much */
+      BBox3fa refit_subtree(size_t i);
+
+      /*! SAH cost of a subtree relative to its bounds */
+      float sah(NodeRef& ref, const BBox3fa& bounds);
+      float recurse_sah(NodeRef& ref);
       
     private:
       TriangleMesh* mesh;
@@ -68,6 +75,9 @@ namespace embree
       Builder* builder;
       BVH4* bvh;                      //!< BVH to refit
       std::vector<NodeRef*> roots;    //!< List of equal sized subtrees for bvh refit
+      std::vector<size_t> depths;     //!< Depth of each subtree root
+      std::vector<float> costs;       //!< SAH cost of each subtree after the last restructuring
+      volatile atomic_t numRestructured; //!< number of subtrees restructured during the last build
     };
   }
 }
@@ -25,6 +25,8 @@ namespace embree
     numLeaves = numPrims = depth = 0;
     childrenAlignedNodes = childrenUnalignedNodes = 0;
     childrenAlignedNodesMB = childrenUnalignedNodesMB = 0;
+    numQuantizedNodes = childrenQuantizedNodes = 0;
+    numSegmentNodesMB = childrenSegmentNodesMB = 0;
     bvhSAH = 0.0f;
     hash = 0;
     float A = max(0.0f,halfArea(bvh->bounds));
@@ -39,10 +41,12 @@ namespace embree
     size_t bytesUnalignedNodes = numUnalignedNodes*sizeof(UnalignedNode);
     size_t bytesAlignedNodesMB = numAlignedNodesMB*sizeof(BVH4::NodeMB);
     size_t bytesUnalignedNodesMB = numUnalignedNodesMB*sizeof(BVH4::UnalignedNodeMB);
+    size_t bytesQuantizedNodes = numQuantizedNodes*sizeof(BVH4::QuantizedNode);
+    size_t bytesSegmentNodesMB = numSegmentNodesMB*BVH4::SegmentNodeMB::bytes(bvh->numTimeSteps);
     size_t bytesPrims  = numPrims*bvh->primTy.bytes;
     size_t numVertices = bvh->numVertices;
     size_t bytesVertices = numVertices*sizeof(Vec3fa); 
-    return bytesAlignedNodes+bytesUnalignedNodes+bytesAlignedNodesMB+bytesUnalignedNodesMB+bytesPrims+bytesVertices;
+    return bytesAlignedNodes+bytesUnalignedNodes+bytesAlignedNodesMB+bytesUnalignedNodesMB+bytesQuantizedNodes+bytesSegmentNodesMB+bytesPrims+bytesVertices;
   }
 
   std::string BVH4Statistics::str()  
@@ -52,10 +56,12 @@ namespace embree
     size_t bytesUnalignedNodes = numUnalignedNodes*sizeof(UnalignedNode);
     size_t bytesAlignedNodesMB = numAlignedNodesMB*sizeof(BVH4::NodeMB);
     size_t bytesUnalignedNodesMB = numUnalignedNodesMB*sizeof(BVH4::UnalignedNodeMB);
+    size_t bytesQuantizedNodes = numQuantizedNodes*sizeof(BVH4::QuantizedNode);
+    size_t bytesSegmentNodesMB = numSegmentNodesMB*BVH4::SegmentNodeMB::bytes(bvh->numTimeSteps);
     size_t bytesPrims  = numPrims*bvh->primTy.bytes;
     size_t numVertices = bvh->numVertices;
     size_t bytesVertices = numVertices*sizeof(Vec3fa); 
-    size_t bytesTotal = bytesAlignedNodes+bytesUnalignedNodes+bytesAlignedNodesMB+bytesUnalignedNodesMB+bytesPrims+bytesVertices;
+    size_t bytesTotal = bytesAlignedNodes+bytesUnalignedNodes+bytesAlignedNodesMB+bytesUnalignedNodesMB+bytesQuantizedNodes+bytesSegmentNodesMB+bytesPrims+bytesVertices;
     //size_t bytesTotalAllocated = bvh->alloc.bytes();
     stream.setf(std::ios::fixed, std::ios::floatfield);
     stream << "  primitives = " << bvh->numPrimitives << ", vertices = " << bvh->numVertices << ", hash= " << hash << std::endl;
@@ -94,6 +100,20 @@ namespace embree
 	     << "(" << 100.0*double(bytesUnalignedNodesMB)/double(bytesTotal) << "% of total)"
 	     << std::endl;
     }
+    if (numSegmentNodesMB) {
+      stream << "  segmentNodesMB = "  << numSegmentNodesMB << " "
+	     << "(" << 100.0*double(childrenSegmentNodesMB)/double(BVH4::N*numSegmentNodesMB) << "% filled) " 
+	     << "(" << bytesSegmentNodesMB/1E6  << " MB) " 
+	     << "(" << 100.0*double(bytesSegmentNodesMB)/double(bytesTotal) << "% of total)"
+	     << std::endl;
+    }
+    if (numQuantizedNodes) {
+      stream << "  quantizedNodes = "  << numQuantizedNodes << " "
+	     << "(" << 100.0*double(childrenQuantizedNodes)/double(BVH4::N*numQuantizedNodes) << "% filled) " 
+	     << "(" << bytesQuantizedNodes/1E6  << " MB) " 
+	     << "(" << 100.0*double(bytesQuantizedNodes)/double(bytesTotal) << "% of total)"
+	     << std::endl;
+    }
     stream << "  leaves = " << numLeaves << " "
            << "(" << bytesPrims/1E6  << " MB) "
            << "(" << 100.0*double(bytesPrims)/double(bytesTotal) << "% of total)"
@@ -179,6 +199,42 @@ namespace embree
 	depth++;
 	hash += 0x76767*depth;
       }
+    else if (node.isSegmentNodeMB())
+      {
+	hash += 0x3C5E7;
+	numSegmentNodesMB++;
+	BVH4::SegmentNodeMB* n = node.segmentNodeMB();
+	bvhSAH += A*BVH4::travCostAligned;
+
+	depth = 0;
+	for (size_t i=0; i<BVH4::N; i++) {
+	  if (n->child(i) == BVH4::emptyNode) continue;
+	  childrenSegmentNodesMB++;
+	  const float Ai = max(0.0f,halfArea(n->extend0(i)));
+	  size_t cdepth; statistics(n->child(i),Ai,cdepth); 
+	  depth=max(depth,cdepth);
+	}
+	depth++;
+	hash += 0x76767*depth;
+      }
+    else if (node.isQuantizedNode())
+      {
+	hash += 0x5A3B1;
+	numQuantizedNodes++;
+	BVH4::QuantizedNode* n = node.quantizedNode();
+	bvhSAH += A*BVH4::travCostAligned;
+
+	depth = 0;
+	for (size_t i=0; i<BVH4::N; i++) {
+	  if (n->child(i) == BVH4::emptyNode) continue;
+	  childrenQuantizedNodes++;
+	  const float Ai = max(0.0f,halfArea(n->extend(i)));
+	  size_t cdepth; statistics(n->child(i),Ai,cdepth); 
+	  depth=max(depth,cdepth);
+	}
+	depth++;
+	hash += 0x76767*depth;
+      }
     else
       {
 	depth = 0;
@@ -52,6 +52,10 @@ namespace embree
     size_t childrenUnalignedNodes;     //!< Number of children of unaligned internal nodes.
     size_t childrenAlignedNodesMB;       //!< Number of children of aligned nodes
     size_t childrenUnalignedNodesMB;     //!< Number of children of unaligned internal nodes.
+    size_t numSegmentNodesMB;          //!< Number of motion blur nodes with bounds for each time step.
+    size_t childrenSegmentNodesMB;     //!< Number of children of motion blur nodes with bounds for each time step.
+    size_t numQuantizedNodes;          //!< Number of quantized internal nodes.
+    size_t childrenQuantizedNodes;     //!< Number of children of quantized internal nodes.
     size_t numLeaves;                  //!< Number of leaf nodes.
     size_t numPrims;                   //!< Number of primitives.
     size_t depth;                      //!< Depth of the tree.
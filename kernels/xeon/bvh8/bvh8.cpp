@@ -28,6 +28,11 @@ namespace embree
   DECLARE_SYMBOL(Accel::Intersector8,BVH8Triangle4Intersector8ChunkMoeller);
   DECLARE_SYMBOL(Accel::Intersector8,BVH8Triangle4Intersector8HybridMoeller);
   DECLARE_SYMBOL(Accel::Intersector8,BVH8Triangle4Intersector8HybridMoellerNoFilter);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH8Triangle4Intersector1MoellerCulling);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH8Triangle4Intersector4HybridMoellerCulling);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH8Triangle4Intersector4HybridMoellerNoFilterCulling);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH8Triangle4Intersector8HybridMoellerCulling);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH8Triangle4Intersector8HybridMoellerNoFilterCulling);
 
   DECLARE_SYMBOL(Accel::Intersector1,BVH8Triangle8Intersector1Moeller);
   DECLARE_SYMBOL(Accel::Intersector4,BVH8Triangle8Intersector4HybridMoeller);
@@ -56,12 +61,15 @@ namespace embree
     /* select intersectors1 */
     SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle4Intersector1Moeller);
     SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle8Intersector1Moeller);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle4Intersector1MoellerCulling);
 
     /* select intersectors4 */
     SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle4Intersector4HybridMoeller);
     SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle4Intersector4HybridMoellerNoFilter);
     SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle8Intersector4HybridMoeller);
     SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle8Intersector4HybridMoellerNoFilter);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle4Intersector4HybridMoellerCulling);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle4Intersector4HybridMoellerNoFilterCulling);
 
     /* select intersectors8 */
     SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle4Intersector8ChunkMoeller);
@@ -70,6 +78,8 @@ namespace embree
     SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle8Intersector8ChunkMoeller);
     SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle8Intersector8HybridMoeller);
     SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle8Intersector8HybridMoellerNoFilter);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle4Intersector8HybridMoellerCulling);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle4Intersector8HybridMoellerNoFilterCulling);
   }
 
   BVH8::BVH8 (const PrimitiveType& primTy, Scene* scene)
@@ -199,6 +209,15 @@ namespace embree
   {
     Accel::Intersectors intersectors;
     intersectors.ptr = bvh;
+    if (bvh->scene->isBackfaceCulling()) {
+      intersectors.intersector1 = BVH8Triangle4Intersector1MoellerCulling;
+      intersectors.intersector4_filter = BVH8Triangle4Intersector4HybridMoellerCulling;
+      intersectors.intersector4_nofilter = BVH8Triangle4Intersector4HybridMoellerNoFilterCulling;
+      intersectors.intersector8_filter = BVH8Triangle4Intersector8HybridMoellerCulling;
+      intersectors.intersector8_nofilter = BVH8Triangle4Intersector8HybridMoellerNoFilterCulling;
+      intersectors.intersector16 = NULL;
+      return intersectors;
+    }
     intersectors.intersector1 = BVH8Triangle4Intersector1Moeller;
     intersectors.intersector4_filter = BVH8Triangle4Intersector4HybridMoeller;
     intersectors.intersector4_nofilter = BVH8Triangle4Intersector4HybridMoellerNoFilter;
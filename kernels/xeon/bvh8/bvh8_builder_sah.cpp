@@ -137,18 +137,87 @@ namespace embree
           auto progress = [&] (size_t dn) { bvh->scene->progressMonitor(dn); };
           auto virtualprogress = BuildProgressMonitorFromClosure(progress);
           
-	    bvh->alloc2.init(numSplitPrimitives*sizeof(PrimRef),numSplitPrimitives*sizeof(BVH8::Node));  // FIXME: better estimate
-	    prims.resize(numSplitPrimitives);
-	    PrimInfo pinfo = mesh ? createPrimRefArray<Mesh>(mesh,prims,virtualprogress) : createPrimRefArray<Mesh,1>(scene,prims,virtualprogress);
+          /* large scenes can get build in chunks to limit the size of the PrimRef array */
+          size_t chunkSize = mesh ? 0 : g_build_chunk_size;
+          if (chunkSize >= numPrimitives) chunkSize = 0;
+
+          /* fall back to a chunked build if the PrimRef array for the entire scene cannot get allocated */
+          if (chunkSize == 0)
+          {
+            bool outOfMemory = false;
+            try {
+              bvh->alloc2.init(numSplitPrimitives*sizeof(PrimRef),numSplitPrimitives*sizeof(BVH8::Node));  // FIXME: better estimate
+              prims.resize(numSplitPrimitives);
+            } 
+            catch (std::bad_alloc&) {
+              if (mesh) throw;
+              outOfMemory = true;
+            }
+            catch (my_runtime_error& e) {
+              if (mesh || e.error != RTC_OUT_OF_MEMORY) throw;
+              outOfMemory = true;
+            }
+            if (outOfMemory) {
+              prims.clear();
+              chunkSize = max(size_t(4096),numPrimitives/16);
+            }
+          }
+
+          BVH8::NodeRef root; 
+          PrimInfo pinfo(empty);
+          if (chunkSize == 0)
+          {
+            pinfo = mesh ? createPrimRefArray<Mesh>(mesh,prims,virtualprogress) : createPrimRefArray<Mesh,1>(scene,prims,virtualprogress);
             if (presplitFactor > 1.0f)
               pinfo = presplit<Mesh>(scene, pinfo, prims);
-	    BVH8::NodeRef root; 
             BVHBuilderBinnedSAH::build<BVH8::NodeRef>
               (root,CreateAlloc(bvh),CreateBVH8Node(bvh),CreateLeaf<Primitive>(bvh,prims.data()), progress,
                prims.data(),pinfo,BVH8::N,BVH8::maxBuildDepthLeaf,sahBlockSize,minLeafSize,maxLeafSize,BVH8::travCost,intCost);
+          }
+          else
+          {
+            /* partition scene into spatially coherent chunks */
+            PrimRefChunks chunks;
+            createPrimRefChunks<Mesh,1>(scene,chunkSize,chunks,virtualprogress);
+            size_t maxChunkSize = 0;
+            for (size_t i=0; i<chunks.size(); i++) maxChunkSize = max(maxChunkSize,chunks.sizes[i]);
+            const size_t maxSplitChunkSize = max(maxChunkSize,size_t(presplitFactor*maxChunkSize));
+            bvh->alloc2.init(maxSplitChunkSize*sizeof(PrimRef),maxSplitChunkSize*sizeof(BVH8::Node));
+
+            /* build hierarchy of each chunk, only the PrimRefs of a single chunk are stored at a time */
+            vector<PrimRef> refs(chunks.size());
+            std::vector<BVH8::NodeRef> roots(chunks.size());
+            for (size_t i=0; i<chunks.size(); i++)
+            {
+              prims.resize(max(chunks.sizes[i],size_t(presplitFactor*chunks.sizes[i])));
+              PrimInfo cinfo = createPrimRefArray<Mesh,1>(scene,chunks,i,prims,virtualprogress);
+              if (presplitFactor > 1.0f)
+                cinfo = presplit<Mesh>(scene, cinfo, prims);
+
+              BVHBuilderBinnedSAH::build<BVH8::NodeRef>
+                (roots[i],CreateAlloc(bvh),CreateBVH8Node(bvh),CreateLeaf<Primitive>(bvh,prims.data()), progress,
+                 prims.data(),cinfo,BVH8::N,BVH8::maxBuildDepthLeaf,sahBlockSize,minLeafSize,maxLeafSize,BVH8::travCost,intCost);
+              refs[i] = PrimRef(cinfo.geomBounds,i);
+              pinfo.add(cinfo.geomBounds,center2(cinfo.geomBounds),cinfo.size());
+            }
+            prims.resize(0,true);
+
+            /* link chunk hierarchies under a common toplevel hierarchy */
+            PrimInfo tinfo(empty);
+            for (size_t i=0; i<refs.size(); i++) tinfo.add(refs[i].bounds(),refs[i].center2());
+            BVHBuilderBinnedSAH::build<BVH8::NodeRef>
+              (root,CreateAlloc(bvh),CreateBVH8Node(bvh),
+               [&] (const BVHBuilderBinnedSAH::BuildRecord& current, Allocator* alloc) -> int
+               {
+                 assert(current.prims.size() == 1);
+                 *current.parent = roots[refs[current.prims.begin()].ID()];
+                 return 1;
+               },
+               [&] (size_t dn) {},refs.data(),tinfo,BVH8::N,BVH8::maxBuildDepthLeaf,1,1,1,1.0f,1.0f);
+          }
 
-            bvh->set(root,pinfo.geomBounds,pinfo.size());
-            bvh->layoutLargeNodes(numSplitPrimitives*0.005f);
+          bvh->set(root,pinfo.geomBounds,pinfo.size());
+          bvh->layoutLargeNodes(pinfo.size()*0.005f);
 
 	    if ((g_benchmark || g_verbose >= 1) && mesh == NULL) dt = getSeconds()-t0;
 
@@ -317,6 +317,7 @@ namespace embree
     }
 
     DEFINE_INTERSECTOR1(BVH8Triangle4Intersector1Moeller,BVH8Intersector1<LeafIterator1<Triangle4Intersector1MoellerTrumbore<LeafMode> > >);
+    DEFINE_INTERSECTOR1(BVH8Triangle4Intersector1MoellerCulling,BVH8Intersector1<LeafIterator1<Triangle4Intersector1MoellerTrumbore<LeafMode COMMA true> > >);
     DEFINE_INTERSECTOR1(BVH8Triangle8Intersector1Moeller,BVH8Intersector1<LeafIterator1<Triangle8Intersector1MoellerTrumbore<LeafMode> > >);
   }
 }
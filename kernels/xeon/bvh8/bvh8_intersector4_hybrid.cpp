@@ -599,6 +599,8 @@ namespace embree
     
     DEFINE_INTERSECTOR4(BVH8Triangle4Intersector4HybridMoeller, BVH8Intersector4Hybrid<LeafIterator4_1<Triangle4Intersector4MoellerTrumbore<LeafMode COMMA true> > >);
     DEFINE_INTERSECTOR4(BVH8Triangle4Intersector4HybridMoellerNoFilter, BVH8Intersector4Hybrid<LeafIterator4_1<Triangle4Intersector4MoellerTrumbore<LeafMode COMMA false> > >);
+    DEFINE_INTERSECTOR4(BVH8Triangle4Intersector4HybridMoellerCulling, BVH8Intersector4Hybrid<LeafIterator4_1<Triangle4Intersector4MoellerTrumbore<LeafMode COMMA true COMMA true> > >);
+    DEFINE_INTERSECTOR4(BVH8Triangle4Intersector4HybridMoellerNoFilterCulling, BVH8Intersector4Hybrid<LeafIterator4_1<Triangle4Intersector4MoellerTrumbore<LeafMode COMMA false COMMA true> > >);
 
     DEFINE_INTERSECTOR4(BVH8Triangle8Intersector4HybridMoeller, BVH8Intersector4Hybrid<LeafIterator4_1<Triangle8Intersector4MoellerTrumbore<LeafMode COMMA true> > >);
     DEFINE_INTERSECTOR4(BVH8Triangle8Intersector4HybridMoellerNoFilter, BVH8Intersector4Hybrid<LeafIterator4_1<Triangle8Intersector4MoellerTrumbore<LeafMode COMMA false> > >);
@@ -0,0 +1,143 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "bezier1v.h"
+
+namespace embree
+{
+  /*! Stores up to 4 bezier curves. The control points (x,y,z,r) of all
+   *  curves are quantized to 16 bits relative to a local frame that
+   *  spans the control points of the curves. Neighboring segments of
+   *  a strand share similar control points, thus the quantization
+   *  error stays small compared to the hair radius. */
+  struct Bezier4q
+  {
+  public:
+
+    /*! Default constructor. */
+    __forceinline Bezier4q () {}
+
+    /*! Returns if the specified curve is valid. */
+    __forceinline bool valid(const size_t i) const {
+      assert(i<4);
+      return geomIDs[i] != -1;
+    }
+
+    /*! Returns the number of stored curves. */
+    __forceinline size_t size() const
+    {
+      size_t n=0;
+      while (n<4 && valid(n)) n++;
+      return n;
+    }
+
+    /*! returns required number of primitive blocks for N primitives */
+    static __forceinline size_t blocks(size_t N) { return (N+3)/4; }
+
+    /*! checks if this is the last block in the list */
+    __forceinline int last() const {
+      return primIDs[0] & 0x80000000;
+    }
+
+    /*! returns the geometry ID of the specified curve */
+    template<bool list>
+    __forceinline unsigned int geomID(const size_t i) const {
+      return geomIDs[i];
+    }
+
+    /*! returns the primitive ID of the specified curve */
+    template<bool list>
+    __forceinline unsigned int primID(const size_t i) const {
+      if (list) return primIDs[i] & 0x7FFFFFFF;
+      else      return primIDs[i];
+    }
+
+    /*! dequantizes the j'th control point of the i'th curve */
+    __forceinline Vec3fa vertex(const size_t i, const size_t j) const
+    {
+      const unsigned short* q = v[i][j];
+      return Vec3fa(offset.x + scale.x*float(q[0]),
+                    offset.y + scale.y*float(q[1]),
+                    offset.z + scale.z*float(q[2]),
+                    offset.w + scale.w*float(q[3]));
+    }
+
+    /*! dequantizes all control points of the i'th curve */
+    __forceinline void gather(const size_t i, Vec3fa& p0, Vec3fa& p1, Vec3fa& p2, Vec3fa& p3) const
+    {
+      p0 = vertex(i,0);
+      p1 = vertex(i,1);
+      p2 = vertex(i,2);
+      p3 = vertex(i,3);
+    }
+
+    /*! fill from curve list */
+    __forceinline void fill(const BezierPrim* prims, size_t& begin, size_t end, Scene* scene, const bool list)
+    {
+      /* calculate local frame that contains all control points */
+      const size_t num = min(end-begin,size_t(4));
+      Vec3fa lower(pos_inf), upper(neg_inf);
+      for (size_t i=0; i<num; i++)
+      {
+        const BezierPrim& curve = prims[begin+i];
+        lower = min(lower,curve.p0,curve.p1,curve.p2,curve.p3);
+        upper = max(upper,curve.p0,curve.p1,curve.p2,curve.p3);
+      }
+      offset = lower;
+      scale  = (upper-lower)*(1.0f/65535.0f);
+      const Vec3fa rcp_scale = select(gt_mask(upper,lower),rcp(scale),Vec3fa(zero));
+
+      /* quantize control points relative to local frame */
+      for (size_t i=0; i<4; i++)
+      {
+        if (i >= num) {
+          for (size_t j=0; j<4; j++) v[i][j][0] = v[i][j][1] = v[i][j][2] = v[i][j][3] = 0;
+          geomIDs[i] = -1; primIDs[i] = -1;
+          continue;
+        }
+        const BezierPrim& curve = prims[begin++];
+        const Vec3fa p[4] = { curve.p0, curve.p1, curve.p2, curve.p3 };
+        for (size_t j=0; j<4; j++) {
+          const Vec3fa q = clamp((p[j]-offset)*rcp_scale+Vec3fa(0.5f),Vec3fa(zero),Vec3fa(65535.0f));
+          v[i][j][0] = (unsigned short) q.x;
+          v[i][j][1] = (unsigned short) q.y;
+          v[i][j][2] = (unsigned short) q.z;
+          v[i][j][3] = (unsigned short) q.w;
+        }
+        geomIDs[i] = curve.geomID<0>();
+        primIDs[i] = curve.primID<0>();
+      }
+      primIDs[0] |= (list && begin>=end) << 31;
+    }
+
+  public:
+    Vec3fa offset;                 //!< origin of local frame (x,y,z,r)
+    Vec3fa scale;                  //!< size of one quantization step of local frame (x,y,z,r)
+    unsigned short v[4][4][4];     //!< quantized control points (x,y,z,r) of the 4 curves
+    unsigned geomIDs[4];           //!< geometry IDs
+    unsigned primIDs[4];           //!< primitive IDs
+  };
+
+  struct Bezier4qType : public PrimitiveType
+  {
+    static Bezier4qType type;
+    Bezier4qType ();
+    size_t blocks(size_t x) const;
+    size_t size(const char* This) const;
+  };
+}
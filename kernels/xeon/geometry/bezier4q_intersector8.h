@@ -0,0 +1,74 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "bezier4q.h"
+#include "bezier_intersector8.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Intersector for a single ray from a ray packet with 4 quantized bezier curves. */
+    template<bool list>
+      struct Bezier4qIntersector8
+      {
+        typedef Bezier4q Primitive;
+        typedef BezierIntersector8::Precalculations Precalculations;
+        
+        static __forceinline void intersect(Precalculations& pre, Ray8& ray, const size_t k, const Primitive& curves, Scene* scene) 
+        {
+          for (size_t i=0; i<4; i++) 
+          {
+            if (!curves.valid(i)) break;
+            Vec3fa p0,p1,p2,p3; curves.gather(i,p0,p1,p2,p3);
+            BezierIntersector8::intersect(pre,ray,k,p0,p1,p2,p3,curves.geomID<list>(i),curves.primID<list>(i),scene);
+          }
+        }
+        
+        static __forceinline void intersect(const avxb& valid_i, Precalculations& pre, Ray8& ray, const Primitive& curves, Scene* scene)
+        {
+          int mask = movemask(valid_i);
+          while (mask) intersect(pre,ray,__bscf(mask),curves,scene);
+        }
+        
+        static __forceinline bool occluded(Precalculations& pre, Ray8& ray, const size_t k, const Primitive& curves, Scene* scene) 
+        {
+          for (size_t i=0; i<4; i++) 
+          {
+            if (!curves.valid(i)) break;
+            Vec3fa p0,p1,p2,p3; curves.gather(i,p0,p1,p2,p3);
+            if (BezierIntersector8::occluded(pre,ray,k,p0,p1,p2,p3,curves.geomID<list>(i),curves.primID<list>(i),scene))
+              return true;
+          }
+          return false;
+        }
+        
+        static __forceinline avxb occluded(const avxb& valid_i, Precalculations& pre, Ray8& ray, const Primitive& curves, Scene* scene)
+        {
+          avxb valid_o = false;
+          int mask = movemask(valid_i);
+          while (mask) {
+            size_t k = __bscf(mask);
+            if (occluded(pre,ray,k,curves,scene))
+              valid_o[k] = -1;
+          }
+          return valid_o;
+        }
+      };
+  }
+}
@@ -39,6 +39,10 @@ namespace embree
     __forceinline bool runIntersectionFilter1(const Geometry* const geometry, Ray& ray, 
                                               const float& u, const float& v, const float& t, const Vec3fa& Ng, const int geomID, const int primID)
     {
+      /* ray masking test */
+      if (unlikely((geometry->mask & ray.mask) == 0)) 
+        return false;
+
       /* temporarily update hit information */
       const float  ray_tfar = ray.tfar;
       const Vec3fa ray_Ng   = ray.Ng;
@@ -51,6 +55,7 @@ namespace embree
       ray.Ng = Ng;
       
       /* invoke filter function */
+      if (geometry->intersectionFilter1 == NULL) return true;
       AVX_ZERO_UPPER();
       geometry->intersectionFilter1(geometry->userPtr,(RTCRay&)ray);
       
@@ -68,6 +73,10 @@ namespace embree
     __forceinline bool runOcclusionFilter1(const Geometry* const geometry, Ray& ray, 
                                            const float& u, const float& v, const float& t, const Vec3fa& Ng, const int geomID, const int primID)
     {
+      /* ray masking test */
+      if (unlikely((geometry->mask & ray.mask) == 0)) 
+        return false;
+
       /* temporarily update hit information */
       const float ray_tfar = ray.tfar;
       const int   ray_geomID = ray.geomID;
@@ -79,6 +88,7 @@ namespace embree
       ray.Ng = Ng;
       
       /* invoke filter function */
+      if (geometry->occlusionFilter1 == NULL) return true;
       AVX_ZERO_UPPER();
       geometry->occlusionFilter1(geometry->userPtr,(RTCRay&)ray);
       
@@ -92,9 +102,13 @@ namespace embree
       return true;
     }
     
-    __forceinline sseb runIntersectionFilter4(const sseb& valid, const Geometry* const geometry, Ray4& ray, 
+    __forceinline sseb runIntersectionFilter4(const sseb& valid_i, const Geometry* const geometry, Ray4& ray, 
                                               const ssef& u, const ssef& v, const ssef& t, const sse3f& Ng, const int geomID, const int primID)
     {
+      /* ray masking test */
+      const sseb valid = valid_i & ((ssei(int(geometry->mask)) & ray.mask) != ssei(zero));
+      if (unlikely(none(valid))) return valid;
+
       /* temporarily update hit information */
       const ssef ray_u = ray.u;           store4f(valid,&ray.u,u);
       const ssef ray_v = ray.v;           store4f(valid,&ray.v,v);
@@ -108,6 +122,7 @@ namespace embree
       /* invoke filter function */
       RTCFilterFunc4  filter4     = (RTCFilterFunc4)  geometry->intersectionFilter4;
       ISPCFilterFunc4 ispcFilter4 = (ISPCFilterFunc4) geometry->ispcIntersectionFilter4;
+      if (filter4 == NULL) return valid;
       AVX_ZERO_UPPER();
       if (ispcFilter4) ispcFilter4(geometry->userPtr,(RTCRay4&)ray,valid);
       else { const sseb valid_temp = valid; filter4(&valid_temp,geometry->userPtr,(RTCRay4&)ray); }
@@ -129,9 +144,13 @@ namespace embree
       return valid_passed;
     }
     
-    __forceinline sseb runOcclusionFilter4(const sseb& valid, const Geometry* const geometry, Ray4& ray, 
+    __forceinline sseb runOcclusionFilter4(const sseb& valid_i, const Geometry* const geometry, Ray4& ray, 
                                            const ssef& u, const ssef& v, const ssef& t, const sse3f& Ng, const int geomID, const int primID)
     {
+      /* ray masking test */
+      const sseb valid = valid_i & ((ssei(int(geometry->mask)) & ray.mask) != ssei(zero));
+      if (unlikely(none(valid))) return valid;
+
       /* temporarily update hit information */
       const ssef ray_tfar = ray.tfar; 
       const ssei ray_geomID = ray.geomID;
@@ -147,6 +166,7 @@ namespace embree
       /* invoke filter function */
       RTCFilterFunc4  filter4     = (RTCFilterFunc4)  geometry->occlusionFilter4;
       ISPCFilterFunc4 ispcFilter4 = (ISPCFilterFunc4) geometry->ispcOcclusionFilter4;
+      if (filter4 == NULL) return valid;
       AVX_ZERO_UPPER();
       if (ispcFilter4) ispcFilter4(geometry->userPtr,(RTCRay4&)ray,valid);
       else { const sseb valid_temp = valid; filter4(&valid_temp,geometry->userPtr,(RTCRay4&)ray); }
@@ -162,6 +182,10 @@ namespace embree
     __forceinline bool runIntersectionFilter4(const Geometry* const geometry, Ray4& ray, const size_t k,
                                               const float& u, const float& v, const float& t, const Vec3fa& Ng, const int geomID, const int primID)
     {
+      /* ray masking test */
+      if (unlikely((geometry->mask & ray.mask[k]) == 0)) 
+        return false;
+
       /* temporarily update hit information */
       const ssef ray_u = ray.u;           ray.u[k] = u;
       const ssef ray_v = ray.v;           ray.v[k] = v;
@@ -176,6 +200,7 @@ namespace embree
       const sseb valid(1 << k);
       RTCFilterFunc4  filter4     = (RTCFilterFunc4)  geometry->intersectionFilter4;
       ISPCFilterFunc4 ispcFilter4 = (ISPCFilterFunc4) geometry->ispcIntersectionFilter4;
+      if (filter4 == NULL) return true;
       AVX_ZERO_UPPER();
       if (ispcFilter4) ispcFilter4(geometry->userPtr,(RTCRay4&)ray,valid);
       else { const sseb valid_temp = valid; filter4(&valid_temp,geometry->userPtr,(RTCRay4&)ray); }
@@ -198,6 +223,10 @@ namespace embree
     __forceinline bool runOcclusionFilter4(const Geometry* const geometry, Ray4& ray, const size_t k,
                                            const float& u, const float& v, const float& t, const Vec3fa& Ng, const int geomID, const int primID)
     {
+      /* ray masking test */
+      if (unlikely((geometry->mask & ray.mask[k]) == 0)) 
+        return false;
+
       /* temporarily update hit information */
       const ssef ray_tfar = ray.tfar; 
       const ssei ray_geomID = ray.geomID;
@@ -214,6 +243,7 @@ namespace embree
       const sseb valid(1 << k);
       RTCFilterFunc4  filter4     = (RTCFilterFunc4)  geometry->occlusionFilter4;
       ISPCFilterFunc4 ispcFilter4 = (ISPCFilterFunc4) geometry->ispcOcclusionFilter4;
+      if (filter4 == NULL) return true;
       AVX_ZERO_UPPER();
       if (ispcFilter4) ispcFilter4(geometry->userPtr,(RTCRay4&)ray,valid);
       else { const sseb valid_temp = valid; filter4(&valid_temp,geometry->userPtr,(RTCRay4&)ray); }
@@ -228,9 +258,13 @@ namespace embree
     }
     
 #if defined(__AVX__)
-    __forceinline avxb runIntersectionFilter8(const avxb& valid, const Geometry* const geometry, Ray8& ray, 
+    __forceinline avxb runIntersectionFilter8(const avxb& valid_i, const Geometry* const geometry, Ray8& ray, 
                                               const avxf& u, const avxf& v, const avxf& t, const avx3f& Ng, const int geomID, const int primID)
     {
+      /* ray masking test */
+      const avxb valid = valid_i & ((avxi(int(geometry->mask)) & ray.mask) != avxi(zero));
+      if (unlikely(none(valid))) return valid;
+
       /* temporarily update hit information */
       const avxf ray_u = ray.u;           store8f(valid,&ray.u,u);
       const avxf ray_v = ray.v;           store8f(valid,&ray.v,v);
@@ -244,6 +278,7 @@ namespace embree
       /* invoke filter function */
       RTCFilterFunc8  filter8     = (RTCFilterFunc8)  geometry->intersectionFilter8;
       ISPCFilterFunc8 ispcFilter8 = (ISPCFilterFunc8) geometry->ispcIntersectionFilter8;
+      if (filter8 == NULL) return valid;
       if (ispcFilter8) ispcFilter8(geometry->userPtr,(RTCRay8&)ray,valid);
       else { const avxb valid_temp = valid; filter8(&valid_temp,geometry->userPtr,(RTCRay8&)ray); }
       const avxb valid_failed = valid & (ray.geomID == avxi(-1));
@@ -264,9 +299,13 @@ namespace embree
       return valid_passed;
     }
     
-    __forceinline avxb runOcclusionFilter8(const avxb& valid, const Geometry* const geometry, Ray8& ray, 
+    __forceinline avxb runOcclusionFilter8(const avxb& valid_i, const Geometry* const geometry, Ray8& ray, 
                                            const avxf& u, const avxf& v, const avxf& t, const avx3f& Ng, const int geomID, const int primID)
     {
+      /* ray masking test */
+      const avxb valid = valid_i & ((avxi(int(geometry->mask)) & ray.mask) != avxi(zero));
+      if (unlikely(none(valid))) return valid;
+
       /* temporarily update hit information */
       const avxf ray_tfar = ray.tfar; 
       const avxi ray_geomID = ray.geomID;
@@ -282,6 +321,7 @@ namespace embree
       /* invoke filter function */
       RTCFilterFunc8  filter8     = (RTCFilterFunc8)  geometry->occlusionFilter8;
       ISPCFilterFunc8 ispcFilter8 = (ISPCFilterFunc8) geometry->ispcOcclusionFilter8;
+      if (filter8 == NULL) return valid;
       if (ispcFilter8) ispcFilter8(geometry->userPtr,(RTCRay8&)ray,valid);
       else { const avxb valid_temp = valid; filter8(&valid_temp,geometry->userPtr,(RTCRay8&)ray); }
       const avxb valid_failed = valid & (ray.geomID == avxi(-1));
@@ -296,6 +336,10 @@ namespace embree
     __forceinline bool runIntersectionFilter8(const Geometry* const geometry, Ray8& ray, const size_t k,
                                               const float& u, const float& v, const float& t, const Vec3fa& Ng, const int geomID, const int primID)
     {
+      /* ray masking test */
+      if (unlikely((geometry->mask & ray.mask[k]) == 0)) 
+        return false;
+
       /* temporarily update hit information */
       const avxf ray_u = ray.u;           ray.u[k] = u;
       const avxf ray_v = ray.v;           ray.v[k] = v;
@@ -310,6 +354,7 @@ namespace embree
       const avxb valid(1 << k);
       RTCFilterFunc8  filter8     = (RTCFilterFunc8)  geometry->intersectionFilter8;
       ISPCFilterFunc8 ispcFilter8 = (ISPCFilterFunc8) geometry->ispcIntersectionFilter8;
+      if (filter8 == NULL) return true;
       if (ispcFilter8) ispcFilter8(geometry->userPtr,(RTCRay8&)ray,valid);
       else filter8(&valid,geometry->userPtr,(RTCRay8&)ray);
       const bool passed = ray.geomID[k] != -1;
@@ -331,6 +376,10 @@ namespace embree
     __forceinline bool runOcclusionFilter8(const Geometry* const geometry, Ray8& ray, const size_t k,
                                            const float& u, const float& v, const float& t, const Vec3fa& Ng, const int geomID, const int primID)
     {
+      /* ray masking test */
+      if (unlikely((geometry->mask & ray.mask[k]) == 0)) 
+        return false;
+
       /* temporarily update hit information */
       const avxf ray_tfar = ray.tfar; 
       const avxi ray_geomID = ray.geomID;
@@ -347,6 +396,7 @@ namespace embree
       const avxb valid(1 << k);
       RTCFilterFunc8  filter8     = (RTCFilterFunc8)  geometry->occlusionFilter8;
       ISPCFilterFunc8 ispcFilter8 = (ISPCFilterFunc8) geometry->ispcOcclusionFilter8;
+      if (filter8 == NULL) return true;
       if (ispcFilter8) ispcFilter8(geometry->userPtr,(RTCRay8&)ray,valid);
       else filter8(&valid,geometry->userPtr,(RTCRay8&)ray);
       const bool passed = ray.geomID[k] != -1;
@@ -488,31 +488,32 @@ namespace embree
     
     __forceinline void displace(Scene* scene, RTCDisplacementFunc func, void* userPtr, const Vec2f* luv, const Vec2f* uv, const Vec3fa* Ng)
     {
-      /* calculate uv coordinates */
+      /* copy all points of the grid into SOA arrays */
+      const size_t N = width*height;
       __aligned(64) float qu[17*17+16], qv[17*17+16];
       __aligned(64) float qx[17*17+16], qy[17*17+16], qz[17*17+16];
       __aligned(64) float nx[17*17+16], ny[17*17+16], nz[17*17+16];
-      for (size_t y=0; y<height; y++) 
+      for (size_t i=0; i<N; i++) 
       {
-        for (size_t x=0; x<width; x++) 
-        {
-          qu[y*width+x] = uv[y*width+x].x;
-          qv[y*width+x] = uv[y*width+x].y;
-          qx[y*width+x] = P[y*width+x].x;
-          qy[y*width+x] = P[y*width+x].y;
-          qz[y*width+x] = P[y*width+x].z;
-          nx[y*width+x] = Ng[y*width+x].x;
-          ny[y*width+x] = Ng[y*width+x].y;
-          nz[y*width+x] = Ng[y*width+x].z;
-        }
+        qu[i] = uv[i].x; qv[i] = uv[i].y;
+        qx[i] = P[i].x; qy[i] = P[i].y; qz[i] = P[i].z;
+        nx[i] = Ng[i].x; ny[i] = Ng[i].y; nz[i] = Ng[i].z;
+      }
+
+      /* pad to a multiple of 16 by replicating the last point, such that the shader can process full SIMD blocks */
+      for (size_t i=N; i<((N+15)&(-16)); i++) 
+      {
+        qu[i] = qu[N-1]; qv[i] = qv[N-1];
+        qx[i] = qx[N-1]; qy[i] = qy[N-1]; qz[i] = qz[N-1];
+        nx[i] = nx[N-1]; ny[i] = ny[N-1]; nz[i] = nz[N-1];
       }
       
-      /* call displacement shader */
+      /* call displacement shader once for the entire grid */
       func(userPtr,geomID,primID,
 	   (float*)qu,(float*)qv,
 	   (float*)nx,(float*)ny,(float*)nz,
 	   (float*)qx,(float*)qy,(float*)qz,
-	   width*height);
+	   N);
       
       /* add displacements */
       for (size_t y=0; y<height; y++) {
@@ -662,7 +663,7 @@ namespace embree
     }
 
     template<typename Patch>
-    __forceinline BBox3fa calculatePositionAndNormal(const Patch& patch, Vec2f luv[17*17], Vec3fa Ng[17*17])
+    __forceinline BBox3fa calculatePositionAndNormal(const Patch& patch, Vec2f luv[17*17], Vec3fa Ng[17*17], const bool normals)
     {
       BBox3fa bounds = empty;
       for (int y=0; y<height; y++) {
@@ -671,7 +672,7 @@ namespace embree
 	  const Vec3fa P = patch.eval(uv.x,uv.y);
 	  bounds.extend(P);
 	  point(x,y)    = P;
-	  Ng[y*width+x] = normalize_safe(patch.normal(luv[y*width+x].x, luv[y*width+x].y)); // FIXME: enable only for displacement mapping
+          if (normals) Ng[y*width+x] = normalize_safe(patch.normal(uv.x,uv.y));
         }
       }
       return bounds;
@@ -740,16 +741,16 @@ namespace embree
       /* stitch local UVs */
       stitchLocalUVs(x0,x1,y0,y1,pattern0,pattern1,pattern2,pattern3,pattern_x,pattern_y,luv);
       
-      /* evaluate position and normal */
+      /* evaluate position, normals are only required for displacement */
+      SubdivMesh* mesh = (SubdivMesh*) scene->get(geomID);
       Vec3fa Ng[17*17];
-      calculatePositionAndNormal(patch,luv,Ng);
+      calculatePositionAndNormal(patch,luv,Ng,mesh->displFunc != NULL);
 
-      /* calculate global UVs */
+      /* calculate global UVs, this also stores the hit UVs of the grid points */
       Vec2f guv[17*17]; 
       calculateGlobalUVs(uv0,uv1,uv2,uv3,luv,guv);
 
       /* perform displacement */
-      SubdivMesh* mesh = (SubdivMesh*) scene->get(geomID);
       if (mesh->displFunc) 
 	displace(scene,mesh->displFunc,mesh->userPtr,luv,guv,Ng);
     }
@@ -806,10 +807,10 @@ namespace embree
       Vec2f guv[17*17]; 
       calculateGlobalUVs(uv0,uv1,uv2,uv3,luv,guv);
 
-      /* try to approximate bounding box */
+      /* try to approximate bounding box, unless tight bounds got requested */
       SubdivMesh* mesh = (SubdivMesh*) scene->get(geomID);
       const BBox3fa dbounds = mesh->displBounds;
-      if (!dbounds.empty()) {
+      if (!dbounds.empty() && !g_subdiv_tight_bounds) {
 	const BBox3fa gbounds = bounds();
 	if (all(gt_mask(8.0f*gbounds.size(),dbounds.size()))) {
 	  return gbounds+dbounds;
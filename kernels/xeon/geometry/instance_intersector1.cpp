@@ -45,8 +45,12 @@ namespace embree
       const Vec3fa ray_dir = ray.dir;
       const int ray_geomID = ray.geomID;
       const int ray_instID = ray.instID;
-      ray.org = xfmPoint (instance->world2local,ray_org);
-      ray.dir = xfmVector(instance->world2local,ray_dir);
+      if (instance->translation) 
+        ray.org = ray_org + instance->world2local.p;
+      else {
+        ray.org = xfmPoint (instance->world2local,ray_org);
+        ray.dir = xfmVector(instance->world2local,ray_dir);
+      }
       ray.geomID = -1;
       ray.instID = instance->id;
       instance->object->intersect((RTCRay&)ray);
@@ -62,8 +66,12 @@ namespace embree
     {
       const Vec3fa ray_org = ray.org;
       const Vec3fa ray_dir = ray.dir;
-      ray.org = xfmPoint (instance->world2local,ray_org);
-      ray.dir = xfmVector(instance->world2local,ray_dir);
+      if (instance->translation) 
+        ray.org = ray_org + instance->world2local.p;
+      else {
+        ray.org = xfmPoint (instance->world2local,ray_org);
+        ray.dir = xfmVector(instance->world2local,ray_dir);
+      }
       ray.instID = instance->id;
       instance->object->occluded((RTCRay&)ray);
       ray.org = ray_org;
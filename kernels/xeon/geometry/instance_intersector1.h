@@ -17,6 +17,7 @@
 #pragma once
 
 #include "common/scene_user_geometry.h"
+#include "virtual_accel.h"
 #include "common/ray.h"
 
 namespace embree
@@ -28,5 +29,48 @@ namespace embree
       static void intersect(const Instance* instance, Ray& ray, size_t item);
       static void occluded (const Instance* instance, Ray& ray, size_t item);
     };
+
+    /*! Intersects a ray with an instance of an instance array using
+     *  the inverse transformation stored in the leaf. */
+    struct InstanceArrayIntersector1
+    {
+      typedef InstanceArrayItem Primitive;
+
+      struct Precalculations {
+        __forceinline Precalculations (const Ray& ray, const void *ptr) {}
+      };
+      
+      static __forceinline void intersect(Precalculations& pre, Ray& ray, const Primitive& prim, Scene* scene) 
+      {
+        const Vec3fa ray_org = ray.org;
+        const Vec3fa ray_dir = ray.dir;
+        const int ray_geomID = ray.geomID;
+        const int ray_instID = ray.instID;
+        ray.org = xfmPoint (prim.world2local,ray_org);
+        ray.dir = xfmVector(prim.world2local,ray_dir);
+        ray.geomID = -1;
+        ray.instID = prim.instances->instID(prim.item);
+        prim.instances->object->intersect((RTCRay&)ray);
+        ray.org = ray_org;
+        ray.dir = ray_dir;
+        if (ray.geomID == -1) {
+          ray.geomID = ray_geomID;
+          ray.instID = ray_instID;
+        }
+      }
+      
+      static __forceinline bool occluded(Precalculations& pre, Ray& ray, const Primitive& prim, Scene* scene) 
+      {
+        const Vec3fa ray_org = ray.org;
+        const Vec3fa ray_dir = ray.dir;
+        ray.org = xfmPoint (prim.world2local,ray_org);
+        ray.dir = xfmVector(prim.world2local,ray_dir);
+        ray.instID = prim.instances->instID(prim.item);
+        prim.instances->object->occluded((RTCRay&)ray);
+        ray.org = ray_org;
+        ray.dir = ray_dir;
+        return ray.geomID == 0;
+      }
+    };
   }
 }
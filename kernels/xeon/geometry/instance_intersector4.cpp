@@ -20,17 +20,20 @@ namespace embree
 {
   namespace isa
   {
-    typedef AffineSpaceT<LinearSpace3<sse3f> > AffineSpace3faSSE;
-    
     void FastInstanceIntersector4::intersect(sseb* valid, const Instance* instance, Ray4& ray, size_t item)
     {
       const sse3f ray_org = ray.org;
       const sse3f ray_dir = ray.dir;
       const ssei ray_geomID = ray.geomID;
       const ssei ray_instID = ray.instID;
-      const AffineSpace3faSSE world2local(instance->world2local);
-      ray.org = xfmPoint (world2local,ray_org);
-      ray.dir = xfmVector(world2local,ray_dir);
+      if (instance->translation) {
+        const Vec3fa& p = instance->world2local.p;
+        ray.org = ray_org + sse3f(ssef(p.x),ssef(p.y),ssef(p.z));
+      } else {
+        const AffineSpace3faSSE world2local(instance->world2local);
+        ray.org = xfmPoint (world2local,ray_org);
+        ray.dir = xfmVector(world2local,ray_dir);
+      }
       ray.geomID = -1;
       ray.instID = instance->id;
       instance->object->intersect4(valid,(RTCRay4&)ray);
@@ -46,9 +49,14 @@ namespace embree
       const sse3f ray_org = ray.org;
       const sse3f ray_dir = ray.dir;
       const ssei ray_geomID = ray.geomID;
-      const AffineSpace3faSSE world2local(instance->world2local);
-      ray.org = xfmPoint (world2local,ray_org);
-      ray.dir = xfmVector(world2local,ray_dir);
+      if (instance->translation) {
+        const Vec3fa& p = instance->world2local.p;
+        ray.org = ray_org + sse3f(ssef(p.x),ssef(p.y),ssef(p.z));
+      } else {
+        const AffineSpace3faSSE world2local(instance->world2local);
+        ray.org = xfmPoint (world2local,ray_org);
+        ray.dir = xfmVector(world2local,ray_dir);
+      }
       ray.instID = instance->id;
       instance->object->occluded4(valid,(RTCRay4&)ray);
       ray.org = ray_org;
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "common/scene_user_geometry.h"
+#include "virtual_accel.h"
 #include "common/ray4.h"
 
 namespace embree
@@ -28,5 +29,52 @@ namespace embree
       static void intersect(sseb* valid, const Instance* instance, Ray4& ray, size_t item);
       static void occluded (sseb* valid, const Instance* instance, Ray4& ray, size_t item);
     };
+
+    typedef AffineSpaceT<LinearSpace3<sse3f> > AffineSpace3faSSE;
+
+    /*! Intersects a ray packet with an instance of an instance array,
+     *  the inverse transformation stored in the leaf gets broadcasted
+     *  once per packet. */
+    struct InstanceArrayIntersector4
+    {
+      typedef InstanceArrayItem Primitive;
+
+      struct Precalculations {
+        __forceinline Precalculations (const sseb& valid, const Ray4& ray) {}
+      };
+      
+      static __forceinline void intersect(const sseb& valid_i, Precalculations& pre, Ray4& ray, const Primitive& prim, Scene* scene) 
+      {
+        const sse3f ray_org = ray.org;
+        const sse3f ray_dir = ray.dir;
+        const ssei ray_geomID = ray.geomID;
+        const ssei ray_instID = ray.instID;
+        const AffineSpace3faSSE world2local(prim.world2local);
+        ray.org = xfmPoint (world2local,ray_org);
+        ray.dir = xfmVector(world2local,ray_dir);
+        ray.geomID = -1;
+        ray.instID = prim.instances->instID(prim.item);
+        prim.instances->object->intersect4(&valid_i,(RTCRay4&)ray);
+        ray.org = ray_org;
+        ray.dir = ray_dir;
+        sseb nohit = ray.geomID == ssei(-1);
+        ray.geomID = select(nohit,ray_geomID,ray.geomID);
+        ray.instID = select(nohit,ray_instID,ray.instID);
+      }
+      
+      static __forceinline sseb occluded(const sseb& valid_i, Precalculations& pre, Ray4& ray, const Primitive& prim, Scene* scene) 
+      {
+        const sse3f ray_org = ray.org;
+        const sse3f ray_dir = ray.dir;
+        const AffineSpace3faSSE world2local(prim.world2local);
+        ray.org = xfmPoint (world2local,ray_org);
+        ray.dir = xfmVector(world2local,ray_dir);
+        ray.instID = prim.instances->instID(prim.item);
+        prim.instances->object->occluded4(&valid_i,(RTCRay4&)ray);
+        ray.org = ray_org;
+        ray.dir = ray_dir;
+        return ray.geomID == 0;
+      }
+    };
   }
 }
@@ -20,17 +20,20 @@ namespace embree
 {
   namespace isa
   {
-    typedef AffineSpaceT<LinearSpace3<avx3f> > AffineSpace3faAVX;
-    
     void FastInstanceIntersector8::intersect(avxb* valid, const Instance* instance, Ray8& ray, size_t item)
     {
       const avx3f ray_org = ray.org;
       const avx3f ray_dir = ray.dir;
       const avxi ray_geomID = ray.geomID;
       const avxi ray_instID = ray.instID;
-      const AffineSpace3faAVX world2local(instance->world2local);
-      ray.org = xfmPoint (world2local,ray_org);
-      ray.dir = xfmVector(world2local,ray_dir);
+      if (instance->translation) {
+        const Vec3fa& p = instance->world2local.p;
+        ray.org = ray_org + avx3f(avxf(p.x),avxf(p.y),avxf(p.z));
+      } else {
+        const AffineSpace3faAVX world2local(instance->world2local);
+        ray.org = xfmPoint (world2local,ray_org);
+        ray.dir = xfmVector(world2local,ray_dir);
+      }
       ray.geomID = -1;
       ray.instID = instance->id;
       instance->object->intersect8(valid,(RTCRay8&)ray);
@@ -46,9 +49,14 @@ namespace embree
       const avx3f ray_org = ray.org;
       const avx3f ray_dir = ray.dir;
       const avxi ray_geomID = ray.geomID;
-      const AffineSpace3faAVX world2local(instance->world2local);
-      ray.org = xfmPoint (world2local,ray_org);
-      ray.dir = xfmVector(world2local,ray_dir);
+      if (instance->translation) {
+        const Vec3fa& p = instance->world2local.p;
+        ray.org = ray_org + avx3f(avxf(p.x),avxf(p.y),avxf(p.z));
+      } else {
+        const AffineSpace3faAVX world2local(instance->world2local);
+        ray.org = xfmPoint (world2local,ray_org);
+        ray.dir = xfmVector(world2local,ray_dir);
+      }
       ray.instID = instance->id;
       instance->object->occluded8(valid,(RTCRay8&)ray);
       ray.org = ray_org;
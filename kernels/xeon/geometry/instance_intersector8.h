@@ -17,6 +17,7 @@
 #pragma once
 
 #include "common/scene_user_geometry.h"
+#include "virtual_accel.h"
 #include "common/ray8.h"
 
 namespace embree
@@ -28,5 +29,52 @@ namespace embree
       static void intersect(avxb* valid, const Instance* instance, Ray8& ray, size_t item);
       static void occluded (avxb* valid, const Instance* instance, Ray8& ray, size_t item);
     };
+
+    typedef AffineSpaceT<LinearSpace3<avx3f> > AffineSpace3faAVX;
+
+    /*! Intersects a ray packet with an instance of an instance array,
+     *  the inverse transformation stored in the leaf gets broadcasted
+     *  once per packet. */
+    struct InstanceArrayIntersector8
+    {
+      typedef InstanceArrayItem Primitive;
+
+      struct Precalculations {
+        __forceinline Precalculations (const avxb& valid, const Ray8& ray) {}
+      };
+      
+      static __forceinline void intersect(const avxb& valid_i, Precalculations& pre, Ray8& ray, const Primitive& prim, Scene* scene) 
+      {
+        const avx3f ray_org = ray.org;
+        const avx3f ray_dir = ray.dir;
+        const avxi ray_geomID = ray.geomID;
+        const avxi ray_instID = ray.instID;
+        const AffineSpace3faAVX world2local(prim.world2local);
+        ray.org = xfmPoint (world2local,ray_org);
+        ray.dir = xfmVector(world2local,ray_dir);
+        ray.geomID = -1;
+        ray.instID = prim.instances->instID(prim.item);
+        prim.instances->object->intersect8(&valid_i,(RTCRay8&)ray);
+        ray.org = ray_org;
+        ray.dir = ray_dir;
+        avxb nohit = ray.geomID == avxi(-1);
+        ray.geomID = select(nohit,ray_geomID,ray.geomID);
+        ray.instID = select(nohit,ray_instID,ray.instID);
+      }
+      
+      static __forceinline avxb occluded(const avxb& valid_i, Precalculations& pre, Ray8& ray, const Primitive& prim, Scene* scene) 
+      {
+        const avx3f ray_org = ray.org;
+        const avx3f ray_dir = ray.dir;
+        const AffineSpace3faAVX world2local(prim.world2local);
+        ray.org = xfmPoint (world2local,ray_org);
+        ray.dir = xfmVector(world2local,ray_dir);
+        ray.instID = prim.instances->instID(prim.item);
+        prim.instances->object->occluded8(&valid_i,(RTCRay8&)ray);
+        ray.org = ray_org;
+        ray.dir = ray_dir;
+        return ray.geomID == 0;
+      }
+    };
   }
 }
@@ -32,6 +32,19 @@
 
 namespace embree
 {
+  /*! Returns true if an intersector has to cull backfaces. Culling is
+   *  either enabled for all kernels at compile time or only for the
+   *  kernels instantiated for scenes with backface culling. */
+  template<bool culling>
+    __forceinline bool backfaceCulling() 
+  {
+#if defined(RTCORE_BACKFACE_CULLING)
+    return true;
+#else
+    return culling;
+#endif
+  }
+
   struct PrimitiveType
   {
     /*! constructs the primitive type */
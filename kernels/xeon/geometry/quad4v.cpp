@@ -0,0 +1,42 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "quad4v.h"
+#include "common/scene.h"
+
+namespace embree
+{
+  Quad4vType Quad4vType::type;
+
+  Quad4vType::Quad4vType ()
+    : PrimitiveType("quad4v",sizeof(Quad4v),4,false,2) {}
+
+  size_t Quad4vType::blocks(size_t x) const {
+    return (x+3)/4;
+  }
+
+  size_t Quad4vType::size(const char* This) const {
+    return ((Quad4v*)This)->size();
+  }
+
+  size_t Quad4vType::hash(const char* This, size_t num) const
+  {
+    size_t hash = 0;
+    for (size_t i=0; i<num; i++)
+      hash += (i+1)*((Quad4v*)This)[i].hash();
+    return hash;
+  }
+}
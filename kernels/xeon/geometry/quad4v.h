@@ -0,0 +1,182 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "primitive.h"
+
+namespace embree
+{
+  /*! Stores the 4 vertices of 4 quads. Each quad v0,v1,v2,v3 gets
+      intersected as the two triangles v0,v1,v3 and v2,v3,v1, thus
+      a leaf of 4 quads is intersected as 8 triangles. */
+  struct Quad4v
+  {
+  public:
+
+    /*! Default constructor. */
+    __forceinline Quad4v () {}
+
+    /*! Construction from vertices and IDs. */
+    __forceinline Quad4v (const sse3f& v0, const sse3f& v1, const sse3f& v2, const sse3f& v3, const ssei& geomIDs, const ssei& primIDs, const ssei& mask, const bool last)
+      : v0(v0), v1(v1), v2(v2), v3(v3), geomIDs(geomIDs), primIDs(primIDs | (last << 31))
+    {
+#if defined(RTCORE_RAY_MASK)
+      this->mask = mask;
+#endif
+    }
+
+    /*! Returns if the specified quad is valid. */
+    __forceinline bool valid(const size_t i) const {
+      assert(i<4);
+      return geomIDs[i] != -1;
+    }
+
+    /*! Returns a mask that tells which quads are valid. */
+    __forceinline sseb valid() const { return geomIDs != ssei(-1); }
+
+    /*! Returns the number of stored quads. */
+    __forceinline size_t size() const {
+      return bitscan(~movemask(valid()));
+    }
+
+    /*! Returns a hash number for the geometry */
+    __forceinline size_t hash() const
+    {
+      size_t hash = 0x3636;
+      for (size_t i=0; i<sizeof(Quad4v)/4; i++)
+	hash += ((uint32*)this)[i];
+      return hash;
+    }
+
+    /*! calculate the bounds of the quads */
+    __forceinline BBox3fa bounds() const
+    {
+      sse3f lower = min(min(v0,v1),min(v2,v3));
+      sse3f upper = max(max(v0,v1),max(v2,v3));
+      sseb mask = valid();
+      lower.x = select(mask,lower.x,ssef(pos_inf));
+      lower.y = select(mask,lower.y,ssef(pos_inf));
+      lower.z = select(mask,lower.z,ssef(pos_inf));
+      upper.x = select(mask,upper.x,ssef(neg_inf));
+      upper.y = select(mask,upper.y,ssef(neg_inf));
+      upper.z = select(mask,upper.z,ssef(neg_inf));
+      return BBox3fa(Vec3fa(reduce_min(lower.x),reduce_min(lower.y),reduce_min(lower.z)),
+                     Vec3fa(reduce_max(upper.x),reduce_max(upper.y),reduce_max(upper.z)));
+    }
+
+    /*! non temporal store */
+    __forceinline static void store_nt(Quad4v* dst, const Quad4v& src)
+    {
+      store4f_nt(&dst->v0.x,src.v0.x);
+      store4f_nt(&dst->v0.y,src.v0.y);
+      store4f_nt(&dst->v0.z,src.v0.z);
+      store4f_nt(&dst->v1.x,src.v1.x);
+      store4f_nt(&dst->v1.y,src.v1.y);
+      store4f_nt(&dst->v1.z,src.v1.z);
+      store4f_nt(&dst->v2.x,src.v2.x);
+      store4f_nt(&dst->v2.y,src.v2.y);
+      store4f_nt(&dst->v2.z,src.v2.z);
+      store4f_nt(&dst->v3.x,src.v3.x);
+      store4f_nt(&dst->v3.y,src.v3.y);
+      store4f_nt(&dst->v3.z,src.v3.z);
+      store4i_nt(&dst->geomIDs,src.geomIDs);
+      store4i_nt(&dst->primIDs,src.primIDs);
+#if defined(RTCORE_RAY_MASK)
+      store4i_nt(&dst->mask,src.mask);
+#endif
+    }
+
+    /*! returns required number of primitive blocks for N primitives */
+    static __forceinline size_t blocks(size_t N) { return (N+3)/4; }
+
+    /*! checks if this is the last quad in the list */
+    __forceinline int last() const {
+      return primIDs[0] & 0x80000000;
+    }
+
+    /*! returns the geometry IDs */
+    template<bool list>
+    __forceinline ssei geomID() const {
+      return geomIDs;
+    }
+    template<bool list>
+    __forceinline int geomID(const size_t i) const {
+      assert(i<4); return geomIDs[i];
+    }
+
+    /*! returns the primitive IDs */
+    template<bool list>
+    __forceinline ssei primID() const {
+      if (list) return primIDs & 0x7FFFFFFF;
+      else      return primIDs;
+    }
+    template<bool list>
+    __forceinline int  primID(const size_t i) const {
+      assert(i<4);
+      if (list) return primIDs[i] & 0x7FFFFFFF;
+      else      return primIDs[i];
+    }
+
+    /*! fill quads from quad list */
+    __forceinline void fill(const PrimRef* prims, size_t& begin, size_t end, Scene* scene, const bool list)
+    {
+      ssei vgeomID = -1, vprimID = -1, vmask = -1;
+      sse3f v0 = zero, v1 = zero, v2 = zero, v3 = zero;
+
+      for (size_t i=0; i<4 && begin<end; i++, begin++)
+      {
+	const PrimRef& prim = prims[begin];
+        const size_t geomID = prim.geomID();
+        const size_t primID = prim.primID();
+        const QuadMesh* __restrict__ const mesh = scene->getQuadMesh(geomID);
+        const QuadMesh::Quad& quad = mesh->quad(primID);
+        const Vec3fa p0 = mesh->vertex(quad.v[0]);
+        const Vec3fa p1 = mesh->vertex(quad.v[1]);
+        const Vec3fa p2 = mesh->vertex(quad.v[2]);
+        const Vec3fa p3 = mesh->vertex(quad.v[3]);
+        vgeomID [i] = geomID;
+        vprimID [i] = primID;
+        vmask   [i] = mesh->mask;
+        v0.x[i] = p0.x; v0.y[i] = p0.y; v0.z[i] = p0.z;
+        v1.x[i] = p1.x; v1.y[i] = p1.y; v1.z[i] = p1.z;
+        v2.x[i] = p2.x; v2.y[i] = p2.y; v2.z[i] = p2.z;
+        v3.x[i] = p3.x; v3.y[i] = p3.y; v3.z[i] = p3.z;
+      }
+      Quad4v::store_nt(this,Quad4v(v0,v1,v2,v3,vgeomID,vprimID,vmask,list && begin>=end));
+    }
+
+  public:
+    sse3f v0;       //!< 1st vertex of the quads.
+    sse3f v1;       //!< 2nd vertex of the quads.
+    sse3f v2;       //!< 3rd vertex of the quads.
+    sse3f v3;       //!< 4th vertex of the quads.
+    ssei geomIDs;   //!< user geometry ID
+    ssei primIDs;   //!< primitive ID
+#if defined(RTCORE_RAY_MASK)
+    ssei mask;      //!< geometry mask
+#endif
+  };
+
+  struct Quad4vType : public PrimitiveType
+  {
+    static Quad4vType type;
+    Quad4vType ();
+    size_t blocks(size_t x) const;
+    size_t size(const char* This) const;
+    size_t hash(const char* This, size_t num) const;
+  };
+}
@@ -0,0 +1,229 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "quad4v.h"
+#include "common/ray.h"
+#include "geometry/filter.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Intersector for a single ray with 4 quads. Each quad is split
+     *  into the triangles v0,v1,v3 and v2,v3,v1 which are intersected
+     *  using the Moeller Trumbore test. With AVX all 8 triangles are
+     *  tested in a single step, otherwise the first and second
+     *  triangles of all quads are tested in two SSE steps. The hit
+     *  coordinates of the second triangle get mapped to the quad
+     *  coordinates by (u,v) -> (1-u,1-v). */
+    template<bool list, bool culling = false>
+      struct Quad4vIntersector1MoellerTrumbore
+      {
+        typedef Quad4v Primitive;
+
+        struct Precalculations {
+          __forceinline Precalculations (const Ray& ray, const void *ptr) {}
+        };
+
+        /*! Intersects a ray with the triangles v0,v1,v2. SIMD lane i belongs to quad i%4. */
+        template<typename simdb, typename simdf, typename simd3f>
+        static __forceinline void intersect(Ray& ray, const simd3f& v0, const simd3f& v1, const simd3f& v2, const simdb& flip, const Primitive& quad, Scene* scene)
+        {
+          /* calculate denominator */
+          const simd3f O = simd3f(ray.org);
+          const simd3f D = simd3f(ray.dir);
+          const simd3f e1 = v0-v1;
+          const simd3f e2 = v2-v0;
+          const simd3f Ng = cross(e1,e2);
+          const simd3f C = v0 - O;
+          const simd3f R = cross(D,C);
+          const simdf den = dot(Ng,D);
+          const simdf absDen = abs(den);
+          const simdf sgnDen = signmsk(den);
+
+          /* perform edge tests */
+          const simdf U = dot(R,e2) ^ sgnDen;
+          const simdf V = dot(R,e1) ^ sgnDen;
+
+          /* perform backface culling */
+          simdb valid = (backfaceCulling<culling>() ? den > simdf(zero) : den != simdf(zero)) & (U >= 0.0f) & (V >= 0.0f) & (U+V<=absDen);
+          if (likely(none(valid))) return;
+
+          /* perform depth test */
+          const simdf T = dot(Ng,C) ^ sgnDen;
+          valid &= (T > absDen*simdf(ray.tnear)) & (T < absDen*simdf(ray.tfar));
+          if (likely(none(valid))) return;
+
+          /* calculate hit information */
+          const simdf rcpAbsDen = rcp(absDen);
+          const simdf u0 = U * rcpAbsDen;
+          const simdf v0_ = V * rcpAbsDen;
+          const simdf u = select(flip,simdf(one)-u0,u0);
+          const simdf v = select(flip,simdf(one)-v0_,v0_);
+          const simdf t = T * rcpAbsDen;
+
+          while (true)
+          {
+            const size_t i = select_min(valid,t);
+            const size_t k = i&3;
+            const int geomID = quad.geomID<list>(k);
+
+            /* ray masking test */
+#if defined(RTCORE_RAY_MASK)
+            if (unlikely((quad.mask[k] & ray.mask) == 0)) {
+              valid[i] = 0;
+              if (none(valid)) return;
+              continue;
+            }
+#endif
+
+            /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER)
+            Geometry* geometry = scene->get(geomID);
+            if (unlikely(geometry->hasIntersectionFilter1()))
+            {
+              const Vec3fa Ngi = Vec3fa(Ng.x[i],Ng.y[i],Ng.z[i]);
+              if (runIntersectionFilter1(geometry,ray,u[i],v[i],t[i],Ngi,geomID,quad.primID<list>(k))) return;
+              valid[i] = 0;
+              if (none(valid)) return;
+              continue;
+            }
+#endif
+
+            /* update hit information */
+            ray.u = u[i];
+            ray.v = v[i];
+            ray.tfar = t[i];
+            ray.Ng.x = Ng.x[i];
+            ray.Ng.y = Ng.y[i];
+            ray.Ng.z = Ng.z[i];
+            ray.geomID = geomID;
+            ray.primID = quad.primID<list>(k);
+            return;
+          }
+        }
+
+        /*! Tests if the ray is occluded by one of the triangles v0,v1,v2. SIMD lane i belongs to quad i%4. */
+        template<typename simdb, typename simdf, typename simd3f>
+        static __forceinline bool occluded(Ray& ray, const simd3f& v0, const simd3f& v1, const simd3f& v2, const simdb& flip, const Primitive& quad, Scene* scene)
+        {
+          /* calculate denominator */
+          const simd3f O = simd3f(ray.org);
+          const simd3f D = simd3f(ray.dir);
+          const simd3f e1 = v0-v1;
+          const simd3f e2 = v2-v0;
+          const simd3f Ng = cross(e1,e2);
+          const simd3f C = v0 - O;
+          const simd3f R = cross(D,C);
+          const simdf den = dot(Ng,D);
+          const simdf absDen = abs(den);
+          const simdf sgnDen = signmsk(den);
+
+          /* perform edge tests */
+          const simdf U = dot(R,e2) ^ sgnDen;
+          const simdf V = dot(R,e1) ^ sgnDen;
+          const simdf W = absDen-U-V;
+          simdb valid = (U >= 0.0f) & (V >= 0.0f) & (W >= 0.0f);
+          if (unlikely(none(valid))) return false;
+
+          /* perform depth test */
+          const simdf T = dot(Ng,C) ^ sgnDen;
+          valid &= (den != simdf(zero)) & (T >= absDen*simdf(ray.tnear)) & (absDen*simdf(ray.tfar) >= T);
+          if (unlikely(none(valid))) return false;
+
+          /* perform backface culling */
+          if (backfaceCulling<culling>()) {
+            valid &= den > simdf(zero);
+            if (unlikely(none(valid))) return false;
+          }
+
+#if defined(RTCORE_RAY_MASK) || defined(RTCORE_INTERSECTION_FILTER)
+          size_t m=movemask(valid), i=__bsf(m);
+          while (true)
+          {
+            const size_t k = i&3;
+            const int geomID = quad.geomID<list>(k);
+
+            /* ray masking test */
+#if defined(RTCORE_RAY_MASK)
+            if (likely((quad.mask[k] & ray.mask) != 0))
+#endif
+            {
+              /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER)
+              Geometry* geometry = scene->get(geomID);
+
+              /* if we have no filter then the test passes */
+              if (likely(!geometry->hasOcclusionFilter1()))
+                break;
+
+              /* calculate hit information */
+              const simdf rcpAbsDen = rcp(absDen);
+              const simdf u0 = U * rcpAbsDen;
+              const simdf v0_ = V * rcpAbsDen;
+              const simdf u = select(flip,simdf(one)-u0,u0);
+              const simdf v = select(flip,simdf(one)-v0_,v0_);
+              const simdf t = T * rcpAbsDen;
+              const Vec3fa Ngi = Vec3fa(Ng.x[i],Ng.y[i],Ng.z[i]);
+              if (runOcclusionFilter1(geometry,ray,u[i],v[i],t[i],Ngi,geomID,quad.primID<list>(k)))
+                break;
+#else
+              break;
+#endif
+            }
+
+            /* test if one more triangle hit */
+            m=__btc(m,i); i=__bsf(m);
+            if (m == 0) return false;
+          }
+#endif
+          return true;
+        }
+
+        /*! Intersect a ray with the 4 quads and updates the hit. */
+        static __forceinline void intersect(const Precalculations& pre, Ray& ray, const Primitive& quad, Scene* scene)
+        {
+          STAT3(normal.trav_prims,1,1,1);
+#if defined(__AVX__)
+          const avx3f p0(avxf(quad.v0.x,quad.v2.x),avxf(quad.v0.y,quad.v2.y),avxf(quad.v0.z,quad.v2.z));
+          const avx3f p1(avxf(quad.v1.x,quad.v3.x),avxf(quad.v1.y,quad.v3.y),avxf(quad.v1.z,quad.v3.z));
+          const avx3f p2(avxf(quad.v3.x,quad.v1.x),avxf(quad.v3.y,quad.v1.y),avxf(quad.v3.z,quad.v1.z));
+          intersect<avxb,avxf,avx3f>(ray,p0,p1,p2,avxb(false,true),quad,scene);
+#else
+          intersect<sseb,ssef,sse3f>(ray,quad.v0,quad.v1,quad.v3,sseb(false),quad,scene);
+          intersect<sseb,ssef,sse3f>(ray,quad.v2,quad.v3,quad.v1,sseb(true ),quad,scene);
+#endif
+        }
+
+        /*! Test if the ray is occluded by one of the 4 quads. */
+        static __forceinline bool occluded(const Precalculations& pre, Ray& ray, const Primitive& quad, Scene* scene)
+        {
+          STAT3(shadow.trav_prims,1,1,1);
+#if defined(__AVX__)
+          const avx3f p0(avxf(quad.v0.x,quad.v2.x),avxf(quad.v0.y,quad.v2.y),avxf(quad.v0.z,quad.v2.z));
+          const avx3f p1(avxf(quad.v1.x,quad.v3.x),avxf(quad.v1.y,quad.v3.y),avxf(quad.v1.z,quad.v3.z));
+          const avx3f p2(avxf(quad.v3.x,quad.v1.x),avxf(quad.v3.y,quad.v1.y),avxf(quad.v3.z,quad.v1.z));
+          return occluded<avxb,avxf,avx3f>(ray,p0,p1,p2,avxb(false,true),quad,scene);
+#else
+          if (occluded<sseb,ssef,sse3f>(ray,quad.v0,quad.v1,quad.v3,sseb(false),quad,scene)) return true;
+          return occluded<sseb,ssef,sse3f>(ray,quad.v2,quad.v3,quad.v1,sseb(true ),quad,scene);
+#endif
+        }
+      };
+  }
+}
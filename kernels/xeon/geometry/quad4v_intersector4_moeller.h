@@ -0,0 +1,203 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "quad4v.h"
+#include "quad4v_intersector1_moeller.h"
+
+#include "../common/ray4.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Intersector for 4 quads with 4 rays. Each quad is intersected
+     *  as the two triangles v0,v1,v3 and v2,v3,v1 using the Moeller
+     *  Trumbore test. */
+    template<bool list, bool enableIntersectionFilter, bool culling = false>
+      struct Quad4vIntersector4MoellerTrumbore
+      {
+        typedef Quad4v Primitive;
+
+        struct Precalculations {
+          __forceinline Precalculations (const sseb& valid, const Ray4& ray) {}
+        };
+
+        /*! Intersects 4 rays with the triangle p0,p1,p2 of quad i. */
+        static __forceinline void intersect(const sseb& valid_i, Ray4& ray, const sse3f& p0, const sse3f& p1, const sse3f& p2, const bool flip,
+                                            const Primitive& quad, const size_t i, Scene* scene)
+        {
+          /* calculate denominator */
+          sseb valid = valid_i;
+          const sse3f e1 = p0-p1;
+          const sse3f e2 = p2-p0;
+          const sse3f Ng = cross(e1,e2);
+          const sse3f C = p0 - ray.org;
+          const sse3f R = cross(ray.dir,C);
+          const ssef den = dot(Ng,ray.dir);
+          const ssef absDen = abs(den);
+          const ssef sgnDen = signmsk(den);
+
+          /* perform edge tests */
+          const ssef U = dot(R,e2) ^ sgnDen;
+          const ssef V = dot(R,e1) ^ sgnDen;
+          const ssef W = absDen-U-V;
+          valid &= (U >= 0.0f) & (V >= 0.0f) & (W >= 0.0f);
+          if (likely(none(valid))) return;
+
+          /* perform depth test */
+          const ssef T = dot(Ng,C) ^ sgnDen;
+          valid &= (T >= absDen*ray.tnear) & (absDen*ray.tfar >= T);
+          if (unlikely(none(valid))) return;
+
+          /* perform backface culling */
+          valid &= backfaceCulling<culling>() ? den > ssef(zero) : den != ssef(zero);
+          if (unlikely(none(valid))) return;
+
+          /* ray masking test */
+#if defined(RTCORE_RAY_MASK)
+          valid &= (quad.mask[i] & ray.mask) != 0;
+          if (unlikely(none(valid))) return;
+#endif
+
+          /* calculate hit information */
+          const ssef rcpAbsDen = rcp(absDen);
+          const ssef u = flip ? ssef(one)-U*rcpAbsDen : U*rcpAbsDen;
+          const ssef v = flip ? ssef(one)-V*rcpAbsDen : V*rcpAbsDen;
+          const ssef t = T*rcpAbsDen;
+          const int geomID = quad.geomID<list>(i);
+          const int primID = quad.primID<list>(i);
+
+          /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER)
+          if (enableIntersectionFilter) {
+            Geometry* geometry = scene->get(geomID);
+            if (unlikely(geometry->hasIntersectionFilter4())) {
+              runIntersectionFilter4(valid,geometry,ray,u,v,t,Ng,geomID,primID);
+              return;
+            }
+          }
+#endif
+
+          /* update hit information */
+          store4f(valid,&ray.u,u);
+          store4f(valid,&ray.v,v);
+          store4f(valid,&ray.tfar,t);
+          store4i(valid,&ray.geomID,geomID);
+          store4i(valid,&ray.primID,primID);
+          store4f(valid,&ray.Ng.x,Ng.x);
+          store4f(valid,&ray.Ng.y,Ng.y);
+          store4f(valid,&ray.Ng.z,Ng.z);
+        }
+
+        /*! Returns the rays of the packet that are occluded by the triangle p0,p1,p2 of quad i. */
+        static __forceinline sseb occluded(const sseb& valid_i, Ray4& ray, const sse3f& p0, const sse3f& p1, const sse3f& p2, const bool flip,
+                                           const Primitive& quad, const size_t i, Scene* scene)
+        {
+          /* calculate denominator */
+          sseb valid = valid_i;
+          const sse3f e1 = p0-p1;
+          const sse3f e2 = p2-p0;
+          const sse3f Ng = cross(e1,e2);
+          const sse3f C = p0 - ray.org;
+          const sse3f R = cross(ray.dir,C);
+          const ssef den = dot(Ng,ray.dir);
+          const ssef absDen = abs(den);
+          const ssef sgnDen = signmsk(den);
+
+          /* perform edge tests */
+          const ssef U = dot(R,e2) ^ sgnDen;
+          const ssef V = dot(R,e1) ^ sgnDen;
+          const ssef W = absDen-U-V;
+          valid &= (U >= 0.0f) & (V >= 0.0f) & (W >= 0.0f);
+          if (likely(none(valid))) return valid;
+
+          /* perform depth test */
+          const ssef T = dot(Ng,C) ^ sgnDen;
+          valid &= (T >= absDen*ray.tnear) & (absDen*ray.tfar >= T);
+          if (unlikely(none(valid))) return valid;
+
+          /* perform backface culling */
+          valid &= backfaceCulling<culling>() ? den > ssef(zero) : den != ssef(zero);
+          if (unlikely(none(valid))) return valid;
+
+          /* ray masking test */
+#if defined(RTCORE_RAY_MASK)
+          valid &= (quad.mask[i] & ray.mask) != 0;
+          if (unlikely(none(valid))) return valid;
+#endif
+
+          /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER)
+          if (enableIntersectionFilter)
+          {
+            const int geomID = quad.geomID<list>(i);
+            Geometry* geometry = scene->get(geomID);
+            if (unlikely(geometry->hasOcclusionFilter4()))
+            {
+              /* calculate hit information */
+              const ssef rcpAbsDen = rcp(absDen);
+              const ssef u = flip ? ssef(one)-U*rcpAbsDen : U*rcpAbsDen;
+              const ssef v = flip ? ssef(one)-V*rcpAbsDen : V*rcpAbsDen;
+              const ssef t = T*rcpAbsDen;
+              const int primID = quad.primID<list>(i);
+              valid = runOcclusionFilter4(valid,geometry,ray,u,v,t,Ng,geomID,primID);
+            }
+          }
+#endif
+          return valid;
+        }
+
+        /*! Intersects 4 rays with 4 quads. */
+        static __forceinline void intersect(const sseb& valid_i, Precalculations& pre, Ray4& ray, const Primitive& quad, Scene* scene)
+        {
+          for (size_t i=0; i<4; i++)
+          {
+            if (!quad.valid(i)) break;
+            STAT3(normal.trav_prims,1,popcnt(valid_i),4);
+            const sse3f p0 = broadcast4f(quad.v0,i);
+            const sse3f p1 = broadcast4f(quad.v1,i);
+            const sse3f p2 = broadcast4f(quad.v2,i);
+            const sse3f p3 = broadcast4f(quad.v3,i);
+            intersect(valid_i,ray,p0,p1,p3,false,quad,i,scene);
+            intersect(valid_i,ray,p2,p3,p1,true ,quad,i,scene);
+          }
+        }
+
+        /*! Test for 4 rays if they are occluded by any of the 4 quads. */
+        static __forceinline sseb occluded(const sseb& valid_i, Precalculations& pre, Ray4& ray, const Primitive& quad, Scene* scene)
+        {
+          sseb valid0 = valid_i;
+
+          for (size_t i=0; i<4; i++)
+          {
+            if (!quad.valid(i)) break;
+            STAT3(shadow.trav_prims,1,popcnt(valid0),4);
+            const sse3f p0 = broadcast4f(quad.v0,i);
+            const sse3f p1 = broadcast4f(quad.v1,i);
+            const sse3f p2 = broadcast4f(quad.v2,i);
+            const sse3f p3 = broadcast4f(quad.v3,i);
+            valid0 &= !occluded(valid0,ray,p0,p1,p3,false,quad,i,scene);
+            if (none(valid0)) break;
+            valid0 &= !occluded(valid0,ray,p2,p3,p1,true ,quad,i,scene);
+            if (none(valid0)) break;
+          }
+          return !valid0;
+        }
+      };
+  }
+}
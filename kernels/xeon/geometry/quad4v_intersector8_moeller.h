@@ -0,0 +1,203 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "quad4v.h"
+#include "quad4v_intersector1_moeller.h"
+
+#include "../common/ray8.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Intersector for 4 quads with 8 rays. Each quad is intersected
+     *  as the two triangles v0,v1,v3 and v2,v3,v1 using the Moeller
+     *  Trumbore test. */
+    template<bool list, bool enableIntersectionFilter, bool culling = false>
+      struct Quad4vIntersector8MoellerTrumbore
+      {
+        typedef Quad4v Primitive;
+
+        struct Precalculations {
+          __forceinline Precalculations (const avxb& valid, const Ray8& ray) {}
+        };
+
+        /*! Intersects 8 rays with the triangle p0,p1,p2 of quad i. */
+        static __forceinline void intersect(const avxb& valid_i, Ray8& ray, const avx3f& p0, const avx3f& p1, const avx3f& p2, const bool flip,
+                                            const Primitive& quad, const size_t i, Scene* scene)
+        {
+          /* calculate denominator */
+          avxb valid = valid_i;
+          const avx3f e1 = p0-p1;
+          const avx3f e2 = p2-p0;
+          const avx3f Ng = cross(e1,e2);
+          const avx3f C = p0 - ray.org;
+          const avx3f R = cross(ray.dir,C);
+          const avxf den = dot(Ng,ray.dir);
+          const avxf absDen = abs(den);
+          const avxf sgnDen = signmsk(den);
+
+          /* perform edge tests */
+          const avxf U = dot(R,e2) ^ sgnDen;
+          const avxf V = dot(R,e1) ^ sgnDen;
+          const avxf W = absDen-U-V;
+          valid &= (U >= 0.0f) & (V >= 0.0f) & (W >= 0.0f);
+          if (likely(none(valid))) return;
+
+          /* perform depth test */
+          const avxf T = dot(Ng,C) ^ sgnDen;
+          valid &= (T >= absDen*ray.tnear) & (absDen*ray.tfar >= T);
+          if (unlikely(none(valid))) return;
+
+          /* perform backface culling */
+          valid &= backfaceCulling<culling>() ? den > avxf(zero) : den != avxf(zero);
+          if (unlikely(none(valid))) return;
+
+          /* ray masking test */
+#if defined(RTCORE_RAY_MASK)
+          valid &= (quad.mask[i] & ray.mask) != 0;
+          if (unlikely(none(valid))) return;
+#endif
+
+          /* calculate hit information */
+          const avxf rcpAbsDen = rcp(absDen);
+          const avxf u = flip ? avxf(one)-U*rcpAbsDen : U*rcpAbsDen;
+          const avxf v = flip ? avxf(one)-V*rcpAbsDen : V*rcpAbsDen;
+          const avxf t = T*rcpAbsDen;
+          const int geomID = quad.geomID<list>(i);
+          const int primID = quad.primID<list>(i);
+
+          /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER)
+          if (enableIntersectionFilter) {
+            Geometry* geometry = scene->get(geomID);
+            if (unlikely(geometry->hasIntersectionFilter8())) {
+              runIntersectionFilter8(valid,geometry,ray,u,v,t,Ng,geomID,primID);
+              return;
+            }
+          }
+#endif
+
+          /* update hit information */
+          store8f(valid,&ray.u,u);
+          store8f(valid,&ray.v,v);
+          store8f(valid,&ray.tfar,t);
+          store8i(valid,&ray.geomID,geomID);
+          store8i(valid,&ray.primID,primID);
+          store8f(valid,&ray.Ng.x,Ng.x);
+          store8f(valid,&ray.Ng.y,Ng.y);
+          store8f(valid,&ray.Ng.z,Ng.z);
+        }
+
+        /*! Returns the rays of the packet that are occluded by the triangle p0,p1,p2 of quad i. */
+        static __forceinline avxb occluded(const avxb& valid_i, Ray8& ray, const avx3f& p0, const avx3f& p1, const avx3f& p2, const bool flip,
+                                           const Primitive& quad, const size_t i, Scene* scene)
+        {
+          /* calculate denominator */
+          avxb valid = valid_i;
+          const avx3f e1 = p0-p1;
+          const avx3f e2 = p2-p0;
+          const avx3f Ng = cross(e1,e2);
+          const avx3f C = p0 - ray.org;
+          const avx3f R = cross(ray.dir,C);
+          const avxf den = dot(Ng,ray.dir);
+          const avxf absDen = abs(den);
+          const avxf sgnDen = signmsk(den);
+
+          /* perform edge tests */
+          const avxf U = dot(R,e2) ^ sgnDen;
+          const avxf V = dot(R,e1) ^ sgnDen;
+          const avxf W = absDen-U-V;
+          valid &= (U >= 0.0f) & (V >= 0.0f) & (W >= 0.0f);
+          if (likely(none(valid))) return valid;
+
+          /* perform depth test */
+          const avxf T = dot(Ng,C) ^ sgnDen;
+          valid &= (T >= absDen*ray.tnear) & (absDen*ray.tfar >= T);
+          if (unlikely(none(valid))) return valid;
+
+          /* perform backface culling */
+          valid &= backfaceCulling<culling>() ? den > avxf(zero) : den != avxf(zero);
+          if (unlikely(none(valid))) return valid;
+
+          /* ray masking test */
+#if defined(RTCORE_RAY_MASK)
+          valid &= (quad.mask[i] & ray.mask) != 0;
+          if (unlikely(none(valid))) return valid;
+#endif
+
+          /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER)
+          if (enableIntersectionFilter)
+          {
+            const int geomID = quad.geomID<list>(i);
+            Geometry* geometry = scene->get(geomID);
+            if (unlikely(geometry->hasOcclusionFilter8()))
+            {
+              /* calculate hit information */
+              const avxf rcpAbsDen = rcp(absDen);
+              const avxf u = flip ? avxf(one)-U*rcpAbsDen : U*rcpAbsDen;
+              const avxf v = flip ? avxf(one)-V*rcpAbsDen : V*rcpAbsDen;
+              const avxf t = T*rcpAbsDen;
+              const int primID = quad.primID<list>(i);
+              valid = runOcclusionFilter8(valid,geometry,ray,u,v,t,Ng,geomID,primID);
+            }
+          }
+#endif
+          return valid;
+        }
+
+        /*! Intersects 8 rays with 4 quads. */
+        static __forceinline void intersect(const avxb& valid_i, Precalculations& pre, Ray8& ray, const Primitive& quad, Scene* scene)
+        {
+          for (size_t i=0; i<4; i++)
+          {
+            if (!quad.valid(i)) break;
+            STAT3(normal.trav_prims,1,popcnt(valid_i),8);
+            const avx3f p0 = broadcast8f(quad.v0,i);
+            const avx3f p1 = broadcast8f(quad.v1,i);
+            const avx3f p2 = broadcast8f(quad.v2,i);
+            const avx3f p3 = broadcast8f(quad.v3,i);
+            intersect(valid_i,ray,p0,p1,p3,false,quad,i,scene);
+            intersect(valid_i,ray,p2,p3,p1,true ,quad,i,scene);
+          }
+        }
+
+        /*! Test for 8 rays if they are occluded by any of the 4 quads. */
+        static __forceinline avxb occluded(const avxb& valid_i, Precalculations& pre, Ray8& ray, const Primitive& quad, Scene* scene)
+        {
+          avxb valid0 = valid_i;
+
+          for (size_t i=0; i<4; i++)
+          {
+            if (!quad.valid(i)) break;
+            STAT3(shadow.trav_prims,1,popcnt(valid0),8);
+            const avx3f p0 = broadcast8f(quad.v0,i);
+            const avx3f p1 = broadcast8f(quad.v1,i);
+            const avx3f p2 = broadcast8f(quad.v2,i);
+            const avx3f p3 = broadcast8f(quad.v3,i);
+            valid0 &= !occluded(valid0,ray,p0,p1,p3,false,quad,i,scene);
+            if (none(valid0)) break;
+            valid0 &= !occluded(valid0,ray,p2,p3,p1,true ,quad,i,scene);
+            if (none(valid0)) break;
+          }
+          return !valid0;
+        }
+      };
+  }
+}
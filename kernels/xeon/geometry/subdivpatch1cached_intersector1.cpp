@@ -111,6 +111,36 @@ namespace embree
         }
     }
 
+    /* compact leaves store the grid offset relative to the cache data shifted by 4 bits */
+    void updateCompactBVH4Refs(const BVH4::NodeRef &ref, const size_t old_ptr, const size_t new_ptr)
+    {
+      if (unlikely(ref == BVH4::emptyNode))
+        return;
+
+      assert(ref != BVH4::invalidNode);
+
+      /* this is a leaf node */
+      if (unlikely(ref.isLeaf()))
+        return;
+
+      const BVH4::Node* node = ref.node();
+      
+      for (size_t i=0;i<4;i++)
+        {
+          const BVH4::NodeRef &child = node->child(i);
+          if (node->child(i) != BVH4::emptyNode)
+            {
+              if (child.isNode())
+                updateCompactBVH4Refs(child,old_ptr,new_ptr);
+
+              const size_t dest_offset = (size_t)&child - old_ptr;              
+              const size_t new_ref     = child.isLeaf() ? (size_t)child + ((new_ptr - old_ptr) << 4) : (size_t)child - old_ptr + new_ptr;
+              size_t *ptr = (size_t*)((char*)new_ptr + dest_offset);
+              *ptr = new_ref;    
+            }
+        }
+    }
+
     // void copyTessellationCacheTag(TessellationCacheTag *dest, TessellationCacheTag *source)
     // {
     //   assert( dest->getNumBlocks() >= source->getNumBlocks() );
@@ -130,6 +160,59 @@ namespace embree
 
     //////////////////////////////////////////////////////////////////////////////////////////////////////
 
+    /* copy subtree of patch into current cache region */
+    size_t SubdivPatch1CachedIntersector1::copyPatch(const unsigned int threadID, SubdivPatch1Cached* const subdiv_patch, const int64 old_root_ref)
+    {
+      static const size_t REF_TAG      = 1;
+      static const size_t REF_USED     = 4;
+      static const size_t REF_TAG_MASK = (~(REF_TAG|REF_USED)) & 0xffffffff;
+
+      const size_t data = (size_t)SharedLazyTessellationCache::sharedLazyTessellationCache.getDataPtr();
+      const size_t old_root = (old_root_ref & REF_TAG_MASK) + data;
+
+      /* small patches consist of a single leaf and are cheap to tessellate again */
+      if (BVH4::NodeRef(old_root).isLeaf())
+        return old_root;
+
+      subdiv_patch->write_lock();
+      const int64 subdiv_patch_root_ref = subdiv_patch->root_ref;
+
+      /* some other thread already copied the subtree */
+      if (subdiv_patch_root_ref != old_root_ref) {
+        subdiv_patch->write_unlock();
+        return (subdiv_patch_root_ref & REF_TAG_MASK) + data;
+      }
+
+      /* keep old subtree if current region is full, it is still valid */
+      const size_t block_index = SharedLazyTessellationCache::sharedLazyTessellationCache.alloc(subdiv_patch->grid_subtree_size_64b_blocks);
+      if (block_index == (size_t)-1) {
+        subdiv_patch->write_unlock();
+        return old_root;
+      }
+
+      /* subtree always starts with the root node at the beginning of its first block */
+      const size_t old_ptr = old_root;
+      const size_t new_ptr = (size_t)SharedLazyTessellationCache::sharedLazyTessellationCache.getBlockPtr(block_index);
+      memcpy((void*)new_ptr,(void*)old_ptr,64*subdiv_patch->grid_subtree_size_64b_blocks);
+#if COMPACT == 1
+      updateCompactBVH4Refs(BVH4::NodeRef(old_root),old_ptr,new_ptr);
+#else
+      updateBVH4Refs(BVH4::NodeRef(old_root),old_ptr,new_ptr);
+#endif
+      const size_t new_root = new_ptr;
+
+      int64 new_root_ref = new_root - data;
+      assert( new_root_ref <= 0xffffffff );
+      new_root_ref |= REF_TAG;
+      new_root_ref |= (int64)SharedLazyTessellationCache::sharedLazyTessellationCache.getCurrentIndex() << 32; 
+      subdiv_patch->root_ref = new_root_ref;
+      subdiv_patch->write_unlock();
+
+      CACHE_STATS(SharedTessellationCacheStats::cache_copies++);
+      SharedLazyTessellationCache::sharedLazyTessellationCache.countCopy(threadID);
+      return new_root;
+    }
+
     /* build lazy subtree over patch */
     size_t SubdivPatch1CachedIntersector1::lazyBuildPatch(Precalculations &pre,
 							  SubdivPatch1Cached* const subdiv_patch, 
@@ -141,6 +224,9 @@ namespace embree
 	  SharedLazyTessellationCache::sharedLazyTessellationCache.unlockThread(pre.threadID);
 	}
 
+      /* only the first lookup of the patch counts as cache hit or miss */
+      bool firstLookup = true;
+
       while(1)
 	{
 	  /* per thread lock */
@@ -158,7 +244,8 @@ namespace embree
 	    }
       
 	  static const size_t REF_TAG      = 1;
-	  static const size_t REF_TAG_MASK = (~REF_TAG) & 0xffffffff;
+	  static const size_t REF_USED     = 4;
+	  static const size_t REF_TAG_MASK = (~(REF_TAG|REF_USED)) & 0xffffffff;
 
 	  /* fast path for cache hit */
 	  {
@@ -173,6 +260,14 @@ namespace embree
 		if (likely( SharedLazyTessellationCache::sharedLazyTessellationCache.validCacheIndex(subdiv_patch_cache_index) ))
 		  {
 		    CACHE_STATS(SharedTessellationCacheStats::cache_hits++);
+		    if (firstLookup) SharedLazyTessellationCache::sharedLazyTessellationCache.countHit(pre.threadID);
+		    /* give entries that got used again late in their lifetime a second chance before they get flushed */
+		    if (unlikely( SharedLazyTessellationCache::sharedLazyTessellationCache.secondChanceCacheIndex(subdiv_patch_cache_index) )) {
+		      if (subdiv_patch_root_ref & REF_USED)
+			return copyPatch(pre.threadID,subdiv_patch,subdiv_patch_root_ref);
+		    }
+		    else if (unlikely( !(subdiv_patch_root_ref & REF_USED) && SharedLazyTessellationCache::sharedLazyTessellationCache.referenceCacheIndex(subdiv_patch_cache_index) ))
+		      atomic_cmpxchg(&subdiv_patch->root_ref,subdiv_patch_root_ref,subdiv_patch_root_ref | REF_USED);
 		    return subdiv_patch_root;
 		  }
 	      }
@@ -180,6 +275,8 @@ namespace embree
 
 	  /* cache miss */
 	  CACHE_STATS(SharedTessellationCacheStats::cache_misses++);
+	  if (firstLookup) SharedLazyTessellationCache::sharedLazyTessellationCache.countMiss(pre.threadID);
+	  firstLookup = false;
 
 	  subdiv_patch->write_lock();
 	  {
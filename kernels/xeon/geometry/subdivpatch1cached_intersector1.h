@@ -129,7 +129,13 @@ namespace embree
 	return Vec2<ssef>(u,v);
       }
 
-      static __forceinline void intersect1_precise_2x3(Ray& ray,
+      /*! the even triangles of the grids are oriented opposite to the patch, flips their denominator to the patch orientation */
+      static __forceinline ssef patchOrientedDen(const ssef& den) {
+        return den * ssef(-1.0f,1.0f,-1.0f,1.0f);
+      }
+
+      template<bool culling>
+        static __forceinline void intersect1_precise_2x3(Ray& ray,
 						       const float *const grid_x,
 						       const float *const grid_y,
 						       const float *const grid_z,
@@ -186,13 +192,8 @@ namespace embree
 	if (unlikely(none(valid))) return;
         
 	/* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-	valid &= den > ssef(zero);
-	if (unlikely(none(valid))) return;
-#else
-	valid &= den != ssef(zero);
+	valid &= backfaceCulling<culling>() ? patchOrientedDen(den) > ssef(zero) : den != ssef(zero);
 	if (unlikely(none(valid))) return;
-#endif
         
 	/* calculate hit information */
 	const ssef rcpAbsDen = rcp(absDen);
@@ -234,7 +235,8 @@ namespace embree
 	  }
       };
 
-      static __forceinline bool occluded1_precise_2x3(Ray& ray,
+      template<bool culling>
+        static __forceinline bool occluded1_precise_2x3(Ray& ray,
 						      const float *const grid_x,
 						      const float *const grid_y,
 						      const float *const grid_z,
@@ -289,13 +291,8 @@ namespace embree
         if (unlikely(none(valid))) return false;
         
         /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-        valid &= den > ssef(zero);
-        if (unlikely(none(valid))) return false;
-#else
-        valid &= den != ssef(zero);
+        valid &= backfaceCulling<culling>() ? patchOrientedDen(den) > ssef(zero) : den != ssef(zero);
         if (unlikely(none(valid))) return false;
-#endif
         return true;
       };
 
@@ -334,8 +331,13 @@ namespace embree
 	const avxf v    = (avxf)i_v * avxf(2.0f/65535.0f);
 	return Vec2<avxf>(u,v);
       }
+
+      static __forceinline avxf patchOrientedDen(const avxf& den) {
+        return den * avxf(-1.0f,1.0f,-1.0f,1.0f,-1.0f,1.0f,-1.0f,1.0f);
+      }
       
-      static __forceinline void intersect1_precise_3x3(Ray& ray,
+      template<bool culling>
+        static __forceinline void intersect1_precise_3x3(Ray& ray,
 						       const float *const grid_x,
 						       const float *const grid_y,
 						       const float *const grid_z,
@@ -393,13 +395,8 @@ namespace embree
 	if (unlikely(none(valid))) return;
         
 	/* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-	valid &= den > avxf(zero);
-	if (unlikely(none(valid))) return;
-#else
-	valid &= den != avxf(zero);
+	valid &= backfaceCulling<culling>() ? patchOrientedDen(den) > avxf(zero) : den != avxf(zero);
 	if (unlikely(none(valid))) return;
-#endif
         
 	/* calculate hit information */
 	const avxf rcpAbsDen = rcp(absDen);
@@ -443,6 +440,7 @@ namespace embree
 	  }
       };
 
+      template<bool culling>
         static __forceinline bool occluded1_precise_3x3(Ray& ray,
 							const float *const grid_x,
 							const float *const grid_y,
@@ -499,20 +497,15 @@ namespace embree
         if (unlikely(none(valid))) return false;
         
         /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-        valid &= den > avxf(zero);
-        if (unlikely(none(valid))) return false;
-#else
-        valid &= den != avxf(zero);
+        valid &= backfaceCulling<culling>() ? patchOrientedDen(den) > avxf(zero) : den != avxf(zero);
         if (unlikely(none(valid))) return false;
-#endif
         return true;
       };
 
 #endif      
       
       /* intersect ray with Quad2x2 structure => 1 ray vs. 8 triangles */
-      template<class M, class T>
+      template<class M, class T, bool culling>
         static __forceinline void intersect1_precise(Ray& ray,
                                                      const Quad2x2 &qquad,
                                                      const void* geom,
@@ -560,13 +553,8 @@ namespace embree
         if (unlikely(none(valid))) return;
         
         /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-        valid &= den > T(zero);
-        if (unlikely(none(valid))) return;
-#else
-        valid &= den != T(zero);
+        valid &= backfaceCulling<culling>() ? patchOrientedDen(den) > T(zero) : den != T(zero);
         if (unlikely(none(valid))) return;
-#endif
         
         /* calculate hit information */
         const T rcpAbsDen = rcp(absDen);
@@ -614,7 +602,7 @@ namespace embree
       
       
       /*! intersect ray with Quad2x2 structure => 1 ray vs. 8 triangles */
-      template<class M, class T>
+      template<class M, class T, bool culling>
         static __forceinline bool occluded1_precise(Ray& ray,
                                                     const Quad2x2 &qquad,
                                                     const void* geom,
@@ -660,17 +648,15 @@ namespace embree
         if (unlikely(none(valid))) return false;
         
         /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-        valid &= den > T(zero);
+        valid &= backfaceCulling<culling>() ? patchOrientedDen(den) > T(zero) : den != T(zero);
         if (unlikely(none(valid))) return false;
-#else
-        valid &= den != T(zero);
-        if (unlikely(none(valid))) return false;
-#endif
         return true;
       };
 
       static size_t lazyBuildPatch(Precalculations &pre, SubdivPatch1Cached* const subdiv_patch, const void* geom);                  
+
+      /*! Copies the cached subtree of a patch into the current cache region. */
+      static size_t copyPatch(const unsigned int threadID, SubdivPatch1Cached* const subdiv_patch, const int64 old_root_ref);
       
       /*! Evaluates grid over patch and builds BVH4 tree over the grid. */
       static BVH4::NodeRef buildSubdivPatchTree(const SubdivPatch1Cached &patch,
@@ -711,7 +697,8 @@ namespace embree
       
       
       /*! Intersect a ray with the primitive. */
-      static __forceinline void intersect(Precalculations& pre, Ray& ray, const Primitive* prim, size_t ty, const void* geom, size_t& lazy_node) 
+      template<bool culling = false>
+        static __forceinline void intersect(Precalculations& pre, Ray& ray, const Primitive* prim, size_t ty, const void* geom, size_t& lazy_node) 
       {
         STAT3(normal.trav_prims,1,1,1);
         
@@ -727,10 +714,10 @@ namespace embree
           const float *const grid_z  = grid_x + 2 * dim_offset;
           const float *const grid_uv = grid_x + 3 * dim_offset;
 #if defined(__AVX__)
-	  intersect1_precise_3x3( ray, grid_x,grid_y,grid_z,grid_uv, line_offset, (SubdivMesh*)geom,pre);
+	  intersect1_precise_3x3<culling>( ray, grid_x,grid_y,grid_z,grid_uv, line_offset, (SubdivMesh*)geom,pre);
 #else
-	  intersect1_precise_2x3( ray, grid_x            ,grid_y            ,grid_z            ,grid_uv            , line_offset, (SubdivMesh*)geom,pre);
-	  intersect1_precise_2x3( ray, grid_x+line_offset,grid_y+line_offset,grid_z+line_offset,grid_uv+line_offset, line_offset, (SubdivMesh*)geom,pre);
+	  intersect1_precise_2x3<culling>( ray, grid_x            ,grid_y            ,grid_z            ,grid_uv            , line_offset, (SubdivMesh*)geom,pre);
+	  intersect1_precise_2x3<culling>( ray, grid_x+line_offset,grid_y+line_offset,grid_z+line_offset,grid_uv+line_offset, line_offset, (SubdivMesh*)geom,pre);
 #endif
 
 #else
@@ -738,10 +725,10 @@ namespace embree
 	  const Quad2x2 &q = *(Quad2x2*)prim;
 
 #if defined(__AVX__)
-          intersect1_precise<avxb,avxf>( ray, q, (SubdivMesh*)geom,pre);
+          intersect1_precise<avxb,avxf,culling>( ray, q, (SubdivMesh*)geom,pre);
 #else
-          intersect1_precise<sseb,ssef>( ray, q, (SubdivMesh*)geom,pre,0);
-          intersect1_precise<sseb,ssef>( ray, q, (SubdivMesh*)geom,pre,6);
+          intersect1_precise<sseb,ssef,culling>( ray, q, (SubdivMesh*)geom,pre,0);
+          intersect1_precise<sseb,ssef,culling>( ray, q, (SubdivMesh*)geom,pre,6);
 #endif
 
 #endif
@@ -757,7 +744,8 @@ namespace embree
       }
       
       /*! Test if the ray is occluded by the primitive */
-      static __forceinline bool occluded(Precalculations& pre, Ray& ray, const Primitive* prim, size_t ty, const void* geom, size_t& lazy_node) 
+      template<bool culling = false>
+        static __forceinline bool occluded(Precalculations& pre, Ray& ray, const Primitive* prim, size_t ty, const void* geom, size_t& lazy_node) 
       {
         STAT3(shadow.trav_prims,1,1,1);
         
@@ -775,10 +763,10 @@ namespace embree
           const float *const grid_uv = grid_x + 3 * dim_offset;
 
 #if defined(__AVX__)
-	  return occluded1_precise_3x3( ray, grid_x,grid_y,grid_z,grid_uv, line_offset, (SubdivMesh*)geom);
+	  return occluded1_precise_3x3<culling>( ray, grid_x,grid_y,grid_z,grid_uv, line_offset, (SubdivMesh*)geom);
 #else
-	  if (occluded1_precise_2x3( ray, grid_x            ,grid_y            ,grid_z            ,grid_uv            , line_offset, (SubdivMesh*)geom)) return true;
-	  if (occluded1_precise_2x3( ray, grid_x+line_offset,grid_y+line_offset,grid_z+line_offset,grid_uv+line_offset, line_offset, (SubdivMesh*)geom)) return true;
+	  if (occluded1_precise_2x3<culling>( ray, grid_x            ,grid_y            ,grid_z            ,grid_uv            , line_offset, (SubdivMesh*)geom)) return true;
+	  if (occluded1_precise_2x3<culling>( ray, grid_x+line_offset,grid_y+line_offset,grid_z+line_offset,grid_uv+line_offset, line_offset, (SubdivMesh*)geom)) return true;
 #endif
 
           
@@ -786,11 +774,11 @@ namespace embree
 
 #if defined(__AVX__)
 	  const Quad2x2 &q = *(Quad2x2*)prim;
-	  return occluded1_precise<avxb,avxf>( ray, q, (SubdivMesh*)geom);
+	  return occluded1_precise<avxb,avxf,culling>( ray, q, (SubdivMesh*)geom);
 #else
           const Quad2x2 &q = *(Quad2x2*)prim;
-          if (occluded1_precise<sseb,ssef>( ray, q, (SubdivMesh*)geom,0)) return true;
-          if (occluded1_precise<sseb,ssef>( ray, q, (SubdivMesh*)geom,6)) return true;
+          if (occluded1_precise<sseb,ssef,culling>( ray, q, (SubdivMesh*)geom,0)) return true;
+          if (occluded1_precise<sseb,ssef,culling>( ray, q, (SubdivMesh*)geom,6)) return true;
 #endif
 
 #endif
@@ -805,5 +793,18 @@ namespace embree
       
       
     };
+
+    /*! Intersector for scenes with backface culling, shares the tessellation cache with SubdivPatch1CachedIntersector1. */
+    class SubdivPatch1CachedIntersector1Culling : public SubdivPatch1CachedIntersector1
+    {
+    public:
+      static __forceinline void intersect(Precalculations& pre, Ray& ray, const Primitive* prim, size_t ty, const void* geom, size_t& lazy_node) {
+        SubdivPatch1CachedIntersector1::intersect<true>(pre,ray,prim,ty,geom,lazy_node);
+      }
+
+      static __forceinline bool occluded(Precalculations& pre, Ray& ray, const Primitive* prim, size_t ty, const void* geom, size_t& lazy_node) {
+        return SubdivPatch1CachedIntersector1::occluded<true>(pre,ray,prim,ty,geom,lazy_node);
+      }
+    };
   }
 }
@@ -33,7 +33,7 @@ namespace embree
      *  e2. The resulting algorithm is similar to the fastest one of the
      *  paper "Optimizing Ray-Triangle Intersection via Automated
      *  Search". */
-    template<bool list>
+    template<bool list, bool culling = false>
       struct Triangle1vIntersector1MoellerTrumboreMB
       {
         typedef Triangle1vMB Primitive;
@@ -77,11 +77,7 @@ namespace embree
           if (unlikely(T < absDen*ray.tnear)) return;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          if (unlikely(den <= 0.0f)) return;
-#else
-          if (unlikely(den == 0.0f)) return;
-#endif
+          if (unlikely(backfaceCulling<culling>() ? den <= 0.0f : den == 0.0f)) return;
           
           /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -149,11 +145,7 @@ namespace embree
           if (unlikely(T < absDen*ray.tnear)) return false;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          if (unlikely(den <= 0.0f)) return false;
-#else
-          if (unlikely(den == 0.0f)) return false;
-#endif
+          if (unlikely(backfaceCulling<culling>() ? den <= 0.0f : den == 0.0f)) return false;
           
           /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -31,7 +31,7 @@ namespace embree
      *  precalculate some factors and factor the calculations
      *  differently to allow precalculating the cross product e1 x
      *  e2. */
-    template<bool list>
+    template<bool list, bool culling = false>
       struct Triangle1vIntersector4MoellerTrumboreMB
       {
         typedef Triangle1vMB Primitive;
@@ -76,13 +76,8 @@ namespace embree
           if (unlikely(none(valid))) return;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          valid &= den > ssef(zero);
+          valid &= backfaceCulling<culling>() ? den > ssef(zero) : den != ssef(zero);
           if (unlikely(none(valid))) return;
-#else
-          valid &= den != ssef(zero);
-          if (unlikely(none(valid))) return;
-#endif
           
           /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -154,13 +149,8 @@ namespace embree
           if (unlikely(none(valid))) return valid;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          valid &= den > ssef(zero);
+          valid &= backfaceCulling<culling>() ? den > ssef(zero) : den != ssef(zero);
           if (unlikely(none(valid))) return valid;
-#else
-          valid &= den != ssef(zero);
-          if (unlikely(none(valid))) return valid;
-#endif
           
           /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -25,7 +25,7 @@ namespace embree
   namespace isa
   {
     /*! Intersector1 for triangle4i */
-    template<bool list>
+    template<bool list, bool culling = false>
       struct Triangle4iIntersector1Pluecker
       {
         typedef Triangle4i Primitive;
@@ -81,13 +81,8 @@ namespace embree
           if (unlikely(none(valid))) return;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          valid &= den > ssef(zero);
+          valid &= backfaceCulling<culling>() ? den > ssef(zero) : den != ssef(zero);
           if (unlikely(none(valid))) return;
-#else
-          valid &= den != ssef(zero);
-          if (unlikely(none(valid))) return;
-#endif
           
           /* calculate hit information */
           const ssef u = U / absDen;
@@ -183,13 +178,8 @@ namespace embree
           if (unlikely(none(valid))) return false;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          valid &= den > ssef(zero);
+          valid &= backfaceCulling<culling>() ? den > ssef(zero) : den != ssef(zero);
           if (unlikely(none(valid))) return false;
-#else
-          valid &= den != ssef(zero);
-          if (unlikely(none(valid))) return false;
-#endif
           
           /* intersection filter test */
 #if defined(RTCORE_INTERSECTION_FILTER) || defined(RTCORE_RAY_MASK)
@@ -24,7 +24,7 @@ namespace embree
   namespace isa
   {
     /*! Intersector8 for triangle4i */
-    template<bool list>
+    template<bool list, bool culling = false>
       struct Triangle4iIntersector8Pluecker
       {
         typedef Triangle4i Primitive;
@@ -82,13 +82,8 @@ namespace embree
             if (unlikely(none(valid))) continue;
             
             /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-            valid &= den > avxf(zero);
+            valid &= backfaceCulling<culling>() ? den > avxf(zero) : den != avxf(zero);
             if (unlikely(none(valid))) continue;
-#else
-            valid &= den != avxf(zero);
-            if (unlikely(none(valid))) continue;
-#endif
             
             /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -175,13 +170,8 @@ namespace embree
             valid &= (T >= absDen*ray.tnear) & (absDen*ray.tfar >= T);
             
             /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-            valid &= den > avxf(zero);
+            valid &= backfaceCulling<culling>() ? den > avxf(zero) : den != avxf(zero);
             if (unlikely(none(valid))) continue;
-#else
-            valid &= den != avxf(zero);
-            if (unlikely(none(valid))) continue;
-#endif
             
             /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -0,0 +1,156 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "primitive.h"
+
+namespace embree
+{
+  /*! Stores 4 motion blur triangles with an arbitrary number of time
+   *  steps from an indexed face set. Only the vertex indices are
+   *  stored, the vertices of the two time steps enclosing the ray
+   *  time are loaded from the mesh and linearly interpolated. */
+  struct Triangle4iMB
+  {
+  public:
+
+    /*! Default constructor. */
+    __forceinline Triangle4iMB () {}
+
+    /*! Construction from vertex indices and IDs. */
+    __forceinline Triangle4iMB (const ssei& v0, const ssei& v1, const ssei& v2, const ssei& geomIDs, const ssei& primIDs, const bool last)
+      : v0(v0), v1(v1), v2(v2), geomIDs(geomIDs | (last << 31)), primIDs(primIDs) {}
+
+    /*! Returns if the specified triangle is valid. */
+    __forceinline bool valid(const size_t i) const {
+      assert(i<4);
+      return primIDs[i] != -1;
+    }
+
+    /*! Returns a mask that tells which triangles are valid. */
+    __forceinline sseb valid() const { return primIDs != ssei(-1); }
+
+    /*! Returns the number of stored triangles. */
+    __forceinline size_t size() const {
+      return __bsf(~movemask(valid()));
+    }
+
+    /*! returns required number of primitive blocks for N primitives */
+    static __forceinline size_t blocks(size_t N) { return (N+3)/4; }
+
+    /*! checks if this is the last triangle in the list */
+    __forceinline int last() const {
+      return geomIDs[0] & 0x80000000;
+    }
+
+    /*! returns the geometry IDs */
+    template<bool list>
+    __forceinline ssei geomID() const {
+      if (list) return geomIDs & 0x7FFFFFFF;
+      else      return geomIDs;
+    }
+    template<bool list>
+    __forceinline int geomID(const size_t i) const {
+      assert(i<4);
+      if (list) return geomIDs[i] & 0x7FFFFFFF;
+      else      return geomIDs[i];
+    }
+
+    /*! returns the primitive IDs */
+    template<bool list>
+    __forceinline ssei primID() const {
+      return primIDs;
+    }
+    template<bool list>
+    __forceinline int primID(const size_t i) const {
+      assert(i<4); return primIDs[i];
+    }
+
+    /*! loads the vertices of all triangles at the specified time,
+     *  invalid triangles get degenerated to a point */
+    template<bool list>
+    __forceinline void gather(sse3f& p0, sse3f& p1, sse3f& p2, const float time, Scene* scene) const
+    {
+      /* all motion blur triangle meshes of the scene have the same number of time steps */
+      float ftime; 
+      const size_t itime = getTimeSegment(time,float(scene->getTriangleMesh(geomID<list>(0))->numTimeSteps-1),ftime);
+      const ssef t0 = ssef(1.0f-ftime), t1 = ssef(ftime);
+      ssef a[4], b[4], c[4];
+      for (size_t i=0; i<4; i++)
+      {
+        if (!valid(i)) { a[i] = b[i] = c[i] = a[0]; continue; }
+        const TriangleMesh* mesh = scene->getTriangleMesh(geomID<list>(i));
+        a[i] = t0*loadu4f(mesh->vertexPtr(v0[i],itime)) + t1*loadu4f(mesh->vertexPtr(v0[i],itime+1));
+        b[i] = t0*loadu4f(mesh->vertexPtr(v1[i],itime)) + t1*loadu4f(mesh->vertexPtr(v1[i],itime+1));
+        c[i] = t0*loadu4f(mesh->vertexPtr(v2[i],itime)) + t1*loadu4f(mesh->vertexPtr(v2[i],itime+1));
+      }
+      transpose(a[0],a[1],a[2],a[3],p0.x,p0.y,p0.z);
+      transpose(b[0],b[1],b[2],b[3],p1.x,p1.y,p1.z);
+      transpose(c[0],c[1],c[2],c[3],p2.x,p2.y,p2.z);
+    }
+
+    /*! returns the geometry masks of the triangles */
+    template<bool list>
+    __forceinline ssei mask(Scene* scene) const
+    {
+      ssei vmask = 0;
+      for (size_t i=0; i<4 && valid(i); i++)
+        vmask[i] = scene->getTriangleMesh(geomID<list>(i))->mask;
+      return vmask;
+    }
+
+    /*! fill triangle from triangle list and extend bounds[t] by the bounds of the triangles at time step t */
+    __forceinline void fill(const PrimRef* prims, size_t& begin, size_t end, Scene* scene, const bool list, BBox3fa* bounds, size_t numTimeSteps)
+    {
+      ssei geomID = -1, primID = -1;
+      ssei v0 = zero, v1 = zero, v2 = zero;
+
+      for (size_t i=0; i<4 && begin<end; i++, begin++)
+      {
+        const PrimRef& prim = prims[begin];
+	const TriangleMesh* mesh = scene->getTriangleMesh(prim.geomID());
+	const TriangleMesh::Triangle& tri = mesh->triangle(prim.primID());
+        geomID[i] = prim.geomID();
+        primID[i] = prim.primID();
+        v0[i] = tri.v[0];
+        v1[i] = tri.v[1];
+        v2[i] = tri.v[2];
+        for (size_t t=0; t<numTimeSteps; t++)
+          bounds[t].extend(mesh->bounds(prim.primID(),t));
+      }
+
+      new (this) Triangle4iMB(v0,v1,v2,geomID,primID,list && begin>=end); // FIXME: use non temporal store
+    }
+
+  public:
+    ssei v0;             //!< Index of 1st vertex.
+    ssei v1;             //!< Index of 2nd vertex.
+    ssei v2;             //!< Index of 3rd vertex.
+    ssei geomIDs;        //!< ID of mesh.
+    ssei primIDs;        //!< ID of primitive inside mesh.
+  };
+
+  /*! virtual interface to query information about the triangle type */
+  struct Triangle4iMBType : public PrimitiveType
+  {
+    static Triangle4iMBType type;
+
+    Triangle4iMBType ();
+    size_t blocks(size_t x) const;
+    size_t size(const char* This) const;
+  };
+}
@@ -0,0 +1,188 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "triangle4i_mb.h"
+#include "common/ray.h"
+#include "geometry/filter.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Intersector for a single ray with 4 motion blur triangles with
+     *  an arbitrary number of time steps. The vertices are
+     *  interpolated at the ray time and intersected using the
+     *  Moeller Trumbore algorithm. */
+    template<bool list, bool culling = false>
+      struct Triangle4iMBIntersector1MoellerTrumbore
+      {
+        typedef Triangle4iMB Primitive;
+        
+        struct Precalculations {
+          __forceinline Precalculations (const Ray& ray, const void *ptr) {}
+        };
+        
+        /*! Intersect a ray with the 4 triangles and updates the hit. */
+        static __forceinline void intersect(const Precalculations& pre, Ray& ray, const Primitive& tri, Scene* scene)
+        {
+          /* calculate denominator */
+          STAT3(normal.trav_prims,1,1,1);
+          sse3f v0,v1,v2; tri.gather<list>(v0,v1,v2,ray.time,scene);
+          const sse3f O = sse3f(ray.org);
+          const sse3f D = sse3f(ray.dir);
+          const sse3f C = v0 - O;
+          const sse3f e1 = v0-v1;
+          const sse3f e2 = v2-v0;
+          const sse3f Ng = cross(e1,e2);
+          const sse3f R = cross(D,C);
+          const ssef den = dot(sse3f(Ng),D);
+          const ssef absDen = abs(den);
+          const ssef sgnDen = signmsk(den);
+          
+          /* perform edge tests */
+          const ssef U = dot(R,sse3f(e2)) ^ sgnDen;
+          const ssef V = dot(R,sse3f(e1)) ^ sgnDen;
+          
+          /* perform backface culling */
+          sseb valid = (backfaceCulling<culling>() ? den > ssef(zero) : den != ssef(zero)) & (U >= 0.0f) & (V >= 0.0f) & (U+V<=absDen);
+          if (likely(none(valid))) return;
+          
+          /* perform depth test */
+          const ssef T = dot(sse3f(Ng),C) ^ sgnDen;
+          valid &= (T > absDen*ssef(ray.tnear)) & (T < absDen*ssef(ray.tfar));
+          if (likely(none(valid))) return;
+          
+          /* ray masking test */
+#if defined(RTCORE_RAY_MASK)
+          valid &= (tri.mask<list>(scene) & ray.mask) != 0;
+          if (unlikely(none(valid))) return;
+#endif
+          
+          /* calculate hit information */
+          const ssef rcpAbsDen = rcp(absDen);
+          const ssef u = U * rcpAbsDen;
+          const ssef v = V * rcpAbsDen;
+          const ssef t = T * rcpAbsDen;
+          size_t i = select_min(valid,t);
+          int geomID = tri.geomID<list>(i);
+          
+          /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER)
+          while (true) 
+          {
+            Geometry* geometry = scene->get(geomID);
+            if (likely(!geometry->hasIntersectionFilter1())) 
+            {
+#endif
+              /* update hit information */
+              ray.u = u[i];
+              ray.v = v[i];
+              ray.tfar = t[i];
+              ray.Ng.x = Ng.x[i];
+              ray.Ng.y = Ng.y[i];
+              ray.Ng.z = Ng.z[i];
+              ray.geomID = geomID;
+              ray.primID = tri.primID<list>(i);
+              
+#if defined(RTCORE_INTERSECTION_FILTER)
+              return;
+            }
+            
+            Vec3fa _Ng = Vec3fa(Ng.x[i],Ng.y[i],Ng.z[i]);
+            if (runIntersectionFilter1(geometry,ray,u[i],v[i],t[i],_Ng,geomID,tri.primID<list>(i))) return;
+            valid[i] = 0;
+            if (none(valid)) return;
+            i = select_min(valid,t);
+            geomID = tri.geomID<list>(i);
+          }
+#endif
+        }
+        
+        /*! Test if the ray is occluded by one of the triangles. */
+        static __forceinline bool occluded(const Precalculations& pre, Ray& ray, const Primitive& tri, Scene* scene)
+        {
+          /* calculate denominator */
+          STAT3(shadow.trav_prims,1,1,1);
+          sse3f v0,v1,v2; tri.gather<list>(v0,v1,v2,ray.time,scene);
+          const sse3f O = sse3f(ray.org);
+          const sse3f D = sse3f(ray.dir);
+          const sse3f C = v0 - O;
+          const sse3f e1 = v0-v1;
+          const sse3f e2 = v2-v0;
+          const sse3f Ng = cross(e1,e2);
+          const sse3f R = cross(D,C);
+          const ssef den = dot(sse3f(Ng),D);
+          const ssef absDen = abs(den);
+          const ssef sgnDen = signmsk(den);
+          
+          /* perform edge tests */
+          const ssef U = dot(R,sse3f(e2)) ^ sgnDen;
+          const ssef V = dot(R,sse3f(e1)) ^ sgnDen;
+          const ssef W = absDen-U-V;
+          sseb valid = (U >= 0.0f) & (V >= 0.0f) & (W >= 0.0f);
+          if (unlikely(none(valid))) return false;
+          
+          /* perform depth test */
+          const ssef T = dot(sse3f(Ng),C) ^ sgnDen;
+          valid &= (den != ssef(zero)) & (T >= absDen*ssef(ray.tnear)) & (absDen*ssef(ray.tfar) >= T);
+          if (unlikely(none(valid))) return false;
+          
+          /* perform backface culling */
+          if (backfaceCulling<culling>()) {
+            valid &= den > ssef(zero);
+            if (unlikely(none(valid))) return false;
+          }
+          
+          /* ray masking test */
+#if defined(RTCORE_RAY_MASK)
+          valid &= (tri.mask<list>(scene) & ray.mask) != 0;
+          if (unlikely(none(valid))) return false;
+#endif
+          
+          /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER)
+          size_t m=movemask(valid), i=__bsf(m);
+          while (true)
+          {  
+            const int geomID = tri.geomID<list>(i);
+            Geometry* geometry = scene->get(geomID);
+            
+            /* if we have no filter then the test passes */
+            if (likely(!geometry->hasOcclusionFilter1()))
+              break;
+            
+            /* calculate hit information */
+            const ssef rcpAbsDen = rcp(absDen);
+            const ssef u = U * rcpAbsDen;
+            const ssef v = V * rcpAbsDen;
+            const ssef t = T * rcpAbsDen;
+            const Vec3fa _Ng = Vec3fa(Ng.x[i],Ng.y[i],Ng.z[i]);
+            if (runOcclusionFilter1(geometry,ray,u[i],v[i],t[i],_Ng,geomID,tri.primID<list>(i))) 
+              break;
+            
+            /* test if one more triangle hit */
+            m=__btc(m,i); i=__bsf(m);
+            if (m == 0) return false;
+          }
+#endif
+          
+          return true;
+        }
+      };
+  }
+}
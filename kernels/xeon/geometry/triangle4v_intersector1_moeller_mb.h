@@ -32,7 +32,7 @@ namespace embree
      *  precalculating the cross product e1 x e2. The resulting
      *  algorithm is similar to the fastest one of the paper "Optimizing
      *  Ray-Triangle Intersection via Automated Search". */
-    template<bool list>
+    template<bool list, bool culling = false>
       struct Triangle4vMBIntersector1MoellerTrumbore
       {
         typedef Triangle4vMB Primitive;
@@ -66,11 +66,7 @@ namespace embree
           const ssef V = dot(R,sse3f(e1)) ^ sgnDen;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          sseb valid = (den > ssef(zero)) & (U >= 0.0f) & (V >= 0.0f) & (U+V<=absDen);
-#else
-          sseb valid = (den != ssef(zero)) & (U >= 0.0f) & (V >= 0.0f) & (U+V<=absDen);
-#endif
+          sseb valid = (backfaceCulling<culling>() ? den > ssef(zero) : den != ssef(zero)) & (U >= 0.0f) & (V >= 0.0f) & (U+V<=absDen);
           if (likely(none(valid))) return;
           
           /* perform depth test */
@@ -157,10 +153,10 @@ namespace embree
           if (unlikely(none(valid))) return false;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          valid &= den > ssef(zero);
-          if (unlikely(none(valid))) return false;
-#endif
+          if (backfaceCulling<culling>()) {
+            valid &= den > ssef(zero);
+            if (unlikely(none(valid))) return false;
+          }
           
           /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -23,7 +23,7 @@ namespace embree
 {
   namespace isa
   {
-    template<bool list>
+    template<bool list, bool culling = false>
       struct Triangle4vIntersector1Pluecker
       {
         typedef Triangle4v Primitive;
@@ -68,13 +68,9 @@ namespace embree
           if (unlikely(none(valid))) return;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          valid &= den > ssef(zero);
+          if (backfaceCulling<culling>()) valid &= den >  ssef(zero);
+          else                            valid &= den != ssef(zero);
           if (unlikely(none(valid))) return;
-#else
-          valid &= den != ssef(zero);
-          if (unlikely(none(valid))) return;
-#endif
           
           /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -157,13 +153,9 @@ namespace embree
           if (unlikely(none(valid))) return false;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          valid &= den > ssef(zero);
+          if (backfaceCulling<culling>()) valid &= den >  ssef(zero);
+          else                            valid &= den != ssef(zero);
           if (unlikely(none(valid))) return false;
-#else
-          valid &= den != ssef(zero);
-          if (unlikely(none(valid))) return false;
-#endif
           
           /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
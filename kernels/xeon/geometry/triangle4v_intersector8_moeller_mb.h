@@ -29,7 +29,7 @@ namespace embree
      *  Intersection". In contrast to the paper we precalculate some
      *  factors and factor the calculations differently to allow
      *  precalculating the cross product e1 x e2. */
-    template<bool list, bool enableIntersectionFilter>
+    template<bool list, bool enableIntersectionFilter, bool culling = false>
       struct Triangle4vMBIntersector8MoellerTrumbore
       {
         typedef Triangle4vMB Primitive;
@@ -85,13 +85,8 @@ namespace embree
             if (unlikely(none(valid))) continue;
             
             /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-            valid &= den > avxf(zero);
+            valid &= backfaceCulling<culling>() ? den > avxf(zero) : den != avxf(zero);
             if (unlikely(none(valid))) continue;
-#else
-            valid &= den != avxf(zero);
-            if (unlikely(none(valid))) continue;
-#endif
             
             /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -179,13 +174,8 @@ namespace embree
             if (unlikely(none(valid))) continue;
             
             /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-            valid &= den > avxf(zero);
+            valid &= backfaceCulling<culling>() ? den > avxf(zero) : den != avxf(zero);
             if (unlikely(none(valid))) continue;
-#else
-            valid &= den != avxf(zero);
-            if (unlikely(none(valid))) continue;
-#endif
             
             /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -244,11 +234,7 @@ namespace embree
           const ssef V = dot(R,sse3f(e1)) ^ sgnDen;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          sseb valid = (den > ssef(zero)) & (U >= 0.0f) & (V >= 0.0f) & (U+V<=absDen);
-#else
-          sseb valid = (den != ssef(zero)) & (U >= 0.0f) & (V >= 0.0f) & (U+V<=absDen);
-#endif
+          sseb valid = (backfaceCulling<culling>() ? den > ssef(zero) : den != ssef(zero)) & (U >= 0.0f) & (V >= 0.0f) & (U+V<=absDen);
           if (likely(none(valid))) return;
           
           /* perform depth test */
@@ -335,13 +321,8 @@ namespace embree
           if (unlikely(none(valid))) return false;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          valid &= den > ssef(zero);
-          if (unlikely(none(valid))) return false;
-#else
-          valid &= den != ssef(zero);
+          valid &= backfaceCulling<culling>() ? den > ssef(zero) : den != ssef(zero);
           if (unlikely(none(valid))) return false;
-#endif
           
           /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
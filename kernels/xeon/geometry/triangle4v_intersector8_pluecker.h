@@ -23,7 +23,7 @@ namespace embree
 {
   namespace isa
   {
-    template<bool list>
+    template<bool list, bool culling = false>
       struct Triangle4vIntersector8Pluecker
       {
         typedef Triangle4v Primitive;
@@ -77,13 +77,9 @@ namespace embree
             if (unlikely(none(valid))) continue;
             
             /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-            valid &= den > avxf(zero);
+            if (backfaceCulling<culling>()) valid &= den >  avxf(zero);
+            else                            valid &= den != avxf(zero);
             if (unlikely(none(valid))) continue;
-#else
-            valid &= den != avxf(zero);
-            if (unlikely(none(valid))) continue;
-#endif
             
             /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -166,13 +162,9 @@ namespace embree
             valid &= (T >= absDen*ray.tnear) & (absDen*ray.tfar >= T);
             
             /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-            valid &= den > avxf(zero);
+            if (backfaceCulling<culling>()) valid &= den >  avxf(zero);
+            else                            valid &= den != avxf(zero);
             if (unlikely(none(valid))) continue;
-#else
-            valid &= den != avxf(zero);
-            if (unlikely(none(valid))) continue;
-#endif
             
             /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -239,13 +231,9 @@ namespace embree
           if (unlikely(none(valid))) return;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          valid &= den > ssef(zero);
+          if (backfaceCulling<culling>()) valid &= den >  ssef(zero);
+          else                            valid &= den != ssef(zero);
           if (unlikely(none(valid))) return;
-#else
-          valid &= den != ssef(zero);
-          if (unlikely(none(valid))) return;
-#endif
           
           /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -328,13 +316,9 @@ namespace embree
           if (unlikely(none(valid))) return false;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          valid &= den > ssef(zero);
+          if (backfaceCulling<culling>()) valid &= den >  ssef(zero);
+          else                            valid &= den != ssef(zero);
           if (unlikely(none(valid))) return false;
-#else
-          valid &= den != ssef(zero);
-          if (unlikely(none(valid))) return false;
-#endif
           
           /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -32,7 +32,7 @@ namespace embree
      *  precalculating the cross product e1 x e2. The resulting
      *  algorithm is similar to the fastest one of the paper "Optimizing
      *  Ray-Triangle Intersection via Automated Search". */
-    template<bool list>
+    template<bool list, bool culling = false>
       struct Triangle8Intersector1MoellerTrumbore
       {
         typedef Triangle8 Primitive;
@@ -59,11 +59,7 @@ namespace embree
           const avxf V = dot(R,avx3f(tri.e1)) ^ sgnDen;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          avxb valid = (den > avxf(zero)) & (U >= 0.0f) & (V >= 0.0f) & (U+V<=absDen);
-#else
-          avxb valid = (den != avxf(zero)) & (U >= 0.0f) & (V >= 0.0f) & (U+V<=absDen);
-#endif
+          avxb valid = (backfaceCulling<culling>() ? den > avxf(zero) : den != avxf(zero)) & (U >= 0.0f) & (V >= 0.0f) & (U+V<=absDen);
           if (likely(none(valid))) return;
           
           /* perform depth test */
@@ -143,13 +139,9 @@ namespace embree
           if (unlikely(none(valid))) return false;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          valid &= den > avxf(zero);
-          if (unlikely(none(valid))) return false;
-#else
-          valid &= den != avxf(zero);
+          if (backfaceCulling<culling>()) valid &= den >  avxf(zero);
+          else                            valid &= den != avxf(zero);
           if (unlikely(none(valid))) return false;
-#endif
           
           /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
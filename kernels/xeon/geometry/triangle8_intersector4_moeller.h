@@ -31,7 +31,7 @@ namespace embree
      *  Intersection". In contrast to the paper we precalculate some
      *  factors and factor the calculations differently to allow
      *  precalculating the cross product e1 x e2. */
-    template<bool list, bool enableIntersectionFilter>
+    template<bool list, bool enableIntersectionFilter, bool culling = false>
       struct Triangle8Intersector4MoellerTrumbore
       {
         typedef Triangle8 Primitive;
@@ -83,13 +83,9 @@ namespace embree
             if (unlikely(none(valid))) continue;
             
             /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-            valid &= den > ssef(zero);
+            if (backfaceCulling<culling>()) valid &= den >  ssef(zero);
+            else                            valid &= den != ssef(zero);
             if (unlikely(none(valid))) continue;
-#else
-            valid &= den != ssef(zero);
-            if (unlikely(none(valid))) continue;
-#endif
             
             /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -173,13 +169,9 @@ namespace embree
             if (unlikely(none(valid))) continue;
             
             /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-            valid &= den > ssef(zero);
+            if (backfaceCulling<culling>()) valid &= den >  ssef(zero);
+            else                            valid &= den != ssef(zero);
             if (unlikely(none(valid))) continue;
-#else
-            valid &= den != ssef(zero);
-            if (unlikely(none(valid))) continue;
-#endif
             
             /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -230,11 +222,7 @@ namespace embree
           const avxf V = dot(R,avx3f(tri.e1)) ^ sgnDen;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          avxb valid = (den > avxf(zero)) & (U >= 0.0f) & (V >= 0.0f) & (U+V<=absDen);
-#else
-          avxb valid = (den != avxf(zero)) & (U >= 0.0f) & (V >= 0.0f) & (U+V<=absDen);
-#endif
+          avxb valid = (backfaceCulling<culling>() ? den > avxf(zero) : den != avxf(zero)) & (U >= 0.0f) & (V >= 0.0f) & (U+V<=absDen);
           if (likely(none(valid))) return;
           
           /* perform depth test */
@@ -314,13 +302,9 @@ namespace embree
           if (unlikely(none(valid))) return false;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          valid &= den > avxf(zero);
-          if (unlikely(none(valid))) return false;
-#else
-          valid &= den != avxf(zero);
+          if (backfaceCulling<culling>()) valid &= den >  avxf(zero);
+          else                            valid &= den != avxf(zero);
           if (unlikely(none(valid))) return false;
-#endif
           
           /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -30,7 +30,7 @@ namespace embree
      *  Intersection". In contrast to the paper we precalculate some
      *  factors and factor the calculations differently to allow
      *  precalculating the cross product e1 x e2. */
-    template<bool list, bool enableIntersectionFilter>
+    template<bool list, bool enableIntersectionFilter, bool culling = false>
       struct Triangle8Intersector8MoellerTrumbore
       {
         typedef Triangle8 Primitive;
@@ -80,13 +80,9 @@ namespace embree
             if (unlikely(none(valid))) continue;
             
             /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-            valid &= den > avxf(zero);
+            if (backfaceCulling<culling>()) valid &= den >  avxf(zero);
+            else                            valid &= den != avxf(zero);
             if (unlikely(none(valid))) continue;
-#else
-            valid &= den != avxf(zero);
-            if (unlikely(none(valid))) continue;
-#endif
             
             /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -168,13 +164,9 @@ namespace embree
             if (unlikely(none(valid))) continue;
             
             /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-            valid &= den > avxf(zero);
+            if (backfaceCulling<culling>()) valid &= den >  avxf(zero);
+            else                            valid &= den != avxf(zero);
             if (unlikely(none(valid))) continue;
-#else
-            valid &= den != avxf(zero);
-            if (unlikely(none(valid))) continue;
-#endif
             
             /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -233,13 +225,9 @@ namespace embree
           if (likely(none(valid))) return;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          valid &= den > avxf(zero);
+          if (backfaceCulling<culling>()) valid &= den >  avxf(zero);
+          else                            valid &= den != avxf(zero);
           if (unlikely(none(valid))) return;
-#else
-          valid &= den != avxf(zero);
-          if (unlikely(none(valid))) return;
-#endif
           
           /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -313,13 +301,9 @@ namespace embree
           if (unlikely(none(valid))) return false;
           
           /* perform backface culling */
-#if defined(RTCORE_BACKFACE_CULLING)
-          valid &= den > avxf(zero);
+          if (backfaceCulling<culling>()) valid &= den >  avxf(zero);
+          else                            valid &= den != avxf(zero);
           if (unlikely(none(valid))) return false;
-#else
-          valid &= den != avxf(zero);
-          if (unlikely(none(valid))) return false;
-#endif
           
           /* ray masking test */
 #if defined(RTCORE_RAY_MASK)
@@ -30,4 +30,17 @@ namespace embree
   size_t VirtualAccelObjectType::size(const char* This) const {
     return 1;
   }
+
+  InstanceArrayItemType InstanceArrayItemType::type;
+
+  InstanceArrayItemType::InstanceArrayItemType () 
+    : PrimitiveType("instance_array",sizeof(InstanceArrayItem),1,false,1) {} 
+
+  size_t InstanceArrayItemType::blocks(size_t x) const {
+    return x;
+  }
+    
+  size_t InstanceArrayItemType::size(const char* This) const {
+    return 1;
+  }
 }
@@ -45,6 +45,111 @@ namespace embree
     bool isLast;
   };
 
+  /*! Leaf primitive of the hierarchy over the instances of instance
+   *  arrays. Stores the inverse transformation of the instance, thus
+   *  traversal does not have to invert it for every visit. */
+  struct InstanceArrayItem
+  {
+  public:
+
+    InstanceArrayItem (const InstanceArray* instances, unsigned item, const AffineSpace3fa& world2local, const bool last) 
+    : world2local(world2local), instances(instances), item(item), isLast(last) {}
+
+    /*! returns required number of primitive blocks for N primitives */
+    static __forceinline size_t blocks(size_t N) { return N; }
+
+    __forceinline bool last() const { return isLast; }
+
+    /*! fill instance from instance list */
+    __forceinline void fill(const PrimRef* prims, size_t& i, size_t end, Scene* scene, const bool list)
+    {
+      const PrimRef& prim = prims[i]; i++;
+      const InstanceArray* instances = (const InstanceArray*) scene->get(prim.geomID());
+      new (this) InstanceArrayItem(instances, prim.primID(), rcp(instances->getTransform(prim.primID())), list && i>=end);
+    }
+
+  public:
+    AffineSpace3fa world2local;      //!< transformation from world space into the space of the instantiated scene
+    const InstanceArray* instances;
+    unsigned item;
+    bool isLast;
+  };
+
+  /*! Collects the ray/item pairs of user geometries that provide
+   *  stream callbacks during traversal and passes them in batches to
+   *  the application. RayK is the ray or ray packet type with K rays. */
+  template<typename RayK, size_t K>
+    struct AccelSetItemStream
+  {
+    static const size_t maxItems = 64;  //!< number of pairs that get buffered before the callbacks are invoked
+
+    struct Entry 
+    {
+      AccelSet* accel;
+      RTCRayItem item;
+    };
+
+  public:
+
+    __forceinline AccelSetItemStream (RayK& ray) 
+      : ray(ray), num(0), occlusion(false) {}
+
+    /*! invokes the stream callbacks for all remaining pairs */
+    __forceinline ~AccelSetItemStream () {
+      if (num) flush();
+    }
+
+    /*! adds a pair for the active rays of the mask, returns true if the buffer is full */
+    __forceinline bool add(size_t mask, const AccelSetItem& prim, bool occluded)
+    {
+      occlusion = occluded;
+      for (; mask; num++) {
+        const size_t k = __bscf(mask);
+        entries[num].accel = prim.accel;
+        entries[num].item.ray = k;
+        entries[num].item.item = prim.item;
+      }
+      return num+K > maxItems;
+    }
+
+    /*! passes all buffered pairs grouped by user geometry to the stream callbacks */
+    void flush()
+    {
+      AVX_ZERO_UPPER();
+      Ray rays[K]; get(ray,rays);
+      RTCRayItem items[maxItems];
+      for (size_t i=0; i<num; i++)
+      {
+        AccelSet* accel = entries[i].accel;
+        if (accel == NULL) continue;
+        size_t N = 0;
+        for (size_t j=i; j<num; j++) {
+          if (entries[j].accel != accel) continue;
+          if (!occlusion || rays[entries[j].item.ray].geomID != 0)
+            items[N++] = entries[j].item;
+          entries[j].accel = NULL;
+        }
+        if (N == 0) continue;
+        if (occlusion) accel->occludedN((RTCRay*)rays,items,N);
+        else           accel->intersectN((RTCRay*)rays,items,N);
+      }
+      set(ray,rays);
+      num = 0;
+    }
+
+  private:
+    static __forceinline void get(const Ray& ray, Ray* rays) { rays[0] = ray; }
+    static __forceinline void set(Ray& ray, const Ray* rays) { ray = rays[0]; }
+    template<typename Ty> static __forceinline void get(const Ty& ray, Ray* rays) { ray.get(rays); }
+    template<typename Ty> static __forceinline void set(Ty& ray, const Ray* rays) { ray.set(rays); }
+
+  private:
+    RayK& ray;
+    size_t num;
+    bool occlusion;
+    Entry entries[maxItems];
+  };
+
   struct VirtualAccelObjectType : public PrimitiveType 
   {
     static VirtualAccelObjectType type;
@@ -53,4 +158,13 @@ namespace embree
     size_t blocks(size_t x) const;
     size_t size(const char* This) const;
   };
+
+  struct InstanceArrayItemType : public PrimitiveType 
+  {
+    static InstanceArrayItemType type;
+    
+    InstanceArrayItemType ();
+    size_t blocks(size_t x) const;
+    size_t size(const char* This) const;
+  };
 }
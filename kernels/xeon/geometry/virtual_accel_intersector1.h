@@ -28,18 +28,28 @@ namespace embree
       typedef AccelSetItem Primitive;
       
       struct Precalculations {
-        __forceinline Precalculations (const Ray& ray, const void *ptr) {}
+        __forceinline Precalculations (const Ray& ray, const void *ptr) 
+          : stream((Ray&)ray) {}
+        AccelSetItemStream<Ray,1> stream;  //!< buffered items of user geometries with stream callbacks
       };
       
-      static __forceinline void intersect(const Precalculations& pre, Ray& ray, const Primitive& prim, Scene* scene) 
+      static __forceinline void intersect(Precalculations& pre, Ray& ray, const Primitive& prim, Scene* scene) 
       {
         AVX_ZERO_UPPER();
+        if (prim.accel->intersectors.intersectorN.intersect) {
+          if (pre.stream.add(1,prim,false)) pre.stream.flush();
+          return;
+        }
         prim.accel->intersect((RTCRay&)ray,prim.item);
       }
       
-      static __forceinline bool occluded(const Precalculations& pre, Ray& ray, const Primitive& prim, Scene* scene) 
+      static __forceinline bool occluded(Precalculations& pre, Ray& ray, const Primitive& prim, Scene* scene) 
       {
         AVX_ZERO_UPPER();
+        if (prim.accel->intersectors.intersectorN.occluded) {
+          if (pre.stream.add(1,prim,true)) pre.stream.flush();
+          return ray.geomID == 0;
+        }
         prim.accel->occluded((RTCRay&)ray,prim.item);
         return ray.geomID == 0;
       }
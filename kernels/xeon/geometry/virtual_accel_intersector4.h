@@ -28,18 +28,28 @@ namespace embree
       typedef AccelSetItem Primitive;
       
       struct Precalculations {
-        __forceinline Precalculations (const sseb& valid, const Ray4& ray) {}
+        __forceinline Precalculations (const sseb& valid, const Ray4& ray) 
+          : stream((Ray4&)ray) {}
+        AccelSetItemStream<Ray4,4> stream;  //!< buffered items of user geometries with stream callbacks
       };
       
-      static __forceinline void intersect(const sseb& valid_i, const Precalculations& pre, Ray4& ray, const Primitive& prim, Scene* scene) 
+      static __forceinline void intersect(const sseb& valid_i, Precalculations& pre, Ray4& ray, const Primitive& prim, Scene* scene) 
       {
         AVX_ZERO_UPPER();
+        if (prim.accel->intersectors.intersectorN.intersect) {
+          if (pre.stream.add(movemask(valid_i),prim,false)) pre.stream.flush();
+          return;
+        }
         prim.accel->intersect4(&valid_i,(RTCRay4&)ray,prim.item);
       }
       
-      static __forceinline sseb occluded(const sseb& valid_i, const Precalculations& pre, const Ray4& ray, const Primitive& prim, Scene* scene) 
+      static __forceinline sseb occluded(const sseb& valid_i, Precalculations& pre, const Ray4& ray, const Primitive& prim, Scene* scene) 
       {
         AVX_ZERO_UPPER();
+        if (prim.accel->intersectors.intersectorN.occluded) {
+          if (pre.stream.add(movemask(valid_i),prim,true)) pre.stream.flush();
+          return ray.geomID == 0;
+        }
         prim.accel->occluded4(&valid_i,(RTCRay4&)ray,prim.item);
         return ray.geomID == 0;
       }
@@ -28,15 +28,25 @@ namespace embree
       typedef AccelSetItem Primitive;
       
       struct Precalculations {
-        __forceinline Precalculations (const avxb& valid, const Ray8& ray) {}
+        __forceinline Precalculations (const avxb& valid, const Ray8& ray) 
+          : stream((Ray8&)ray) {}
+        AccelSetItemStream<Ray8,8> stream;  //!< buffered items of user geometries with stream callbacks
       };
       
-      static __forceinline void intersect(const avxb& valid_i, const Precalculations& pre, Ray8& ray, const Primitive& prim, Scene* scene) {
+      static __forceinline void intersect(const avxb& valid_i, Precalculations& pre, Ray8& ray, const Primitive& prim, Scene* scene) {
+        if (prim.accel->intersectors.intersectorN.intersect) {
+          if (pre.stream.add(movemask(valid_i),prim,false)) pre.stream.flush();
+          return;
+        }
         prim.accel->intersect8(&valid_i,(RTCRay8&)ray,prim.item);
       }
       
-      static __forceinline avxb occluded(const avxb& valid_i, const Precalculations& pre, const Ray8& ray, const Primitive& prim, Scene* scene) 
+      static __forceinline avxb occluded(const avxb& valid_i, Precalculations& pre, const Ray8& ray, const Primitive& prim, Scene* scene) 
       {
+        if (prim.accel->intersectors.intersectorN.occluded) {
+          if (pre.stream.add(movemask(valid_i),prim,true)) pre.stream.flush();
+          return ray.geomID == 0;
+        }
         prim.accel->occluded8(&valid_i,(RTCRay8&)ray,prim.item);
         return ray.geomID == 0;
       }
@@ -357,6 +357,9 @@ namespace embree
 					Scene *const scene,
 					LocalTessellationCacheThreadInfo *threadInfo)
     {
+      /* only the first lookup of the patch counts as cache hit or miss */
+      bool firstLookup = true;
+
       while(1)
 	{
 	  /* per thread lock */
@@ -391,6 +394,7 @@ namespace embree
 		if (likely( SharedLazyTessellationCache::sharedLazyTessellationCache.validCacheIndex(subdiv_patch_cache_index) ))
 		  {
 		    CACHE_STATS(SharedTessellationCacheStats::cache_hits++);	      
+		    if (firstLookup) SharedLazyTessellationCache::sharedLazyTessellationCache.countHit(threadInfo->id);
 		    return subdiv_patch_root;
 		  }
 	      }
@@ -398,6 +402,8 @@ namespace embree
 
 	  /* cache miss */
 	  CACHE_STATS(SharedTessellationCacheStats::cache_misses++);
+	  if (firstLookup) SharedLazyTessellationCache::sharedLazyTessellationCache.countMiss(threadInfo->id);
+	  firstLookup = false;
 
 	  subdiv_patch->write_lock();
 	  {
@@ -27,8 +27,11 @@
 #include "sys/sync/mutex.h"
 #include "sys/sync/condition.h"
 #include <vector>
+#include <map>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <iomanip>
 
 #define DBG(x) 
 
@@ -163,6 +166,8 @@ namespace embree
     void *raydata;
     void *raydata_verify;
     size_t numLogRayStreamElements;
+    const unsigned int *indices;
+    size_t numIndices;
     bool check;
   };  
 
@@ -198,6 +203,10 @@ namespace embree
   static size_t g_threadCount = 1;
   static size_t g_frames = 1;
   static size_t g_simd_width = 0;
+  static size_t g_activeThreads = 1;
+  static bool g_thread_scaling = false;
+  static std::string g_results_file = "";
+  static std::string g_compare_file = "";
   static AlignedAtomicCounter32 g_rays_traced = 0;
   static AlignedAtomicCounter32 g_rays_traced_diff = 0;
   static std::vector<thread_t> g_threads;
@@ -254,14 +263,26 @@ namespace embree
         else if (tag == "-sde") {
           g_sde = true;
         }
+        else if (tag == "-scaling") {
+          g_thread_scaling = true;
+        }
+        else if (tag == "-results" && i+1<argc) {
+          g_results_file = argv[++i];
+        }
+        else if (tag == "-compare" && i+1<argc) {
+          g_compare_file = argv[++i];
+        }
         else if (tag == "-h" || tag == "-help") {
           std::cout << "Usage: retrace [OPTIONS] [PATH_TO_BINARY_FILES] " << std::endl;
           std::cout << "Options:" << std::endl;
           std::cout << "-threads N   : sets number of render/worker threads for the retracing phase to N" << std::endl;
+          std::cout << "-scaling     : additionally measures all power of two thread counts below N" << std::endl;
           std::cout << "-frames N    : retraces all rays N times  " << std::endl;
           std::cout << "-check       : loads second ray stream file and validates result of rtcIntersectN/rtcOccludedN for each ray/packet" << std::endl;
-          std::cout << "-simd_width N: loads ray stream for simd width N (if existing)" << std:: endl;
+          std::cout << "-simd_width N: loads ray stream for simd width N (if existing), otherwise all existing ray streams get retraced" << std:: endl;
           std::cout << "-sde         : inserts markers for generating instruction traces with SDE" << std:: endl;
+          std::cout << "-results F   : writes the measured performance to file F" << std:: endl;
+          std::cout << "-compare F   : compares the measured performance against the results file F of a previous run" << std:: endl;
           exit(0);
         }
 
@@ -285,39 +306,45 @@ namespace embree
 
   void *loadGeometryData(std::string &geometryFile)
   {
-    std::ifstream geometryData;
-
-    geometryData.open(geometryFile.c_str(),std::ios::in | std::ios::binary);
-    if (!geometryData) { FATAL("could not open geometry data file"); }
-    geometryData.seekg(0, std::ios::beg);
-    std::streampos begin = geometryData.tellg();
-    geometryData.seekg(0, std::ios::end);
-    std::streampos end = geometryData.tellg();
-    size_t fileSize = end - begin;
-    char *ptr = (char*)os_malloc(fileSize);
-    geometryData.seekg(0, std::ios::beg);
-    geometryData.read(ptr,fileSize);
-    geometryData.close();
+    size_t fileSize = 0;
+    void *ptr = os_map_file(geometryFile.c_str(),fileSize);
+    if (!ptr) { FATAL("could not open geometry data file"); }
     return ptr;
   }
 
   template<class T>
   void *loadRayStreamData(std::string &rayStreamFile, size_t &numLogRayStreamElements)
   {
-    std::ifstream rayStreamData;
-
-    rayStreamData.open(rayStreamFile.c_str(),std::ios::in | std::ios::binary);
-    if (!rayStreamData) { FATAL("could not open raystream data file"); }
-    rayStreamData.seekg(0, std::ios::beg);
-    std::streampos begin = rayStreamData.tellg();
-    rayStreamData.seekg(0, std::ios::end);
-    std::streampos end = rayStreamData.tellg();
-    size_t fileSize = end - begin;
-    char *ptr = (char*)os_malloc(fileSize);
-    rayStreamData.seekg(0, std::ios::beg);
-    rayStreamData.read(ptr,fileSize);
+    size_t fileSize = 0;
+    char *ptr = (char*)os_map_file(rayStreamFile.c_str(),fileSize);
+    if (!ptr) { FATAL("could not open raystream data file"); }
+
+    /* decompress compressed ray streams */
+    if (fileSize >= sizeof(unsigned int) && *(unsigned int*)ptr == RayStreamLogger::COMPRESSED_STREAM_MAGIC)
+    {
+      typedef RayStreamLogger::CompressedChunkHeader Header;
+      size_t rawSize = 0;
+      for (size_t pos = sizeof(unsigned int); pos < fileSize; ) {
+        Header* header = (Header*)(ptr+pos);
+        rawSize += header->rawBytes;
+        pos += sizeof(Header) + header->compressedBytes;
+      }
+
+      char *raw = (char*)os_malloc(rawSize);
+      char *dst = raw;
+      for (size_t pos = sizeof(unsigned int); pos < fileSize; ) {
+        Header* header = (Header*)(ptr+pos);
+        if (RayStreamLogger::decompress(ptr+pos+sizeof(Header),header->compressedBytes,dst) != header->rawBytes)
+          FATAL("corrupt compressed raystream data file");
+        dst += header->rawBytes;
+        pos += sizeof(Header) + header->compressedBytes;
+      }
+      os_unmap_file(ptr,fileSize);
+      ptr = raw;
+      fileSize = rawSize;
+    }
+
     numLogRayStreamElements = fileSize / sizeof(T);
-    rayStreamData.close();
     return ptr;
   }
 
@@ -466,18 +493,21 @@ namespace embree
     while(1)
       {
 	size_t global_index = g_counter.add(RAY_BLOCK_SIZE);
-	if (global_index >= g_retraceTask.numLogRayStreamElements) break;
+	if (global_index >= g_retraceTask.numIndices) break;
 	size_t startID = global_index;
-	size_t endID   = min(g_retraceTask.numLogRayStreamElements,startID+RAY_BLOCK_SIZE);
+	size_t endID   = min(g_retraceTask.numIndices,startID+RAY_BLOCK_SIZE);
 
-	for (size_t index=startID;index<endID;index++)
+	for (size_t i=startID;i<endID;i++)
 	  {
+            /* the logged rays are copied, thus every frame traces the same rays */
+            const size_t index = g_retraceTask.indices[i];
+
             if (SIMD_WIDTH == 1)
               {
                 RayStreamLogger::LogRay1 *raydata        = (RayStreamLogger::LogRay1 *)g_retraceTask.raydata;
                 RayStreamLogger::LogRay1 *raydata_verify = (RayStreamLogger::LogRay1 *)g_retraceTask.raydata_verify;
 
-                RTCRay &ray = raydata[index].ray;
+                RTCRay ray = raydata[index].ray;
                 rays ++;
                 if (raydata[index].type == RayStreamLogger::RAY_INTERSECT)
                   rtcIntersect(g_retraceTask.scene,ray);
@@ -493,7 +523,7 @@ namespace embree
                 RayStreamLogger::LogRay4 *raydata        = (RayStreamLogger::LogRay4 *)g_retraceTask.raydata;
                 RayStreamLogger::LogRay4 *raydata_verify = (RayStreamLogger::LogRay4 *)g_retraceTask.raydata_verify;
 
-                RTCRay4 &ray4 = raydata[index].ray4;
+                RTCRay4 ray4 = raydata[index].ray4;
                 sseb valid((int)raydata[index].m_valid);
                 rays += raydata[index].numRays;
                 if (raydata[index].type == RayStreamLogger::RAY_INTERSECT)
@@ -502,14 +532,14 @@ namespace embree
                   rtcOccluded4(&valid,g_retraceTask.scene,ray4);
 
                 if (unlikely(g_check))
-                  diff += check_ray_packets<RTCRay4>(raydata[index].m_valid,  raydata[index].ray4, raydata_verify[index].ray4);
+                  diff += check_ray_packets<RTCRay4>(raydata[index].m_valid, ray4, raydata_verify[index].ray4);
               }
             else if (SIMD_WIDTH == 8)
               {
                 RayStreamLogger::LogRay8 *raydata        = (RayStreamLogger::LogRay8 *)g_retraceTask.raydata;
                 RayStreamLogger::LogRay8 *raydata_verify = (RayStreamLogger::LogRay8 *)g_retraceTask.raydata_verify;
 
-                RTCRay8 &ray8 = raydata[index].ray8;
+                RTCRay8 ray8 = raydata[index].ray8;
                 __aligned(64) sseb valid[2];
 
                 valid[0] = sseb((int)(raydata[index].m_valid & 0xf));
@@ -523,7 +553,7 @@ namespace embree
                   rtcOccluded8(valid,g_retraceTask.scene,ray8);
 
                 if (unlikely(g_check))
-                  diff += check_ray_packets<RTCRay8>(raydata[index].m_valid,  raydata[index].ray8, raydata_verify[index].ray8);
+                  diff += check_ray_packets<RTCRay8>(raydata[index].m_valid, ray8, raydata_verify[index].ray8);
               }
 #endif
             else if (SIMD_WIDTH == 16)
@@ -531,19 +561,18 @@ namespace embree
                 RayStreamLogger::LogRay16 *raydata        = (RayStreamLogger::LogRay16 *)g_retraceTask.raydata;
                 RayStreamLogger::LogRay16 *raydata_verify = (RayStreamLogger::LogRay16 *)g_retraceTask.raydata_verify;
 #if defined(__MIC__)
-                RTCRay16 &ray16 = raydata[index].ray16;
+                RTCRay16 ray16 = raydata[index].ray16;
                 mic_i valid = select((mic_m)raydata[index].m_valid,mic_i(-1),mic_i(0));
                 rays += raydata[index].numRays;
 
-                //raydata[index+1].prefetchL2();
-  
                 if (raydata[index].type == RayStreamLogger::RAY_INTERSECT)
                   rtcIntersect16(&valid,g_retraceTask.scene,ray16);
                 else 
                   rtcOccluded16(&valid,g_retraceTask.scene,ray16);
-#endif
+
                 if (unlikely(g_check))
-                  diff += check_ray_packets<RTCRay16>(raydata[index].m_valid,  raydata[index].ray16, raydata_verify[index].ray16);
+                  diff += check_ray_packets<RTCRay16>(raydata[index].m_valid, ray16, raydata_verify[index].ray16);
+#endif
               }
 
 
@@ -558,6 +587,9 @@ namespace embree
 
   void renderMainLoop(size_t id)
   {
+    /* threads above the currently measured thread count stay idle */
+    if (id >= g_activeThreads) return;
+
     switch(g_simd_width)
       {
       case 1:
@@ -604,6 +636,169 @@ namespace embree
       g_threads.push_back(createThread(threadMainLoop,(void*)i,1000000,i));
   }
 
+  /*! retraces all rays of the current task once using the specified number of threads, returns mrays/sec */
+  double retraceFrame(size_t numThreads)
+  {
+    g_activeThreads = numThreads;
+    g_rays_traced = 0;
+    g_rays_traced_diff = 0;
+    g_counter = 0;
+
+    if (g_sde)
+      {
+#if defined(__INTEL_COMPILER)
+        __asm { int 3 };
+        SSC_MARK(111);
+#endif
+      }
+
+    double dt = getSeconds();
+    g_barrier.wait(0,g_threadCount);
+    renderMainLoop(0);
+    g_barrier.wait(0,g_threadCount);
+    dt = getSeconds()-dt;
+
+    if (g_sde)
+      {
+#if defined(__INTEL_COMPILER)
+        __asm { int 3 };
+        SSC_MARK(222);
+#endif
+      }
+
+    return (double)g_rays_traced / dt / 1000000.;
+  }
+
+  /*! measured performance for one ray stream, ray type and thread count */
+  struct RetraceResult
+  {
+    RetraceResult () {}
+    RetraceResult (size_t simd_width, const std::string& type, size_t threads, size_t rays, double min_mrays, double avg_mrays, double max_mrays)
+      : simd_width(simd_width), type(type), threads(threads), rays(rays), min_mrays(min_mrays), avg_mrays(avg_mrays), max_mrays(max_mrays) {}
+
+    std::string key() const {
+      return "ray" + std::stringOf(simd_width) + " " + type + " " + std::stringOf(threads);
+    }
+
+    size_t simd_width;
+    std::string type;
+    size_t threads;
+    size_t rays;
+    double min_mrays, avg_mrays, max_mrays;
+  };
+
+  static std::vector<RetraceResult> g_results;
+
+  /*! writes all results in a format that can get diffed between two builds */
+  void writeResults(const std::string& fileName)
+  {
+    std::ofstream file(fileName.c_str());
+    if (!file) FATAL("could not open results file");
+    file << "# simd_width type threads rays min_mrays avg_mrays max_mrays" << std::endl;
+    for (size_t i=0; i<g_results.size(); i++) {
+      const RetraceResult& r = g_results[i];
+      file << r.simd_width << " " << r.type << " " << r.threads << " " << r.rays << " "
+           << r.min_mrays << " " << r.avg_mrays << " " << r.max_mrays << std::endl;
+    }
+  }
+
+  /*! compares all results against the results of a previous run */
+  void compareResults(const std::string& fileName)
+  {
+    std::ifstream file(fileName.c_str());
+    if (!file) FATAL("could not open reference results file");
+
+    std::map<std::string,RetraceResult> reference;
+    std::string line;
+    while (std::getline(file,line)) 
+    {
+      if (line.empty() || line[0] == '#') continue;
+      std::istringstream str(line);
+      RetraceResult r;
+      str >> r.simd_width >> r.type >> r.threads >> r.rays >> r.min_mrays >> r.avg_mrays >> r.max_mrays;
+      if (str) reference[r.key()] = r;
+    }
+
+    std::cout << "comparison against '" << fileName << "':" << std::endl;
+    for (size_t i=0; i<g_results.size(); i++) 
+    {
+      const RetraceResult& r = g_results[i];
+      if (reference.find(r.key()) == reference.end()) continue;
+      const RetraceResult& ref = reference[r.key()];
+      if (ref.rays != r.rays) 
+        std::cout << "  WARNING: " << r.key() << " traces " << r.rays << " rays, reference traced " << ref.rays << std::endl;
+      std::cout << "  " << std::setw(24) << std::left << r.key() + " threads" << std::right 
+                << std::setw(10) << ref.avg_mrays << " -> " << std::setw(10) << r.avg_mrays << " mrays/sec (" 
+                << std::showpos << 100.0*(r.avg_mrays/ref.avg_mrays-1.0) << std::noshowpos << "%)" << std::endl;
+    }
+  }
+
+  /*! loads the ray stream of the specified SIMD width and measures its performance */
+  template<class T>
+  void retraceStream(RTCScene scene, std::string& rayStreamFileName, std::string& rayStreamVerifyFileName, const std::vector<size_t>& threadCounts)
+  {
+    /* load ray stream data */
+    std::cout << "loading ray stream data from files '" << rayStreamFileName << "/" << rayStreamVerifyFileName << "'..." << std::flush;    
+    size_t numLogRayStreamElements       = 0;
+    size_t numLogRayStreamElementsVerify = 0;
+    T* raydata = (T*) loadRayStreamData<T>(rayStreamFileName, numLogRayStreamElements);
+    T* raydata_verify = NULL;
+    if (g_check)
+      raydata_verify = (T*) loadRayStreamData<T>(rayStreamVerifyFileName, numLogRayStreamElementsVerify); 
+    std::cout <<  "done" << std::endl << std::flush;
+
+    if (g_check)
+      if (numLogRayStreamElements != numLogRayStreamElementsVerify)
+        FATAL("numLogRayStreamElements != numLogRayStreamElementsVerify");
+
+    /* analyse ray stream data */
+    std::cout << "analyse ray stream:" << std::endl << std::flush;    
+    RayStreamStats stats = analyseRayStreamData<T>(raydata,numLogRayStreamElements);
+    stats.print(g_simd_width);
+
+    /* split ray stream by ray type */
+    std::vector<unsigned int> indices[3];
+    const char* types[3] = { "all", "intersect", "occluded" };
+    for (size_t i=0; i<numLogRayStreamElements; i++) {
+      indices[0].push_back((unsigned int)i);
+      indices[raydata[i].type == RayStreamLogger::RAY_INTERSECT ? 1 : 2].push_back((unsigned int)i);
+    }
+
+    g_retraceTask.scene                   = scene;
+    g_retraceTask.raydata                 = raydata;
+    g_retraceTask.raydata_verify          = raydata_verify;
+    g_retraceTask.numLogRayStreamElements = numLogRayStreamElements;
+    g_retraceTask.check                   = g_check;
+
+    std::cout << "Retracing logged rays:" << std::endl << std::flush;
+    for (size_t t=0; t<3; t++)
+    {
+      if (indices[t].empty()) continue;
+      g_retraceTask.indices    = &indices[t][0];
+      g_retraceTask.numIndices = indices[t].size();
+
+      for (size_t c=0; c<threadCounts.size(); c++)
+      {
+        double min_mrays = inf, max_mrays = 0.0, avg_mrays = 0.0;
+        for (size_t i=0;i<g_frames;i++)
+        {
+          const double mrays = retraceFrame(threadCounts[c]);
+          min_mrays = min(min_mrays,mrays);
+          max_mrays = max(max_mrays,mrays);
+          avg_mrays += mrays / (double)g_frames;
+
+          if (unlikely(g_check))
+            std::cout << g_rays_traced_diff << " rays differ in result (" << 100. * g_rays_traced_diff / g_rays_traced << "%)" << std::endl;
+        }
+
+        const RetraceResult result(g_simd_width,types[t],threadCounts[c],g_rays_traced,min_mrays,avg_mrays,max_mrays);
+        std::cout << "  " << std::setw(24) << std::left << result.key() + " threads" << std::right
+                  << " rays " << std::setw(10) << result.rays << " mrays/sec = [" << min_mrays << " / " << avg_mrays << " / " << max_mrays << "]" << std::endl;
+        g_results.push_back(result);
+      }
+    }
+  }
+
   /* main function in embree namespace */
   int main(int argc, char** argv) 
   {
@@ -636,168 +831,62 @@ namespace embree
     std::cout << "transfering geometry data:" << std::endl << std::flush;
     RTCScene scene = transferGeometryData((char*)g);
 
-    /* looking for ray stream file */
-    std::string rayStreamFileName;
-    std::string rayStreamVerifyFileName;
-
-    if (g_simd_width != 0)
+    /* looking for ray stream files, without a specified SIMD width all existing ray streams get retraced */
+    std::vector<size_t> simdWidths;
+    for (size_t shift=0;shift<=4;shift++)
       {
-        rayStreamFileName = g_binaries_path + "ray" + std::stringOf(g_simd_width) + ".bin";
-        rayStreamVerifyFileName = g_binaries_path + "ray" + std::stringOf(g_simd_width) + "_verify.bin";
-      }
-    else
-      {
-        /* looking for stream files in the following order: ray1.bin, ray4.bin, ray8.bin, ray16.bin */
-        for (size_t shift=0;shift<=4;shift++)
-          {
-            g_simd_width = (size_t)1 << shift;
-            rayStreamFileName = g_binaries_path + "ray" + std::stringOf(g_simd_width) + ".bin";
-            rayStreamVerifyFileName = g_binaries_path + "ray" + std::stringOf(g_simd_width) + "_verify.bin";
-            if (existsFile( rayStreamFileName )) break;
-
-          }
+        const size_t simd_width = (size_t)1 << shift;
+        if (g_simd_width != 0 && g_simd_width != simd_width) continue;
+        std::string rayStreamFileName = g_binaries_path + "ray" + std::stringOf(simd_width) + ".bin";
+        if (existsFile( rayStreamFileName )) simdWidths.push_back(simd_width);
       }
    
-    if (g_simd_width == 0)
+    if (simdWidths.empty())
       FATAL("no valid ray stream data files found");
 
-    DBG_PRINT( rayStreamFileName );
-    DBG_PRINT( rayStreamVerifyFileName );
-
-    if (!existsFile( rayStreamFileName )) FATAL("ray stream file does not exists!");
-    if (!existsFile( rayStreamVerifyFileName )) FATAL("ray stream verify file does not exists!");
-
-
-    /* load ray stream data */
-    std::cout << "loading ray stream data from files '" << rayStreamFileName << "/" << rayStreamVerifyFileName << "'..." << std::flush;    
-    size_t numLogRayStreamElements       = 0;
-    size_t numLogRayStreamElementsVerify = 0;
-
-    void *raydata        = NULL;
-    void *raydata_verify = NULL;
-
-    switch(g_simd_width)
-      {
-      case 1:
-        raydata = loadRayStreamData<RayStreamLogger::LogRay1>(rayStreamFileName, numLogRayStreamElements);
-        if (g_check)
-          raydata_verify = loadRayStreamData<RayStreamLogger::LogRay1>(rayStreamVerifyFileName, numLogRayStreamElementsVerify); 
-        break;
-      case 4:
-        raydata = loadRayStreamData<RayStreamLogger::LogRay4>(rayStreamFileName, numLogRayStreamElements);
-        if (g_check)
-          raydata_verify = loadRayStreamData<RayStreamLogger::LogRay4>(rayStreamVerifyFileName, numLogRayStreamElementsVerify); 
-        break;
-      case 8:
-        raydata = loadRayStreamData<RayStreamLogger::LogRay8>(rayStreamFileName, numLogRayStreamElements);
-        if (g_check)
-          raydata_verify = loadRayStreamData<RayStreamLogger::LogRay8>(rayStreamVerifyFileName, numLogRayStreamElementsVerify); 
-        break;
-      case 16:
-        raydata = loadRayStreamData<RayStreamLogger::LogRay16>(rayStreamFileName, numLogRayStreamElements);
-        if (g_check)
-          raydata_verify = loadRayStreamData<RayStreamLogger::LogRay16>(rayStreamVerifyFileName, numLogRayStreamElementsVerify); 
-        break;
-      default:
-        FATAL("unknown SIMD width");
-      }
-
-    std::cout <<  "done" << std::endl << std::flush;
-
-    if (g_check)
-      if (numLogRayStreamElements != numLogRayStreamElementsVerify)
-        FATAL("numLogRayStreamElements != numLogRayStreamElementsVerify");
-
-    /* analyse ray stream data */
-    std::cout << "analyse ray stream:" << std::endl << std::flush;    
-    RayStreamStats stats;
-    switch(g_simd_width)
-      {
-      case 1:
-        stats = analyseRayStreamData<RayStreamLogger::LogRay1>(raydata,numLogRayStreamElements);
-        break;
-      case 4:
-        stats = analyseRayStreamData<RayStreamLogger::LogRay4>(raydata,numLogRayStreamElements);
-        break;
-      case 8:
-        stats = analyseRayStreamData<RayStreamLogger::LogRay8>(raydata,numLogRayStreamElements);
-        break;
-      case 16:
-        stats = analyseRayStreamData<RayStreamLogger::LogRay16>(raydata,numLogRayStreamElements);
-        break;
-      }
-
-    stats.print(g_simd_width);
-
 #if defined(RTCORE_ENABLE_RAYSTREAM_LOGGER)
     FATAL("ray stream logger still active, must be disabled to run 'retrace'");
 #endif
 
-
+    /* thread counts to measure */
+    std::vector<size_t> threadCounts;
+    if (g_thread_scaling) {
+      for (size_t i=1; i<g_threadCount; i*=2) threadCounts.push_back(i);
+    }
+    threadCounts.push_back(g_threadCount);
 
     /* init global tasking barrier */
     g_barrier.init( g_threadCount );
 
-
-    g_retraceTask.scene                   = scene;
-    g_retraceTask.raydata                 = raydata;
-    g_retraceTask.raydata_verify          = raydata_verify;
-    g_retraceTask.numLogRayStreamElements = numLogRayStreamElements;
-    g_retraceTask.check                   = g_check;
-
-
     std::cout << "using " << g_threadCount << " threads for retracing rays" << std::endl << std::flush;
     createThreads(g_threadCount);
 
-
-    /* retrace ray packets */
-    DBG_PRINT( g_threadCount );
-
-    std::cout << "Retracing logged rays:" << std::endl << std::flush;
-    
-    double avg_time = 0;
-    double mrays_sec = 0;
-    for (size_t i=0;i<g_frames;i++)
+    for (size_t i=0; i<simdWidths.size(); i++)
       {
-	double dt = getSeconds();
-
-        /* retrace rays using all threads */
+        g_simd_width = simdWidths[i];
+        std::string rayStreamFileName = g_binaries_path + "ray" + std::stringOf(g_simd_width) + ".bin";
+        std::string rayStreamVerifyFileName = g_binaries_path + "ray" + std::stringOf(g_simd_width) + "_verify.bin";
 
-	g_rays_traced = 0;
-	g_rays_traced_diff = 0;
-	g_counter = 0;
-
-	if (g_sde)
-	  {
-#if defined(__INTEL_COMPILER)
-	    __asm { int 3 };
-	    SSC_MARK(111);
-#endif
-	  }
+        DBG_PRINT( rayStreamFileName );
+        DBG_PRINT( rayStreamVerifyFileName );
 
-        g_barrier.wait(0,g_threadCount);
-        renderMainLoop(0);
+        if (g_check && !existsFile( rayStreamVerifyFileName )) FATAL("ray stream verify file does not exists!");
 
-	dt = getSeconds()-dt;
-	mrays_sec += (double)g_rays_traced / dt / 1000000.;
-#if 0
-	std::cout << "frame " << i << " => time " << 1000. * dt << " " << 1. / dt << " fps " << "ms " << g_rays_traced / dt / 1000000. << " mrays/sec" << std::endl;
-#endif
-
-        g_barrier.wait(0,g_threadCount);
+        switch(g_simd_width)
+          {
+          case 1:  retraceStream<RayStreamLogger::LogRay1 >(scene,rayStreamFileName,rayStreamVerifyFileName,threadCounts); break;
+          case 4:  retraceStream<RayStreamLogger::LogRay4 >(scene,rayStreamFileName,rayStreamVerifyFileName,threadCounts); break;
+          case 8:  retraceStream<RayStreamLogger::LogRay8 >(scene,rayStreamFileName,rayStreamVerifyFileName,threadCounts); break;
+          case 16: retraceStream<RayStreamLogger::LogRay16>(scene,rayStreamFileName,rayStreamVerifyFileName,threadCounts); break;
+          default: FATAL("unknown SIMD width");
+          }
+      }
 
-	if (g_sde)
-	  {
-#if defined(__INTEL_COMPILER)
-	    __asm { int 3 };
-	    SSC_MARK(222);
-#endif
-	  }
+    if (g_results_file != "")
+      writeResults(g_results_file);
 
-        if (unlikely(g_check))
-          std::cout << g_rays_traced_diff << " rays differ in result (" << 100. * g_rays_traced_diff / g_rays_traced << "%)" << std::endl;
-      }
-    std::cout << "rays " << g_rays_traced << " avg. mrays/sec = " << mrays_sec / (double)g_frames << std::endl;
+    if (g_compare_file != "")
+      compareResults(g_compare_file);
 
     std::cout << "freeing threads..." << std::flush;
     g_exitThreads = true;
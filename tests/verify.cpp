@@ -1127,6 +1127,72 @@ namespace embree
     return true;
   }
 
+  bool rtcore_refit_restructure(size_t numFrames)
+  {
+    /* grid with enough triangles to get refitted in parallel */
+    const size_t G = 160;
+    const size_t numVertices = (G+1)*(G+1);
+    const size_t numTriangles = 2*G*G;
+    std::vector<Vertex3f> vertices(numVertices+1); // one more vertex as vertices get loaded with 16 bytes
+    std::vector<Triangle> triangles(numTriangles);
+    for (size_t y=0; y<G; y++) {
+      for (size_t x=0; x<G; x++) {
+        const int p00 = (y+0)*(G+1)+(x+0), p01 = (y+0)*(G+1)+(x+1);
+        const int p10 = (y+1)*(G+1)+(x+0), p11 = (y+1)*(G+1)+(x+1);
+        Triangle& t0 = triangles[2*(y*G+x)+0]; t0.v0 = p00; t0.v1 = p01; t0.v2 = p10;
+        Triangle& t1 = triangles[2*(y*G+x)+1]; t1.v0 = p11; t1.v1 = p10; t1.v2 = p01;
+      }
+    }
+    std::vector<size_t> perm(numVertices);
+    for (size_t i=0; i<numVertices; i++) perm[i] = i;
+
+    RTCScene scene = rtcNewScene(RTC_SCENE_DYNAMIC,aflags);
+    unsigned mesh = rtcNewTriangleMesh(scene,RTC_GEOMETRY_DEFORMABLE,numTriangles,numVertices);
+    rtcSetBuffer(scene,mesh,RTC_VERTEX_BUFFER,&vertices[0],0,sizeof(Vertex3f));
+    rtcSetBuffer(scene,mesh,RTC_INDEX_BUFFER ,&triangles[0],0,sizeof(Triangle));
+    AssertNoError();
+
+    bool passed = true;
+    for (size_t f=0; f<numFrames; f++)
+    {
+      /* scramble the vertices more with every frame to degrade the refitted BVH */
+      for (size_t i=0; i<f*numVertices/8; i++) 
+        std::swap(perm[rand()%numVertices],perm[rand()%numVertices]);
+      for (size_t i=0; i<numVertices; i++) {
+        vertices[i].x = float(perm[i]%(G+1))/float(G);
+        vertices[i].y = 0.01f*float(perm[i]%7);
+        vertices[i].z = float(perm[i]/(G+1))/float(G);
+      }
+      rtcUpdate(scene,mesh);
+      rtcCommit (scene);
+
+      /* reference scene built from scratch */
+      RTCScene ref = rtcNewScene(RTC_SCENE_STATIC,aflags);
+      unsigned refMesh = rtcNewTriangleMesh(ref,RTC_GEOMETRY_STATIC,numTriangles,numVertices);
+      rtcSetBuffer(ref,refMesh,RTC_VERTEX_BUFFER,&vertices[0],0,sizeof(Vertex3f));
+      rtcSetBuffer(ref,refMesh,RTC_INDEX_BUFFER ,&triangles[0],0,sizeof(Triangle));
+      rtcCommit (ref);
+      AssertNoError();
+
+      for (size_t i=0; i<1000; i++) 
+      {
+        const Vec3fa org(drand48(),1.0f,drand48());
+        const Vec3fa dir(0.1f*drand48()-0.05f,-1.0f,0.1f*drand48()-0.05f);
+        RTCRay ray0 = makeRay(org,dir); rtcIntersect(scene,ray0);
+        RTCRay ray1 = makeRay(org,dir); rtcIntersect(ref,ray1);
+        passed &= ray0.geomID == ray1.geomID;
+        if (ray0.geomID != RTC_INVALID_GEOMETRY_ID) passed &= abs(ray0.tfar-ray1.tfar) < 1E-4f;
+        RTCRay shadow = makeRay(org,dir); rtcOccluded(scene,shadow);
+        passed &= (shadow.geomID == 0) == (ray1.geomID != -1);
+      }
+      rtcDeleteScene (ref);
+    }
+
+    rtcDeleteScene (scene);
+    AssertNoError();
+    return passed;
+  }
+
   bool rtcore_unmapped_before_commit()
   {
     RTCScene scene = rtcNewScene(RTC_SCENE_STATIC,aflags);
@@ -1235,6 +1301,433 @@ namespace embree
     return true;
   }
 
+  bool rtcore_async_commit(size_t N)
+  {
+    /* asynchronous commit is only valid for scenes created with the corresponding flag */
+    RTCScene scene0 = rtcNewScene(RTC_SCENE_DYNAMIC,aflags);
+    rtcCommitAsync(scene0);
+    AssertAnyError();
+    rtcDeleteScene (scene0);
+
+    RTCScene scene = rtcNewScene(RTCSceneFlags(RTC_SCENE_DYNAMIC | RTC_SCENE_ASYNC_COMMIT),aflags);
+    AssertNoError();
+    unsigned geom0 = addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(-1,0,-1),1.0f,50);
+    unsigned geom1 = addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(+1,0,+1),1.0f,50);
+    rtcDisable(scene,geom1);
+    AssertNoError();
+
+    /* rays traced during a commit see either the previous or the new state of the scene */
+    bool passed = true;
+    for (size_t i=0; i<8; i++)
+    {
+      const bool enabled0 = (i & 1) == 0, enabled1 = !enabled0;
+      if (i > 0) {
+        if (enabled0) rtcEnable(scene,geom0); else rtcDisable(scene,geom0);
+        if (enabled1) rtcEnable(scene,geom1); else rtcDisable(scene,geom1);
+      }
+      if (i == 4) rtcCommit(scene);
+      else        rtcCommitAsync(scene);
+      AssertNoError();
+
+      for (size_t j=0; j<N; j++) 
+      {
+        RTCRay ray0 = makeRay(Vec3fa(-1,10,-1),Vec3fa(0,-1,0));
+        RTCRay ray1 = makeRay(Vec3fa(+1,10,+1),Vec3fa(0,-1,0));
+        rtcIntersect(scene,ray0);
+        rtcIntersect(scene,ray1);
+        passed &= ray0.geomID == -1 || ray0.geomID == geom0;
+        passed &= ray1.geomID == -1 || ray1.geomID == geom1;
+      }
+
+      rtcWaitCommit(scene);
+      AssertNoError();
+      RTCRay ray0 = makeRay(Vec3fa(-1,10,-1),Vec3fa(0,-1,0));
+      RTCRay ray1 = makeRay(Vec3fa(+1,10,+1),Vec3fa(0,-1,0));
+      rtcIntersect(scene,ray0);
+      rtcIntersect(scene,ray1);
+      passed &= enabled0 ? ray0.geomID == geom0 : ray0.geomID == -1;
+      passed &= enabled1 ? ray1.geomID == geom1 : ray1.geomID == -1;
+    }
+
+    /* deleted geometries stay valid until no ray traverses the previous build anymore */
+    rtcDeleteGeometry(scene,geom0);
+    rtcDeleteGeometry(scene,geom1);
+    rtcCommitAsync(scene);
+    for (size_t j=0; j<N; j++) {
+      RTCRay ray = makeRay(Vec3fa(+1,10,+1),Vec3fa(0,-1,0));
+      rtcOccluded(scene,ray);
+    }
+    rtcDeleteScene (scene);
+    clearBuffers();
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_async_commit_scenes(size_t numScenes)
+  {
+    /* asynchronous commits of different scenes share one scheduler */
+    std::vector<RTCScene> scenes(numScenes);
+    for (size_t i=0; i<numScenes; i++) {
+      scenes[i] = rtcNewScene(RTCSceneFlags(RTC_SCENE_DYNAMIC | RTC_SCENE_ASYNC_COMMIT),aflags);
+      addSphere(scenes[i],RTC_GEOMETRY_STATIC,Vec3fa(float(i),0,0),0.4f,50);
+    }
+    for (size_t i=0; i<numScenes; i++) rtcCommitAsync(scenes[i]);
+    for (size_t i=0; i<numScenes; i++) rtcWaitCommit(scenes[i]);
+    AssertNoError();
+
+    bool passed = true;
+    for (size_t i=0; i<numScenes; i++) 
+    {
+      RTCRay ray0 = makeRay(Vec3fa(float(i),10,0),Vec3fa(0,-1,0)); rtcIntersect(scenes[i],ray0);
+      RTCRay ray1 = makeRay(Vec3fa(float(i)+0.5f,10,0),Vec3fa(0,-1,0)); rtcIntersect(scenes[i],ray1);
+      passed &= ray0.geomID == 0 && ray1.geomID == -1;
+      rtcDeleteScene (scenes[i]);
+    }
+    clearBuffers();
+    return passed;
+  }
+
+  bool rtcore_async_commit_update()
+  {
+    /* every commit goes to the build that is not traced, thus both builds have to see all changes */
+    RTCScene scene = rtcNewScene(RTCSceneFlags(RTC_SCENE_DYNAMIC | RTC_SCENE_ASYNC_COMMIT),aflags);
+    const size_t numPhi = 20, numVertices = 2*numPhi*(numPhi+1);
+    unsigned geom0 = addSphere(scene,RTC_GEOMETRY_DEFORMABLE,zero,1.0f,numPhi);
+    unsigned geom1 = addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(0,0,10),1.0f,numPhi);
+    rtcCommitAsync(scene);
+    AssertNoError();
+
+    /* the application can commit other scenes during an asynchronous commit */
+    RTCScene other = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    addSphere(other,RTC_GEOMETRY_STATIC,zero,1.0f,200);
+    rtcCommit(other);
+    AssertNoError();
+    rtcWaitCommit(scene);
+    AssertNoError();
+    rtcDeleteScene (other);
+
+    bool passed = true;
+    for (size_t i=1; i<=6; i++)
+    {
+      Vertex3f* vertices = (Vertex3f*) rtcMapBuffer(scene,geom0,RTC_VERTEX_BUFFER);
+      for (size_t j=0; j<numVertices; j++) vertices[j].x += 3.0f;
+      rtcUnmapBuffer(scene,geom0,RTC_VERTEX_BUFFER);
+      rtcUpdate(scene,geom0);
+      if (i == 2) { rtcDeleteGeometry(scene,geom1); geom1 = RTC_INVALID_GEOMETRY_ID; }
+      if (i == 4) geom1 = addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(0,0,10),1.0f,numPhi);
+      if (i % 3 == 0) rtcCommit(scene);
+      else            rtcCommitAsync(scene);
+      rtcWaitCommit(scene);
+      AssertNoError();
+
+      RTCRay ray0 = makeRay(Vec3fa(3.0f*i,10,0),Vec3fa(0,-1,0));
+      RTCRay ray1 = makeRay(Vec3fa(3.0f*(i-1),10,0),Vec3fa(0,-1,0));
+      RTCRay ray2 = makeRay(Vec3fa(0,10,10),Vec3fa(0,-1,0));
+      rtcIntersect(scene,ray0);
+      rtcIntersect(scene,ray1);
+      rtcIntersect(scene,ray2);
+      passed &= ray0.geomID == geom0 && ray1.geomID == -1 && ray2.geomID == geom1;
+    }
+    rtcDeleteScene (scene);
+    clearBuffers();
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_instance_array(size_t numInstances, size_t N)
+  {
+    RTCScene object = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    addSphere(object,RTC_GEOMETRY_STATIC,zero,0.5f,20);
+    rtcCommit (object);
+    AssertNoError();
+
+    /* place the instances along the x axis with varying scale */
+    std::vector<AffineSpace3fa> xfms(numInstances);
+    for (size_t i=0; i<numInstances; i++)
+      xfms[i] = AffineSpace3fa::translate(Vec3fa(2.0f*i,0.0f,0.0f)) * AffineSpace3fa::scale(Vec3fa(0.5f+0.5f*float(i%3)/2.0f));
+
+    /* reference scene with one instance per transformation */
+    RTCScene scene0 = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    for (size_t i=0; i<numInstances; i++) {
+      unsigned inst = rtcNewInstance(scene0,object);
+      rtcSetTransform(scene0,inst,RTC_MATRIX_COLUMN_MAJOR_ALIGNED16,(float*)&xfms[i]);
+    }
+    rtcCommit (scene0);
+    AssertNoError();
+
+    /* same instances stored in a strided transform buffer */
+    RTCScene scene1 = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    unsigned instances = rtcNewInstanceArray(scene1,object,numInstances);
+    std::vector<float> buffer(16*numInstances);
+    for (size_t i=0; i<numInstances; i++) {
+      const AffineSpace3fa& xfm = xfms[i];
+      float* m = &buffer[16*i];
+      m[0] = xfm.l.vx.x; m[ 1] = xfm.l.vx.y; m[ 2] = xfm.l.vx.z;
+      m[3] = xfm.l.vy.x; m[ 4] = xfm.l.vy.y; m[ 5] = xfm.l.vy.z;
+      m[6] = xfm.l.vz.x; m[ 7] = xfm.l.vz.y; m[ 8] = xfm.l.vz.z;
+      m[9] = xfm.p.x;    m[10] = xfm.p.y;    m[11] = xfm.p.z;
+    }
+    rtcSetBuffer(scene1,instances,RTC_TRANSFORM_BUFFER,&buffer[0],0,16*sizeof(float));
+    rtcCommit (scene1);
+    const unsigned baseID = rtcGetInstanceArrayBaseID(scene1,instances);
+    AssertNoError();
+
+    bool passed = true;
+    for (size_t i=0; i<N; i++) 
+    {
+      const RTCRay ray = makeRay(Vec3fa(2.0f*numInstances*drand48()-1.0f,10.0f,drand48()-0.5f),Vec3fa(0,-1,0));
+      RTCRay ray0 = ray; rtcIntersect(scene0,ray0);
+      RTCRay ray1 = ray; rtcIntersect(scene1,ray1);
+      passed &= ray0.geomID == ray1.geomID && ray0.primID == ray1.primID && ray0.tfar == ray1.tfar;
+      if (ray0.geomID != -1) passed &= RTC_IS_INSTANCE_ARRAY_INSTID(ray1.instID) && unsigned(ray1.instID) - baseID == unsigned(ray0.instID);
+      else                   passed &= ray1.instID == -1;
+      RTCRay shadow = ray; rtcOccluded(scene1,shadow);
+      passed &= (shadow.geomID == 0) == (ray0.geomID != -1);
+
+      RTCRay4 ray4; setRay(ray4,0,ray); setRay(ray4,1,ray); setRay(ray4,2,ray); setRay(ray4,3,ray);
+      __aligned(16) int valid4[4] = { -1,-1,-1,-1 };
+      rtcIntersect4(valid4,scene1,ray4);
+      passed &= ray4.geomID[3] == ray0.geomID && ray4.primID[3] == ray0.primID && ray4.instID[3] == ray1.instID;
+    }
+
+    /* the geometry ID of an array is not limited, but all arrays of a scene share the instance IDs */
+    RTCScene scene2 = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    for (size_t i=0; i<4096; i++) rtcNewInstance(scene2,object);
+    unsigned array0 = rtcNewInstanceArray(scene2,object,3);
+    unsigned array1 = rtcNewInstanceArray(scene2,object,5);
+    AssertNoError();
+    passed &= array0 == 4096 && rtcGetInstanceArrayBaseID(scene2,array0) == 0x80000000u;
+    passed &= array1 == 4097 && rtcGetInstanceArrayBaseID(scene2,array1) == 0x80000003u;
+    passed &= rtcNewInstanceArray(scene2,object,RTC_MAX_INSTANCE_ARRAY_SIZE-7) == RTC_INVALID_GEOMETRY_ID;
+    AssertError(RTC_INVALID_ARGUMENT);
+    passed &= rtcNewInstanceArray(scene2,object,size_t(RTC_MAX_INSTANCE_ARRAY_SIZE)+1) == RTC_INVALID_GEOMETRY_ID;
+    AssertError(RTC_INVALID_ARGUMENT);
+    passed &= rtcGetInstanceArrayBaseID(scene2,0) == RTC_INVALID_GEOMETRY_ID;
+    AssertError(RTC_INVALID_ARGUMENT);
+
+    rtcDeleteScene (scene0);
+    rtcDeleteScene (scene1);
+    rtcDeleteScene (scene2);
+    rtcDeleteScene (object);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_instance_nested(size_t numLevels, size_t N)
+  {
+    /* every level instantiates the previous level 4 times */
+    std::vector<RTCScene> scenes(numLevels+1);
+    scenes[0] = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    addSphere(scenes[0],RTC_GEOMETRY_STATIC,zero,1.0f,10);
+    rtcCommit (scenes[0]);
+    for (size_t l=1; l<=numLevels; l++) 
+    {
+      scenes[l] = rtcNewScene(RTC_SCENE_STATIC,aflags);
+      for (size_t i=0; i<4; i++) {
+        const AffineSpace3fa xfm = AffineSpace3fa::translate(Vec3fa(float(i&1),0.0f,float(i>>1))*3.0f*float(1<<(l-1)))
+          * AffineSpace3fa::rotate(Vec3fa(0,1,0),float(i)*0.5f);
+        unsigned inst = rtcNewInstance(scenes[l],scenes[l-1]);
+        rtcSetTransform(scenes[l],inst,RTC_MATRIX_COLUMN_MAJOR_ALIGNED16,(float*)&xfm);
+      }
+      rtcCommit (scenes[l]);
+    }
+    AssertNoError();
+
+    /* packets have to report the same hits as single rays */
+    RTCScene scene = scenes[numLevels];
+    const float size = 3.0f*float(1<<numLevels);
+    bool passed = true;
+    for (size_t i=0; i<N; i++) 
+    {
+      RTCRay rays[4], prims[4];
+      for (size_t j=0; j<4; j++) {
+        const Vec3fa org(size*drand48()-1.0f,10.0f,size*drand48()-1.0f);
+        const Vec3fa dir(drand48()-0.5f,-1.0f,drand48()-0.5f);
+        prims[j] = rays[j] = makeRay(org,dir);
+        rtcIntersect(scene,rays[j]);
+      }
+
+      RTCRay4 ray4; 
+      for (size_t j=0; j<4; j++) setRay(ray4,j,prims[j]);
+      __aligned(16) int valid4[4] = { -1,-1,-1,-1 };
+      rtcIntersect4(valid4,scene,ray4);
+      for (size_t j=0; j<4; j++) {
+        const RTCRay ray = getRay(ray4,j);
+        passed &= ray.geomID == rays[j].geomID && ray.primID == rays[j].primID && ray.instID == rays[j].instID;
+        passed &= ray.geomID == -1 || abs(ray.tfar-rays[j].tfar) < 1E-4f*rays[j].tfar;
+      }
+
+      RTCRay4 shadow4; 
+      for (size_t j=0; j<4; j++) setRay(shadow4,j,prims[j]);
+      rtcOccluded4(valid4,scene,shadow4);
+      for (size_t j=0; j<4; j++)
+        passed &= (shadow4.geomID[j] == 0) == (rays[j].geomID != -1);
+
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+      if (has_feature(AVX)) 
+      {
+        RTCRay8 ray8; 
+        for (size_t j=0; j<8; j++) setRay(ray8,j,prims[j%4]);
+        __aligned(32) int valid8[8] = { -1,-1,-1,-1,-1,-1,-1,-1 };
+        rtcIntersect8(valid8,scene,ray8);
+        for (size_t j=0; j<8; j++) {
+          const RTCRay ray = getRay(ray8,j);
+          passed &= ray.geomID == rays[j%4].geomID && ray.primID == rays[j%4].primID && ray.instID == rays[j%4].instID;
+        }
+      }
+#endif
+    }
+
+    for (size_t l=0; l<=numLevels; l++) 
+      rtcDeleteScene (scenes[l]);
+    AssertNoError();
+    return passed;
+  }
+
+  struct SphereSet
+  {
+    Sphere* spheres;
+    unsigned geomID;
+    size_t numCalls;
+  };
+
+  bool intersectSphere(const SphereSet* set, RTCRay& ray, size_t item)
+  {
+    const Sphere& sphere = set->spheres[item];
+    const Vec3fa org(ray.org[0],ray.org[1],ray.org[2]);
+    const Vec3fa dir(ray.dir[0],ray.dir[1],ray.dir[2]);
+    const Vec3fa v = org-sphere.pos;
+    const float A = dot(dir,dir);
+    const float B = dot(v,dir);
+    const float C = dot(v,v) - sphere.r*sphere.r;
+    const float D = B*B - A*C;
+    if (D < 0.0f) return false;
+    const float Q = sqrt(D);
+    const float t0 = (-B-Q)/A, t1 = (-B+Q)/A;
+    const float t = t0 > ray.tnear ? t0 : t1;
+    if (t <= ray.tnear || t >= ray.tfar) return false;
+    const Vec3fa Ng = org+t*dir-sphere.pos;
+    ray.tfar = t;
+    ray.u = ray.v = 0.0f;
+    ray.Ng[0] = Ng.x; ray.Ng[1] = Ng.y; ray.Ng[2] = Ng.z;
+    ray.geomID = set->geomID;
+    ray.primID = item;
+    return true;
+  }
+
+  void SphereSetBoundsFunc(SphereSet* set, size_t item, BBox3fa* bounds_o) {
+    *bounds_o = set->spheres[item].bounds();
+  }
+
+  void SphereSetIntersectFunc(SphereSet* set, RTCRay& ray, size_t item) {
+    intersectSphere(set,ray,item);
+  }
+
+  void SphereSetOccludedFunc(SphereSet* set, RTCRay& ray, size_t item) {
+    RTCRay hit = ray;
+    if (intersectSphere(set,hit,item)) ray.geomID = 0;
+  }
+
+  void SphereSetIntersectFuncN(SphereSet* set, RTCRay* rays, const RTCRayItem* items, size_t N) 
+  {
+    set->numCalls++;
+    for (size_t i=0; i<N; i++)
+      intersectSphere(set,rays[items[i].ray],items[i].item);
+  }
+
+  void SphereSetOccludedFuncN(SphereSet* set, RTCRay* rays, const RTCRayItem* items, size_t N) 
+  {
+    set->numCalls++;
+    for (size_t i=0; i<N; i++) 
+      SphereSetOccludedFunc(set,rays[items[i].ray],items[i].item);
+  }
+
+  bool rtcore_user_geometry_stream(size_t numSpheres, size_t N)
+  {
+    std::vector<Sphere> spheres(numSpheres);
+    for (size_t i=0; i<numSpheres; i++) 
+      spheres[i] = Sphere(Vec3fa(10.0f*drand48(),10.0f*drand48(),10.0f*drand48()),0.1f+0.3f*drand48());
+
+    /* the reference scene intersects each item individually */
+    SphereSet set0 = { &spheres[0], 0, 0 };
+    RTCScene scene0 = rtcNewScene(RTC_SCENE_STATIC,RTC_INTERSECT1);
+    set0.geomID = rtcNewUserGeometry (scene0,numSpheres);
+    rtcSetBoundsFunction(scene0,set0.geomID,(RTCBoundsFunc)SphereSetBoundsFunc);
+    rtcSetUserData(scene0,set0.geomID,&set0);
+    rtcSetIntersectFunction(scene0,set0.geomID,(RTCIntersectFunc)SphereSetIntersectFunc);
+    rtcSetOccludedFunction(scene0,set0.geomID,(RTCOccludedFunc)SphereSetOccludedFunc);
+    rtcCommit (scene0);
+
+    /* the second scene only provides the stream callbacks */
+    SphereSet set1 = { &spheres[0], 0, 0 };
+    RTCScene scene1 = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    set1.geomID = rtcNewUserGeometry (scene1,numSpheres);
+    rtcSetBoundsFunction(scene1,set1.geomID,(RTCBoundsFunc)SphereSetBoundsFunc);
+    rtcSetUserData(scene1,set1.geomID,&set1);
+    rtcSetIntersectFunctionN(scene1,set1.geomID,(RTCIntersectFuncN)SphereSetIntersectFuncN);
+    rtcSetOccludedFunctionN(scene1,set1.geomID,(RTCOccludedFuncN)SphereSetOccludedFuncN);
+    rtcCommit (scene1);
+    AssertNoError();
+
+    bool passed = true;
+    for (size_t i=0; i<N; i++) 
+    {
+      RTCRay rays[4], prims[4];
+      for (size_t j=0; j<4; j++) {
+        const Vec3fa org(10.0f*drand48(),10.0f*drand48(),-1.0f);
+        const Vec3fa dir(drand48()-0.5f,drand48()-0.5f,1.0f);
+        prims[j] = rays[j] = makeRay(org,dir);
+        rtcIntersect(scene0,rays[j]);
+      }
+
+      for (size_t j=0; j<4; j++) {
+        RTCRay ray = prims[j]; rtcIntersect(scene1,ray);
+        passed &= ray.geomID == rays[j].geomID && ray.primID == rays[j].primID;
+        passed &= ray.geomID == -1 || abs(ray.tfar-rays[j].tfar) < 1E-4f*rays[j].tfar;
+        RTCRay shadow = prims[j]; rtcOccluded(scene1,shadow);
+        passed &= (shadow.geomID == 0) == (rays[j].geomID != -1);
+      }
+
+      RTCRay4 ray4; 
+      for (size_t j=0; j<4; j++) setRay(ray4,j,prims[j]);
+      __aligned(16) int valid4[4] = { -1,-1,-1,-1 };
+      rtcIntersect4(valid4,scene1,ray4);
+      for (size_t j=0; j<4; j++) {
+        const RTCRay ray = getRay(ray4,j);
+        passed &= ray.geomID == rays[j].geomID && ray.primID == rays[j].primID;
+        passed &= ray.geomID == -1 || abs(ray.tfar-rays[j].tfar) < 1E-4f*rays[j].tfar;
+      }
+
+      RTCRay4 shadow4; 
+      for (size_t j=0; j<4; j++) setRay(shadow4,j,prims[j]);
+      rtcOccluded4(valid4,scene1,shadow4);
+      for (size_t j=0; j<4; j++)
+        passed &= (shadow4.geomID[j] == 0) == (rays[j].geomID != -1);
+
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+      if (has_feature(AVX)) 
+      {
+        RTCRay8 ray8; 
+        for (size_t j=0; j<8; j++) setRay(ray8,j,prims[j%4]);
+        __aligned(32) int valid8[8] = { -1,-1,-1,-1,-1,-1,-1,-1 };
+        rtcIntersect8(valid8,scene1,ray8);
+        for (size_t j=0; j<8; j++) {
+          const RTCRay ray = getRay(ray8,j);
+          passed &= ray.geomID == rays[j%4].geomID && ray.primID == rays[j%4].primID;
+        }
+      }
+#endif
+    }
+
+    /* the stream callbacks have to get invoked for batches of items */
+    passed &= set1.numCalls > 0;
+
+    rtcDeleteScene (scene0);
+    rtcDeleteScene (scene1);
+    AssertNoError();
+    return passed;
+  }
+
   bool rtcore_get_user_data()
   {
     RTCScene scene = rtcNewScene(RTC_SCENE_STATIC,RTC_INTERSECT1);
@@ -2369,26 +2862,13 @@ namespace embree
     return true;
   }
 
-  bool rtcore_backface_culling (RTCSceneFlags sflags, RTCGeometryFlags gflags)
+  bool rtcore_backface_culling_rays (RTCScene scene, float x = 0.25f, float y = 0.25f)
   {
-    /* create triangle that is front facing for a right handed 
-     coordinate system if looking along the z direction */
-    RTCScene scene = rtcNewScene(sflags,aflags);
-    unsigned mesh = rtcNewTriangleMesh (scene, gflags, 1, 3);
-    Vertex3fa*   vertices  = (Vertex3fa*  ) rtcMapBuffer(scene,mesh,RTC_VERTEX_BUFFER); 
-    Triangle* triangles = (Triangle*) rtcMapBuffer(scene,mesh,RTC_INDEX_BUFFER);
-    vertices[0].x = 0; vertices[0].y = 0; vertices[0].z = 0;
-    vertices[1].x = 0; vertices[1].y = 1; vertices[1].z = 0;
-    vertices[2].x = 1; vertices[2].y = 0; vertices[2].z = 0;
-    triangles[0].v0 = 0; triangles[0].v1 = 1; triangles[0].v2 = 2;
-    rtcUnmapBuffer(scene,mesh,RTC_VERTEX_BUFFER); 
-    rtcUnmapBuffer(scene,mesh,RTC_INDEX_BUFFER);
-    rtcCommit (scene);
-
+    /* the geometry in the scene is front facing for rays along the z direction */
     bool passed = true;
     RTCRay ray;
-    RTCRay backfacing = makeRay(Vec3fa(0.25f,0.25f,1),Vec3fa(0,0,-1)); 
-    RTCRay frontfacing = makeRay(Vec3fa(0.25f,0.25f,-1),Vec3fa(0,0,1)); 
+    RTCRay backfacing = makeRay(Vec3fa(x,y,1),Vec3fa(0,0,-1)); 
+    RTCRay frontfacing = makeRay(Vec3fa(x,y,-1),Vec3fa(0,0,1)); 
 
     ray = frontfacing; rtcOccludedN(scene,ray,1);  if (ray.geomID != 0) passed = false;
     ray = frontfacing; rtcIntersectN(scene,ray,1); if (ray.geomID != 0) passed = false;
@@ -2417,6 +2897,83 @@ namespace embree
     return passed;
   }
 
+  bool rtcore_backface_culling (RTCSceneFlags sflags, RTCGeometryFlags gflags)
+  {
+    /* create triangle that is front facing for a right handed 
+     coordinate system if looking along the z direction */
+    RTCScene scene = rtcNewScene(sflags,aflags);
+    unsigned mesh = rtcNewTriangleMesh (scene, gflags, 1, 3);
+    Vertex3fa*   vertices  = (Vertex3fa*  ) rtcMapBuffer(scene,mesh,RTC_VERTEX_BUFFER); 
+    Triangle* triangles = (Triangle*) rtcMapBuffer(scene,mesh,RTC_INDEX_BUFFER);
+    vertices[0].x = 0; vertices[0].y = 0; vertices[0].z = 0;
+    vertices[1].x = 0; vertices[1].y = 1; vertices[1].z = 0;
+    vertices[2].x = 1; vertices[2].y = 0; vertices[2].z = 0;
+    triangles[0].v0 = 0; triangles[0].v1 = 1; triangles[0].v2 = 2;
+    rtcUnmapBuffer(scene,mesh,RTC_VERTEX_BUFFER); 
+    rtcUnmapBuffer(scene,mesh,RTC_INDEX_BUFFER);
+    rtcCommit (scene);
+    AssertNoError();
+
+    bool passed = rtcore_backface_culling_rays(scene);
+    rtcDeleteScene (scene);
+    return passed;
+  }
+
+  enum BackfaceCullingGeometry { CULLING_QUADS, CULLING_MOTION_BLUR_TRIANGLES, CULLING_SUBDIV };
+
+  bool rtcore_backface_culling_geometry (RTCSceneFlags sflags, BackfaceCullingGeometry type, size_t numTimeSteps = 2)
+  {
+    /* create a unit quad with the same orientation as the triangle of rtcore_backface_culling */
+    const Vec3fa quad[4] = { Vec3fa(0,0,0), Vec3fa(0,1,0), Vec3fa(1,1,0), Vec3fa(1,0,0) };
+    RTCScene scene = rtcNewScene(sflags,aflags);
+    if (type == CULLING_QUADS)
+    {
+      unsigned mesh = rtcNewQuadMesh (scene, RTC_GEOMETRY_STATIC, 1, 4);
+      Vec3fa* vertices = (Vec3fa*) rtcMapBuffer(scene,mesh,RTC_VERTEX_BUFFER); 
+      int* indices = (int*) rtcMapBuffer(scene,mesh,RTC_INDEX_BUFFER);
+      for (size_t i=0; i<4; i++) { vertices[i] = quad[i]; indices[i] = i; }
+      rtcUnmapBuffer(scene,mesh,RTC_VERTEX_BUFFER); 
+      rtcUnmapBuffer(scene,mesh,RTC_INDEX_BUFFER);
+    }
+    else if (type == CULLING_MOTION_BLUR_TRIANGLES)
+    {
+      unsigned mesh = rtcNewTriangleMesh (scene, RTC_GEOMETRY_STATIC, 2, 4, numTimeSteps);
+      Triangle* triangles = (Triangle*) rtcMapBuffer(scene,mesh,RTC_INDEX_BUFFER);
+      triangles[0].v0 = 0; triangles[0].v1 = 1; triangles[0].v2 = 2;
+      triangles[1].v0 = 0; triangles[1].v1 = 2; triangles[1].v2 = 3;
+      rtcUnmapBuffer(scene,mesh,RTC_INDEX_BUFFER);
+      for (size_t t=0; t<numTimeSteps; t++) {
+        Vec3fa* vertices = (Vec3fa*) rtcMapBuffer(scene,mesh,(RTCBufferType)(RTC_VERTEX_BUFFER0+t));
+        for (size_t i=0; i<4; i++) vertices[i] = quad[i];
+        rtcUnmapBuffer(scene,mesh,(RTCBufferType)(RTC_VERTEX_BUFFER0+t));
+      }
+    }
+    else
+    {
+      unsigned mesh = rtcNewSubdivisionMesh (scene, RTC_GEOMETRY_STATIC, 1, 4, 4, 0, 0, 0);
+      Vec3fa* vertices = (Vec3fa*) rtcMapBuffer(scene,mesh,RTC_VERTEX_BUFFER); 
+      int* indices = (int*) rtcMapBuffer(scene,mesh,RTC_INDEX_BUFFER);
+      int* faces = (int*) rtcMapBuffer(scene,mesh,RTC_FACE_BUFFER);
+      float* levels = (float*) rtcMapBuffer(scene,mesh,RTC_LEVEL_BUFFER);
+      for (size_t i=0; i<4; i++) { vertices[i] = quad[i]; indices[i] = i; levels[i] = 8.0f; }
+      faces[0] = 4;
+      rtcUnmapBuffer(scene,mesh,RTC_VERTEX_BUFFER); 
+      rtcUnmapBuffer(scene,mesh,RTC_INDEX_BUFFER);
+      rtcUnmapBuffer(scene,mesh,RTC_FACE_BUFFER);
+      rtcUnmapBuffer(scene,mesh,RTC_LEVEL_BUFFER);
+    }
+    rtcCommit (scene);
+    AssertNoError();
+
+    /* hit different triangles of the quads and the tessellated grids */
+    bool passed = true;
+    for (float x=0.35f; x<0.7f; x+=0.1f) 
+      for (float y=0.35f; y<0.7f; y+=0.1f) 
+        passed &= rtcore_backface_culling_rays(scene,x+0.01f*y,y);
+    rtcDeleteScene (scene);
+    return passed;
+  }
+
   void rtcore_backface_culling_all ()
   {
     printf("%30s ... ","backface_culling");
@@ -2433,28 +2990,1164 @@ namespace embree
     numFailedTests += !passed;
   }
 
-  bool rtcore_new_delete_geometry()
+  bool rtcore_mixed_accels(size_t N)
   {
-    RTCScene scene = rtcNewScene(RTC_SCENE_DYNAMIC,aflags);
+    /* scene that mixes triangles, hair, motion blur triangles and motion blur hair */
+    RTCScene scene = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(-1.0f,0.0f,0.0f),0.5f,50);
+    addHair  (scene,RTC_GEOMETRY_STATIC,Vec3fa(0.5f,-0.5f,-0.5f),0.1f,0.02f,50);
+    addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(0.0f,1.0f,0.0f),0.4f,50,-1,0.5f);
+    addHair  (scene,RTC_GEOMETRY_STATIC,Vec3fa(-1.5f,-1.5f,-1.5f),0.1f,0.02f,50,1.0f);
+    rtcCommit (scene);
     AssertNoError();
-    int geom[128];
-    for (size_t i=0; i<128; i++) geom[i] = -1;
-    Sphere spheres[128];
-    memset(spheres,0,sizeof(spheres));
 
-    for (size_t i=0; i<50; i++) {
-      for (size_t j=0; j<10; j++) {
-        int index = random<int>()%128;
-        Vec3fa pos = 100.0f*Vec3fa(drand48(),drand48(),drand48());
-        if (geom[index] == -1) {
-          switch (random<int>()%4) {
-          case 0: geom[index] = addSphere(scene,RTC_GEOMETRY_STATIC,pos,2.0f,10); break;
-          case 1: geom[index] = addHair  (scene,RTC_GEOMETRY_STATIC,pos,1.0f,2.0f,10); break;
-	  case 2: geom[index] = addSubdivSphere(scene,RTC_GEOMETRY_STATIC,pos,2.0f,4,4); break;
-          case 3: 
-	    spheres[index] = Sphere(pos,2.0f);
-	    geom[index] = addUserGeometryEmpty(scene,&spheres[index]); break;
-          }
+    /* the same geometries each in its own scene */
+    RTCScene scenes[4];
+    for (size_t i=0; i<4; i++) scenes[i] = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    addSphere(scenes[0],RTC_GEOMETRY_STATIC,Vec3fa(-1.0f,0.0f,0.0f),0.5f,50);
+    addHair  (scenes[1],RTC_GEOMETRY_STATIC,Vec3fa(0.5f,-0.5f,-0.5f),0.1f,0.02f,50);
+    addSphere(scenes[2],RTC_GEOMETRY_STATIC,Vec3fa(0.0f,1.0f,0.0f),0.4f,50,-1,0.5f);
+    addHair  (scenes[3],RTC_GEOMETRY_STATIC,Vec3fa(-1.5f,-1.5f,-1.5f),0.1f,0.02f,50,1.0f);
+    for (size_t i=0; i<4; i++) rtcCommit (scenes[i]);
+    AssertNoError();
+
+    bool passed = true;
+    std::vector<RTCRay> rays(N), refs(N);
+    for (size_t i=0; i<N; i++) 
+    {
+      Vec3fa org(4.0f*drand48()-2.0f,4.0f*drand48()-2.0f,4.0f*drand48()-2.0f);
+      Vec3fa dir(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+      rays[i] = refs[i] = makeRay(org,dir);
+      rays[i].time = refs[i].time = drand48();
+
+      /* closest hit over all single geometry scenes */
+      float tfar[4];
+      for (size_t j=0; j<4; j++) {
+        RTCRay ray = rays[i]; rtcIntersect(scenes[j],ray);
+        tfar[j] = ray.geomID == RTC_INVALID_GEOMETRY_ID ? float(inf) : ray.tfar;
+        if (tfar[j] < refs[i].tfar) { refs[i].tfar = tfar[j]; refs[i].geomID = j; }
+      }
+      
+      /* skip rays with ambiguous closest hit */
+      bool ambiguous = false;
+      for (size_t j=0; j<4; j++) 
+        ambiguous |= j != refs[i].geomID && tfar[j] != float(inf) && abs(tfar[j]-refs[i].tfar) < 1E-3f;
+      if (ambiguous) rays[i].tnear = refs[i].tnear = rays[i].tfar = refs[i].tfar = 0.0f;
+
+      RTCRay ray = rays[i]; rtcIntersect(scene,ray);
+      if (!ambiguous) passed &= ray.geomID == refs[i].geomID;
+      ray = rays[i]; rtcOccluded(scene,ray);
+      if (!ambiguous) passed &= (ray.geomID == 0) == (refs[i].geomID != RTC_INVALID_GEOMETRY_ID);
+    }
+
+    /* packets are also culled against the bounds of each accel */
+    std::vector<RTCRay> stream = rays;
+    ::rtcIntersectN(scene,&stream[0],N,sizeof(RTCRay));
+    for (size_t i=0; i<N; i++) 
+      if (refs[i].tfar != 0.0f) passed &= stream[i].geomID == refs[i].geomID;
+
+    stream = rays;
+    ::rtcOccludedN(scene,&stream[0],N,sizeof(RTCRay));
+    for (size_t i=0; i<N; i++) 
+      if (refs[i].tfar != 0.0f) passed &= (stream[i].geomID == 0) == (refs[i].geomID != RTC_INVALID_GEOMETRY_ID);
+    AssertNoError();
+
+    for (size_t i=0; i<4; i++) rtcDeleteScene (scenes[i]);
+    rtcDeleteScene (scene);
+    return passed;
+  }
+
+  RTCScene createCachedScene(RTCSceneFlags sflags, const char* fileName, float radius)
+  {
+    RTCScene scene = rtcNewScene(sflags,aflags);
+    if (fileName) rtcSetSceneCacheFile(scene,fileName);
+    addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(-0.5f,0.0f,0.0f),radius,50);
+    addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(+0.5f,0.0f,0.0f),0.4f,50);
+    rtcCommit (scene);
+    return scene;
+  }
+
+  bool rtcore_scene_cache(RTCSceneFlags sflags, size_t N)
+  {
+    const char* fileName = "verify_scene_cache.bin";
+    std::remove(fileName);
+
+    /* first commit writes the cache file */
+    RTCScene scene0 = createCachedScene(sflags,fileName,0.4f);
+    long bytes = 0;
+    FILE* file = fopen(fileName,"ab");
+    if (file) {
+      fseek(file,0,SEEK_END);
+      bytes = ftell(file);
+      fputc(0x5a,file);
+      fclose(file);
+    }
+    const bool written = bytes > 0;
+
+    /* second commit maps the file, a rewritten file would lose the appended marker byte */
+    RTCScene scene1 = createCachedScene(sflags,fileName,0.4f);
+    bool hit = false;
+    file = fopen(fileName,"rb");
+    if (file) {
+      fseek(file,bytes,SEEK_SET);
+      hit = fgetc(file) == 0x5a;
+      fclose(file);
+    }
+
+    RTCScene scene2 = createCachedScene(sflags,NULL,0.4f);
+
+    /* modified geometry does not use the cache file */
+    RTCScene scene3 = createCachedScene(sflags,fileName,0.3f);
+    RTCScene scene4 = createCachedScene(sflags,NULL,0.3f);
+    AssertNoError();
+
+    bool passed = written && hit;
+    for (size_t i=0; i<N; i++) 
+    {
+      Vec3fa org(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+      Vec3fa dir(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+      RTCRay ray0 = makeRay(org,dir); rtcIntersect(scene0,ray0);
+      RTCRay ray1 = makeRay(org,dir); rtcIntersect(scene1,ray1);
+      RTCRay ray2 = makeRay(org,dir); rtcIntersect(scene2,ray2);
+      RTCRay ray3 = makeRay(org,dir); rtcIntersect(scene3,ray3);
+      RTCRay ray4 = makeRay(org,dir); rtcIntersect(scene4,ray4);
+      passed &= ray0.geomID == ray2.geomID && ray0.primID == ray2.primID;
+      passed &= ray1.geomID == ray2.geomID && ray1.primID == ray2.primID;
+      passed &= ray3.geomID == ray4.geomID && ray3.primID == ray4.primID;
+      if (ray1.geomID != RTC_INVALID_GEOMETRY_ID) passed &= ray1.tfar == ray2.tfar;
+    }
+    AssertNoError();
+
+    rtcDeleteScene (scene0);
+    rtcDeleteScene (scene1);
+    rtcDeleteScene (scene2);
+    rtcDeleteScene (scene3);
+    rtcDeleteScene (scene4);
+    std::remove(fileName);
+    return passed;
+  }
+
+  bool rtcore_scene_cache_corrupted(RTCSceneFlags sflags, size_t N)
+  {
+    const char* fileName = "verify_scene_cache_corrupted.bin";
+    bool passed = true;
+    for (size_t i=0; i<N; i++)
+    {
+      std::remove(fileName);
+      RTCScene scene0 = createCachedScene(sflags,fileName,0.4f);
+      rtcDeleteScene (scene0);
+
+      /* overwrite random words behind the file header, the hash of the scene still matches */
+      FILE* file = fopen(fileName,"r+b");
+      if (!file) return false;
+      fseek(file,0,SEEK_END);
+      const long bytes = ftell(file);
+      for (size_t j=0; j<16; j++) {
+        const int word = int(drand48()*double(1u<<31));
+        fseek(file,(1024+long(drand48()*(bytes-1024-sizeof(int))))&~3L,SEEK_SET);
+        fwrite(&word,sizeof(word),1,file);
+      }
+      fclose(file);
+
+      /* the corrupted file either gets rejected or yields a traversable hierarchy */
+      RTCScene scene1 = createCachedScene(sflags,fileName,0.4f);
+      AssertNoError();
+      for (size_t k=0; k<100; k++) {
+        Vec3fa org(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+        Vec3fa dir(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+        RTCRay ray = makeRay(org,dir); rtcIntersect(scene1,ray);
+      }
+      passed &= rtcGetError() == RTC_NO_ERROR;
+      rtcDeleteScene (scene1);
+    }
+    std::remove(fileName);
+    return passed;
+  }
+
+  bool rtcore_tessellation_cache(size_t N)
+  {
+    /* dynamic scenes trace subdivision surfaces through the tessellation cache */
+    RTCScene scene = rtcNewScene(RTC_SCENE_DYNAMIC,aflags);
+    for (size_t i=0; i<16; i++)
+      addSubdivSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(3.0f*(i%4),0.0f,3.0f*(i/4)),1.0f,8,16);
+    rtcCommit (scene);
+    AssertNoError();
+
+    RTCTessellationCacheStatistics stats;
+    rtcGetTessellationCacheStatistics(&stats);
+    const size_t defaultSize = stats.size;
+    rtcSetTessellationCacheSize(1024);
+    AssertError(RTC_INVALID_ARGUMENT);
+
+    /* trace with default cache */
+    std::vector<Vec3fa> org(N);
+    std::vector<unsigned> primID(N);
+    std::vector<float> tfar(N);
+    for (size_t i=0; i<N; i++) {
+      org[i] = Vec3fa(12.0f*drand48()-1.5f,5.0f,12.0f*drand48()-1.5f);
+      RTCRay ray = makeRay(org[i],Vec3fa(0,-1,0)); rtcIntersect(scene,ray);
+      primID[i] = ray.primID; tfar[i] = ray.tfar;
+    }
+    AssertNoError();
+
+    /* trace again with a small cache that has to get flushed */
+    rtcSetTessellationCacheSize(2*1024*1024);
+    rtcResetTessellationCacheStatistics();
+    AssertNoError();
+
+    bool passed = true;
+    for (size_t i=0; i<N; i++) {
+      RTCRay ray = makeRay(org[i],Vec3fa(0,-1,0)); rtcIntersect(scene,ray);
+      passed &= ray.primID == primID[i] && ray.tfar == tfar[i];
+    }
+    rtcGetTessellationCacheStatistics(&stats);
+    passed &= stats.size == 2*1024*1024 && stats.bytesUsed <= stats.size;
+    passed &= stats.hits > 0 && stats.misses > 0 && stats.flushes > 0;
+
+    rtcResetTessellationCacheStatistics();
+    rtcGetTessellationCacheStatistics(&stats);
+    passed &= stats.hits == 0 && stats.misses == 0 && stats.copies == 0 && stats.flushes == 0;
+
+    rtcSetTessellationCacheSize(defaultSize);
+    AssertNoError();
+
+    /* every lookup of the first ray counts once, thus the same ray again hits as often as the first one looked up patches */
+    RTCTessellationCacheStatistics stats0, stats1;
+    rtcResetTessellationCacheStatistics();
+    RTCRay ray0 = makeRay(Vec3fa(0.1f,5.0f,0.1f),Vec3fa(0,-1,0)); rtcIntersect(scene,ray0);
+    rtcGetTessellationCacheStatistics(&stats0);
+    RTCRay ray1 = makeRay(Vec3fa(0.1f,5.0f,0.1f),Vec3fa(0,-1,0)); rtcIntersect(scene,ray1);
+    rtcGetTessellationCacheStatistics(&stats1);
+    passed &= ray0.geomID != RTC_INVALID_GEOMETRY_ID && stats0.misses > 0;
+    passed &= stats1.misses == stats0.misses && stats1.hits-stats0.hits == stats0.hits+stats0.misses;
+
+    rtcDeleteScene (scene);
+    return passed;
+  }
+
+  bool rtcore_quantized_nodes(size_t N)
+  {
+    /* compact static scenes store the BVH with quantized nodes */
+    RTCScene scenes[2];
+    scenes[0] = rtcNewScene(RTC_SCENE_STATIC | RTC_SCENE_ROBUST | RTC_SCENE_COMPACT,aflags);
+    scenes[1] = rtcNewScene(RTC_SCENE_STATIC | RTC_SCENE_ROBUST,aflags);
+    const Vec3fa pos[3] = { Vec3fa(0.0f,0.0f,0.0f), Vec3fa(1000.0f,1000.0f,1000.0f), Vec3fa(1000.0f,1000.0f,1000.51f) };
+    const float radius[3] = { 1.0f, 0.5f, 0.001f };
+    for (size_t i=0; i<2; i++) {
+      for (size_t j=0; j<3; j++) addSphere(scenes[i],RTC_GEOMETRY_STATIC,pos[j],radius[j],50);
+      rtcCommit (scenes[i]);
+    }
+    AssertNoError();
+
+    /* rays start inside the closed and disjoint spheres, thus conservative bounds are required to always hit,
+       rays through an edge may report either triangle */
+    bool passed = true;
+    std::vector<RTCRay> rays(N);
+    for (size_t i=0; i<N; i++) {
+      const size_t j = i%3;
+      Vec3fa org(drand48()-0.5f,drand48()-0.5f,drand48()-0.5f);
+      Vec3fa dir(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+      rays[i] = makeRay(pos[j]+radius[j]*org,dir);
+    }
+
+    for (size_t i=0; i<N; i++) {
+      RTCRay ray0 = rays[i]; rtcIntersect(scenes[0],ray0);
+      RTCRay ray1 = rays[i]; rtcIntersect(scenes[1],ray1);
+      passed &= ray0.geomID == i%3 && ray0.geomID == ray1.geomID && ray0.tfar == ray1.tfar;
+      RTCRay shadow = rays[i]; rtcOccluded(scenes[0],shadow);
+      passed &= shadow.geomID == 0;
+    }
+
+#if !defined(__MIC__)
+    for (size_t i=0; i+4<=N; i+=4) {
+      RTCRay4 ray4, shadow4;
+      for (size_t j=0; j<4; j++) { setRay(ray4,j,rays[i+j]); setRay(shadow4,j,rays[i+j]); }
+      __aligned(16) int valid4[4] = { -1,-1,-1,-1 };
+      rtcIntersect4(valid4,scenes[0],ray4);
+      rtcOccluded4(valid4,scenes[0],shadow4);
+      for (size_t j=0; j<4; j++) {
+        RTCRay ray1 = rays[i+j]; rtcIntersect(scenes[1],ray1);
+        passed &= ray4.geomID[j] == ray1.geomID && ray4.tfar[j] == ray1.tfar;
+        passed &= shadow4.geomID[j] == 0;
+      }
+    }
+#endif
+
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+    if (has_feature(AVX))
+    {
+      for (size_t i=0; i+8<=N; i+=8) {
+        RTCRay8 ray8, shadow8;
+        for (size_t j=0; j<8; j++) { setRay(ray8,j,rays[i+j]); setRay(shadow8,j,rays[i+j]); }
+        __aligned(32) int valid8[8] = { -1,-1,-1,-1,-1,-1,-1,-1 };
+        rtcIntersect8(valid8,scenes[0],ray8);
+        rtcOccluded8(valid8,scenes[0],shadow8);
+        for (size_t j=0; j<8; j++) {
+          RTCRay ray1 = rays[i+j]; rtcIntersect(scenes[1],ray1);
+          passed &= ray8.geomID[j] == ray1.geomID && ray8.tfar[j] == ray1.tfar;
+          passed &= shadow8.geomID[j] == 0;
+        }
+      }
+    }
+#endif
+    AssertNoError();
+
+    rtcDeleteScene (scenes[0]);
+    rtcDeleteScene (scenes[1]);
+    return passed;
+  }
+
+  bool rtcore_quad_mesh(RTCSceneFlags sflags, size_t N)
+  {
+    /* the same bumpy grid once as quad mesh and once split into triangles v0,v1,v3 and v2,v3,v1 */
+    const size_t num = 32;
+    RTCScene scene0 = rtcNewScene(sflags,aflags);
+    RTCScene scene1 = rtcNewScene(sflags,aflags);
+    unsigned mesh0 = rtcNewQuadMesh (scene0, RTC_GEOMETRY_STATIC, num*num, (num+1)*(num+1));
+    unsigned mesh1 = rtcNewTriangleMesh (scene1, RTC_GEOMETRY_STATIC, 2*num*num, (num+1)*(num+1));
+    Vertex3fa* vertices0 = (Vertex3fa*) rtcMapBuffer(scene0,mesh0,RTC_VERTEX_BUFFER);
+    Vertex3fa* vertices1 = (Vertex3fa*) rtcMapBuffer(scene1,mesh1,RTC_VERTEX_BUFFER);
+    int* quads = (int*) rtcMapBuffer(scene0,mesh0,RTC_INDEX_BUFFER);
+    Triangle* triangles = (Triangle*) rtcMapBuffer(scene1,mesh1,RTC_INDEX_BUFFER);
+    for (size_t z=0; z<=num; z++) {
+      for (size_t x=0; x<=num; x++) {
+        const Vec3fa p(float(x),0.5f*sinf(1.3f*x)*cosf(0.7f*z)+0.2f*float(drand48()),float(z));
+        vertices0[z*(num+1)+x] = vertices1[z*(num+1)+x] = p;
+      }
+    }
+    for (size_t z=0; z<num; z++) {
+      for (size_t x=0; x<num; x++) {
+        const int v0 = z*(num+1)+x, v1 = v0+1, v2 = v1+(num+1), v3 = v0+(num+1);
+        const size_t i = z*num+x;
+        quads[4*i+0] = v0; quads[4*i+1] = v1; quads[4*i+2] = v2; quads[4*i+3] = v3;
+        triangles[2*i+0].v0 = v0; triangles[2*i+0].v1 = v1; triangles[2*i+0].v2 = v3;
+        triangles[2*i+1].v0 = v2; triangles[2*i+1].v1 = v3; triangles[2*i+1].v2 = v1;
+      }
+    }
+    rtcUnmapBuffer(scene0,mesh0,RTC_VERTEX_BUFFER);
+    rtcUnmapBuffer(scene1,mesh1,RTC_VERTEX_BUFFER);
+    rtcUnmapBuffer(scene0,mesh0,RTC_INDEX_BUFFER);
+    rtcUnmapBuffer(scene1,mesh1,RTC_INDEX_BUFFER);
+    rtcCommit (scene0);
+    rtcCommit (scene1);
+    AssertNoError();
+
+    /* quads only support a single time step */
+    rtcNewQuadMesh (scene0, RTC_GEOMETRY_STATIC, 1, 4, 2);
+    AssertAnyError();
+
+    std::vector<RTCRay> rays(N);
+    for (size_t i=0; i<N; i++) {
+      Vec3fa org(num*drand48(),5.0f,num*drand48());
+      Vec3fa dir(0.4f*drand48()-0.2f,-1.0f,0.4f*drand48()-0.2f);
+      rays[i] = makeRay(org,dir);
+    }
+
+    /* quad hits have to match the triangle hits, the second triangle maps to the quad coordinates 1-u,1-v */
+    bool passed = true;
+    auto compare = [&] (unsigned geomID, unsigned primID, float tfar, float u, float v, const RTCRay& ray1) -> bool
+    {
+      if (ray1.geomID == RTC_INVALID_GEOMETRY_ID) return geomID == RTC_INVALID_GEOMETRY_ID;
+      const float u1 = (ray1.primID & 1) ? 1.0f-ray1.u : ray1.u;
+      const float v1 = (ray1.primID & 1) ? 1.0f-ray1.v : ray1.v;
+      return geomID == mesh0 && primID == ray1.primID/2 && fabsf(tfar-ray1.tfar) < 1E-4f && fabsf(u-u1) < 1E-4f && fabsf(v-v1) < 1E-4f;
+    };
+
+    for (size_t i=0; i<N; i++) {
+      RTCRay ray0 = rays[i]; rtcIntersect(scene0,ray0);
+      RTCRay ray1 = rays[i]; rtcIntersect(scene1,ray1);
+      passed &= compare(ray0.geomID,ray0.primID,ray0.tfar,ray0.u,ray0.v,ray1);
+      RTCRay shadow = rays[i]; rtcOccluded(scene0,shadow);
+      passed &= (shadow.geomID == 0) == (ray1.geomID != RTC_INVALID_GEOMETRY_ID);
+    }
+
+#if !defined(__MIC__)
+    for (size_t i=0; i+4<=N; i+=4) {
+      RTCRay4 ray4, shadow4;
+      for (size_t j=0; j<4; j++) { setRay(ray4,j,rays[i+j]); setRay(shadow4,j,rays[i+j]); }
+      __aligned(16) int valid4[4] = { -1,-1,-1,-1 };
+      rtcIntersect4(valid4,scene0,ray4);
+      rtcOccluded4(valid4,scene0,shadow4);
+      for (size_t j=0; j<4; j++) {
+        RTCRay ray1 = rays[i+j]; rtcIntersect(scene1,ray1);
+        passed &= compare(ray4.geomID[j],ray4.primID[j],ray4.tfar[j],ray4.u[j],ray4.v[j],ray1);
+        passed &= (shadow4.geomID[j] == 0) == (ray1.geomID != RTC_INVALID_GEOMETRY_ID);
+      }
+    }
+#endif
+
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+    if (has_feature(AVX))
+    {
+      for (size_t i=0; i+8<=N; i+=8) {
+        RTCRay8 ray8, shadow8;
+        for (size_t j=0; j<8; j++) { setRay(ray8,j,rays[i+j]); setRay(shadow8,j,rays[i+j]); }
+        __aligned(32) int valid8[8] = { -1,-1,-1,-1,-1,-1,-1,-1 };
+        rtcIntersect8(valid8,scene0,ray8);
+        rtcOccluded8(valid8,scene0,shadow8);
+        for (size_t j=0; j<8; j++) {
+          RTCRay ray1 = rays[i+j]; rtcIntersect(scene1,ray1);
+          passed &= compare(ray8.geomID[j],ray8.primID[j],ray8.tfar[j],ray8.u[j],ray8.v[j],ray1);
+          passed &= (shadow8.geomID[j] == 0) == (ray1.geomID != RTC_INVALID_GEOMETRY_ID);
+        }
+      }
+    }
+#endif
+    AssertNoError();
+
+    rtcDeleteScene (scene0);
+    rtcDeleteScene (scene1);
+    return passed;
+  }
+
+  bool rtcore_interpolate(size_t N)
+  {
+    /* a bumpy grid once as quad mesh and once as triangle mesh, and a subdivision cube */
+    const size_t num = 32;
+    const size_t numVertices = (num+1)*(num+1);
+    RTCScene scene0 = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    RTCScene scene1 = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    RTCScene scene2 = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    unsigned mesh0 = rtcNewQuadMesh (scene0, RTC_GEOMETRY_STATIC, num*num, numVertices);
+    unsigned mesh1 = rtcNewTriangleMesh (scene1, RTC_GEOMETRY_STATIC, 2*num*num, numVertices);
+    unsigned mesh2 = rtcNewSubdivisionMesh(scene2, RTC_GEOMETRY_STATIC, 6, 24, 8, 0, 0, 0);
+
+    /* the interpolated attribute is the position plus a constant 4th component, padded by one vertex */
+    std::vector<float> attr0(4*(numVertices+1),0.0f);
+    Vertex3fa* vertices0 = (Vertex3fa*) rtcMapBuffer(scene0,mesh0,RTC_VERTEX_BUFFER);
+    Vertex3fa* vertices1 = (Vertex3fa*) rtcMapBuffer(scene1,mesh1,RTC_VERTEX_BUFFER);
+    std::vector<int> quads(4*num*num);
+    std::vector<Triangle> triangles(2*num*num);
+    for (size_t z=0; z<=num; z++) {
+      for (size_t x=0; x<=num; x++) {
+        const size_t i = z*(num+1)+x;
+        const Vec3fa p(float(x),0.5f*sinf(1.3f*x)*cosf(0.7f*z)+0.2f*float(drand48()),float(z));
+        vertices0[i] = vertices1[i] = p;
+        attr0[4*i+0] = p.x; attr0[4*i+1] = p.y; attr0[4*i+2] = p.z; attr0[4*i+3] = 1.0f;
+      }
+    }
+    for (size_t z=0; z<num; z++) {
+      for (size_t x=0; x<num; x++) {
+        const int v0 = z*(num+1)+x, v1 = v0+1, v2 = v1+(num+1), v3 = v0+(num+1);
+        const size_t i = z*num+x;
+        quads[4*i+0] = v0; quads[4*i+1] = v1; quads[4*i+2] = v2; quads[4*i+3] = v3;
+        triangles[2*i+0].v0 = v0; triangles[2*i+0].v1 = v1; triangles[2*i+0].v2 = v3;
+        triangles[2*i+1].v0 = v2; triangles[2*i+1].v1 = v3; triangles[2*i+1].v2 = v1;
+      }
+    }
+    rtcUnmapBuffer(scene0,mesh0,RTC_VERTEX_BUFFER);
+    rtcUnmapBuffer(scene1,mesh1,RTC_VERTEX_BUFFER);
+
+    /* the index buffers are shared as static scenes release mapped index buffers after the commit */
+    rtcSetBuffer(scene0,mesh0,RTC_INDEX_BUFFER,quads.data(),0,4*sizeof(int));
+    rtcSetBuffer(scene1,mesh1,RTC_INDEX_BUFFER,triangles.data(),0,sizeof(Triangle));
+
+    const Vec3fa cubeVertices[8] = { Vec3fa(-1,-1,-1), Vec3fa(+1,-1,-1), Vec3fa(+1,-1,+1), Vec3fa(-1,-1,+1),
+                                     Vec3fa(-1,+1,-1), Vec3fa(+1,+1,-1), Vec3fa(+1,+1,+1), Vec3fa(-1,+1,+1) };
+    const int cubeIndices[24] = { 0,1,5,4, 1,2,6,5, 2,3,7,6, 0,4,7,3, 4,5,6,7, 0,3,2,1 };
+    std::vector<float> attr2(4*(8+1),0.0f);
+    Vec3fa* vertices2 = (Vec3fa*) rtcMapBuffer(scene2,mesh2,RTC_VERTEX_BUFFER);
+    int* indices2 = (int*) rtcMapBuffer(scene2,mesh2,RTC_INDEX_BUFFER);
+    int* faces2 = (int*) rtcMapBuffer(scene2,mesh2,RTC_FACE_BUFFER);
+    float* levels2 = (float*) rtcMapBuffer(scene2,mesh2,RTC_LEVEL_BUFFER);
+    for (size_t i=0; i<8; i++) {
+      const Vec3fa p = cubeVertices[i];
+      vertices2[i] = p;
+      attr2[4*i+0] = p.x; attr2[4*i+1] = p.y; attr2[4*i+2] = p.z; attr2[4*i+3] = 1.0f;
+    }
+    for (size_t i=0; i<24; i++) { indices2[i] = cubeIndices[i]; levels2[i] = 16.0f; }
+    for (size_t i=0; i<6; i++) faces2[i] = 4;
+    rtcUnmapBuffer(scene2,mesh2,RTC_VERTEX_BUFFER);
+    rtcUnmapBuffer(scene2,mesh2,RTC_INDEX_BUFFER);
+    rtcUnmapBuffer(scene2,mesh2,RTC_FACE_BUFFER);
+    rtcUnmapBuffer(scene2,mesh2,RTC_LEVEL_BUFFER);
+    rtcCommit (scene0);
+    rtcCommit (scene1);
+    rtcCommit (scene2);
+    AssertNoError();
+
+    /* the interpolated positions have to match the hit points and the derivatives have to be tangential */
+    auto test = [&] (RTCScene scene, unsigned geomID, const std::vector<float>& attr, const std::vector<RTCRay>& rays, float eps) -> bool
+    {
+      std::vector<unsigned> primIDs; std::vector<float> us, vs; std::vector<Vec3fa> hits, normals;
+      for (size_t i=0; i<rays.size(); i++) {
+        RTCRay ray = rays[i]; rtcIntersect(scene,ray);
+        if (ray.geomID != geomID) continue;
+        primIDs.push_back(ray.primID); us.push_back(ray.u); vs.push_back(ray.v);
+        hits.push_back(Vec3fa(ray.org[0],ray.org[1],ray.org[2])+ray.tfar*Vec3fa(ray.dir[0],ray.dir[1],ray.dir[2]));
+        normals.push_back(normalize(Vec3fa(ray.Ng[0],ray.Ng[1],ray.Ng[2])));
+      }
+      const size_t M = primIDs.size();
+      if (M == 0) return false;
+      std::vector<float> P(4*M), dPdu(4*M), dPdv(4*M);
+      rtcInterpolateN(scene,geomID,primIDs.data(),us.data(),vs.data(),M,attr.data(),4*sizeof(float),P.data(),dPdu.data(),dPdv.data(),4);
+      rtcInterpolateN(scene,geomID,primIDs.data(),us.data(),vs.data(),M,attr.data(),4*sizeof(float),NULL,NULL,NULL,4);
+      AssertNoError();
+      for (size_t i=0; i<M; i++) {
+        const Vec3fa Pi(P[0*M+i],P[1*M+i],P[2*M+i]);
+        const Vec3fa du(dPdu[0*M+i],dPdu[1*M+i],dPdu[2*M+i]);
+        const Vec3fa dv(dPdv[0*M+i],dPdv[1*M+i],dPdv[2*M+i]);
+        if (length(Pi-hits[i]) > eps) return false;
+        if (fabsf(P[3*M+i]-1.0f) > 1E-4f || fabsf(dPdu[3*M+i]) > 1E-4f || fabsf(dPdv[3*M+i]) > 1E-4f) return false;
+        if (fabsf(dot(du,normals[i])) > 10.0f*eps*length(du)) return false;
+        if (fabsf(dot(dv,normals[i])) > 10.0f*eps*length(dv)) return false;
+      }
+      return true;
+    };
+
+    std::vector<RTCRay> rays0(N), rays2(N);
+    for (size_t i=0; i<N; i++) {
+      Vec3fa org(num*drand48(),5.0f,num*drand48());
+      Vec3fa dir(0.4f*drand48()-0.2f,-1.0f,0.4f*drand48()-0.2f);
+      rays0[i] = makeRay(org,dir);
+      Vec3fa org2 = 5.0f*normalize(Vec3fa(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f));
+      Vec3fa dst2(0.2f*drand48()-0.1f,0.2f*drand48()-0.1f,0.2f*drand48()-0.1f);
+      rays2[i] = makeRay(org2,dst2-org2);
+    }
+
+    bool passed = true;
+    passed &= test(scene0,mesh0,attr0,rays0,1E-3f);
+    passed &= test(scene1,mesh1,attr0,rays0,1E-3f);
+    passed &= test(scene2,mesh2,attr2,rays2,1E-2f);
+
+    /* the derivatives of subdivision meshes match finite differences and locations outside of the face are clamped to it */
+    const float h = 1E-3f;
+    const unsigned facePrimIDs[7] = { 2, 2, 2, 2, 2, 2, 2 };
+    const float faceU[7] = { 0.3f, 0.3f+h, 0.3f-h, 0.3f, 0.3f, 1.2f, 1.0f };
+    const float faceV[7] = { 0.7f, 0.7f, 0.7f, 0.7f+h, 0.7f-h, -0.1f, 0.0f };
+    float P3[4*7], dPdu3[4*7], dPdv3[4*7];
+    for (size_t i=0; i<4*7; i++) P3[i] = dPdu3[i] = dPdv3[i] = nan;
+    rtcInterpolateN(scene2,mesh2,facePrimIDs,faceU,faceV,7,attr2.data(),4*sizeof(float),P3,dPdu3,dPdv3,4);
+    AssertNoError();
+    for (size_t j=0; j<4; j++) {
+      passed &= fabsf((P3[j*7+1]-P3[j*7+2])/(2.0f*h) - dPdu3[j*7+0]) < 1E-2f;
+      passed &= fabsf((P3[j*7+3]-P3[j*7+4])/(2.0f*h) - dPdv3[j*7+0]) < 1E-2f;
+      passed &= P3[j*7+5] == P3[j*7+6] && dPdu3[j*7+5] == dPdu3[j*7+6] && dPdv3[j*7+5] == dPdv3[j*7+6];
+    }
+
+    /* invalid geometry and primitive IDs and uncommitted scenes get rejected */
+    const unsigned badPrimIDs[3] = { 0, 2*num*num, 6 };
+    const float uv[1] = { 0.5f };
+    float Pbad[4];
+    rtcInterpolateN(scene0,mesh0+1,badPrimIDs,uv,uv,1,attr0.data(),4*sizeof(float),Pbad,NULL,NULL,4);
+    AssertError(RTC_INVALID_ARGUMENT);
+    rtcInterpolateN(scene0,mesh0,&badPrimIDs[1],uv,uv,1,attr0.data(),4*sizeof(float),Pbad,NULL,NULL,4);
+    AssertError(RTC_INVALID_ARGUMENT);
+    rtcInterpolateN(scene1,mesh1,&badPrimIDs[1],uv,uv,1,attr0.data(),4*sizeof(float),Pbad,NULL,NULL,4);
+    AssertError(RTC_INVALID_ARGUMENT);
+    rtcInterpolateN(scene2,mesh2,&badPrimIDs[2],uv,uv,1,attr2.data(),4*sizeof(float),Pbad,NULL,NULL,4);
+    AssertError(RTC_INVALID_ARGUMENT);
+    RTCScene scene3 = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    unsigned mesh3 = rtcNewTriangleMesh (scene3, RTC_GEOMETRY_STATIC, 2*num*num, numVertices);
+    rtcSetBuffer(scene3,mesh3,RTC_INDEX_BUFFER,triangles.data(),0,sizeof(Triangle));
+    rtcInterpolateN(scene3,mesh3,badPrimIDs,uv,uv,1,attr0.data(),4*sizeof(float),Pbad,NULL,NULL,4);
+    AssertError(RTC_INVALID_OPERATION);
+    rtcDeleteScene (scene3);
+
+    rtcDeleteScene (scene0);
+    rtcDeleteScene (scene1);
+    rtcDeleteScene (scene2);
+    AssertNoError();
+    return passed;
+  }
+
+  RTCScene createGridScene(size_t num, RTCSceneFlags sflags)
+  {
+    RTCScene scene = rtcNewScene(sflags,aflags);
+    unsigned mesh = rtcNewTriangleMesh (scene, RTC_GEOMETRY_STATIC, 2*num*num, (num+1)*(num+1));
+    Vertex3fa* vertices = (Vertex3fa*) rtcMapBuffer(scene,mesh,RTC_VERTEX_BUFFER);
+    Triangle* triangles = (Triangle*) rtcMapBuffer(scene,mesh,RTC_INDEX_BUFFER);
+    for (size_t z=0; z<=num; z++) {
+      for (size_t x=0; x<=num; x++) {
+        vertices[z*(num+1)+x] = Vec3fa(float(x),0.5f*sinf(1.3f*x)*cosf(0.7f*z),float(z));
+      }
+    }
+    for (size_t z=0; z<num; z++) {
+      for (size_t x=0; x<num; x++) {
+        const int v0 = z*(num+1)+x, v1 = v0+1, v2 = v1+(num+1), v3 = v0+(num+1);
+        const size_t i = z*num+x;
+        triangles[2*i+0].v0 = v0; triangles[2*i+0].v1 = v1; triangles[2*i+0].v2 = v3;
+        triangles[2*i+1].v0 = v2; triangles[2*i+1].v1 = v3; triangles[2*i+1].v2 = v1;
+      }
+    }
+    rtcUnmapBuffer(scene,mesh,RTC_VERTEX_BUFFER);
+    rtcUnmapBuffer(scene,mesh,RTC_INDEX_BUFFER);
+    rtcCommit (scene);
+    return scene;
+  }
+
+  bool rtcore_subdiv_refit(size_t numFrames)
+  {
+    /* two subdivision spheres in a dynamic scene, only the first one deforms */
+    RTCScene scene = rtcNewScene(RTC_SCENE_DYNAMIC,aflags);
+    const size_t numPhi = 8;
+    const size_t numVertices = 2*numPhi*(numPhi+1);
+    unsigned geom0 = addSubdivSphere(scene,RTC_GEOMETRY_DEFORMABLE,Vec3fa(-1.5f,0.0f,0.0f),1.0f,numPhi,4);
+    addSubdivSphere(scene,RTC_GEOMETRY_DEFORMABLE,Vec3fa(+1.5f,0.0f,0.0f),1.0f,numPhi,4);
+    rtcCommit (scene);
+    AssertNoError();
+
+    std::vector<Vec3fa> base(numVertices);
+    Vec3fa* vertices = (Vec3fa*) rtcMapBuffer(scene,geom0,RTC_VERTEX_BUFFER);
+    for (size_t i=0; i<numVertices; i++) base[i] = vertices[i];
+    rtcUnmapBuffer(scene,geom0,RTC_VERTEX_BUFFER);
+
+    bool passed = true;
+    std::vector<RTCRay> rays(1000);
+    for (size_t f=0; f<numFrames; f++)
+    {
+      /* only the vertices change, thus the BVH gets refitted */
+      vertices = (Vec3fa*) rtcMapBuffer(scene,geom0,RTC_VERTEX_BUFFER);
+      for (size_t i=0; i<numVertices; i++) {
+        const Vec3fa d = base[i]-Vec3fa(-1.5f,0.0f,0.0f);
+        vertices[i] = base[i] + 0.3f*sinf(float(f)+3.0f*d.y)*d;
+      }
+      rtcUnmapBuffer(scene,geom0,RTC_VERTEX_BUFFER);
+      rtcUpdateBuffer(scene,geom0,RTC_VERTEX_BUFFER);
+      rtcCommit (scene);
+      AssertNoError();
+
+      for (size_t i=0; i<rays.size(); i++) {
+        rays[i] = makeRay(Vec3fa(6.0f*drand48()-3.0f,5.0f,3.0f*drand48()-1.5f),Vec3fa(0,-1,0));
+        rtcIntersect(scene,rays[i]);
+      }
+
+      /* compare against a full rebuild */
+      rtcUpdate(scene,geom0);
+      rtcCommit (scene);
+      AssertNoError();
+
+      for (size_t i=0; i<rays.size(); i++) {
+        RTCRay ray = makeRay(Vec3fa(rays[i].org[0],rays[i].org[1],rays[i].org[2]),Vec3fa(0,-1,0));
+        rtcIntersect(scene,ray);
+        passed &= ray.geomID == rays[i].geomID;
+        if (ray.geomID != RTC_INVALID_GEOMETRY_ID) passed &= fabsf(ray.tfar-rays[i].tfar) < 1E-4f;
+      }
+    }
+
+    rtcDeleteScene (scene);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_view_dependent_tessellation(size_t numFrames)
+  {
+    RTCScene scene = rtcNewScene(RTC_SCENE_DYNAMIC,aflags);
+    unsigned geom0 = addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(0.0f,-5.0f,0.0f),1.0f,10);
+    unsigned geom1 = addSubdivSphere(scene,RTC_GEOMETRY_DEFORMABLE,Vec3fa(-1.5f,0.0f,0.0f),1.0f,8,1);
+    addSubdivSphere(scene,RTC_GEOMETRY_DEFORMABLE,Vec3fa(+1.5f,0.0f,0.0f),1.0f,8,1);
+    AssertNoError();
+
+    /* only subdivision meshes support view dependent levels */
+    float camera[3] = { -1.5f, 20.0f, 0.0f };
+    rtcSetViewDependentTessellation(scene,geom0,camera,60.0f,512,4.0f);
+    AssertError(RTC_INVALID_OPERATION);
+    rtcSetViewDependentTessellation(scene,geom1,camera,0.0f,512,4.0f);
+    AssertError(RTC_INVALID_ARGUMENT);
+
+    bool passed = true;
+    std::vector<RTCRay> rays(1000);
+    for (size_t f=0; f<numFrames; f++)
+    {
+      /* the camera approaches the first sphere, which only changes some of its levels */
+      camera[1] = 20.0f-2.0f*float(f);
+      rtcSetViewDependentTessellation(scene,geom1,camera,60.0f,512,4.0f);
+      rtcCommit (scene);
+      AssertNoError();
+
+      for (size_t i=0; i<rays.size(); i++) {
+        rays[i] = makeRay(Vec3fa(6.0f*drand48()-3.0f,5.0f,3.0f*drand48()-1.5f),Vec3fa(0,-1,0));
+        rtcIntersect(scene,rays[i]);
+      }
+
+      /* compare against a full rebuild */
+      rtcUpdate(scene,geom1);
+      rtcCommit (scene);
+      AssertNoError();
+
+      for (size_t i=0; i<rays.size(); i++) {
+        RTCRay ray = makeRay(Vec3fa(rays[i].org[0],rays[i].org[1],rays[i].org[2]),Vec3fa(0,-1,0));
+        rtcIntersect(scene,ray);
+        passed &= ray.geomID == rays[i].geomID;
+        if (ray.geomID != RTC_INVALID_GEOMETRY_ID) passed &= fabsf(ray.tfar-rays[i].tfar) < 1E-4f;
+      }
+    }
+
+    /* disabling view dependent levels goes back to the coarse levels of the level buffer */
+    rtcSetViewDependentTessellation(scene,geom1,camera,60.0f,512,0.0f);
+    rtcCommit (scene);
+    AssertNoError();
+    size_t numChanged = 0;
+    for (size_t i=0; i<rays.size(); i++) {
+      RTCRay ray = makeRay(Vec3fa(rays[i].org[0],rays[i].org[1],rays[i].org[2]),Vec3fa(0,-1,0));
+      rtcIntersect(scene,ray);
+      if (ray.geomID == geom1) numChanged += fabsf(ray.tfar-rays[i].tfar) > 1E-3f;
+    }
+    passed &= numChanged > 0;
+
+    rtcDeleteScene (scene);
+    AssertNoError();
+    return passed;
+  }
+
+  bool g_displacement_layout_ok = true;
+
+  void displacementFunction(void* ptr, unsigned geomID, unsigned primID, 
+                            const float* u, const float* v, 
+                            const float* nx, const float* ny, const float* nz, 
+                            float* px, float* py, float* pz, size_t N)
+  {
+    /* all arrays have to be aligned and padded by replicating the last point */
+    const void* arrays[8] = { u,v,nx,ny,nz,px,py,pz };
+    for (size_t i=0; i<8; i++) g_displacement_layout_ok &= (size_t(arrays[i]) & 63) == 0;
+    for (size_t i=N; i<((N+15)&(-16)); i++) {
+      g_displacement_layout_ok &= u[i] == u[N-1] && v[i] == v[N-1] && nx[i] == nx[N-1];
+      g_displacement_layout_ok &= px[i] == px[N-1] && py[i] == py[N-1] && pz[i] == pz[N-1];
+    }
+
+    for (size_t i=0; i<N; i++) {
+      px[i] += 0.2f*nx[i];
+      py[i] += 0.2f*ny[i];
+      pz[i] += 0.2f*nz[i];
+    }
+  }
+
+  bool rtcore_displacement(const char* cfg, RTCSceneFlags sflags, size_t N)
+  {
+    rtcExit();
+    rtcInit((g_rtcore == "" ? std::string(cfg) : g_rtcore + "," + cfg).c_str());
+
+    /* the displaced sphere has to be hit 0.2 units before the undisplaced one */
+    RTCScene scene0 = rtcNewScene(sflags,aflags);
+    addSubdivSphere(scene0,RTC_GEOMETRY_STATIC,zero,1.0f,8,16);
+    rtcCommit (scene0);
+    RTCScene scene1 = rtcNewScene(sflags,aflags);
+    unsigned geom1 = addSubdivSphere(scene1,RTC_GEOMETRY_STATIC,zero,1.0f,8,16);
+    RTCBounds bounds = { -0.2f,-0.2f,-0.2f,0.0f, 0.2f,0.2f,0.2f,0.0f };
+    rtcSetDisplacementFunction(scene1,geom1,displacementFunction,&bounds);
+    rtcCommit (scene1);
+    AssertNoError();
+
+    g_displacement_layout_ok = true;
+    bool passed = true;
+    for (size_t i=0; i<N; i++) 
+    {
+      const Vec3fa dir = normalize(Vec3fa(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f)+Vec3fa(1E-3f));
+      RTCRay ray0 = makeRay(-5.0f*dir,dir); rtcIntersect(scene0,ray0);
+      RTCRay ray1 = makeRay(-5.0f*dir,dir); rtcIntersect(scene1,ray1);
+      passed &= ray0.geomID == 0 && ray1.geomID == 0;
+      passed &= fabsf(ray0.tfar-ray1.tfar-0.2f) < 0.05f;
+    }
+    passed &= g_displacement_layout_ok;
+
+    rtcDeleteScene (scene0);
+    rtcDeleteScene (scene1);
+    AssertNoError();
+    rtcExit();
+    rtcInit(g_rtcore.c_str());
+    return passed;
+  }
+
+  bool rtcore_subdiv_uv(const char* cfg, size_t N)
+  {
+    /* trace the same rays through the default subdivision accel and the specified one */
+    std::vector<RTCRay> rays(N);
+    for (size_t i=0; i<N; i++) {
+      const Vec3fa dir = normalize(Vec3fa(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f)+Vec3fa(1E-3f));
+      rays[i] = makeRay(-5.0f*dir,dir);
+    }
+
+    RTCScene scene0 = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    addSubdivSphere(scene0,RTC_GEOMETRY_STATIC,zero,1.0f,8,16);
+    rtcCommit (scene0);
+    AssertNoError();
+    std::vector<RTCRay> hits0(rays);
+    for (size_t i=0; i<N; i++) rtcIntersect(scene0,hits0[i]);
+    rtcDeleteScene (scene0);
+
+    rtcExit();
+    rtcInit((g_rtcore == "" ? std::string(cfg) : g_rtcore + "," + cfg).c_str());
+    RTCScene scene1 = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    addSubdivSphere(scene1,RTC_GEOMETRY_STATIC,zero,1.0f,8,16);
+    rtcCommit (scene1);
+    AssertNoError();
+
+    /* the tessellation differs between the accels, thus allow a few hits close to patch borders to differ */
+    bool passed = true;
+    size_t numMismatches = 0;
+    for (size_t i=0; i<N; i++) 
+    {
+      RTCRay hit1 = rays[i]; rtcIntersect(scene1,hit1);
+      passed &= hits0[i].geomID == 0 && hit1.geomID == 0;
+      numMismatches += hits0[i].primID != hit1.primID || fabsf(hits0[i].u-hit1.u) > 0.02f || fabsf(hits0[i].v-hit1.v) > 0.02f;
+    }
+    passed &= numMismatches <= N/20;
+
+    rtcDeleteScene (scene1);
+    AssertNoError();
+    rtcExit();
+    rtcInit(g_rtcore.c_str());
+    return passed;
+  }
+
+  RTCScene createStrandScene(size_t numStrands, size_t numSegments)
+  {
+    /* deterministic hair strands with shared end points between neighboring segments */
+    RTCScene scene = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    unsigned geomID = rtcNewHairGeometry (scene, RTC_GEOMETRY_STATIC, numStrands*numSegments, numStrands*(3*numSegments+1));
+    Vec3fa* vertices = (Vec3fa*) rtcMapBuffer(scene,geomID,RTC_VERTEX_BUFFER); 
+    int* indices = (int*) rtcMapBuffer(scene,geomID,RTC_INDEX_BUFFER);
+    for (size_t i=0; i<numStrands; i++) 
+    {
+      const Vec3fa root(4.0f*float((37*i)%97)/97.0f,0.0f,4.0f*float((61*i)%89)/89.0f);
+      const float phase = 0.37f*float(i);
+      for (size_t j=0; j<3*numSegments+1; j++) {
+        const float t = float(j)/float(3*numSegments);
+        const Vec3fa p = root + Vec3fa(0.3f*sinf(4.0f*t+phase),2.0f*t,0.3f*cosf(4.0f*t+phase));
+        vertices[i*(3*numSegments+1)+j] = Vec3fa(p,0.02f*(1.0f-0.5f*t));
+      }
+      for (size_t j=0; j<numSegments; j++)
+        indices[i*numSegments+j] = i*(3*numSegments+1)+3*j;
+    }
+    rtcUnmapBuffer(scene,geomID,RTC_VERTEX_BUFFER); 
+    rtcUnmapBuffer(scene,geomID,RTC_INDEX_BUFFER);
+    rtcCommit(scene);
+    return scene;
+  }
+
+  bool rtcore_hair_accel(const char* cfg, size_t N)
+  {
+    /* trace the same rays through the default hair accel and the specified one */
+    std::vector<RTCRay> rays(N);
+    for (size_t i=0; i<N; i++) {
+      Vec3fa org(-1.0f,2.0f*drand48(),6.0f*drand48()-1.0f);
+      Vec3fa dir(1.0f,0.2f*drand48()-0.1f,0.2f*drand48()-0.1f);
+      rays[i] = makeRay(org,dir);
+    }
+
+    RTCScene scene0 = createStrandScene(500,8);
+    AssertNoError();
+    std::vector<RTCRay> hits0(rays);
+    for (size_t i=0; i<N; i++) rtcIntersect(scene0,hits0[i]);
+    rtcDeleteScene (scene0);
+
+    rtcExit();
+    rtcInit((g_rtcore == "" ? std::string(cfg) : g_rtcore + "," + cfg).c_str());
+    RTCScene scene1 = createStrandScene(500,8);
+    AssertNoError();
+
+    /* quantization may change a few grazing hits */
+    size_t numHits = 0, numMismatches = 0;
+    for (size_t i=0; i<N; i++) 
+    {
+      RTCRay hit1 = rays[i]; rtcIntersect(scene1,hit1);
+      RTCRay shadow = rays[i]; rtcOccluded(scene1,shadow);
+      numHits += hits0[i].geomID != RTC_INVALID_GEOMETRY_ID;
+      bool match = hits0[i].geomID == hit1.geomID && (shadow.geomID == 0) == (hit1.geomID != RTC_INVALID_GEOMETRY_ID);
+      if (hit1.geomID != RTC_INVALID_GEOMETRY_ID) match &= hits0[i].primID == hit1.primID && fabsf(hits0[i].tfar-hit1.tfar) < 1E-3f;
+      numMismatches += !match;
+    }
+    rtcDeleteScene (scene1);
+    AssertNoError();
+    rtcExit();
+    rtcInit(g_rtcore.c_str());
+    return numHits > N/10 && numMismatches <= N/1000;
+  }
+
+  bool rtcore_build_config(const char* cfg, RTCSceneFlags sflags, size_t N)
+  {
+    /* trace the same rays once through a normally build scene and once through a scene build with the specified configuration */
+    const size_t num = 128;
+    std::vector<RTCRay> rays(N);
+    for (size_t i=0; i<N; i++) {
+      Vec3fa org(num*drand48(),5.0f,num*drand48());
+      Vec3fa dir(0.4f*drand48()-0.2f,-1.0f,0.4f*drand48()-0.2f);
+      rays[i] = makeRay(org,dir);
+    }
+
+    std::vector<RTCRay> hits0(rays), hits1(rays);
+    RTCScene scene0 = createGridScene(num,sflags);
+    AssertNoError();
+    for (size_t i=0; i<N; i++) rtcIntersect(scene0,hits0[i]);
+    rtcDeleteScene (scene0);
+
+    rtcExit();
+    rtcInit((g_rtcore == "" ? std::string(cfg) : g_rtcore + "," + cfg).c_str());
+    RTCScene scene1 = createGridScene(num,sflags);
+    AssertNoError();
+    bool passed = true;
+    for (size_t i=0; i<N; i++) {
+      rtcIntersect(scene1,hits1[i]);
+      passed &= hits0[i].geomID == hits1[i].geomID && hits0[i].primID == hits1[i].primID && hits0[i].tfar == hits1[i].tfar;
+      RTCRay shadow = rays[i]; rtcOccluded(scene1,shadow);
+      passed &= (shadow.geomID == 0) == (hits0[i].geomID != RTC_INVALID_GEOMETRY_ID);
+    }
+    rtcDeleteScene (scene1);
+    AssertNoError();
+    rtcExit();
+    rtcInit(g_rtcore.c_str());
+    return passed;
+  }
+
+  unsigned addMotionBlurPlane (RTCScene scene, const std::vector<float>& heights, const size_t res = 1)
+  {
+    unsigned mesh = rtcNewTriangleMesh (scene, RTC_GEOMETRY_STATIC, 2*res*res, (res+1)*(res+1), heights.size());
+    if (mesh == RTC_INVALID_GEOMETRY_ID) return mesh;
+    Triangle* triangles = (Triangle*) rtcMapBuffer(scene,mesh,RTC_INDEX_BUFFER);
+    for (size_t z=0; z<res; z++) {
+      for (size_t x=0; x<res; x++) {
+        const int p00 = (z+0)*(res+1)+(x+0), p01 = (z+0)*(res+1)+(x+1);
+        const int p10 = (z+1)*(res+1)+(x+0), p11 = (z+1)*(res+1)+(x+1);
+        Triangle* tri = &triangles[2*(z*res+x)];
+        tri[0].v0 = p00; tri[0].v1 = p10; tri[0].v2 = p11;
+        tri[1].v0 = p00; tri[1].v1 = p11; tri[1].v2 = p01;
+      }
+    }
+    rtcUnmapBuffer(scene,mesh,RTC_INDEX_BUFFER);
+    for (size_t t=0; t<heights.size(); t++) {
+      Vec3fa* vertices = (Vec3fa*) rtcMapBuffer(scene,mesh,(RTCBufferType)(RTC_VERTEX_BUFFER0+t));
+      for (size_t z=0; z<=res; z++)
+        for (size_t x=0; x<=res; x++)
+          vertices[z*(res+1)+x] = Vec3fa(20.0f*x/res-10.0f,heights[t],20.0f*z/res-10.0f);
+      rtcUnmapBuffer(scene,mesh,(RTCBufferType)(RTC_VERTEX_BUFFER0+t));
+    }
+    return mesh;
+  }
+
+  bool rtcore_motion_blur_segments(size_t numTimeSteps, size_t res, size_t N)
+  {
+    /* a plane that moves non-linearly in y over the time steps */
+    std::vector<float> heights(numTimeSteps);
+    for (size_t t=0; t<numTimeSteps; t++) 
+      heights[t] = 3.0f*sinf(1.7f*t)+float(t);
+
+    RTCScene scene = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    addMotionBlurPlane(scene,heights,res);
+    AssertNoError();
+
+    /* too many time steps and a different number of time steps than other meshes are invalid */
+    addMotionBlurPlane(scene,std::vector<float>(RTC_MAX_TIME_STEPS+1,0.0f));
+    AssertAnyError();
+    addMotionBlurPlane(scene,std::vector<float>(numTimeSteps+1,0.0f));
+    AssertAnyError();
+
+    rtcCommit (scene);
+    AssertNoError();
+
+    const size_t numSegments = numTimeSteps-1;
+    bool passed = true;
+    for (size_t i=0; i<N; i++) 
+    {
+      RTCRay rays[8]; float expected[8];
+      for (size_t k=0; k<8; k++) {
+        rays[k] = makeRay(Vec3fa(10.0f*drand48()-5.0f,100.0f,10.0f*drand48()-5.0f),Vec3fa(0,-1,0));
+        rays[k].time = drand48();
+        const size_t s = min(size_t(rays[k].time*numSegments),numSegments-1);
+        const float f = rays[k].time*numSegments-float(s);
+        expected[k] = 100.0f-((1.0f-f)*heights[s]+f*heights[s+1]);
+      }
+
+      for (size_t k=0; k<8; k++) {
+        RTCRay ray = rays[k]; rtcIntersect(scene,ray);
+        passed &= ray.geomID == 0 && fabsf(ray.tfar-expected[k]) < 1E-3f;
+        RTCRay shadow = rays[k]; rtcOccluded(scene,shadow);
+        passed &= shadow.geomID == 0;
+      }
+
+      RTCRay4 ray4; for (size_t k=0; k<4; k++) setRay(ray4,k,rays[k]);
+      __aligned(16) int valid4[4] = { -1,-1,-1,-1 };
+      rtcIntersect4(valid4,scene,ray4);
+      for (size_t k=0; k<4; k++)
+        passed &= ray4.geomID[k] == 0 && fabsf(ray4.tfar[k]-expected[k]) < 1E-3f;
+
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+      if (has_feature(AVX))
+      {
+        RTCRay8 ray8; for (size_t k=0; k<8; k++) setRay(ray8,k,rays[k]);
+        __aligned(32) int valid8[8] = { -1,-1,-1,-1,-1,-1,-1,-1 };
+        rtcIntersect8(valid8,scene,ray8);
+        for (size_t k=0; k<8; k++)
+          passed &= ray8.geomID[k] == 0 && fabsf(ray8.tfar[k]-expected[k]) < 1E-3f;
+      }
+#endif
+    }
+    rtcDeleteScene (scene);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_motion_blur_time_steps_delete()
+  {
+    RTCScene scene = rtcNewScene(RTC_SCENE_DYNAMIC,aflags);
+    unsigned geom0 = addMotionBlurPlane(scene,std::vector<float>(2,0.0f));
+    unsigned geom1 = addMotionBlurPlane(scene,std::vector<float>(2,1.0f));
+    rtcCommit (scene);
+    AssertNoError();
+
+    /* once all meshes with 2 time steps are deleted, other numbers of time steps are allowed */
+    rtcDeleteGeometry(scene,geom0);
+    addMotionBlurPlane(scene,std::vector<float>(8,0.0f));
+    AssertAnyError();
+    rtcDeleteGeometry(scene,geom1);
+    unsigned geom2 = addMotionBlurPlane(scene,std::vector<float>(8,2.0f));
+    AssertNoError();
+    rtcCommit (scene);
+    AssertNoError();
+
+    /* also after a commit that removed all motion blur meshes */
+    rtcDeleteGeometry(scene,geom2);
+    rtcCommit (scene);
+    unsigned geom3 = addMotionBlurPlane(scene,std::vector<float>(4,3.0f));
+    rtcCommit (scene);
+    AssertNoError();
+
+    RTCRay ray = makeRay(Vec3fa(0,100,0),Vec3fa(0,-1,0)); ray.time = 0.5f;
+    rtcIntersect(scene,ray);
+    rtcDeleteScene (scene);
+    AssertNoError();
+    return geom2 != RTC_INVALID_GEOMETRY_ID && ray.geomID == geom3 && fabsf(ray.tfar-97.0f) < 1E-3f;
+  }
+
+  bool rtcore_incremental_update(RTCGeometryFlags flags, size_t N)
+  {
+    RTCScene scene = rtcNewScene(RTC_SCENE_DYNAMIC,aflags);
+    const size_t numPhi = 10;
+    const size_t numVertices = 2*numPhi*(numPhi+1);
+    std::vector<Vec3fa> pos;
+    for (size_t x=0; x<8; x++) {
+      for (size_t z=0; z<8; z++) {
+        pos.push_back(Vec3fa(2.0f*x-8.0f,0.0f,2.0f*z-8.0f));
+        addSphere(scene,flags,pos.back(),0.5f,numPhi);
+      }
+    }
+    rtcCommit (scene);
+    AssertNoError();
+
+    bool passed = true;
+    for (size_t frame=0; frame<8; frame++)
+    {
+      /* move only a few meshes each frame */
+      for (size_t i=0; i<3; i++) {
+        const size_t geomID = size_t(drand48()*pos.size()) % pos.size();
+        Vec3fa ds(0.4f*drand48()-0.2f,0.4f*drand48()-0.2f,0.4f*drand48()-0.2f);
+        move_mesh_vec3f(scene,geomID,numVertices,ds); pos[geomID] += ds;
+      }
+      rtcCommit (scene);
+      AssertNoError();
+
+      /* compare against scene build from scratch */
+      RTCScene ref = rtcNewScene(RTC_SCENE_STATIC,aflags);
+      for (size_t i=0; i<pos.size(); i++) addSphere(ref,RTC_GEOMETRY_STATIC,pos[i],0.5f,numPhi);
+      rtcCommit (ref);
+      AssertNoError();
+
+      for (size_t i=0; i<N; i++) 
+      {
+        Vec3fa org(20.0f*drand48()-10.0f,2.0f,20.0f*drand48()-10.0f);
+        Vec3fa dir(0.2f*drand48()-0.1f,-1.0f,0.2f*drand48()-0.1f);
+        RTCRay ray0 = makeRay(org,dir); rtcIntersect(scene,ray0);
+        RTCRay ray1 = makeRay(org,dir); rtcIntersect(ref,ray1);
+        passed &= ray0.geomID == ray1.geomID;
+        if (ray0.geomID != RTC_INVALID_GEOMETRY_ID) passed &= abs(ray0.tfar-ray1.tfar) < 1E-4f;
+      }
+      rtcDeleteScene (ref);
+    }
+    AssertNoError();
+
+    rtcDeleteScene (scene);
+    return passed;
+  }
+
+  bool rtcore_ray_stream(size_t N)
+  {
+    RTCScene scene = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(-0.5f,0.0f,0.0f),0.4f,50);
+    addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(+0.5f,0.0f,0.0f),0.4f,50);
+    addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(0.0f,0.5f,0.5f),0.3f,50);
+    rtcCommit (scene);
+    AssertNoError();
+
+    /* reference results using single rays */
+    std::vector<RTCRay> rays(N), hits(N), shadows(N);
+    for (size_t i=0; i<N; i++) {
+      Vec3fa org(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+      Vec3fa dir(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+      rays[i] = hits[i] = shadows[i] = makeRay(org,dir);
+      rtcIntersect(scene,hits[i]);
+      rtcOccluded(scene,shadows[i]);
+    }
+    
+    /* trace stream in AoS layout */
+    bool passed = true;
+    std::vector<RTCRay> aos = rays;
+    ::rtcIntersectN(scene,&aos[0],N,sizeof(RTCRay));
+    AssertNoError();
+    for (size_t i=0; i<N; i++) {
+      passed &= aos[i].geomID == hits[i].geomID && aos[i].primID == hits[i].primID;
+      if (hits[i].geomID != RTC_INVALID_GEOMETRY_ID)
+        passed &= fabs(aos[i].tfar-hits[i].tfar) <= 1E-4f*max(1.0f,fabs(hits[i].tfar));
+    }
+    aos = rays;
+    ::rtcOccludedN(scene,&aos[0],N,sizeof(RTCRay));
+    AssertNoError();
+    for (size_t i=0; i<N; i++)
+      passed &= (aos[i].geomID == 0) == (shadows[i].geomID == 0);
+
+    /* trace stream in SoA layout */
+    std::vector<float> orgx(N), orgy(N), orgz(N), dirx(N), diry(N), dirz(N), tnear(N), tfar(N), time(N);
+    std::vector<float> Ngx(N), Ngy(N), Ngz(N), u(N), v(N);
+    std::vector<int> mask(N), geomID(N), primID(N), instID(N);
+    RTCRayNp soa;
+    soa.orgx = &orgx[0]; soa.orgy = &orgy[0]; soa.orgz = &orgz[0];
+    soa.dirx = &dirx[0]; soa.diry = &diry[0]; soa.dirz = &dirz[0];
+    soa.tnear = &tnear[0]; soa.tfar = &tfar[0]; soa.time = &time[0]; soa.mask = &mask[0];
+    soa.Ngx = &Ngx[0]; soa.Ngy = &Ngy[0]; soa.Ngz = &Ngz[0]; soa.u = &u[0]; soa.v = &v[0];
+    soa.geomID = &geomID[0]; soa.primID = &primID[0]; soa.instID = &instID[0];
+
+    for (int occluded=0; occluded<2; occluded++)
+    {
+      for (size_t i=0; i<N; i++) {
+        orgx[i] = rays[i].org[0]; orgy[i] = rays[i].org[1]; orgz[i] = rays[i].org[2];
+        dirx[i] = rays[i].dir[0]; diry[i] = rays[i].dir[1]; dirz[i] = rays[i].dir[2];
+        tnear[i] = rays[i].tnear; tfar[i] = rays[i].tfar; time[i] = rays[i].time; mask[i] = rays[i].mask;
+        geomID[i] = primID[i] = instID[i] = RTC_INVALID_GEOMETRY_ID;
+      }
+      if (occluded) ::rtcOccludedNp(scene,soa,N);
+      else          ::rtcIntersectNp(scene,soa,N);
+      AssertNoError();
+
+      for (size_t i=0; i<N; i++) {
+        if (occluded) passed &= (geomID[i] == 0) == (shadows[i].geomID == 0);
+        else          passed &= geomID[i] == hits[i].geomID && primID[i] == hits[i].primID;
+      }
+    }
+
+    rtcDeleteScene (scene);
+    return passed;
+  }
+
+  bool rtcore_new_delete_geometry()
+  {
+    RTCScene scene = rtcNewScene(RTC_SCENE_DYNAMIC,aflags);
+    AssertNoError();
+    int geom[128];
+    for (size_t i=0; i<128; i++) geom[i] = -1;
+    Sphere spheres[128];
+    memset(spheres,0,sizeof(spheres));
+
+    for (size_t i=0; i<50; i++) {
+      for (size_t j=0; j<10; j++) {
+        int index = random<int>()%128;
+        Vec3fa pos = 100.0f*Vec3fa(drand48(),drand48(),drand48());
+        if (geom[index] == -1) {
+          switch (random<int>()%4) {
+          case 0: geom[index] = addSphere(scene,RTC_GEOMETRY_STATIC,pos,2.0f,10); break;
+          case 1: geom[index] = addHair  (scene,RTC_GEOMETRY_STATIC,pos,1.0f,2.0f,10); break;
+	  case 2: geom[index] = addSubdivSphere(scene,RTC_GEOMETRY_STATIC,pos,2.0f,4,4); break;
+          case 3: 
+	    spheres[index] = Sphere(pos,2.0f);
+	    geom[index] = addUserGeometryEmpty(scene,&spheres[index]); break;
+          }
           AssertNoError();
         }
         else { 
@@ -3018,18 +4711,64 @@ namespace embree
 
     POSITIVE("dynamic_enable_disable",    rtcore_dynamic_enable_disable());
     POSITIVE("get_user_data"         ,    rtcore_get_user_data());
+    POSITIVE("async_commit",              rtcore_async_commit(1000));
+    POSITIVE("async_commit_update",       rtcore_async_commit_update());
+    POSITIVE("async_commit_scenes",       rtcore_async_commit_scenes(8));
+    POSITIVE("instance_array",            rtcore_instance_array(100,10000));
+    POSITIVE("instance_nested",           rtcore_instance_nested(3,10000));
+    POSITIVE("user_geometry_stream",      rtcore_user_geometry_stream(1000,10000));
+    POSITIVE("interpolate",               rtcore_interpolate(10000));
+    POSITIVE("subdiv_refit",              rtcore_subdiv_refit(8));
+    POSITIVE("view_dependent_tessellation", rtcore_view_dependent_tessellation(8));
+    POSITIVE("displacement_cached",       rtcore_displacement("subdiv_accel=bvh4.subdivpatch1cached",RTC_SCENE_DYNAMIC,1000));
+    POSITIVE("displacement_eager",        rtcore_displacement("subdiv_accel=bvh4.grid.eager",RTC_SCENE_STATIC,1000));
+    POSITIVE("displacement_lazy",         rtcore_displacement("subdiv_accel=bvh4.grid.lazy",RTC_SCENE_STATIC,1000));
+    POSITIVE("displacement_tight_bounds", rtcore_displacement("subdiv_accel=bvh4.grid.lazy,subdiv_tight_bounds=1",RTC_SCENE_STATIC,1000));
+    POSITIVE("subdiv_uv_cached",          rtcore_subdiv_uv("subdiv_accel=bvh4.subdivpatch1cached",1000));
+    POSITIVE("subdiv_uv_adaptive",        rtcore_subdiv_uv("subdiv_accel=bvh4.grid.adaptive",1000));
+    POSITIVE("subdiv_uv_eager",           rtcore_subdiv_uv("subdiv_accel=bvh4.grid.eager",1000));
+    POSITIVE("subdiv_uv_lazy",            rtcore_subdiv_uv("subdiv_accel=bvh4.grid.lazy",1000));
 
     POSITIVE("update_deformable",         rtcore_update(RTC_GEOMETRY_DEFORMABLE));
     POSITIVE("update_dynamic",            rtcore_update(RTC_GEOMETRY_DYNAMIC));
+    POSITIVE("incremental_static",        rtcore_incremental_update(RTC_GEOMETRY_STATIC,1000));
+    POSITIVE("incremental_deformable",    rtcore_incremental_update(RTC_GEOMETRY_DEFORMABLE,1000));
+    POSITIVE("refit_restructure",         rtcore_refit_restructure(8));
+    POSITIVE("incremental_dynamic",       rtcore_incremental_update(RTC_GEOMETRY_DYNAMIC,1000));
     POSITIVE("overlapping_triangles",     rtcore_overlapping_triangles(100000));
     POSITIVE("overlapping_hair",          rtcore_overlapping_hair(100000));
     POSITIVE("new_delete_geometry",       rtcore_new_delete_geometry());
+    POSITIVE("ray_stream_small",          rtcore_ray_stream(17));
+    POSITIVE("ray_stream",                rtcore_ray_stream(10000));
+    POSITIVE("mixed_accels",              rtcore_mixed_accels(10000));
+    POSITIVE("scene_cache",               rtcore_scene_cache(RTC_SCENE_STATIC,10000));
+    POSITIVE("scene_cache_compact",       rtcore_scene_cache(RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_COMPACT),10000));
+    POSITIVE("scene_cache_corrupted",     rtcore_scene_cache_corrupted(RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_COMPACT),100));
+    POSITIVE("tessellation_cache",        rtcore_tessellation_cache(10000));
+    POSITIVE("quantized_nodes",           rtcore_quantized_nodes(10000));
+    POSITIVE("quad_mesh_static",          rtcore_quad_mesh(RTC_SCENE_STATIC,10000));
+    POSITIVE("quad_mesh_dynamic",         rtcore_quad_mesh(RTC_SCENE_DYNAMIC,10000));
+    POSITIVE("chunked_build",             rtcore_build_config("build_chunk_size=4096",RTC_SCENE_STATIC | RTC_SCENE_ROBUST,10000));
+    POSITIVE("chunked_build_quantized",   rtcore_build_config("build_chunk_size=4096",RTC_SCENE_STATIC | RTC_SCENE_COMPACT,10000));
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+    if (has_feature(AVX))
+      POSITIVE("chunked_build_bvh8",      rtcore_build_config("build_chunk_size=4096,tri_accel=bvh8.triangle8",RTC_SCENE_STATIC,10000));
+#endif
+    POSITIVE("transparent_hugepages",     rtcore_build_config("hugepages=1,numa_interleave=1",RTC_SCENE_STATIC,10000));
+    POSITIVE("explicit_hugepages",        rtcore_build_config("hugepages=2",RTC_SCENE_DYNAMIC,10000));
+    POSITIVE("hair_quantized",            rtcore_hair_accel("hair_accel=bvh4obb.bezier4q",10000));
+#if !defined(__MIC__)
+    POSITIVE("motion_blur_2_time_steps",  rtcore_motion_blur_segments(2,1,1000));
+    POSITIVE("motion_blur_8_time_steps",  rtcore_motion_blur_segments(8,1,1000));
+    POSITIVE("motion_blur_8_time_steps_grid",  rtcore_motion_blur_segments(8,32,1000));
+    POSITIVE("motion_blur_time_steps_delete", rtcore_motion_blur_time_steps_delete());
+#endif
 
     rtcore_build();
 
     const Vec3fa pos = Vec3fa(148376.0f,1234.0f,-223423.0f);
 
-#if defined(RTCORE_RAY_MASK)
+#if defined(RTCORE_RAY_MASK) || (defined(RTCORE_INTERSECTION_FILTER) && !defined(__MIC__))
     rtcore_ray_masks_all();
 #endif
 
@@ -3040,6 +4779,18 @@ namespace embree
 #if defined(RTCORE_BACKFACE_CULLING)
     rtcore_backface_culling_all();
 #endif
+#if !defined(__MIC__)
+    POSITIVE("backface_culling_flag_static",  rtcore_backface_culling(RTCSceneFlags(RTC_SCENE_STATIC  | RTC_SCENE_BACKFACE_CULLING),RTC_GEOMETRY_STATIC));
+    POSITIVE("backface_culling_flag_dynamic", rtcore_backface_culling(RTCSceneFlags(RTC_SCENE_DYNAMIC | RTC_SCENE_BACKFACE_CULLING),RTC_GEOMETRY_STATIC));
+    POSITIVE("backface_culling_flag_robust",  rtcore_backface_culling(RTCSceneFlags(RTC_SCENE_STATIC  | RTC_SCENE_ROBUST | RTC_SCENE_BACKFACE_CULLING),RTC_GEOMETRY_STATIC));
+    POSITIVE("backface_culling_flag_robust_dynamic", rtcore_backface_culling(RTCSceneFlags(RTC_SCENE_DYNAMIC | RTC_SCENE_ROBUST | RTC_SCENE_BACKFACE_CULLING),RTC_GEOMETRY_STATIC));
+    POSITIVE("backface_culling_flag_compact", rtcore_backface_culling(RTCSceneFlags(RTC_SCENE_STATIC  | RTC_SCENE_COMPACT | RTC_SCENE_BACKFACE_CULLING),RTC_GEOMETRY_STATIC));
+    POSITIVE("backface_culling_flag_compact_dynamic", rtcore_backface_culling(RTCSceneFlags(RTC_SCENE_DYNAMIC | RTC_SCENE_COMPACT | RTC_SCENE_BACKFACE_CULLING),RTC_GEOMETRY_STATIC));
+    POSITIVE("backface_culling_flag_quads", rtcore_backface_culling_geometry(RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_BACKFACE_CULLING),CULLING_QUADS));
+    POSITIVE("backface_culling_flag_motion_blur", rtcore_backface_culling_geometry(RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_BACKFACE_CULLING),CULLING_MOTION_BLUR_TRIANGLES));
+    POSITIVE("backface_culling_flag_motion_blur_3_time_steps", rtcore_backface_culling_geometry(RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_BACKFACE_CULLING),CULLING_MOTION_BLUR_TRIANGLES,3));
+    POSITIVE("backface_culling_flag_subdiv", rtcore_backface_culling_geometry(RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_BACKFACE_CULLING),CULLING_SUBDIV));
+#endif
 
     rtcore_packet_write_test_all();
 